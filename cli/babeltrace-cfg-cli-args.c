@@ -1305,6 +1305,7 @@ enum {
 	OPT_COMPONENT,
 	OPT_CONNECT,
 	OPT_DEBUG,
+	OPT_DEBUG_INFO_CACHE_DIR,
 	OPT_DEBUG_INFO_DIR,
 	OPT_DEBUG_INFO_FULL_PATH,
 	OPT_DEBUG_INFO_TARGET_PREFIX,
@@ -1330,6 +1331,7 @@ enum {
 	OPT_RUN_ARGS,
 	OPT_RUN_ARGS_0,
 	OPT_STREAM_INTERSECTION,
+	OPT_THREADS,
 	OPT_TIMERANGE,
 	OPT_URL,
 	OPT_VALUE,
@@ -2320,7 +2322,8 @@ void print_run_usage(FILE *fp)
 	fprintf(fp, "  -r, --reset-base-params           Reset the current base parameters to an\n");
 	fprintf(fp, "                                    empty map\n");
 	fprintf(fp, "      --retry-duration=DUR          When babeltrace(1) needs to retry to run\n");
-	fprintf(fp, "                                    the graph later, retry in DUR µs\n");
+	fprintf(fp, "                                    the graph later, retry as soon as a\n");
+	fprintf(fp, "                                    component is ready, or in DUR µs at most\n");
 	fprintf(fp, "                                    (default: 100000)\n");
 	fprintf(fp, "      --value=VAL                   Add a string initialization parameter to\n");
 	fprintf(fp, "                                    the current component with a name given by\n");
@@ -2782,7 +2785,8 @@ void print_convert_usage(FILE *fp)
 	fprintf(fp, "                                    current component to PATH\n");
 	fprintf(fp, "      --plugin-path=PATH[:PATH]...  Add PATH to the list of paths from which\n");
 	fprintf(fp, "      --retry-duration=DUR          When babeltrace(1) needs to retry to run\n");
-	fprintf(fp, "                                    the graph later, retry in DUR µs\n");
+	fprintf(fp, "                                    the graph later, retry as soon as a\n");
+	fprintf(fp, "                                    component is ready, or in DUR µs at most\n");
 	fprintf(fp, "                                    (default: 100000)\n");
 	fprintf(fp, "                                    dynamic plugins can be loaded\n");
 	fprintf(fp, "      --run-args                    Print the equivalent arguments for the\n");
@@ -2830,6 +2834,9 @@ void print_convert_usage(FILE *fp)
 	fprintf(fp, "\n");
 	fprintf(fp, "      --clock-force-correlate       Assume that clocks are inherently\n");
 	fprintf(fp, "                                    correlated across traces\n");
+	fprintf(fp, "      --threads=N                   Read the upstream ports with N worker\n");
+	fprintf(fp, "                                    threads (default: 0, read on the main\n");
+	fprintf(fp, "                                    thread)\n");
 	fprintf(fp, "\n");
 	fprintf(fp, "Implicit `filter.utils.trimmer` component options:\n");
 	fprintf(fp, "\n");
@@ -2844,6 +2851,9 @@ void print_convert_usage(FILE *fp)
 	fprintf(fp, "\n");
 	fprintf(fp, "Implicit `filter.lttng-utils.debug-info` component options:\n");
 	fprintf(fp, "\n");
+	fprintf(fp, "      --debug-info-cache-dir=DIR    Keep the resolved symbol and line tables\n");
+	fprintf(fp, "                                    of the executables in directory DIR and\n");
+	fprintf(fp, "                                    reuse them in later runs\n");
 	fprintf(fp, "      --debug-info-dir=DIR          Search for debug info in directory DIR\n");
 	fprintf(fp, "                                    instead of `/usr/lib/debug`\n");
 	fprintf(fp, "      --debug-info-full-path        Show full debug info source and\n");
@@ -2902,6 +2912,7 @@ struct poptOption convert_long_options[] = {
 	{ "color", '\0', POPT_ARG_STRING, NULL, OPT_COLOR, NULL, NULL },
 	{ "component", 'c', POPT_ARG_STRING, NULL, OPT_COMPONENT, NULL, NULL },
 	{ "debug", 'd', POPT_ARG_NONE, NULL, OPT_DEBUG, NULL, NULL },
+	{ "debug-info-cache-dir", 0, POPT_ARG_STRING, NULL, OPT_DEBUG_INFO_CACHE_DIR, NULL, NULL },
 	{ "debug-info-dir", 0, POPT_ARG_STRING, NULL, OPT_DEBUG_INFO_DIR, NULL, NULL },
 	{ "debug-info-full-path", 0, POPT_ARG_NONE, NULL, OPT_DEBUG_INFO_FULL_PATH, NULL, NULL },
 	{ "debug-info-target-prefix", 0, POPT_ARG_STRING, NULL, OPT_DEBUG_INFO_TARGET_PREFIX, NULL, NULL },
@@ -2924,6 +2935,7 @@ struct poptOption convert_long_options[] = {
 	{ "run-args", '\0', POPT_ARG_NONE, NULL, OPT_RUN_ARGS, NULL, NULL },
 	{ "run-args-0", '\0', POPT_ARG_NONE, NULL, OPT_RUN_ARGS_0, NULL, NULL },
 	{ "stream-intersection", '\0', POPT_ARG_NONE, NULL, OPT_STREAM_INTERSECTION, NULL, NULL },
+	{ "threads", '\0', POPT_ARG_STRING, NULL, OPT_THREADS, NULL, NULL },
 	{ "timerange", '\0', POPT_ARG_STRING, NULL, OPT_TIMERANGE, NULL, NULL },
 	{ "url", 'u', POPT_ARG_STRING, NULL, OPT_URL, NULL, NULL },
 	{ "verbose", 'v', POPT_ARG_NONE, NULL, OPT_VERBOSE, NULL, NULL },
@@ -3594,6 +3606,7 @@ struct bt_config *bt_config_convert_from_args(int argc, const char *argv[],
 	struct bt_config *cfg = NULL;
 	bool got_input_format_opt = false;
 	bool got_output_format_opt = false;
+	bool got_threads_opt = false;
 	bool trimmer_has_begin = false;
 	bool trimmer_has_end = false;
 	GString *cur_name = NULL;
@@ -3956,6 +3969,7 @@ struct bt_config *bt_config_convert_from_args(int argc, const char *argv[],
 		case OPT_CLOCK_SECONDS:
 		case OPT_COLOR:
 		case OPT_DEBUG:
+		case OPT_DEBUG_INFO_CACHE_DIR:
 		case OPT_DEBUG_INFO_DIR:
 		case OPT_DEBUG_INFO_FULL_PATH:
 		case OPT_DEBUG_INFO_TARGET_PREFIX:
@@ -3970,6 +3984,7 @@ struct bt_config *bt_config_convert_from_args(int argc, const char *argv[],
 		case OPT_RUN_ARGS:
 		case OPT_RUN_ARGS_0:
 		case OPT_STREAM_INTERSECTION:
+		case OPT_THREADS:
 		case OPT_TIMERANGE:
 		case OPT_VERBOSE:
 			/* Ignore in this pass */
@@ -4135,6 +4150,14 @@ struct bt_config *bt_config_convert_from_args(int argc, const char *argv[],
 		case OPT_NO_DEBUG_INFO:
 			implicit_debug_info_args.exists = false;
 			break;
+		case OPT_DEBUG_INFO_CACHE_DIR:
+			implicit_debug_info_args.exists = true;
+			ret = append_implicit_component_extra_param(
+				&implicit_debug_info_args, "cache-dir", arg);
+			if (ret) {
+				goto error;
+			}
+			break;
 		case OPT_DEBUG_INFO_DIR:
 			implicit_debug_info_args.exists = true;
 			ret = append_implicit_component_extra_param(
@@ -4272,6 +4295,25 @@ struct bt_config *bt_config_convert_from_args(int argc, const char *argv[],
 				"stream-intersection", "yes");
 			base_implicit_ctf_input_args.exists = true;
 			break;
+		case OPT_THREADS:
+		{
+			char *endptr;
+			long long threads;
+
+			errno = 0;
+			threads = strtoll(arg, &endptr, 10);
+			if (*arg == '\0' || *endptr != '\0' || errno != 0 ||
+					threads < 0) {
+				printf_err("Invalid --threads option's argument (must be a positive integer or 0):\n    %s\n",
+					arg);
+				goto error;
+			}
+
+			append_implicit_component_param(
+				&implicit_muxer_args, "threads", arg);
+			got_threads_opt = true;
+			break;
+		}
 		case OPT_VERBOSE:
 			if (*log_level != 'V' && *log_level != 'D') {
 				*log_level = 'I';
@@ -4494,6 +4536,17 @@ struct bt_config *bt_config_convert_from_args(int argc, const char *argv[],
 		goto error;
 	}
 
+	/*
+	 * An implicit `source.ctf.lttng-live` component adds output
+	 * ports while it's being iterated, which would happen on the
+	 * muxer's worker threads.
+	 */
+	if (implicit_lttng_live_args.exists && got_threads_opt) {
+		printf_err("Cannot use --threads with an implicit `%s` component\n",
+			implicit_lttng_live_args.comp_arg->str);
+		goto error;
+	}
+
 	/* Assign names to implicit components */
 	for (i = 0; i < implicit_ctf_inputs_args->len; i++) {
 		struct implicit_component_args *impl_args =
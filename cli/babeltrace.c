@@ -1851,15 +1851,22 @@ int cmd_run(struct bt_config *cfg)
 			}
 
 			if (cfg->cmd_data.run.retry_duration_us > 0) {
-				BT_LOGV("Got BT_GRAPH_STATUS_AGAIN: sleeping: "
-					"time-us=%" PRIu64,
+				/*
+				 * Wait until a component is ready, at
+				 * most for the retry duration.
+				 */
+				BT_LOGV("Got BT_GRAPH_STATUS_AGAIN: waiting: "
+					"max-time-us=%" PRIu64,
 					cfg->cmd_data.run.retry_duration_us);
-
-				if (usleep(cfg->cmd_data.run.retry_duration_us)) {
-					if (bt_graph_is_canceled(ctx.graph)) {
-						BT_LOGI_STR("Graph was canceled by user.");
-						goto error;
-					}
+				graph_status = bt_graph_wait(ctx.graph,
+					(int64_t) MIN(cfg->cmd_data.run.retry_duration_us,
+						INT64_MAX));
+				if (graph_status == BT_GRAPH_STATUS_CANCELED) {
+					BT_LOGI_STR("Graph was canceled by user.");
+					goto error;
+				} else if (graph_status < 0) {
+					BT_LOGE_STR("Cannot wait for the graph's components.");
+					goto error;
 				}
 			}
 			break;
@@ -30,6 +30,7 @@
 #include <stdint.h>	/* C99 5.2.4.2 Numerical limits */
 #include <babeltrace/compat/limits-internal.h>	/* C99 5.2.4.2 Numerical limits */
 #include <assert.h>
+#include <string.h>
 #include <babeltrace/endian-internal.h>	/* Non-standard BIG_ENDIAN, LITTLE_ENDIAN, BYTE_ORDER */
 
 /* We can't shift a int from 32 bit, >> 32 and << 32 on int is undefined */
@@ -422,4 +423,51 @@ do {									\
 
 #endif
 
+/*
+ * bt_bitfield_read_aligned_{le,be}_{u,s}{8,16,32,64} - read a whole
+ * 8, 16, 32, or 64-bit integer starting on a byte boundary
+ *
+ * Those are equivalent to bt_bitfield_read_le() and
+ * bt_bitfield_read_be() with a start offset which is a multiple of
+ * CHAR_BIT and a length of 8, 16, 32, or 64, but they compile down to
+ * a single (possibly unaligned) load, followed by a byte swap if the
+ * byte order is not the host's. The signed variants sign-extend the
+ * value to 64 bits.
+ */
+
+#define _bt_le8toh(_v)	(_v)
+#define _bt_be8toh(_v)	(_v)
+#define _bt_le16toh(_v)	le16toh(_v)
+#define _bt_be16toh(_v)	be16toh(_v)
+#define _bt_le32toh(_v)	le32toh(_v)
+#define _bt_be32toh(_v)	be32toh(_v)
+#define _bt_le64toh(_v)	le64toh(_v)
+#define _bt_be64toh(_v)	be64toh(_v)
+
+#define _bt_bitfield_define_read_aligned(_bo, _size)			\
+static inline								\
+uint64_t bt_bitfield_read_aligned_##_bo##_u##_size(const unsigned char *ptr) \
+{									\
+	uint##_size##_t v;						\
+									\
+	memcpy(&v, ptr, sizeof(v));					\
+	return (uint64_t) (uint##_size##_t) _bt_##_bo##_size##toh(v);	\
+}									\
+									\
+static inline								\
+int64_t bt_bitfield_read_aligned_##_bo##_s##_size(const unsigned char *ptr) \
+{									\
+	return (int64_t) (int##_size##_t)				\
+		bt_bitfield_read_aligned_##_bo##_u##_size(ptr);		\
+}
+
+_bt_bitfield_define_read_aligned(le, 8)
+_bt_bitfield_define_read_aligned(le, 16)
+_bt_bitfield_define_read_aligned(le, 32)
+_bt_bitfield_define_read_aligned(le, 64)
+_bt_bitfield_define_read_aligned(be, 8)
+_bt_bitfield_define_read_aligned(be, 16)
+_bt_bitfield_define_read_aligned(be, 32)
+_bt_bitfield_define_read_aligned(be, 64)
+
 #endif /* _BABELTRACE_BITFIELD_H */
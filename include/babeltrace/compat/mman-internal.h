@@ -53,6 +53,45 @@ int munmap(void *addr, size_t length);
 
 #endif /* __MINGW32__ */
 
+/*
+ * Hints that the mapping at `addr` of `length` bytes is read
+ * sequentially. This is a no-op on platforms which don't support it.
+ */
+#ifdef HAVE_MADVISE
+static inline
+int bt_madvise_sequential(void *addr, size_t length)
+{
+	return madvise(addr, length, MADV_SEQUENTIAL);
+}
+#else
+static inline
+int bt_madvise_sequential(void *addr, size_t length)
+{
+	return 0;
+}
+#endif /* HAVE_MADVISE */
+
+/*
+ * Starts reading `length` bytes of the file `fd` at `offset` into the
+ * page cache, so that accessing them later through a mapping does not
+ * block on I/O. This is a no-op on platforms which don't support it.
+ */
+#ifdef HAVE_POSIX_FADVISE
+#include <fcntl.h>
+
+static inline
+int bt_fadvise_willneed(int fd, off_t offset, off_t length)
+{
+	return posix_fadvise(fd, offset, length, POSIX_FADV_WILLNEED);
+}
+#else
+static inline
+int bt_fadvise_willneed(int fd, off_t offset, off_t length)
+{
+	return 0;
+}
+#endif /* HAVE_POSIX_FADVISE */
+
 #ifndef MAP_ANONYMOUS
 # ifdef MAP_ANON
 #   define MAP_ANONYMOUS MAP_ANON
@@ -30,11 +30,14 @@
 #include <babeltrace/ctf-ir/clock-class.h>
 #include <babeltrace/ctf-ir/trace-internal.h>
 #include <babeltrace/object-internal.h>
+#include <babeltrace/object-pool-internal.h>
 #include <babeltrace/babeltrace-internal.h>
 #include <babeltrace/compat/uuid-internal.h>
 #include <babeltrace/types.h>
 #include <glib.h>
 
+#define NS_PER_S	1000000000ULL
+
 struct bt_ctf_clock_class {
 	struct bt_object base;
 	GString *name;
@@ -52,6 +55,24 @@ struct bt_ctf_clock_class {
 	 * class.
 	 */
 	int frozen;
+
+	/*
+	 * Precomputed cycles to nanoseconds conversion multiplier,
+	 * updated when the frequency changes: its integral part and
+	 * its fractional part, in units of 2^-64 (only used when
+	 * 128-bit integers are available).
+	 */
+	uint64_t ns_per_cycle_int;
+	uint64_t ns_per_cycle_frac;
+
+	/*
+	 * `offset_s` and `offset` converted to nanoseconds, updated when
+	 * any of them or the frequency changes.
+	 */
+	int64_t offset_ns;
+
+	/* Released clock values of this class, ready to be reused */
+	struct bt_object_pool value_pool;
 };
 
 struct bt_ctf_clock_value {
@@ -35,11 +35,35 @@
 #include <babeltrace/ctf-ir/stream-class.h>
 #include <babeltrace/ctf-ir/stream.h>
 #include <babeltrace/object-internal.h>
+#include <babeltrace/object-pool-internal.h>
 #include <glib.h>
 
 #define BT_CTF_EVENT_CLASS_ATTR_ID_INDEX	0
 #define BT_CTF_EVENT_CLASS_ATTR_NAME_INDEX	1
 
+/*
+ * How a scope field of an event created with
+ * bt_ctf_event_create_extended() is made from the corresponding scope
+ * field of its base event.
+ */
+enum bt_ctf_event_scope_mapping {
+	/* Own field, created as usual */
+	BT_CTF_EVENT_SCOPE_MAPPING_NONE,
+	/* Same field as the base event's (same field types) */
+	BT_CTF_EVENT_SCOPE_MAPPING_SHARE,
+	/* Own structure field, starting with the base event's fields */
+	BT_CTF_EVENT_SCOPE_MAPPING_GRAFT,
+};
+
+/* Scopes of an event, in the order of their scope mappings */
+enum bt_ctf_event_scope_mapping_index {
+	BT_CTF_EVENT_SCOPE_MAPPING_INDEX_HEADER,
+	BT_CTF_EVENT_SCOPE_MAPPING_INDEX_STREAM_EVENT_CONTEXT,
+	BT_CTF_EVENT_SCOPE_MAPPING_INDEX_EVENT_CONTEXT,
+	BT_CTF_EVENT_SCOPE_MAPPING_INDEX_EVENT_PAYLOAD,
+	BT_CTF_EVENT_SCOPE_MAPPING_COUNT,
+};
+
 struct bt_ctf_event_class {
 	struct bt_object base;
 	struct bt_value *attributes;
@@ -60,6 +84,23 @@ struct bt_ctf_event_class {
 	/* Cached values */
 	const char *name;
 	int64_t id;
+
+	/* Released pooled events of this class, ready to be reused */
+	struct bt_object_pool event_pool;
+
+	/*
+	 * Class of the base event last given to
+	 * bt_ctf_event_create_extended() with this class, and how the
+	 * scope fields of the created events map to the ones of such a
+	 * base event. Both classes are frozen, so this mapping cannot
+	 * change while this class holds a reference on the base class.
+	 * When the base class is this class, this is a weak reference:
+	 * a class holding a reference on itself would never be
+	 * destroyed.
+	 */
+	struct bt_ctf_event_class *extended_base_class;
+	enum bt_ctf_event_scope_mapping
+		extended_scope_mappings[BT_CTF_EVENT_SCOPE_MAPPING_COUNT];
 };
 
 BT_HIDDEN
@@ -51,6 +51,13 @@ struct bt_ctf_event {
 	/* Maps clock classes to bt_ctf_clock_value. */
 	GHashTable *clock_values;
 	int frozen;
+
+	/*
+	 * True if this event goes back to its class's event pool
+	 * instead of being destroyed when it's released (see
+	 * bt_ctf_event_create_pooled()).
+	 */
+	bt_bool is_pooled;
 };
 
 BT_HIDDEN
@@ -64,6 +71,10 @@ int bt_ctf_event_serialize(struct bt_ctf_event *event,
 BT_HIDDEN
 void bt_ctf_event_freeze(struct bt_ctf_event *event);
 
+/* Destroys an event which is in its class's event pool. */
+BT_HIDDEN
+void bt_ctf_event_destroy_recycled(void *obj);
+
 static inline struct bt_ctf_packet *bt_ctf_event_borrow_packet(
 		struct bt_ctf_event *event)
 {
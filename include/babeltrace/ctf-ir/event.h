@@ -164,6 +164,91 @@ with bt_ctf_trace_add_stream_class(), then this function fails.
 extern struct bt_ctf_event *bt_ctf_event_create(
 		struct bt_ctf_event_class *event_class);
 
+/**
+@brief  Creates a default CTF IR event from the CTF IR event class
+	\p event_class, reusing a recycled event of this class if
+	possible.
+
+This function is the same as bt_ctf_event_create(), except that the
+returned event is not destroyed when it is released (when its
+reference count falls to zero): it is reset and kept in an event pool
+owned by \p event_class. The next call to this function with the same
+event class returns such a recycled event, if any, instead of allocating
+and validating a new one.
+
+The fields of a recycled event are kept, not set and not frozen, unless
+something else still holds a reference on them: you can get them with
+bt_ctf_event_get_header(), bt_ctf_event_get_stream_event_context(),
+bt_ctf_event_get_event_context(), and bt_ctf_event_get_event_payload()
+and fill them again instead of creating new fields.
+
+An event which is appended to a CTF IR stream with
+bt_ctf_stream_append_event() is destroyed, not recycled.
+
+@param[in] event_class	CTF IR event class to use to create the
+			CTF IR event.
+@returns		Created or recycled event object, or \c NULL on
+			error.
+
+@prenotnull{event_class}
+@pre \p event_class has a parent stream class.
+@postsuccessrefcountret1
+
+@sa bt_ctf_event_create(): Creates an event which is never recycled.
+*/
+extern struct bt_ctf_event *bt_ctf_event_create_pooled(
+		struct bt_ctf_event_class *event_class);
+
+/**
+@brief  Creates a CTF IR event from the CTF IR event class
+	\p event_class which shares the fields of the CTF IR event
+	\p base_event.
+
+This function is the same as bt_ctf_event_create_pooled(), except that
+the scope fields of the returned event are made from the ones of
+\p base_event, which can be of another event class, without copying
+them:
+
+- If the type of a scope field of \p base_event is equivalent to the
+  corresponding scope field type of \p event_class (see
+  bt_ctf_field_type_compare()), the returned event gets this very
+  field.
+- If both are structure field types and the fields of the one of
+  \p base_event have the same names and types as the first fields of
+  the one of \p event_class, the returned event gets a new structure
+  field whose first fields are the ones of \p base_event's scope
+  field. This is how you extend a scope of an event with extra fields,
+  which you set afterwards, without copying the original fields.
+- Otherwise, the returned event gets a new, default scope field, like
+  with bt_ctf_event_create_pooled().
+
+Shared fields must not be modified since they are also part of
+\p base_event: set only the extra fields and the fields which are not
+shared.
+
+The way the scope fields of \p event_class map to the ones of
+\p base_event's class is computed once and kept in \p event_class as
+long as this function is called with base events of the same class.
+
+@param[in] event_class	CTF IR event class to use to create the
+			CTF IR event.
+@param[in] base_event	CTF IR event of which to share the fields.
+@returns		Created or recycled event object, or \c NULL on
+			error.
+
+@prenotnull{event_class}
+@prenotnull{base_event}
+@pre \p event_class has a parent stream class.
+@postrefcountsame{base_event}
+@postsuccessrefcountret1
+
+@sa bt_ctf_event_create_pooled(): Creates an event which does not
+	share the fields of another event.
+*/
+extern struct bt_ctf_event *bt_ctf_event_create_extended(
+		struct bt_ctf_event_class *event_class,
+		struct bt_ctf_event *base_event);
+
 /**
 @brief	Returns the parent CTF IR event class of the CTF IR event
 	\p event.
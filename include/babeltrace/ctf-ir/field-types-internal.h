@@ -204,6 +204,16 @@ BT_HIDDEN
 int bt_ctf_field_type_sequence_set_element_type(struct bt_ctf_field_type *array,
 		struct bt_ctf_field_type *element_type);
 
+/*
+ * Returns 0 if the first fields of the structure field type `type` have
+ * the same names and types as all the fields of the structure field
+ * type `prefix_type`, and 1 otherwise.
+ */
+BT_HIDDEN
+int bt_ctf_field_type_structure_compare_prefix(
+		struct bt_ctf_field_type *prefix_type,
+		struct bt_ctf_field_type *type);
+
 BT_HIDDEN
 int64_t bt_ctf_field_type_get_field_count(struct bt_ctf_field_type *type);
 
@@ -72,6 +72,9 @@ struct bt_ctf_field_variant {
 	struct bt_ctf_field parent;
 	struct bt_ctf_field *tag;
 	struct bt_ctf_field *payload;
+
+	/* Value of the tag when the current payload was selected */
+	int64_t tag_value;
 };
 
 struct bt_ctf_field_array {
@@ -98,6 +101,31 @@ int bt_ctf_field_validate(struct bt_ctf_field *field);
 BT_HIDDEN
 int bt_ctf_field_reset(struct bt_ctf_field *field);
 
+/*
+ * Resets and unfreezes a field so that its owner can fill it again.
+ *
+ * Subfields which are also owned by something else are released
+ * instead of being reset, so that they are not modified behind the
+ * back of their other owners: they are created again when needed.
+ *
+ * The caller must hold the only reference on the field.
+ */
+BT_HIDDEN
+void bt_ctf_field_reset_for_reuse(struct bt_ctf_field *field);
+
+/*
+ * Replaces the first fields of the structure field `field` with the
+ * fields of the structure field `base_field`, without copying them:
+ * both structure fields then share them.
+ *
+ * The type of `base_field` must be a prefix of the type of `field`
+ * (see bt_ctf_field_type_structure_compare_prefix()) and `field` must
+ * not be frozen.
+ */
+BT_HIDDEN
+void bt_ctf_field_structure_graft(struct bt_ctf_field *field,
+		struct bt_ctf_field *base_field);
+
 BT_HIDDEN
 int bt_ctf_field_serialize(struct bt_ctf_field *field,
 		struct bt_ctf_stream_pos *pos,
@@ -35,6 +35,8 @@
 #include <babeltrace/ctf-writer/serialize-internal.h>
 #include <babeltrace/babeltrace-internal.h>
 #include <glib.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 struct bt_port;
 struct bt_component;
@@ -79,6 +81,39 @@ struct bt_ctf_stream {
 	/* Array of pointers to bt_ctf_event for the current packet */
 	GPtrArray *events;
 	struct bt_ctf_stream_pos pos;
+
+	/*
+	 * True if the events are serialized to the current packet when
+	 * they are appended instead of being kept in `events` until the
+	 * packet is flushed.
+	 */
+	bool serialize_on_append;
+
+	/*
+	 * True if the current packet's header and context are
+	 * serialized. The packet context is serialized again at
+	 * `packet_context_pos` when the packet is flushed, and must then
+	 * end at `packet_payload_offset`.
+	 */
+	bool packet_is_open;
+	struct bt_ctf_stream_pos packet_context_pos;
+	int64_t packet_payload_offset;
+
+	/*
+	 * Number of events which are serialized to the current packet
+	 * and timestamps of its first and last ones (serialize-on-append
+	 * mode only).
+	 */
+	uint64_t packet_event_count;
+	uint64_t packet_timestamp_begin;
+	uint64_t packet_timestamp_end;
+
+	/*
+	 * Index file (`index/<stream file name>.idx`, in the LTTng
+	 * index format) to which an entry is appended for each flushed
+	 * packet, or -1 if the index could not be created.
+	 */
+	int index_fd;
 	unsigned int flushed_packet_count;
 	uint64_t discarded_events;
 	uint64_t size;
@@ -28,6 +28,7 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <limits.h>
 #include <babeltrace/compat/mman-internal.h>
 #include <sys/types.h>
@@ -40,6 +41,7 @@
 #include <babeltrace/common-internal.h>
 #include <babeltrace/mmap-align-internal.h>
 #include <babeltrace/types.h>
+#include <glib.h>
 
 #define PACKET_LEN_INCREMENT	(bt_common_get_page_size() * 8 * CHAR_BIT)
 
@@ -54,6 +56,20 @@ struct bt_ctf_stream_pos {
 	uint64_t packet_size;	/* current packet size, in bits */
 	int64_t offset;		/* offset from base, in bits. EOF for end of file. */
 	struct mmap_align *base_mma;/* mmap base address */
+
+	/* Packet allocation (writer only) */
+	uint64_t packet_len_increment;	/* initial size and growth step of a packet, in bits */
+	off_t prealloc_len;	/* minimal file space to preallocate at once, in bytes */
+	off_t prealloc_end;	/* end of the preallocated file space, in bytes */
+
+	/*
+	 * In buffered mode, the current packet is built in `buf`
+	 * instead of being mapped, and written to the file with a
+	 * single write when it is committed.
+	 */
+	bool buffered;
+	char *buf;		/* packet buffer (`buf_len` bytes, owned by this) */
+	size_t buf_len;
 };
 
 BT_HIDDEN
@@ -110,13 +126,24 @@ int bt_ctf_stream_pos_align(struct bt_ctf_stream_pos *pos, uint64_t bit_offset)
 		offset_align(pos->offset, bit_offset));
 }
 
+static inline
+char *bt_ctf_stream_pos_get_base_addr(struct bt_ctf_stream_pos *pos)
+{
+	if (pos->buf) {
+		return pos->buf + pos->mmap_base_offset;
+	}
+
+	return ((char *) mmap_align_addr(pos->base_mma)) +
+		pos->mmap_base_offset;
+}
+
 static inline
 char *bt_ctf_stream_pos_get_addr(struct bt_ctf_stream_pos *pos)
 {
 	/* Only makes sense to get the address after aligning on CHAR_BIT */
 	assert(!(pos->offset % CHAR_BIT));
-	return ((char *) mmap_align_addr(pos->base_mma)) +
-		pos->mmap_base_offset + (pos->offset / CHAR_BIT);
+	return bt_ctf_stream_pos_get_base_addr(pos) +
+		(pos->offset / CHAR_BIT);
 }
 
 static inline
@@ -138,17 +165,23 @@ int bt_ctf_stream_pos_init(struct bt_ctf_stream_pos *pos,
 		abort();
 	}
 
+	pos->packet_len_increment = PACKET_LEN_INCREMENT;
 	return 0;
 }
 
 static inline
 int bt_ctf_stream_pos_fini(struct bt_ctf_stream_pos *pos)
 {
+	g_free(pos->buf);
+	pos->buf = NULL;
+	pos->buf_len = 0;
+
 	if (pos->base_mma) {
 		int ret;
 
 		/* unmap old base */
 		ret = munmap_align(pos->base_mma);
+		pos->base_mma = NULL;
 		if (ret) {
 			return -1;
 		}
@@ -157,8 +190,47 @@ int bt_ctf_stream_pos_fini(struct bt_ctf_stream_pos *pos)
 	return 0;
 }
 
+/*
+ * Sets how the packets are allocated: a new packet has an initial
+ * size of `packet_len` bits and grows by the same amount, the file
+ * space is preallocated by extents of at least `prealloc_len` bytes,
+ * and the packets are built in memory when `buffered` is true. Takes
+ * effect at the next packet.
+ */
+static inline
+void bt_ctf_stream_pos_set_packet_allocation(struct bt_ctf_stream_pos *pos,
+		uint64_t packet_len, off_t prealloc_len, bool buffered)
+{
+	assert(packet_len > 0 && packet_len % CHAR_BIT == 0);
+	assert(prealloc_len >= 0);
+	pos->packet_len_increment = packet_len;
+	pos->prealloc_len = prealloc_len;
+	pos->buffered = buffered;
+}
+
+/*
+ * Moves to the next packet, which is allocated with the initial packet
+ * size. Returns a negative value if the packet cannot be allocated, in
+ * which case the position has no current packet and its packet size is
+ * 0, so that the next seek retries at the same offset.
+ */
 BT_HIDDEN
-void bt_ctf_stream_pos_packet_seek(struct bt_ctf_stream_pos *pos, size_t index,
+int bt_ctf_stream_pos_packet_seek(struct bt_ctf_stream_pos *pos, size_t index,
 	int whence);
 
+/*
+ * Grows the current packet by the packet size increment. Returns a
+ * negative value on error, in which case the position has no current
+ * packet.
+ */
+BT_HIDDEN
+int bt_ctf_stream_pos_increase_packet_size(struct bt_ctf_stream_pos *pos);
+
+/*
+ * Writes the current, complete packet to the file in buffered mode
+ * (the packet is already in the file otherwise).
+ */
+BT_HIDDEN
+int bt_ctf_stream_pos_packet_commit(struct bt_ctf_stream_pos *pos);
+
 #endif /* BABELTRACE_CTF_WRITER_SERIALIZE_INTERNAL_H */
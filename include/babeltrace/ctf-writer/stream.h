@@ -152,6 +152,72 @@ extern int bt_ctf_stream_set_packet_context(
  */
 extern int bt_ctf_stream_flush(struct bt_ctf_stream *stream);
 
+/*
+ * bt_ctf_stream_set_serialize_on_append: serialize events as soon as they
+ * are appended.
+ *
+ * By default, the events appended to a stream are kept until the next call
+ * to bt_ctf_stream_flush, which serializes them. When this mode is enabled,
+ * bt_ctf_stream_append_event serializes the event to the stream's current
+ * packet and releases the stream's reference to it right away, so that the
+ * memory used by a packet's events does not depend on the packet's length.
+ *
+ * The packet header and context are serialized when the first event of a
+ * packet is appended; bt_ctf_stream_flush serializes the packet context
+ * again, once its default attributes (end timestamp, content size, discarded
+ * events count, etc.) are set. The packet context must therefore keep the
+ * same serialized size until the packet is flushed, and changes to the
+ * packet header once the packet's first event is appended are ignored.
+ *
+ * When the current packet cannot grow to fit an appended event,
+ * bt_ctf_stream_append_event fails and the packet keeps the events which were
+ * appended before: the packet can be flushed and the event appended again to
+ * the next one. If the packet cannot be written anymore, its events are lost
+ * and counted as discarded in the next packet.
+ *
+ * This mode can only be changed when the stream's current packet is empty.
+ *
+ * @param stream Stream instance.
+ * @param serialize_on_append Non-zero to enable the mode, 0 to disable it.
+ *
+ * Returns 0 on success, a negative value on error.
+ */
+extern int bt_ctf_stream_set_serialize_on_append(struct bt_ctf_stream *stream,
+		int serialize_on_append);
+
+/*
+ * bt_ctf_stream_set_packet_allocation: set how a stream's packets are
+ * allocated.
+ *
+ * A new packet is allocated with an initial size of "packet_size" bytes,
+ * and grows by the same amount whenever an event does not fit in it. By
+ * default, this size is eight pages.
+ *
+ * The stream file's space is preallocated by extents of at least
+ * "preallocation_size" bytes, so that large packets or many small ones do
+ * not require a file system allocation each. The unused preallocated space
+ * is truncated when the stream is destroyed. By default, the space of one
+ * packet is preallocated at a time (0).
+ *
+ * By default, packets are written through a shared memory mapping of the
+ * stream file. When "buffered" is non-zero, packets are built in memory
+ * and written with a single write when they are flushed instead.
+ *
+ * The new allocation applies from the next packet. It can only be changed
+ * when the stream's current packet is empty.
+ *
+ * @param stream Stream instance.
+ * @param packet_size Initial size and growth step of a packet, in bytes.
+ * @param preallocation_size Minimal file space to preallocate at once,
+ *	in bytes.
+ * @param buffered Non-zero to build packets in memory.
+ *
+ * Returns 0 on success, a negative value on error.
+ */
+extern int bt_ctf_stream_set_packet_allocation(struct bt_ctf_stream *stream,
+		uint64_t packet_size, uint64_t preallocation_size,
+		int buffered);
+
 extern int bt_ctf_stream_is_writer(struct bt_ctf_stream *stream);
 
 /*
@@ -29,6 +29,8 @@
 
 #ifdef __FreeBSD__
 #include <machine/endian.h>
+/* Conversion interfaces (htobe16(), le16toh(), and so on). */
+#include <sys/endian.h>
 
 #elif defined(__sun__)
 #include <sys/byteorder.h>
@@ -64,6 +66,12 @@
 #define be32toh(x) BE_32(x)
 #define htobe64(x) BE_64(x)
 #define be64toh(x) BE_64(x)
+#define htole16(x) LE_16(x)
+#define le16toh(x) LE_16(x)
+#define htole32(x) LE_32(x)
+#define le32toh(x) LE_32(x)
+#define htole64(x) LE_64(x)
+#define le64toh(x) LE_64(x)
 
 #elif defined(__MINGW32__)
 #include <stdint.h>
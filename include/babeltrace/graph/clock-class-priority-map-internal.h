@@ -31,6 +31,7 @@
 #include <assert.h>
 #include <babeltrace/ctf-ir/clock-class.h>
 #include <babeltrace/object-internal.h>
+#include <babeltrace/object-pool-internal.h>
 #include <babeltrace/types.h>
 #include <glib.h>
 
@@ -47,6 +48,12 @@ struct bt_clock_class_priority_map {
 	struct bt_ctf_clock_class *highest_prio_cc;
 
 	bt_bool frozen;
+
+	/*
+	 * Released event notifications of pooled events which were
+	 * created with this map, ready to be reused.
+	 */
+	struct bt_object_pool event_notif_pool;
 };
 
 static inline
@@ -47,6 +47,11 @@ int bt_component_class_filter_set_notification_iterator_finalize_method(
 		struct bt_component_class *component_class,
 		bt_component_class_notification_iterator_finalize_method notification_iterator_finalize_method);
 
+extern
+int bt_component_class_filter_set_notification_iterator_next_batch_method(
+		struct bt_component_class *component_class,
+		bt_component_class_notification_iterator_next_batch_method notification_iterator_next_batch_method);
+
 extern
 int bt_component_class_filter_set_notification_iterator_seek_time_method(
 		struct bt_component_class *component_class,
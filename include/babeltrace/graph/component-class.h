@@ -76,6 +76,20 @@ typedef void (*bt_component_class_notification_iterator_finalize_method)(
 typedef struct bt_notification_iterator_next_return (*bt_component_class_notification_iterator_next_method)(
 		struct bt_private_notification_iterator *private_notification_iterator);
 
+/*
+ * Fills `notifications` with up to `capacity` notifications (new
+ * references) and sets `*count` to their number. The method can return
+ * BT_NOTIFICATION_ITERATOR_STATUS_END or
+ * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN with notifications: they are
+ * delivered before the status. With an error status, the returned
+ * notifications are discarded.
+ */
+typedef enum bt_notification_iterator_status
+		(*bt_component_class_notification_iterator_next_batch_method)(
+		struct bt_private_notification_iterator *private_notification_iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count);
+
 typedef enum bt_notification_iterator_status
 		(*bt_component_class_notification_iterator_seek_time_method)(
 		struct bt_private_notification_iterator *private_notification_iterator,
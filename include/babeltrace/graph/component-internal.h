@@ -65,6 +65,12 @@ struct bt_component {
 	/* Array of struct bt_component_destroy_listener */
 	GArray *destroy_listeners;
 
+	/*
+	 * File descriptor which becomes readable when the component can
+	 * make progress after returning AGAIN, or -1.
+	 */
+	int poll_fd;
+
 	bool initialized;
 };
 
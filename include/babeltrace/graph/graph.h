@@ -29,6 +29,7 @@
 
 #include <babeltrace/graph/component.h>
 #include <babeltrace/types.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -105,6 +106,19 @@ extern enum bt_graph_status bt_graph_run(struct bt_graph *graph);
  */
 extern enum bt_graph_status bt_graph_consume(struct bt_graph *graph);
 
+/**
+ * Waits until one of the graph's components which set a poll file
+ * descriptor can make progress, or until "timeout_us" microseconds have
+ * elapsed (forever if negative). Meant to be called when
+ * bt_graph_run() returns BT_GRAPH_STATUS_AGAIN, instead of sleeping.
+ *
+ * Returns BT_GRAPH_STATUS_OK when a component is ready,
+ * BT_GRAPH_STATUS_AGAIN on timeout, and BT_GRAPH_STATUS_CANCELED if the
+ * graph is canceled, including while waiting (by a signal).
+ */
+extern enum bt_graph_status bt_graph_wait(struct bt_graph *graph,
+		int64_t timeout_us);
+
 extern int bt_graph_add_port_added_listener(struct bt_graph *graph,
 		bt_graph_port_added_listener listener, void *data);
 
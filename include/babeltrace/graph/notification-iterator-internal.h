@@ -29,13 +29,16 @@
 #include <babeltrace/babeltrace-internal.h>
 #include <babeltrace/object-internal.h>
 #include <babeltrace/ref-internal.h>
+#include <babeltrace/graph/component-class.h>
 #include <babeltrace/graph/connection.h>
 #include <babeltrace/graph/notification.h>
 #include <babeltrace/graph/notification-iterator.h>
 #include <babeltrace/graph/private-notification-iterator.h>
 #include <babeltrace/types.h>
+#include <pthread.h>
 
 struct bt_port;
+struct stream_state;
 
 enum bt_notification_iterator_notif_type {
 	BT_NOTIFICATION_ITERATOR_NOTIF_TYPE_EVENT =		(1U << 0),
@@ -98,6 +101,30 @@ struct bt_notification_iterator {
 	 */
 	GHashTable *stream_states;
 
+	/*
+	 * Streams (weak) of ended stream states which were destroyed
+	 * since the last time this iterator removed their states from
+	 * stream_states above. The last reference of a stream can be
+	 * put by another thread than the one which uses this iterator
+	 * (a notification consumer on another thread), so its destroy
+	 * listener only records it here, protected by
+	 * destroyed_streams_lock, and the iterator removes the
+	 * corresponding states itself before it uses stream_states.
+	 */
+	GPtrArray *destroyed_streams;
+	pthread_mutex_t destroyed_streams_lock;
+
+	/* True if destroyed_streams above is not empty (atomic access) */
+	bool has_destroyed_streams;
+
+	/*
+	 * Stream state (weak, in stream_states above) of the last event
+	 * notification which this iterator validated, or NULL. An event
+	 * notification of this stream state's current packet needs no
+	 * validation: it is queued directly.
+	 */
+	struct stream_state *last_event_stream_state;
+
 	/*
 	 * This is an array of actions which can be rolled back. It's
 	 * similar to the memento pattern, but it's not exactly that. It
@@ -113,6 +140,13 @@ struct bt_notification_iterator {
 	 */
 	uint32_t subscription_mask;
 
+	/*
+	 * Upstream component class's "next" and optional "next batch"
+	 * methods (the component class is frozen).
+	 */
+	bt_component_class_notification_iterator_next_method next_method;
+	bt_component_class_notification_iterator_next_batch_method next_batch_method;
+
 	enum bt_notification_iterator_state state;
 	void *user_data;
 };
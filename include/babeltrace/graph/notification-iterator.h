@@ -108,6 +108,33 @@ extern struct bt_notification *bt_notification_iterator_get_notification(
 extern enum bt_notification_iterator_status
 bt_notification_iterator_next(struct bt_notification_iterator *iterator);
 
+/**
+ * Advance the iterator's position forward by up to \p capacity
+ * notifications at once.
+ *
+ * On success, \p notifications contains \p *count (at least one)
+ * notifications of which the ownership is transferred to the caller,
+ * and the iterator's current notification is the last one. Otherwise,
+ * \p *count is 0.
+ *
+ * Prefer this function to bt_notification_iterator_next() to consume
+ * many notifications: it amortizes the cost of the iteration over the
+ * whole batch.
+ *
+ * @param iterator	Iterator instance
+ * @param notifications	Array of at least \p capacity notifications
+ *			to fill
+ * @param capacity	Maximum number of notifications to get
+ * @param count		Number of notifications put in \p notifications
+ * @returns		One of #bt_notification_iterator_status values
+ *
+ * @see bt_notification_iterator_next()
+ */
+extern enum bt_notification_iterator_status
+bt_notification_iterator_next_batch(struct bt_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count);
+
 /**
  * Seek iterator to time.
  *
@@ -117,6 +144,16 @@ bt_notification_iterator_next(struct bt_notification_iterator *iterator);
  *
  * time is expressed in nanoseconds.
  *
+ * Only #BT_NOTIFICATION_ITERATOR_SEEK_ORIGIN_EPOCH is currently
+ * supported. On success, the notifications which were queued by the
+ * iterator are discarded, as well as its current notification, and
+ * the next call to bt_notification_iterator_next() returns the first
+ * notification at or after \p time. Since the iterator forgets the
+ * states of the streams it was tracking, "stream begin" and "packet
+ * begin" notifications are emitted again for the streams and packets
+ * which are active at the new position. An ended iterator becomes
+ * active again after a successful seek.
+ *
  * @param iterator	Iterator instance
  * @param seek_origin	One of #bt_notification_iterator_seek_type values.
  * @returns		One of #bt_notification_iterator_status values;
@@ -41,6 +41,9 @@ extern enum bt_component_status bt_private_component_set_user_data(
 		struct bt_private_component *private_component,
 		void *user_data);
 
+extern enum bt_component_status bt_private_component_set_poll_fd(
+		struct bt_private_component *private_component, int fd);
+
 #ifdef __cplusplus
 }
 #endif
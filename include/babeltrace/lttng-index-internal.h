@@ -22,9 +22,10 @@
  * SOFTWARE.
  */
 
-#ifndef LTTNG_INDEX_H
-#define LTTNG_INDEX_H
+#ifndef BABELTRACE_LTTNG_INDEX_INTERNAL_H
+#define BABELTRACE_LTTNG_INDEX_INTERNAL_H
 
+#include <stdint.h>
 #include <babeltrace/compat/limits-internal.h>
 
 #define CTF_INDEX_MAGIC 0xC1F1DCC1
@@ -60,4 +61,4 @@ struct ctf_packet_index {
 	uint64_t packet_seq_num;	/* packet sequence number */
 } __attribute__((__packed__));
 
-#endif /* LTTNG_INDEX_H */
+#endif /* BABELTRACE_LTTNG_INDEX_INTERNAL_H */
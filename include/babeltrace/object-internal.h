@@ -51,7 +51,7 @@ long bt_object_get_ref_count(const void *ptr)
 {
 	const struct bt_object *obj = ptr;
 
-	return obj->ref_count.count;
+	return bt_ref_get_count(&obj->ref_count);
 }
 
 static inline
@@ -61,7 +61,7 @@ void bt_object_release(void *ptr)
 
 #ifdef BT_LOGV
 	BT_LOGV("Releasing object: addr=%p, ref-count=%lu", ptr,
-		obj->ref_count.count);
+		bt_ref_get_count(&obj->ref_count));
 #endif
 
 	if (obj && obj->release && bt_object_get_ref_count(obj) == 0) {
@@ -78,8 +78,8 @@ void generic_release(struct bt_object *obj)
 #ifdef BT_LOGV
 		BT_LOGV("Releasing parented object: addr=%p, ref-count=%lu, "
 			"parent-addr=%p, parent-ref-count=%lu",
-			obj, obj->ref_count.count,
-			parent, parent->ref_count.count);
+			obj, bt_ref_get_count(&obj->ref_count),
+			parent, bt_ref_get_count(&parent->ref_count));
 #endif
 
 		if (obj->parent_is_owner_listener) {
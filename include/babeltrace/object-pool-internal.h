@@ -0,0 +1,174 @@
+#ifndef BABELTRACE_OBJECT_POOL_INTERNAL_H
+#define BABELTRACE_OBJECT_POOL_INTERNAL_H
+
+/*
+ * Babeltrace - Object pool
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * An object pool is a free list of released objects of the same kind
+ * which are kept around to be recycled instead of being freed.
+ *
+ * The owner of a pool (for example, an event class for its events)
+ * calls bt_object_pool_get_object() to reuse a released object, and
+ * recycles an object with bt_object_pool_recycle_object() from the
+ * object's release function, once the object is reset.
+ *
+ * An object in a pool must not hold a reference on the pool's owner,
+ * otherwise the owner could never be destroyed: the object's release
+ * function must put it after recycling the object. The owner destroys
+ * the remaining objects with bt_object_pool_finalize() when it is
+ * destroyed itself.
+ *
+ * A pool is protected by a mutex because the objects of a single pool
+ * can be created and released by different threads, for example when
+ * a notification which a worker thread creates is released by the
+ * thread which consumes it.
+ */
+
+#include <babeltrace/babeltrace-internal.h>
+#include <babeltrace/object-internal.h>
+#include <glib.h>
+#include <pthread.h>
+
+typedef void (*bt_object_pool_destroy_object_func)(void *obj);
+
+struct bt_object_pool {
+	/* Array of recycled objects (owned by this) */
+	GPtrArray *objects;
+
+	/* Destroys an object when finalizing the pool */
+	bt_object_pool_destroy_object_func destroy_object;
+
+	/* Protects objects above */
+	pthread_mutex_t lock;
+};
+
+static inline
+int bt_object_pool_initialize(struct bt_object_pool *pool,
+		bt_object_pool_destroy_object_func destroy_object)
+{
+	int ret = 0;
+
+	assert(pool);
+	assert(destroy_object);
+	pool->objects = g_ptr_array_new();
+	if (!pool->objects) {
+		ret = -1;
+		goto end;
+	}
+
+	pool->destroy_object = destroy_object;
+	ret = pthread_mutex_init(&pool->lock, NULL);
+	if (ret) {
+		g_ptr_array_free(pool->objects, TRUE);
+		pool->objects = NULL;
+		ret = -1;
+		goto end;
+	}
+
+end:
+	return ret;
+}
+
+static inline
+void bt_object_pool_finalize(struct bt_object_pool *pool)
+{
+	guint i;
+
+	assert(pool);
+
+	if (!pool->objects) {
+		return;
+	}
+
+	for (i = 0; i < pool->objects->len; i++) {
+		pool->destroy_object(pool->objects->pdata[i]);
+	}
+
+	g_ptr_array_free(pool->objects, TRUE);
+	pool->objects = NULL;
+	(void) pthread_mutex_destroy(&pool->lock);
+}
+
+/*
+ * Returns a recycled object from the pool, or NULL if the pool is
+ * empty. The returned object's reference count is reset to 1.
+ */
+static inline
+void *bt_object_pool_get_object(struct bt_object_pool *pool)
+{
+	struct bt_object *obj = NULL;
+
+	assert(pool);
+
+	if (unlikely(!pool->objects)) {
+		goto end;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+
+	if (unlikely(pool->objects->len == 0)) {
+		pthread_mutex_unlock(&pool->lock);
+		goto end;
+	}
+
+	obj = pool->objects->pdata[pool->objects->len - 1];
+	g_ptr_array_set_size(pool->objects, pool->objects->len - 1);
+	pthread_mutex_unlock(&pool->lock);
+	assert(bt_object_get_ref_count(obj) == 0);
+	bt_ref_init(&obj->ref_count, obj->ref_count.release);
+
+end:
+	return obj;
+}
+
+/*
+ * Adds a released object, which must not have a parent, to the pool.
+ * Returns 0 if the object was recycled, or a negative value if it
+ * could not be added, in which case the caller must destroy it.
+ */
+static inline
+int bt_object_pool_recycle_object(struct bt_object_pool *pool, void *ptr)
+{
+	struct bt_object *obj = ptr;
+	int ret = 0;
+
+	assert(pool);
+	assert(obj);
+	assert(!obj->parent);
+
+	if (unlikely(!pool->objects)) {
+		ret = -1;
+		goto end;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	g_ptr_array_add(pool->objects, obj);
+	pthread_mutex_unlock(&pool->lock);
+
+end:
+	return ret;
+}
+
+#endif /* BABELTRACE_OBJECT_POOL_INTERNAL_H */
@@ -173,6 +173,7 @@ enum __bt_plugin_component_class_descriptor_attribute_type {
 	BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_INIT_METHOD		= 9,
 	BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_FINALIZE_METHOD		= 10,
 	BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_SEEK_TIME_METHOD		= 11,
+	BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_NEXT_BATCH_METHOD	= 12,
 };
 
 /* Component class attribute (internal use) */
@@ -223,6 +224,9 @@ struct __bt_plugin_component_class_descriptor_attribute {
 
 		/* BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_SEEK_TIME_METHOD */
 		bt_component_class_notification_iterator_seek_time_method notif_iter_seek_time_method;
+
+		/* BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_NEXT_BATCH_METHOD */
+		bt_component_class_notification_iterator_next_batch_method notif_iter_next_batch_method;
 	} value;
 } __attribute__((packed));
 
@@ -751,6 +755,18 @@ struct __bt_plugin_component_class_descriptor_attribute {
 #define BT_PLUGIN_SOURCE_COMPONENT_CLASS_NOTIFICATION_ITERATOR_FINALIZE_METHOD_WITH_ID(_id, _comp_class_id, _x) \
 	__BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE(notif_iter_finalize_method, BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_FINALIZE_METHOD, _id, _comp_class_id, source, _x)
 
+/*
+ * Defines an iterator next batch method attribute attached to a
+ * specific source component class descriptor.
+ *
+ * _id:            Plugin descriptor ID (C identifier).
+ * _comp_class_id: Component class descriptor ID (C identifier).
+ * _x:             Iterator next batch method
+ *                 (bt_component_class_notification_iterator_next_batch_method).
+ */
+#define BT_PLUGIN_SOURCE_COMPONENT_CLASS_NOTIFICATION_ITERATOR_NEXT_BATCH_METHOD_WITH_ID(_id, _comp_class_id, _x) \
+	__BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE(notif_iter_next_batch_method, BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_NEXT_BATCH_METHOD, _id, _comp_class_id, source, _x)
+
 /*
  * Defines an iterator seek time method attribute attached to a specific
  * source component class descriptor.
@@ -787,6 +803,18 @@ struct __bt_plugin_component_class_descriptor_attribute {
 #define BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_FINALIZE_METHOD_WITH_ID(_id, _comp_class_id, _x) \
 	__BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE(notif_iter_finalize_method, BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_FINALIZE_METHOD, _id, _comp_class_id, filter, _x)
 
+/*
+ * Defines an iterator next batch method attribute attached to a
+ * specific filter component class descriptor.
+ *
+ * _id:            Plugin descriptor ID (C identifier).
+ * _comp_class_id: Component class descriptor ID (C identifier).
+ * _x:             Iterator next batch method
+ *                 (bt_component_class_notification_iterator_next_batch_method).
+ */
+#define BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_NEXT_BATCH_METHOD_WITH_ID(_id, _comp_class_id, _x) \
+	__BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE(notif_iter_next_batch_method, BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_NEXT_BATCH_METHOD, _id, _comp_class_id, filter, _x)
+
 /*
  * Defines an iterator seek time method attribute attached to a specific
  * filter component class descriptor.
@@ -1177,6 +1205,18 @@ struct __bt_plugin_component_class_descriptor_attribute {
 #define BT_PLUGIN_SOURCE_COMPONENT_CLASS_NOTIFICATION_ITERATOR_FINALIZE_METHOD(_name, _x) \
 	BT_PLUGIN_SOURCE_COMPONENT_CLASS_NOTIFICATION_ITERATOR_FINALIZE_METHOD_WITH_ID(auto, _name, _x)
 
+/*
+ * Defines an iterator next batch method attribute attached to a source
+ * component class descriptor which is attached to the automatic plugin
+ * descriptor.
+ *
+ * _name: Component class name (C identifier).
+ * _x:    Iterator next batch method
+ *        (bt_component_class_notification_iterator_next_batch_method).
+ */
+#define BT_PLUGIN_SOURCE_COMPONENT_CLASS_NOTIFICATION_ITERATOR_NEXT_BATCH_METHOD(_name, _x) \
+	BT_PLUGIN_SOURCE_COMPONENT_CLASS_NOTIFICATION_ITERATOR_NEXT_BATCH_METHOD_WITH_ID(auto, _name, _x)
+
 /*
  * Defines an iterator seek time method attribute attached to a source
  * component class descriptor which is attached to the automatic plugin
@@ -1213,6 +1253,18 @@ struct __bt_plugin_component_class_descriptor_attribute {
 #define BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_FINALIZE_METHOD(_name, _x) \
 	BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_FINALIZE_METHOD_WITH_ID(auto, _name, _x)
 
+/*
+ * Defines an iterator next batch method attribute attached to a filter
+ * component class descriptor which is attached to the automatic plugin
+ * descriptor.
+ *
+ * _name: Component class name (C identifier).
+ * _x:    Iterator next batch method
+ *        (bt_component_class_notification_iterator_next_batch_method).
+ */
+#define BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_NEXT_BATCH_METHOD(_name, _x) \
+	BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_NEXT_BATCH_METHOD_WITH_ID(auto, _name, _x)
+
 /*
  * Defines an iterator seek time method attribute attached to a filter
  * component class descriptor which is attached to the automatic plugin
@@ -33,6 +33,13 @@
 struct bt_object;
 typedef void (*bt_object_release_func)(struct bt_object *);
 
+/*
+ * The reference count is updated atomically so that objects can be
+ * shared between threads, for example notifications which a worker
+ * thread creates and which another thread consumes, as well as the
+ * metadata objects (event classes, clock classes, and the rest) which
+ * those notifications reference.
+ */
 struct bt_ref {
 	unsigned long count;
 	bt_object_release_func release;
@@ -42,30 +49,54 @@ static inline
 void bt_ref_init(struct bt_ref *ref, bt_object_release_func release)
 {
 	assert(ref);
-	ref->count = 1;
+	__atomic_store_n(&ref->count, 1, __ATOMIC_RELAXED);
 	ref->release = release;
 }
 
 static inline
-void bt_ref_get(struct bt_ref *ref)
+unsigned long bt_ref_get_count(const struct bt_ref *ref)
+{
+	assert(ref);
+	return __atomic_load_n(&ref->count, __ATOMIC_RELAXED);
+}
+
+/*
+ * Returns the reference count before the increment.
+ */
+static inline
+unsigned long bt_ref_get(struct bt_ref *ref)
 {
+	unsigned long old_count;
+
 	assert(ref);
 
 	if (unlikely(!ref->release)) {
-		return;
+		return 0;
 	}
 
-	ref->count++;
+	/*
+	 * A relaxed increment is enough: the caller already owns a
+	 * reference, or the object's parent does.
+	 */
+	old_count = __atomic_fetch_add(&ref->count, 1, __ATOMIC_RELAXED);
+
 	/* Overflow check. */
-	assert(ref->count);
+	assert(old_count + 1);
+	return old_count;
 }
 
 static inline
 void bt_ref_put(struct bt_ref *ref)
 {
 	assert(ref);
-	/* Only assert if the object has opted-in for reference counting. */
-	if (unlikely((--ref->count) == 0 && ref->release)) {
+
+	/*
+	 * The release ordering makes this thread's modifications of
+	 * the object visible to the thread which releases it, and the
+	 * acquire ordering makes the releasing thread see all of them.
+	 */
+	if (unlikely(__atomic_sub_fetch(&ref->count, 1,
+			__ATOMIC_ACQ_REL) == 0 && ref->release)) {
 		ref->release((struct bt_object *) ref);
 	}
 }
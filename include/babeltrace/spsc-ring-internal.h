@@ -0,0 +1,172 @@
+#ifndef BABELTRACE_SPSC_RING_INTERNAL_H
+#define BABELTRACE_SPSC_RING_INTERNAL_H
+
+/*
+ * Babeltrace - Bounded single-producer, single-consumer ring
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * A ring of pointers with a fixed capacity which one thread (the
+ * producer) pushes to and another thread (the consumer) pops from
+ * without any lock.
+ *
+ * Only the producer modifies `tail` and only the consumer modifies
+ * `head`: each one publishes its index with a release store and reads
+ * the other one's index with an acquire load, so that the slots which
+ * are written before pushing are visible when they are popped.
+ */
+
+#include <babeltrace/babeltrace-internal.h>
+#include <glib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#define BT_SPSC_RING_CACHE_LINE_SIZE	64
+
+struct bt_spsc_ring {
+	/* Array of `mask + 1` slots (owned by this) */
+	void **slots;
+	uint64_t mask;
+
+	/* Index of the next slot to pop (modified by the consumer) */
+	uint64_t head __attribute__((aligned(BT_SPSC_RING_CACHE_LINE_SIZE)));
+
+	/* Index of the next slot to push (modified by the producer) */
+	uint64_t tail __attribute__((aligned(BT_SPSC_RING_CACHE_LINE_SIZE)));
+};
+
+/*
+ * Initializes `ring` with at least `capacity` slots (the capacity is
+ * rounded up to a power of two).
+ */
+static inline
+int bt_spsc_ring_init(struct bt_spsc_ring *ring, uint64_t capacity)
+{
+	uint64_t real_capacity = 1;
+	int ret = 0;
+
+	assert(ring);
+	assert(capacity > 0);
+
+	while (real_capacity < capacity) {
+		real_capacity <<= 1;
+	}
+
+	ring->slots = g_new0(void *, real_capacity);
+	if (!ring->slots) {
+		ret = -1;
+		goto end;
+	}
+
+	ring->mask = real_capacity - 1;
+	ring->head = 0;
+	ring->tail = 0;
+
+end:
+	return ret;
+}
+
+static inline
+void bt_spsc_ring_fini(struct bt_spsc_ring *ring)
+{
+	assert(ring);
+	g_free(ring->slots);
+	ring->slots = NULL;
+}
+
+/*
+ * Returns the number of free slots. Only the producer can rely on this
+ * value: it can only grow until the producer pushes.
+ */
+static inline
+uint64_t bt_spsc_ring_free_count(struct bt_spsc_ring *ring)
+{
+	uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	return ring->mask + 1 - (ring->tail - head);
+}
+
+/*
+ * Returns true if the ring is full. Only the consumer can rely on this
+ * value: the ring can only become full when the producer pushes.
+ */
+static inline
+bool bt_spsc_ring_is_full(struct bt_spsc_ring *ring)
+{
+	uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+	return tail - ring->head == ring->mask + 1;
+}
+
+/*
+ * Returns true if the ring is empty, from any thread's point of view.
+ */
+static inline
+bool bt_spsc_ring_is_empty(struct bt_spsc_ring *ring)
+{
+	return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) ==
+		__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Pushes `ptr`, which must not be NULL, to the ring (producer only).
+ * Returns false if the ring is full.
+ */
+static inline
+bool bt_spsc_ring_push(struct bt_spsc_ring *ring, void *ptr)
+{
+	uint64_t tail = ring->tail;
+
+	assert(ptr);
+
+	if (unlikely(tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) ==
+			ring->mask + 1)) {
+		return false;
+	}
+
+	ring->slots[tail & ring->mask] = ptr;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+/*
+ * Pops the oldest pointer of the ring (consumer only). Returns NULL if
+ * the ring is empty.
+ */
+static inline
+void *bt_spsc_ring_pop(struct bt_spsc_ring *ring)
+{
+	uint64_t head = ring->head;
+	void *ptr;
+
+	if (unlikely(head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE))) {
+		return NULL;
+	}
+
+	ptr = ring->slots[head & ring->mask];
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return ptr;
+}
+
+#endif /* BABELTRACE_SPSC_RING_INTERNAL_H */
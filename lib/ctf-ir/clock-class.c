@@ -37,6 +37,7 @@
 #include <babeltrace/types.h>
 #include <babeltrace/compat/string-internal.h>
 #include <inttypes.h>
+#include <stdint.h>
 #include <babeltrace/object-internal.h>
 
 static
@@ -92,6 +93,85 @@ end:
 	return ret;
 }
 
+/*
+ * Converts `value` cycles of `clock_class` to nanoseconds, rounding
+ * down, without floating point operations.
+ */
+static inline
+uint64_t ns_from_value(struct bt_ctf_clock_class *clock_class, uint64_t value)
+{
+	const uint64_t frequency = clock_class->frequency;
+
+	if (likely(frequency == NS_PER_S)) {
+		return value;
+	}
+
+	if (unlikely(frequency == 0)) {
+		return 0;
+	}
+
+#ifdef __SIZEOF_INT128__
+	{
+		const unsigned __int128 exact_num =
+			(unsigned __int128) value * NS_PER_S;
+		unsigned __int128 ns = (unsigned __int128) value *
+			clock_class->ns_per_cycle_int +
+			(((unsigned __int128) value *
+				clock_class->ns_per_cycle_frac) >> 64);
+
+		/*
+		 * The fractional part of the multiplier is truncated, so
+		 * that `ns` can be one less than the exact result.
+		 */
+		if ((ns + 1) * frequency <= exact_num) {
+			ns++;
+		}
+
+		return (uint64_t) ns;
+	}
+#else
+	if (frequency <= UINT64_MAX / NS_PER_S) {
+		/* The remainder, times 10^9, fits in 64 bits */
+		return (value / frequency) * NS_PER_S +
+			((value % frequency) * NS_PER_S) / frequency;
+	}
+
+	return (uint64_t) ((1e9 * (double) value) / (double) frequency);
+#endif /* __SIZEOF_INT128__ */
+}
+
+/*
+ * Updates the precomputed cycles to nanoseconds conversion factors and
+ * offset of `clock_class` after its frequency or offset changed.
+ */
+static
+void update_ns_conversion(struct bt_ctf_clock_class *clock_class)
+{
+	const uint64_t frequency = clock_class->frequency;
+
+	clock_class->ns_per_cycle_int = 0;
+	clock_class->ns_per_cycle_frac = 0;
+
+	if (frequency != 0) {
+		clock_class->ns_per_cycle_int = NS_PER_S / frequency;
+#ifdef __SIZEOF_INT128__
+		clock_class->ns_per_cycle_frac = (uint64_t)
+			(((unsigned __int128) (NS_PER_S % frequency) << 64) /
+				frequency);
+#endif
+	}
+
+	clock_class->offset_ns = clock_class->offset_s * (int64_t) NS_PER_S;
+
+	if (clock_class->offset >= 0) {
+		clock_class->offset_ns += (int64_t) ns_from_value(clock_class,
+			(uint64_t) clock_class->offset);
+	} else {
+		clock_class->offset_ns -= (int64_t) ns_from_value(clock_class,
+			-(uint64_t) clock_class->offset);
+	}
+}
+
 struct bt_ctf_clock_class *bt_ctf_clock_class_create(const char *name)
 {
 	int ret;
@@ -106,8 +186,14 @@ struct bt_ctf_clock_class *bt_ctf_clock_class_create(const char *name)
 	}
 
 	clock_class->precision = 1;
-	clock_class->frequency = 1000000000;
+	clock_class->frequency = NS_PER_S;
+	update_ns_conversion(clock_class);
 	bt_object_init(clock_class, bt_ctf_clock_class_destroy);
+	ret = bt_object_pool_initialize(&clock_class->value_pool, g_free);
+	if (ret) {
+		BT_LOGE_STR("Failed to initialize clock value pool.");
+		goto error;
+	}
 
 	if (name) {
 		ret = bt_ctf_clock_class_set_name(clock_class, name);
@@ -228,6 +314,7 @@ int bt_ctf_clock_class_set_frequency(struct bt_ctf_clock_class *clock_class,
 	}
 
 	clock_class->frequency = freq;
+	update_ns_conversion(clock_class);
 	BT_LOGV("Set clock class's frequency: addr=%p, name=\"%s\", freq=%" PRIu64,
 		clock_class, bt_ctf_clock_class_get_name(clock_class), freq);
 end:
@@ -315,6 +402,7 @@ int bt_ctf_clock_class_set_offset_s(struct bt_ctf_clock_class *clock_class,
 	}
 
 	clock_class->offset_s = offset_s;
+	update_ns_conversion(clock_class);
 	BT_LOGV("Set clock class's offset (seconds): "
 		"addr=%p, name=\"%s\", offset-s=%" PRId64,
 		clock_class, bt_ctf_clock_class_get_name(clock_class),
@@ -361,6 +449,7 @@ int bt_ctf_clock_class_set_offset_cycles(struct bt_ctf_clock_class *clock_class,
 	}
 
 	clock_class->offset = offset;
+	update_ns_conversion(clock_class);
 	BT_LOGV("Set clock class's offset (cycles): addr=%p, name=\"%s\", offset-cycles=%" PRId64,
 		clock_class, bt_ctf_clock_class_get_name(clock_class), offset);
 end:
@@ -476,19 +565,6 @@ end:
 	return ret;
 }
 
-static uint64_t ns_from_value(uint64_t frequency, uint64_t value)
-{
-	uint64_t ns;
-
-	if (frequency == 1000000000) {
-		ns = value;
-	} else {
-		ns = (uint64_t) ((1e9 * (double) value) / (double) frequency);
-	}
-
-	return ns;
-}
-
 BT_HIDDEN
 void bt_ctf_clock_class_freeze(struct bt_ctf_clock_class *clock_class)
 {
@@ -565,24 +641,40 @@ void bt_ctf_clock_class_destroy(struct bt_object *obj)
 		g_string_free(clock_class->description, TRUE);
 	}
 
+	bt_object_pool_finalize(&clock_class->value_pool);
 	g_free(clock_class);
 }
 
+/*
+ * A clock value holds no other object than its class: a released
+ * clock value goes back to its class's pool, to be reused by
+ * bt_ctf_clock_value_create(), instead of being freed.
+ */
 static
-void bt_ctf_clock_value_destroy(struct bt_object *obj)
+void bt_ctf_clock_value_release(struct bt_object *obj)
 {
 	struct bt_ctf_clock_value *value;
+	struct bt_ctf_clock_class *clock_class;
 
 	if (!obj) {
 		return;
 	}
 
 	value = container_of(obj, struct bt_ctf_clock_value, base);
-	BT_LOGD("Destroying clock value: addr=%p, clock-class-addr=%p, "
-		"clock-class-name=\"%s\"", obj, value->clock_class,
-		bt_ctf_clock_class_get_name(value->clock_class));
-	bt_put(value->clock_class);
-	g_free(value);
+	clock_class = value->clock_class;
+	BT_LOGV("Recycling clock value: addr=%p, clock-class-addr=%p, "
+		"clock-class-name=\"%s\"", obj, clock_class,
+		bt_ctf_clock_class_get_name(clock_class));
+
+	if (bt_object_pool_recycle_object(&clock_class->value_pool, value)) {
+		g_free(value);
+	}
+
+	/*
+	 * Put the class last: this could destroy it, and its pool
+	 * with this clock value.
+	 */
+	bt_put(clock_class);
 }
 
 struct bt_ctf_clock_value *bt_ctf_clock_value_create(
@@ -599,13 +691,17 @@ struct bt_ctf_clock_value *bt_ctf_clock_value_create(
 		goto end;
 	}
 
-	ret = g_new0(struct bt_ctf_clock_value, 1);
+	ret = bt_object_pool_get_object(&clock_class->value_pool);
 	if (!ret) {
-		BT_LOGE_STR("Failed to allocate one clock value.");
-		goto end;
+		ret = g_new0(struct bt_ctf_clock_value, 1);
+		if (!ret) {
+			BT_LOGE_STR("Failed to allocate one clock value.");
+			goto end;
+		}
+
+		bt_object_init(ret, bt_ctf_clock_value_release);
 	}
 
-	bt_object_init(ret, bt_ctf_clock_value_destroy);
 	ret->clock_class = bt_get(clock_class);
 	ret->value = value;
 	BT_LOGD("Created clock value object: clock-value-addr=%p, "
@@ -647,15 +743,11 @@ int bt_ctf_clock_value_get_value_ns_from_epoch(struct bt_ctf_clock_value *value,
 		goto end;
 	}
 
-	/* Initialize nanosecond timestamp to clock's offset in seconds. */
-	ns = value->clock_class->offset_s * (int64_t) 1000000000;
-
-	/* Add offset in cycles, converted to nanoseconds. */
-	ns += ns_from_value(value->clock_class->frequency,
-			value->clock_class->offset);
+	/* Clock's offset (seconds and cycles), converted to nanoseconds. */
+	ns = value->clock_class->offset_ns;
 
-	/* Add given value, converter to nanoseconds. */
-	ns += ns_from_value(value->clock_class->frequency, value->value);
+	/* Add given value, converted to nanoseconds. */
+	ns += ns_from_value(value->clock_class, value->value);
 
 	*ret_value_ns = ns;
 end:
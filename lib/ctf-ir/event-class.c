@@ -33,6 +33,7 @@
 #include <babeltrace/ctf-ir/field-types-internal.h>
 #include <babeltrace/ctf-ir/event-class.h>
 #include <babeltrace/ctf-ir/event-class-internal.h>
+#include <babeltrace/ctf-ir/event-internal.h>
 #include <babeltrace/ctf-ir/stream-class.h>
 #include <babeltrace/ctf-ir/stream-class-internal.h>
 #include <babeltrace/ctf-ir/trace-internal.h>
@@ -67,6 +68,13 @@ struct bt_ctf_event_class *bt_ctf_event_class_create(const char *name)
 
 	event_class->id = -1;
 	bt_object_init(event_class, bt_ctf_event_class_destroy);
+	ret = bt_object_pool_initialize(&event_class->event_pool,
+		bt_ctf_event_destroy_recycled);
+	if (ret) {
+		BT_LOGE_STR("Failed to initialize event pool.");
+		goto error;
+	}
+
 	event_class->fields = bt_ctf_field_type_structure_create();
 	if (!event_class->fields) {
 		BT_LOGE_STR("Cannot create event class's initial payload field type object.");
@@ -776,6 +784,13 @@ void bt_ctf_event_class_destroy(struct bt_object *obj)
 	BT_LOGD("Destroying event class: addr=%p, name=\"%s\", id=%" PRId64,
 		event_class, bt_ctf_event_class_get_name(event_class),
 		bt_ctf_event_class_get_id(event_class));
+	BT_LOGD_STR("Destroying event class's pooled events.");
+	bt_object_pool_finalize(&event_class->event_pool);
+	BT_LOGD_STR("Putting extended events' base event class.");
+	if (event_class->extended_base_class != event_class) {
+		bt_put(event_class->extended_base_class);
+	}
+
 	BT_LOGD_STR("Destroying event class's attributes.");
 	bt_ctf_attributes_destroy(event_class->attributes);
 	BT_LOGD_STR("Putting context field type.");
@@ -52,7 +52,7 @@
 #include <inttypes.h>
 
 static
-void bt_ctf_event_destroy(struct bt_object *obj);
+void bt_ctf_event_release(struct bt_object *obj);
 
 struct bt_ctf_event *bt_ctf_event_create(struct bt_ctf_event_class *event_class)
 {
@@ -159,7 +159,7 @@ struct bt_ctf_event *bt_ctf_event_create(struct bt_ctf_event_class *event_class)
 		goto error;
 	}
 
-	bt_object_init(event, bt_ctf_event_destroy);
+	bt_object_init(event, bt_ctf_event_release);
 
 	/*
 	 * event does not share a common ancestor with the event class; it has
@@ -275,6 +275,283 @@ error:
 	return event;
 }
 
+static
+int create_missing_scope_field(struct bt_ctf_field **field,
+		struct bt_ctf_field_type *type)
+{
+	int ret = 0;
+
+	if (*field || !type) {
+		goto end;
+	}
+
+	*field = bt_ctf_field_create(type);
+	if (!*field) {
+		ret = -1;
+	}
+
+end:
+	return ret;
+}
+
+/*
+ * Gets a recycled event of the class event_class from its event pool,
+ * or creates a new pooled event if the pool is empty.
+ *
+ * The scope fields which were released when a recycled event was
+ * recycled because they were still shared are not created again: the
+ * caller must create them or set them.
+ */
+static
+struct bt_ctf_event *get_pooled_event(struct bt_ctf_event_class *event_class)
+{
+	struct bt_ctf_event *event;
+
+	event = bt_object_pool_get_object(&event_class->event_pool);
+	if (!event) {
+		/* Pool is empty: create a brand new event */
+		event = bt_ctf_event_create(event_class);
+		if (event) {
+			event->is_pooled = BT_TRUE;
+		}
+
+		goto end;
+	}
+
+	/*
+	 * The event class is valid and frozen since this event was
+	 * created from it: its field types and the ones of its stream
+	 * class cannot have changed since.
+	 */
+	assert(event->event_class == event_class);
+	assert(!event->base.parent);
+	event->event_class = bt_get(event_class);
+	BT_LOGV("Reused recycled event: addr=%p, event-class-name=\"%s\", "
+		"event-class-id=%" PRId64, event,
+		bt_ctf_event_class_get_name(event_class),
+		bt_ctf_event_class_get_id(event_class));
+
+end:
+	return event;
+}
+
+struct bt_ctf_event *bt_ctf_event_create_pooled(
+		struct bt_ctf_event_class *event_class)
+{
+	struct bt_ctf_event *event = NULL;
+	struct bt_ctf_stream_class *stream_class;
+
+	if (!event_class) {
+		BT_LOGW_STR("Invalid parameter: event class is NULL.");
+		goto end;
+	}
+
+	event = get_pooled_event(event_class);
+	if (!event) {
+		goto end;
+	}
+
+	stream_class = bt_ctf_event_class_borrow_stream_class(event_class);
+	assert(stream_class);
+
+	if (create_missing_scope_field(&event->event_header,
+			stream_class->event_header_type) ||
+			create_missing_scope_field(&event->stream_event_context,
+				stream_class->event_context_type) ||
+			create_missing_scope_field(&event->context_payload,
+				event_class->context) ||
+			create_missing_scope_field(&event->fields_payload,
+				event_class->fields)) {
+		BT_LOGE("Cannot create recycled event's scope fields: "
+			"event-addr=%p, event-class-name=\"%s\", "
+			"event-class-id=%" PRId64, event,
+			bt_ctf_event_class_get_name(event_class),
+			bt_ctf_event_class_get_id(event_class));
+		BT_PUT(event);
+		goto end;
+	}
+
+end:
+	return event;
+}
+
+static
+enum bt_ctf_event_scope_mapping get_scope_mapping(
+		struct bt_ctf_field_type *type,
+		struct bt_ctf_field_type *base_type)
+{
+	if (!type || !base_type) {
+		return BT_CTF_EVENT_SCOPE_MAPPING_NONE;
+	}
+
+	if (bt_ctf_field_type_compare(type, base_type) == 0) {
+		return BT_CTF_EVENT_SCOPE_MAPPING_SHARE;
+	}
+
+	if (bt_ctf_field_type_get_type_id(type) ==
+			BT_CTF_FIELD_TYPE_ID_STRUCT &&
+			bt_ctf_field_type_get_type_id(base_type) ==
+			BT_CTF_FIELD_TYPE_ID_STRUCT &&
+			bt_ctf_field_type_structure_compare_prefix(base_type,
+				type) == 0) {
+		return BT_CTF_EVENT_SCOPE_MAPPING_GRAFT;
+	}
+
+	return BT_CTF_EVENT_SCOPE_MAPPING_NONE;
+}
+
+/*
+ * Computes how the scope fields of the events of the class event_class
+ * map to the ones of the events of the class base_class, unless it's
+ * already known.
+ */
+static
+void update_extended_scope_mappings(struct bt_ctf_event_class *event_class,
+		struct bt_ctf_event_class *base_class)
+{
+	struct bt_ctf_stream_class *stream_class;
+	struct bt_ctf_stream_class *base_stream_class;
+	enum bt_ctf_event_scope_mapping *mappings =
+		event_class->extended_scope_mappings;
+
+	if (event_class->extended_base_class == base_class) {
+		return;
+	}
+
+	stream_class = bt_ctf_event_class_borrow_stream_class(event_class);
+	base_stream_class = bt_ctf_event_class_borrow_stream_class(base_class);
+	assert(stream_class);
+	assert(base_stream_class);
+	mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_HEADER] =
+		get_scope_mapping(stream_class->event_header_type,
+			base_stream_class->event_header_type);
+	mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_STREAM_EVENT_CONTEXT] =
+		get_scope_mapping(stream_class->event_context_type,
+			base_stream_class->event_context_type);
+	mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_EVENT_CONTEXT] =
+		get_scope_mapping(event_class->context, base_class->context);
+	mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_EVENT_PAYLOAD] =
+		get_scope_mapping(event_class->fields, base_class->fields);
+
+	if (event_class->extended_base_class != event_class) {
+		bt_put(event_class->extended_base_class);
+	}
+
+	event_class->extended_base_class = base_class;
+
+	if (base_class != event_class) {
+		bt_get(base_class);
+	}
+
+	BT_LOGD("Computed extended event's scope mappings: "
+		"event-class-addr=%p, event-class-name=\"%s\", "
+		"base-event-class-addr=%p, base-event-class-name=\"%s\", "
+		"header=%d, stream-event-context=%d, event-context=%d, "
+		"event-payload=%d", event_class,
+		bt_ctf_event_class_get_name(event_class), base_class,
+		bt_ctf_event_class_get_name(base_class),
+		mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_HEADER],
+		mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_STREAM_EVENT_CONTEXT],
+		mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_EVENT_CONTEXT],
+		mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_EVENT_PAYLOAD]);
+}
+
+static
+int extend_scope_field(struct bt_ctf_field **field,
+		struct bt_ctf_field_type *type, struct bt_ctf_field *base_field,
+		enum bt_ctf_event_scope_mapping mapping)
+{
+	int ret = 0;
+
+	if (!base_field) {
+		mapping = BT_CTF_EVENT_SCOPE_MAPPING_NONE;
+	}
+
+	if (mapping == BT_CTF_EVENT_SCOPE_MAPPING_SHARE) {
+		if (*field != base_field) {
+			bt_put(*field);
+			*field = bt_get(base_field);
+		}
+
+		goto end;
+	}
+
+	ret = create_missing_scope_field(field, type);
+	if (ret) {
+		goto end;
+	}
+
+	if (mapping == BT_CTF_EVENT_SCOPE_MAPPING_GRAFT) {
+		bt_ctf_field_structure_graft(*field, base_field);
+	}
+
+end:
+	return ret;
+}
+
+struct bt_ctf_event *bt_ctf_event_create_extended(
+		struct bt_ctf_event_class *event_class,
+		struct bt_ctf_event *base_event)
+{
+	struct bt_ctf_event *event = NULL;
+	struct bt_ctf_stream_class *stream_class;
+	enum bt_ctf_event_scope_mapping *mappings;
+
+	if (!event_class) {
+		BT_LOGW_STR("Invalid parameter: event class is NULL.");
+		goto end;
+	}
+
+	if (!base_event) {
+		BT_LOGW_STR("Invalid parameter: base event is NULL.");
+		goto end;
+	}
+
+	event = get_pooled_event(event_class);
+	if (!event) {
+		goto end;
+	}
+
+	/* Both event classes are valid, thus frozen, at this point */
+	update_extended_scope_mappings(event_class, base_event->event_class);
+	mappings = event_class->extended_scope_mappings;
+	stream_class = bt_ctf_event_class_borrow_stream_class(event_class);
+	assert(stream_class);
+
+	if (extend_scope_field(&event->event_header,
+			stream_class->event_header_type,
+			base_event->event_header,
+			mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_HEADER]) ||
+			extend_scope_field(&event->stream_event_context,
+				stream_class->event_context_type,
+				base_event->stream_event_context,
+				mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_STREAM_EVENT_CONTEXT]) ||
+			extend_scope_field(&event->context_payload,
+				event_class->context,
+				base_event->context_payload,
+				mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_EVENT_CONTEXT]) ||
+			extend_scope_field(&event->fields_payload,
+				event_class->fields,
+				base_event->fields_payload,
+				mappings[BT_CTF_EVENT_SCOPE_MAPPING_INDEX_EVENT_PAYLOAD])) {
+		BT_LOGE("Cannot create extended event's scope fields: "
+			"event-addr=%p, event-class-name=\"%s\", "
+			"event-class-id=%" PRId64 ", base-event-addr=%p", event,
+			bt_ctf_event_class_get_name(event_class),
+			bt_ctf_event_class_get_id(event_class), base_event);
+		BT_PUT(event);
+		goto end;
+	}
+
+	BT_LOGV("Created extended event: addr=%p, event-class-name=\"%s\", "
+		"event-class-id=%" PRId64 ", base-event-addr=%p", event,
+		bt_ctf_event_class_get_name(event_class),
+		bt_ctf_event_class_get_id(event_class), base_event);
+
+end:
+	return event;
+}
+
 struct bt_ctf_event_class *bt_ctf_event_get_class(struct bt_ctf_event *event)
 {
 	struct bt_ctf_event_class *event_class = NULL;
@@ -736,11 +1013,25 @@ void bt_ctf_event_put(struct bt_ctf_event *event)
 	bt_put(event);
 }
 
-void bt_ctf_event_destroy(struct bt_object *obj)
+static
+void put_event_members(struct bt_ctf_event *event)
 {
-	struct bt_ctf_event *event;
+	g_hash_table_destroy(event->clock_values);
+	BT_LOGD_STR("Putting event's header field.");
+	bt_put(event->event_header);
+	BT_LOGD_STR("Putting event's stream event context field.");
+	bt_put(event->stream_event_context);
+	BT_LOGD_STR("Putting event's context field.");
+	bt_put(event->context_payload);
+	BT_LOGD_STR("Putting event's payload field.");
+	bt_put(event->fields_payload);
+	BT_LOGD_STR("Putting event's packet.");
+	bt_put(event->packet);
+}
 
-	event = container_of(obj, struct bt_ctf_event, base);
+static
+void bt_ctf_event_destroy(struct bt_ctf_event *event)
+{
 	BT_LOGD("Destroying event: addr=%p, "
 		"event-class-name=\"%s\", event-class-id=%" PRId64,
 		event, bt_ctf_event_class_get_name(event->event_class),
@@ -754,20 +1045,81 @@ void bt_ctf_event_destroy(struct bt_object *obj)
 		 */
 		bt_put(event->event_class);
 	}
-	g_hash_table_destroy(event->clock_values);
-	BT_LOGD_STR("Putting event's header field.");
-	bt_put(event->event_header);
-	BT_LOGD_STR("Putting event's stream event context field.");
-	bt_put(event->stream_event_context);
-	BT_LOGD_STR("Putting event's context field.");
-	bt_put(event->context_payload);
-	BT_LOGD_STR("Putting event's payload field.");
-	bt_put(event->fields_payload);
-	BT_LOGD_STR("Putting event's packet.");
-	bt_put(event->packet);
+
+	put_event_members(event);
+	g_free(event);
+}
+
+BT_HIDDEN
+void bt_ctf_event_destroy_recycled(void *obj)
+{
+	struct bt_ctf_event *event = obj;
+
+	/* A recycled event does not own its class */
+	BT_LOGD("Destroying recycled event: addr=%p", event);
+	put_event_members(event);
 	g_free(event);
 }
 
+/*
+ * Resets the scope field *field for the next user of a recycled
+ * event, or releases it if it's still owned by something else.
+ */
+static
+void reset_scope_field_for_reuse(struct bt_ctf_field **field)
+{
+	if (!*field) {
+		return;
+	}
+
+	if (bt_object_get_ref_count(*field) > 1) {
+		BT_PUT(*field);
+		return;
+	}
+
+	bt_ctf_field_reset_for_reuse(*field);
+}
+
+static
+void bt_ctf_event_release(struct bt_object *obj)
+{
+	struct bt_ctf_event *event =
+		container_of(obj, struct bt_ctf_event, base);
+	struct bt_ctf_event_class *event_class = event->event_class;
+
+	/*
+	 * An event which is part of a (writer) stream does not own its
+	 * class: destroy it instead of recycling it.
+	 */
+	if (!event->is_pooled || event->base.parent) {
+		bt_ctf_event_destroy(event);
+		return;
+	}
+
+	BT_LOGV("Recycling event: addr=%p, "
+		"event-class-name=\"%s\", event-class-id=%" PRId64,
+		event, bt_ctf_event_class_get_name(event_class),
+		bt_ctf_event_class_get_id(event_class));
+	g_hash_table_remove_all(event->clock_values);
+	BT_PUT(event->packet);
+	reset_scope_field_for_reuse(&event->event_header);
+	reset_scope_field_for_reuse(&event->stream_event_context);
+	reset_scope_field_for_reuse(&event->context_payload);
+	reset_scope_field_for_reuse(&event->fields_payload);
+	event->frozen = 0;
+
+	if (bt_object_pool_recycle_object(&event_class->event_pool, event)) {
+		bt_ctf_event_destroy(event);
+		return;
+	}
+
+	/*
+	 * Put the class last: this could destroy it, and its pool
+	 * with this event.
+	 */
+	bt_put(event_class);
+}
+
 struct bt_ctf_clock_value *bt_ctf_event_get_clock_value(
 		struct bt_ctf_event *event, struct bt_ctf_clock_class *clock_class)
 {
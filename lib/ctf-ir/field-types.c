@@ -5243,6 +5243,50 @@ end:
 	return ret;
 }
 
+BT_HIDDEN
+int bt_ctf_field_type_structure_compare_prefix(
+		struct bt_ctf_field_type *prefix_type,
+		struct bt_ctf_field_type *type)
+{
+	int ret = 1;
+	int i;
+	struct bt_ctf_field_type_structure *prefix_struct;
+	struct bt_ctf_field_type_structure *struct_type;
+
+	assert(prefix_type);
+	assert(type);
+	assert(prefix_type->id == BT_CTF_FIELD_TYPE_ID_STRUCT);
+	assert(type->id == BT_CTF_FIELD_TYPE_ID_STRUCT);
+	prefix_struct = container_of(prefix_type,
+		struct bt_ctf_field_type_structure, parent);
+	struct_type = container_of(type,
+		struct bt_ctf_field_type_structure, parent);
+
+	if (prefix_struct->fields->len > struct_type->fields->len) {
+		BT_LOGV("Structure field type is not a prefix: too many fields: "
+			"prefix-ft-field-count=%u, ft-field-count=%u",
+			prefix_struct->fields->len, struct_type->fields->len);
+		goto end;
+	}
+
+	for (i = 0; i < prefix_struct->fields->len; ++i) {
+		ret = compare_structure_fields(
+			g_ptr_array_index(prefix_struct->fields, i),
+			g_ptr_array_index(struct_type->fields, i));
+		if (ret) {
+			/* compare_structure_fields() logs what differs */
+			BT_LOGV_STR("Structure field type is not a prefix: different fields.");
+			goto end;
+		}
+	}
+
+	/* Prefix */
+	ret = 0;
+
+end:
+	return ret;
+}
+
 BT_HIDDEN
 int64_t bt_ctf_field_type_get_field_count(struct bt_ctf_field_type *field_type)
 {
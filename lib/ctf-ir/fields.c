@@ -35,7 +35,6 @@
 #include <babeltrace/object-internal.h>
 #include <babeltrace/ref.h>
 #include <babeltrace/compiler-internal.h>
-#include <babeltrace/compat/fcntl-internal.h>
 #include <babeltrace/align-internal.h>
 #include <inttypes.h>
 
@@ -178,9 +177,6 @@ bt_bool bt_ctf_field_array_is_set(struct bt_ctf_field *);
 static
 bt_bool bt_ctf_field_sequence_is_set(struct bt_ctf_field *);
 
-static
-int increase_packet_size(struct bt_ctf_stream_pos *pos);
-
 static
 struct bt_ctf_field *(* const field_create_funcs[])(
 		struct bt_ctf_field_type *) = {
@@ -488,20 +484,50 @@ int bt_ctf_field_sequence_set_length(struct bt_ctf_field *field,
 	sequence_length = length->payload.unsignd;
 	sequence = container_of(field, struct bt_ctf_field_sequence, parent);
 	if (sequence->elements) {
-		g_ptr_array_free(sequence->elements, TRUE);
-		bt_put(sequence->length);
-	}
+		size_t i;
 
-	sequence->elements = g_ptr_array_sized_new((size_t)sequence_length);
-	if (!sequence->elements) {
-		BT_LOGE_STR("Failed to allocate a GPtrArray.");
-		ret = -1;
-		goto end;
+		/*
+		 * Keep the existing element fields which are not
+		 * shared with anything else, resetting them, instead of
+		 * creating them all again.
+		 */
+		g_ptr_array_set_size(sequence->elements,
+			(size_t) sequence_length);
+
+		for (i = 0; i < sequence->elements->len; i++) {
+			struct bt_ctf_field *elem =
+				sequence->elements->pdata[i];
+
+			if (!elem) {
+				continue;
+			}
+
+			if (bt_object_get_ref_count(elem) > 1 ||
+					elem->frozen) {
+				bt_put(elem);
+				sequence->elements->pdata[i] = NULL;
+				continue;
+			}
+
+			(void) bt_ctf_field_reset(elem);
+		}
+
+		BT_PUT(sequence->length);
+	} else {
+		sequence->elements =
+			g_ptr_array_sized_new((size_t) sequence_length);
+		if (!sequence->elements) {
+			BT_LOGE_STR("Failed to allocate a GPtrArray.");
+			ret = -1;
+			goto end;
+		}
+
+		g_ptr_array_set_free_func(sequence->elements,
+			(GDestroyNotify) bt_put);
+		g_ptr_array_set_size(sequence->elements,
+			(size_t) sequence_length);
 	}
 
-	g_ptr_array_set_free_func(sequence->elements,
-		(GDestroyNotify) bt_put);
-	g_ptr_array_set_size(sequence->elements, (size_t) sequence_length);
 	bt_get(length_field);
 	sequence->length = length_field;
 end:
@@ -923,28 +949,23 @@ struct bt_ctf_field *bt_ctf_field_variant_get_field(struct bt_ctf_field *field,
 	tag_enum_value = tag_enum_integer->payload.signd;
 
 	/*
-	 * If the variant currently has a tag and a payload, and if the
-	 * requested tag value is the same as the current one, return
+	 * If the variant currently has a payload, and if the requested
+	 * tag value is the same as the one which selected it, return
 	 * the current payload instead of creating a fresh one.
+	 *
+	 * The tag value is cached because the current tag field could
+	 * be the same object as the requested one, with a new value,
+	 * or could be missing (when the variant field is reused: see
+	 * bt_ctf_field_reset_for_reuse()).
 	 */
-	if (variant->tag && variant->payload) {
-		struct bt_ctf_field *cur_tag_container = NULL;
-		struct bt_ctf_field_integer *cur_tag_enum_integer;
-		int64_t cur_tag_value;
-
-		cur_tag_container =
-			bt_ctf_field_enumeration_get_container(variant->tag);
-		assert(cur_tag_container);
-		cur_tag_enum_integer = container_of(cur_tag_container,
-			struct bt_ctf_field_integer, parent);
-		bt_put(cur_tag_container);
-		cur_tag_value = cur_tag_enum_integer->payload.signd;
-
-		if (cur_tag_value == tag_enum_value) {
-			new_field = variant->payload;
-			bt_get(new_field);
-			goto end;
+	if (variant->payload && variant->tag_value == tag_enum_value) {
+		if (!variant->tag && !field->frozen) {
+			variant->tag = bt_get(tag_field);
 		}
+
+		new_field = variant->payload;
+		bt_get(new_field);
+		goto end;
 	}
 
 	/* We don't want to modify this field if it's frozen */
@@ -985,6 +1006,7 @@ struct bt_ctf_field *bt_ctf_field_variant_get_field(struct bt_ctf_field *field,
 	bt_get(tag_field);
 	variant->tag = tag_field;
 	variant->payload = new_field;
+	variant->tag_value = tag_enum_value;
 end:
 	bt_put(tag_enum);
 	return new_field;
@@ -1697,6 +1719,212 @@ end:
 	return ret;
 }
 
+static
+void put_tag_and_length_fields(struct bt_ctf_field *field);
+
+static
+void put_tag_and_length_fields_in_array(GPtrArray *fields)
+{
+	guint i;
+
+	if (!fields) {
+		return;
+	}
+
+	for (i = 0; i < fields->len; i++) {
+		put_tag_and_length_fields(fields->pdata[i]);
+	}
+}
+
+/*
+ * Releases the references which the variant and sequence fields
+ * within field hold on their tag and length fields. Those are owned
+ * by an enclosing field: once they're released, the reference count of
+ * a subfield tells whether or not it is also owned by something else.
+ *
+ * Subfields which are already owned by something else are left as is.
+ */
+static
+void put_tag_and_length_fields(struct bt_ctf_field *field)
+{
+	if (!field || bt_object_get_ref_count(field) > 1) {
+		return;
+	}
+
+	switch (bt_ctf_field_type_get_type_id(field->type)) {
+	case BT_CTF_FIELD_TYPE_ID_STRUCT:
+	{
+		struct bt_ctf_field_structure *structure = container_of(
+			field, struct bt_ctf_field_structure, parent);
+
+		put_tag_and_length_fields_in_array(structure->fields);
+		break;
+	}
+	case BT_CTF_FIELD_TYPE_ID_VARIANT:
+	{
+		struct bt_ctf_field_variant *variant = container_of(
+			field, struct bt_ctf_field_variant, parent);
+
+		BT_PUT(variant->tag);
+		put_tag_and_length_fields(variant->payload);
+		break;
+	}
+	case BT_CTF_FIELD_TYPE_ID_ARRAY:
+	{
+		struct bt_ctf_field_array *array = container_of(
+			field, struct bt_ctf_field_array, parent);
+
+		put_tag_and_length_fields_in_array(array->elements);
+		break;
+	}
+	case BT_CTF_FIELD_TYPE_ID_SEQUENCE:
+	{
+		struct bt_ctf_field_sequence *sequence = container_of(
+			field, struct bt_ctf_field_sequence, parent);
+
+		BT_PUT(sequence->length);
+		put_tag_and_length_fields_in_array(sequence->elements);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static
+void reset_field_for_reuse(struct bt_ctf_field *field);
+
+/*
+ * Releases the subfield *subfield if it is also owned by something
+ * else than its parent, otherwise prepares it for reuse.
+ */
+static
+void reset_subfield_for_reuse(struct bt_ctf_field **subfield)
+{
+	if (!*subfield) {
+		return;
+	}
+
+	if (bt_object_get_ref_count(*subfield) > 1) {
+		BT_PUT(*subfield);
+		return;
+	}
+
+	reset_field_for_reuse(*subfield);
+}
+
+static
+void reset_subfield_array_for_reuse(GPtrArray *fields)
+{
+	guint i;
+
+	if (!fields) {
+		return;
+	}
+
+	for (i = 0; i < fields->len; i++) {
+		reset_subfield_for_reuse(
+			(struct bt_ctf_field **) &fields->pdata[i]);
+	}
+}
+
+static
+void reset_field_for_reuse(struct bt_ctf_field *field)
+{
+	switch (bt_ctf_field_type_get_type_id(field->type)) {
+	case BT_CTF_FIELD_TYPE_ID_ENUM:
+	{
+		struct bt_ctf_field_enumeration *enumeration = container_of(
+			field, struct bt_ctf_field_enumeration, parent);
+
+		reset_subfield_for_reuse(&enumeration->payload);
+		break;
+	}
+	case BT_CTF_FIELD_TYPE_ID_STRUCT:
+	{
+		struct bt_ctf_field_structure *structure = container_of(
+			field, struct bt_ctf_field_structure, parent);
+
+		reset_subfield_array_for_reuse(structure->fields);
+		break;
+	}
+	case BT_CTF_FIELD_TYPE_ID_VARIANT:
+	{
+		struct bt_ctf_field_variant *variant = container_of(
+			field, struct bt_ctf_field_variant, parent);
+
+		reset_subfield_for_reuse(&variant->payload);
+		break;
+	}
+	case BT_CTF_FIELD_TYPE_ID_ARRAY:
+	{
+		struct bt_ctf_field_array *array = container_of(
+			field, struct bt_ctf_field_array, parent);
+
+		reset_subfield_array_for_reuse(array->elements);
+		break;
+	}
+	case BT_CTF_FIELD_TYPE_ID_SEQUENCE:
+	{
+		struct bt_ctf_field_sequence *sequence = container_of(
+			field, struct bt_ctf_field_sequence, parent);
+
+		reset_subfield_array_for_reuse(sequence->elements);
+		break;
+	}
+	default:
+		(void) bt_ctf_field_reset(field);
+		break;
+	}
+
+	field->frozen = 0;
+}
+
+BT_HIDDEN
+void bt_ctf_field_reset_for_reuse(struct bt_ctf_field *field)
+{
+	assert(field);
+	assert(bt_object_get_ref_count(field) <= 1);
+	put_tag_and_length_fields(field);
+	reset_field_for_reuse(field);
+}
+
+BT_HIDDEN
+void bt_ctf_field_structure_graft(struct bt_ctf_field *field,
+		struct bt_ctf_field *base_field)
+{
+	guint i;
+	struct bt_ctf_field_structure *structure;
+	struct bt_ctf_field_structure *base_structure;
+
+	assert(field);
+	assert(base_field);
+	assert(!field->frozen);
+	assert(bt_ctf_field_type_get_type_id(field->type) ==
+		BT_CTF_FIELD_TYPE_ID_STRUCT);
+	assert(bt_ctf_field_type_get_type_id(base_field->type) ==
+		BT_CTF_FIELD_TYPE_ID_STRUCT);
+	structure = container_of(field, struct bt_ctf_field_structure, parent);
+	base_structure = container_of(base_field,
+		struct bt_ctf_field_structure, parent);
+	assert(base_structure->fields->len <= structure->fields->len);
+
+	for (i = 0; i < base_structure->fields->len; i++) {
+		struct bt_ctf_field *base_member =
+			base_structure->fields->pdata[i];
+
+		if (structure->fields->pdata[i] == base_member) {
+			continue;
+		}
+
+		bt_put(structure->fields->pdata[i]);
+		structure->fields->pdata[i] = bt_get(base_member);
+	}
+
+	BT_LOGV("Grafted structure field's fields: addr=%p, base-addr=%p, "
+		"count=%u", field, base_field, base_structure->fields->len);
+}
+
 BT_HIDDEN
 int bt_ctf_field_serialize(struct bt_ctf_field *field,
 		struct bt_ctf_stream_pos *pos,
@@ -2483,7 +2711,7 @@ retry:
 		 * The field is too large to fit in the current packet's
 		 * remaining space. Bump the packet size and retry.
 		 */
-		ret = increase_packet_size(pos);
+		ret = bt_ctf_stream_pos_increase_packet_size(pos);
 		if (ret) {
 			BT_LOGE("Cannot increase packet size: ret=%d", ret);
 			goto end;
@@ -2536,7 +2764,7 @@ retry:
 		 * The field is too large to fit in the current packet's
 		 * remaining space. Bump the packet size and retry.
 		 */
-		ret = increase_packet_size(pos);
+		ret = bt_ctf_stream_pos_increase_packet_size(pos);
 		if (ret) {
 			BT_LOGE("Cannot increase packet size: ret=%d", ret);
 			goto end;
@@ -2563,7 +2791,7 @@ int bt_ctf_field_structure_serialize(struct bt_ctf_field *field,
 
 	while (!bt_ctf_stream_pos_access_ok(pos,
 		offset_align(pos->offset, field->type->alignment))) {
-		ret = increase_packet_size(pos);
+		ret = bt_ctf_stream_pos_increase_packet_size(pos);
 		if (ret) {
 			BT_LOGE("Cannot increase packet size: ret=%d", ret);
 			goto end;
@@ -2881,6 +3109,8 @@ int bt_ctf_field_variant_copy(struct bt_ctf_field *src,
 		}
 	}
 
+	variant_dst->tag_value = variant_src->tag_value;
+
 	BT_LOGD_STR("Copied variant field.");
 
 end:
@@ -3025,52 +3255,6 @@ end:
 	return ret;
 }
 
-static
-int increase_packet_size(struct bt_ctf_stream_pos *pos)
-{
-	int ret;
-
-	assert(pos);
-	BT_LOGV("Increasing packet size: pos-offset=%" PRId64 ", "
-		"cur-packet-size=%" PRIu64,
-		pos->offset, pos->packet_size);
-	ret = munmap_align(pos->base_mma);
-	if (ret) {
-		BT_LOGE("Failed to perform an aligned memory unmapping: "
-			"ret=%d, errno=%d", ret, errno);
-		goto end;
-	}
-
-	pos->packet_size += PACKET_LEN_INCREMENT;
-	do {
-		ret = bt_posix_fallocate(pos->fd, pos->mmap_offset,
-			pos->packet_size / CHAR_BIT);
-	} while (ret == EINTR);
-	if (ret) {
-		BT_LOGE("Failed to preallocate memory space: ret=%d, errno=%d",
-			ret, errno);
-		errno = EINTR;
-		ret = -1;
-		goto end;
-	}
-
-	pos->base_mma = mmap_align(pos->packet_size / CHAR_BIT, pos->prot,
-		pos->flags, pos->fd, pos->mmap_offset);
-	if (pos->base_mma == MAP_FAILED) {
-		BT_LOGE("Failed to perform an aligned memory mapping: "
-			"ret=%d, errno=%d", ret, errno);
-		ret = -1;
-	}
-
-	BT_LOGV("Increased packet size: pos-offset=%" PRId64 ", "
-		"new-packet-size=%" PRIu64,
-		pos->offset, pos->packet_size);
-	assert(pos->packet_size % 8 == 0);
-
-end:
-	return ret;
-}
-
 static
 void generic_field_freeze(struct bt_ctf_field *field)
 {
@@ -47,6 +47,8 @@
 #include <babeltrace/ctf-writer/functor-internal.h>
 #include <babeltrace/compiler-internal.h>
 #include <babeltrace/align-internal.h>
+#include <babeltrace/endian-internal.h>
+#include <babeltrace/lttng-index-internal.h>
 #include <inttypes.h>
 #include <unistd.h>
 
@@ -466,15 +468,19 @@ end:
 	return ret;
 }
 
+/*
+ * Sets the packet context's `field_name` field to the timestamp of
+ * `event` or, if `event` is NULL because the event is already
+ * serialized, to `ts`.
+ */
 static
 int set_packet_context_timestamp_field(struct bt_ctf_stream *stream,
-		const char *field_name, struct bt_ctf_event *event)
+		const char *field_name, struct bt_ctf_event *event, uint64_t ts)
 {
 	int ret = 0;
 	struct bt_ctf_field *field = bt_ctf_field_structure_get_field(
 		stream->packet_context, field_name);
 	struct bt_ctf_clock_class *field_mapped_clock_class = NULL;
-	uint64_t ts;
 
 	assert(stream);
 
@@ -524,7 +530,8 @@ int set_packet_context_timestamp_field(struct bt_ctf_stream *stream,
 		goto end;
 	}
 
-	if (get_event_header_timestamp(stream, event->event_header, &ts)) {
+	if (event && get_event_header_timestamp(stream, event->event_header,
+			&ts)) {
 		BT_LOGW("Cannot get event's timestamp: "
 			"event-header-field-addr=%p",
 			event->event_header);
@@ -537,12 +544,12 @@ int set_packet_context_timestamp_field(struct bt_ctf_stream *stream,
 		BT_LOGW("Cannot set packet context field's `%s` integer field's value: "
 			"stream-addr=%p, stream-name=\"%s\", field-addr=%p, value=%" PRIu64,
 			field_name, stream, bt_ctf_stream_get_name(stream),
-			field, stream->discarded_events);
+			field, ts);
 	} else {
 		BT_LOGV("Set packet context field's `%s` field's value: "
 			"stream-addr=%p, stream-name=\"%s\", field-addr=%p, value=%" PRIu64,
 			field_name, stream, bt_ctf_stream_get_name(stream),
-			field, stream->discarded_events);
+			field, ts);
 	}
 
 end:
@@ -551,20 +558,34 @@ end:
 	return ret;
 }
 
+static
+uint64_t get_packet_event_count(struct bt_ctf_stream *stream)
+{
+	return stream->serialize_on_append ? stream->packet_event_count :
+		(uint64_t) stream->events->len;
+}
+
 static
 int set_packet_context_timestamp_begin(struct bt_ctf_stream *stream)
 {
 	int ret = 0;
 
-	if (stream->events->len == 0) {
+	if (get_packet_event_count(stream) == 0) {
 		BT_LOGV("Current packet contains no events: skipping: "
 			"stream-addr=%p, stream-name=\"%s\"",
 			stream, bt_ctf_stream_get_name(stream));
 		goto end;
 	}
 
-	ret = set_packet_context_timestamp_field(stream, "timestamp_begin",
-		g_ptr_array_index(stream->events, 0));
+	if (stream->serialize_on_append) {
+		ret = set_packet_context_timestamp_field(stream,
+			"timestamp_begin", NULL,
+			stream->packet_timestamp_begin);
+	} else {
+		ret = set_packet_context_timestamp_field(stream,
+			"timestamp_begin",
+			g_ptr_array_index(stream->events, 0), 0);
+	}
 
 end:
 	return ret;
@@ -575,15 +596,22 @@ int set_packet_context_timestamp_end(struct bt_ctf_stream *stream)
 {
 	int ret = 0;
 
-	if (stream->events->len == 0) {
+	if (get_packet_event_count(stream) == 0) {
 		BT_LOGV("Current packet contains no events: skipping: "
 			"stream-addr=%p, stream-name=\"%s\"",
 			stream, bt_ctf_stream_get_name(stream));
 		goto end;
 	}
 
-	ret = set_packet_context_timestamp_field(stream, "timestamp_end",
-		g_ptr_array_index(stream->events, stream->events->len - 1));
+	if (stream->serialize_on_append) {
+		ret = set_packet_context_timestamp_field(stream,
+			"timestamp_end", NULL, stream->packet_timestamp_end);
+	} else {
+		ret = set_packet_context_timestamp_field(stream,
+			"timestamp_end",
+			g_ptr_array_index(stream->events,
+				stream->events->len - 1), 0);
+	}
 
 end:
 	return ret;
@@ -663,16 +691,14 @@ void release_event(struct bt_ctf_event *event)
 }
 
 static
-int create_stream_file(struct bt_ctf_writer *writer,
-		struct bt_ctf_stream *stream)
+GString *get_stream_file_name(struct bt_ctf_stream *stream)
 {
-	int fd;
 	GString *filename = g_string_new(stream->stream_class->name->str);
 
-	BT_LOGD("Creating stream file: writer-addr=%p, stream-addr=%p, "
-		"stream-name=\"%s\", stream-class-addr=%p, stream-class-name=\"%s\"",
-		writer, stream, bt_ctf_stream_get_name(stream),
-		stream->stream_class, stream->stream_class->name->str);
+	if (!filename) {
+		BT_LOGE_STR("Failed to allocate a GString.");
+		goto error;
+	}
 
 	if (stream->stream_class->name->len == 0) {
 		int64_t ret;
@@ -684,14 +710,35 @@ int create_stream_file(struct bt_ctf_writer *writer,
 				"stream-class-name=\"%s\"",
 				stream->stream_class,
 				stream->stream_class->name->str);
-			fd = -1;
-			goto end;
+			goto error;
 		}
 
 		g_string_printf(filename, "stream_%" PRId64, ret);
 	}
 
 	g_string_append_printf(filename, "_%" PRId64, stream->id);
+	goto end;
+
+error:
+	if (filename) {
+		g_string_free(filename, TRUE);
+		filename = NULL;
+	}
+
+end:
+	return filename;
+}
+
+static
+int create_stream_file(struct bt_ctf_writer *writer,
+		struct bt_ctf_stream *stream, GString *filename)
+{
+	int fd;
+
+	BT_LOGD("Creating stream file: writer-addr=%p, stream-addr=%p, "
+		"stream-name=\"%s\", stream-class-addr=%p, stream-class-name=\"%s\"",
+		writer, stream, bt_ctf_stream_get_name(stream),
+		stream->stream_class, stream->stream_class->name->str);
 	fd = openat(writer->trace_dir_fd, filename->str,
 		O_RDWR | O_CREAT | O_TRUNC,
 		S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
@@ -709,7 +756,98 @@ int create_stream_file(struct bt_ctf_writer *writer,
 		writer->trace_dir_fd, filename->str, fd);
 
 end:
-	g_string_free(filename, TRUE);
+	return fd;
+}
+
+static
+int write_all(int fd, const void *buf, size_t len)
+{
+	const char *addr = buf;
+	int ret = 0;
+
+	while (len > 0) {
+		ssize_t written = write(fd, addr, len);
+
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			ret = -1;
+			goto end;
+		}
+
+		addr += written;
+		len -= written;
+	}
+
+end:
+	return ret;
+}
+
+/*
+ * Creates the index file of the stream file named `filename` and writes
+ * its header. Returns the index file's FD, or -1 on error.
+ */
+static
+int create_stream_index_file(struct bt_ctf_writer *writer,
+		struct bt_ctf_stream *stream, GString *filename)
+{
+	int fd = -1;
+	int ret;
+	GString *index_filename = NULL;
+	struct ctf_packet_index_file_hdr hdr;
+
+	ret = mkdirat(writer->trace_dir_fd, "index", S_IRWXU | S_IRWXG);
+	if (ret && errno != EEXIST) {
+		BT_LOGW("Failed to create index directory: %s: "
+			"writer-trace-dir-fd=%d, ret=%d, errno=%d",
+			strerror(errno), writer->trace_dir_fd, ret, errno);
+		goto end;
+	}
+
+	index_filename = g_string_new("index/");
+	if (!index_filename) {
+		BT_LOGE_STR("Failed to allocate a GString.");
+		goto end;
+	}
+
+	g_string_append_printf(index_filename, "%s.idx", filename->str);
+	fd = openat(writer->trace_dir_fd, index_filename->str,
+		O_WRONLY | O_CREAT | O_TRUNC,
+		S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+	if (fd < 0) {
+		BT_LOGW("Failed to open stream index file for writing: %s: "
+			"writer-trace-dir-fd=%d, filename=\"%s\", "
+			"ret=%d, errno=%d", strerror(errno),
+			writer->trace_dir_fd, index_filename->str, fd, errno);
+		goto end;
+	}
+
+	hdr.magic = htobe32(CTF_INDEX_MAGIC);
+	hdr.index_major = htobe32(CTF_INDEX_MAJOR);
+	hdr.index_minor = htobe32(CTF_INDEX_MINOR);
+	hdr.packet_index_len = htobe32(sizeof(struct ctf_packet_index));
+
+	if (write_all(fd, &hdr, sizeof(hdr))) {
+		BT_LOGW("Failed to write stream index file's header: %s: "
+			"filename=\"%s\", fd=%d, errno=%d", strerror(errno),
+			index_filename->str, fd, errno);
+		(void) close(fd);
+		fd = -1;
+		goto end;
+	}
+
+	BT_LOGD("Created stream index file for writing: "
+		"stream-addr=%p, stream-name=\"%s\", filename=\"%s\", fd=%d",
+		stream, bt_ctf_stream_get_name(stream), index_filename->str,
+		fd);
+
+end:
+	if (index_filename) {
+		g_string_free(index_filename, TRUE);
+	}
+
 	return fd;
 }
 
@@ -739,6 +877,7 @@ struct bt_ctf_stream *bt_ctf_stream_create_with_id_no_check(
 	struct bt_ctf_stream *stream = NULL;
 	struct bt_ctf_trace *trace = NULL;
 	struct bt_ctf_writer *writer = NULL;
+	GString *filename = NULL;
 
 	if (!stream_class) {
 		BT_LOGW_STR("Invalid parameter: stream class is NULL.");
@@ -811,6 +950,7 @@ struct bt_ctf_stream *bt_ctf_stream_create_with_id_no_check(
 	bt_object_set_parent(stream, trace);
 	stream->stream_class = stream_class;
 	stream->pos.fd = -1;
+	stream->index_fd = -1;
 	stream->id = (int64_t) id;
 
 	stream->destroy_listeners = g_array_new(FALSE, TRUE,
@@ -893,7 +1033,13 @@ struct bt_ctf_stream *bt_ctf_stream_create_with_id_no_check(
 		}
 
 		/* Create file associated with this stream */
-		fd = create_stream_file(writer, stream);
+		filename = get_stream_file_name(stream);
+		if (!filename) {
+			BT_LOGW_STR("Cannot get stream file's name.");
+			goto error;
+		}
+
+		fd = create_stream_file(writer, stream, filename);
 		if (fd < 0) {
 			BT_LOGW_STR("Cannot create stream file.");
 			goto error;
@@ -901,6 +1047,17 @@ struct bt_ctf_stream *bt_ctf_stream_create_with_id_no_check(
 
 		set_stream_fd(stream, fd);
 
+		/*
+		 * The packet index only makes the trace faster to read:
+		 * if it cannot be created, the stream is written
+		 * without it.
+		 */
+		stream->index_fd = create_stream_index_file(writer, stream,
+			filename);
+		if (stream->index_fd < 0) {
+			BT_LOGW_STR("Cannot create stream index file: continuing without packet index.");
+		}
+
 		/* Freeze the writer */
 		BT_LOGD_STR("Freezing stream's CTF writer.");
 		bt_ctf_writer_freeze(writer);
@@ -924,6 +1081,10 @@ error:
 	BT_PUT(stream);
 
 end:
+	if (filename) {
+		g_string_free(filename, TRUE);
+	}
+
 	bt_put(writer);
 	return stream;
 }
@@ -1199,6 +1360,219 @@ end:
 	return ret;
 }
 
+/*
+ * Maps the stream's next packet and serializes its header and context.
+ * The position of the packet context is saved so that the context can
+ * be serialized again once the packet is complete.
+ */
+static
+int open_packet(struct bt_ctf_stream *stream)
+{
+	int ret = 0;
+	struct bt_ctf_trace *trace;
+	enum bt_ctf_byte_order native_byte_order;
+
+	trace = bt_ctf_stream_class_borrow_trace(stream->stream_class);
+	assert(trace);
+	native_byte_order = bt_ctf_trace_get_native_byte_order(trace);
+
+	ret = auto_populate_packet_header(stream);
+	if (ret) {
+		BT_LOGW_STR("Cannot automatically populate the stream's packet header field.");
+		ret = -1;
+		goto end;
+	}
+
+	ret = auto_populate_packet_context(stream);
+	if (ret) {
+		BT_LOGW_STR("Cannot automatically populate the stream's packet context field.");
+		ret = -1;
+		goto end;
+	}
+
+	/* mmap the next packet */
+	BT_LOGV("Seeking to the next packet: pos-offset=%" PRId64,
+		stream->pos.offset);
+	ret = bt_ctf_stream_pos_packet_seek(&stream->pos, 0, SEEK_CUR);
+	if (ret) {
+		BT_LOGW("Cannot allocate the stream's next packet: "
+			"stream-addr=%p, stream-name=\"%s\"",
+			stream, bt_ctf_stream_get_name(stream));
+		goto end;
+	}
+
+	assert(stream->pos.packet_size % 8 == 0);
+
+	if (stream->packet_header) {
+		BT_LOGV_STR("Serializing packet header field.");
+		ret = bt_ctf_field_serialize(stream->packet_header, &stream->pos,
+			native_byte_order);
+		if (ret) {
+			BT_LOGW("Cannot serialize stream's packet header field: "
+				"field-addr=%p", stream->packet_header);
+			goto error;
+		}
+	}
+
+	if (stream->packet_context) {
+		/* Write packet context */
+		memcpy(&stream->packet_context_pos, &stream->pos,
+			sizeof(stream->packet_context_pos));
+		BT_LOGV_STR("Serializing packet context field.");
+		ret = bt_ctf_field_serialize(stream->packet_context,
+			&stream->pos, native_byte_order);
+		if (ret) {
+			BT_LOGW("Cannot serialize stream's packet context field: "
+				"field-addr=%p", stream->packet_context);
+			goto error;
+		}
+	}
+
+	stream->packet_payload_offset = stream->pos.offset;
+	stream->packet_is_open = true;
+	goto end;
+
+error:
+	/* Map the next packet at the same place */
+	stream->pos.packet_size = 0;
+
+end:
+	return ret;
+}
+
+static
+int serialize_event(struct bt_ctf_stream *stream, struct bt_ctf_event *event,
+		enum bt_ctf_byte_order native_byte_order)
+{
+	int ret;
+
+	/* Write event header */
+	BT_LOGV_STR("Serializing event's header field.");
+	ret = bt_ctf_field_serialize(event->event_header,
+		&stream->pos, native_byte_order);
+	if (ret) {
+		BT_LOGW("Cannot serialize event's header field: "
+			"field-addr=%p", event->event_header);
+		goto end;
+	}
+
+	/* Write stream event context */
+	if (event->stream_event_context) {
+		BT_LOGV_STR("Serializing event's stream event context field.");
+		ret = bt_ctf_field_serialize(
+			event->stream_event_context, &stream->pos,
+			native_byte_order);
+		if (ret) {
+			BT_LOGW("Cannot serialize event's stream event context field: "
+				"field-addr=%p", event->stream_event_context);
+			goto end;
+		}
+	}
+
+	/* Write event content */
+	ret = bt_ctf_event_serialize(event, &stream->pos,
+		native_byte_order);
+	if (ret) {
+		/* bt_ctf_event_serialize() logs errors */
+		goto end;
+	}
+
+end:
+	return ret;
+}
+
+/*
+ * Serializes an appended event to the stream's current packet, opening
+ * the packet first if needed (serialize-on-append mode).
+ */
+static
+int serialize_appended_event(struct bt_ctf_stream *stream,
+		struct bt_ctf_event *event)
+{
+	int ret = 0;
+	uint64_t ts = 0;
+	uint64_t prev_timestamp_end = stream->packet_timestamp_end;
+	int64_t event_offset;
+	struct bt_ctf_trace *trace;
+
+	if (stream->stream_class->clock) {
+		ret = get_event_header_timestamp(stream, event->event_header,
+			&ts);
+		if (ret) {
+			BT_LOGW("Cannot get event's timestamp: "
+				"event-header-field-addr=%p",
+				event->event_header);
+			goto end;
+		}
+	}
+
+	/*
+	 * Update the packet's timestamps and event count first: they
+	 * are used to populate the packet context when opening a packet.
+	 */
+	if (stream->packet_event_count == 0) {
+		stream->packet_timestamp_begin = ts;
+	}
+
+	stream->packet_timestamp_end = ts;
+	stream->packet_event_count++;
+
+	if (!stream->packet_is_open) {
+		ret = open_packet(stream);
+		if (ret) {
+			/* open_packet() logs errors */
+			goto error;
+		}
+	}
+
+	BT_LOGV("Serializing appended event: event-addr=%p, "
+		"pos-offset=%" PRId64 ", packet-size=%" PRIu64,
+		event, stream->pos.offset, stream->pos.packet_size);
+	trace = bt_ctf_stream_class_borrow_trace(stream->stream_class);
+	assert(trace);
+	event_offset = stream->pos.offset;
+	ret = serialize_event(stream, event,
+		bt_ctf_trace_get_native_byte_order(trace));
+	if (ret) {
+		if (!stream->pos.buffered && !stream->pos.base_mma) {
+			/*
+			 * The packet could not grow and could not be
+			 * mapped again: drop it, counting its events as
+			 * discarded in the next packet, and map the next
+			 * packet at the same place.
+			 */
+			BT_LOGE("Dropping stream's current packet: "
+				"stream-addr=%p, stream-name=\"%s\", "
+				"event-count=%" PRIu64,
+				stream, bt_ctf_stream_get_name(stream),
+				stream->packet_event_count - 1);
+			stream->discarded_events +=
+				stream->packet_event_count - 1;
+			stream->packet_is_open = false;
+			stream->pos.packet_size = 0;
+			stream->packet_event_count = 0;
+			goto end;
+		}
+
+		/*
+		 * Overwrite what was serialized with the next event. The
+		 * packet keeps the events which were appended before: the
+		 * caller can flush it and append this event again.
+		 */
+		stream->pos.offset = event_offset;
+		goto error;
+	}
+
+	goto end;
+
+error:
+	stream->packet_event_count--;
+	stream->packet_timestamp_end = prev_timestamp_end;
+
+end:
+	return ret;
+}
+
 int bt_ctf_stream_append_event(struct bt_ctf_stream *stream,
 		struct bt_ctf_event *event)
 {
@@ -1257,10 +1631,20 @@ int bt_ctf_stream_append_event(struct bt_ctf_stream *stream,
 		goto error;
 	}
 
+	if (stream->serialize_on_append) {
+		ret = serialize_appended_event(stream, event);
+		if (ret) {
+			goto error;
+		}
+	}
+
 	/* Save the new event and freeze it */
 	BT_LOGV_STR("Freezing the event to append.");
 	bt_ctf_event_freeze(event);
-	g_ptr_array_add(stream->events, event);
+
+	if (!stream->serialize_on_append) {
+		g_ptr_array_add(stream->events, event);
+	}
 
 	/*
 	 * Event had to hold a reference to its event class as long as it wasn't
@@ -1277,6 +1661,11 @@ int bt_ctf_stream_append_event(struct bt_ctf_stream *stream,
 		bt_ctf_event_class_get_name(bt_ctf_event_borrow_event_class(event)),
 		bt_ctf_event_class_get_id(bt_ctf_event_borrow_event_class(event)));
 
+	if (stream->serialize_on_append) {
+		/* The event is serialized: the stream doesn't need it anymore */
+		release_event(event);
+	}
+
 end:
 	return ret;
 
@@ -1456,11 +1845,82 @@ void reset_structure_field(struct bt_ctf_field *structure, const char *name)
 	bt_put(member);
 }
 
+static
+uint64_t get_packet_context_field_value(struct bt_ctf_stream *stream,
+		const char *name, uint64_t default_value)
+{
+	struct bt_ctf_field *field = NULL;
+	uint64_t value = default_value;
+
+	if (!stream->packet_context) {
+		goto end;
+	}
+
+	field = bt_ctf_field_structure_get_field(stream->packet_context, name);
+	if (!field || !bt_ctf_field_type_is_integer(field->type)) {
+		goto end;
+	}
+
+	if (bt_ctf_field_unsigned_integer_get_value(field, &value)) {
+		value = default_value;
+	}
+
+end:
+	bt_put(field);
+	return value;
+}
+
+/*
+ * Appends the index entry of the packet which was just written to the
+ * stream's index file, if any.
+ */
+static
+void write_packet_index_entry(struct bt_ctf_stream *stream)
+{
+	struct ctf_packet_index entry;
+	int64_t stream_class_id;
+
+	if (stream->index_fd < 0) {
+		return;
+	}
+
+	stream_class_id = bt_ctf_stream_class_get_id(stream->stream_class);
+	entry.offset = htobe64(stream->size);
+	entry.packet_size = htobe64(stream->pos.packet_size);
+	entry.content_size = htobe64((uint64_t) stream->pos.offset);
+	entry.timestamp_begin = htobe64(get_packet_context_field_value(stream,
+		"timestamp_begin", 0));
+	entry.timestamp_end = htobe64(get_packet_context_field_value(stream,
+		"timestamp_end", 0));
+	entry.events_discarded = htobe64(get_packet_context_field_value(stream,
+		"events_discarded", stream->discarded_events));
+	entry.stream_id = htobe64((uint64_t) stream_class_id);
+	entry.stream_instance_id = htobe64((uint64_t) stream->id);
+	entry.packet_seq_num = htobe64(get_packet_context_field_value(stream,
+		"packet_seq_num", stream->flushed_packet_count));
+
+	if (write_all(stream->index_fd, &entry, sizeof(entry))) {
+		/* Readers reject an index which doesn't cover the stream */
+		BT_LOGW("Failed to write packet index entry: %s: "
+			"stream-addr=%p, stream-name=\"%s\", fd=%d, errno=%d",
+			strerror(errno), stream, bt_ctf_stream_get_name(stream),
+			stream->index_fd, errno);
+		(void) close(stream->index_fd);
+		stream->index_fd = -1;
+		return;
+	}
+
+	BT_LOGV("Wrote packet index entry: stream-addr=%p, "
+		"stream-name=\"%s\", offset=%" PRIu64 ", "
+		"packet-size=%" PRIu64 ", content-size=%" PRId64,
+		stream, bt_ctf_stream_get_name(stream), stream->size,
+		stream->pos.packet_size, stream->pos.offset);
+}
+
 int bt_ctf_stream_flush(struct bt_ctf_stream *stream)
 {
 	int ret = 0;
 	size_t i;
-	struct bt_ctf_stream_pos packet_context_pos;
 	struct bt_ctf_trace *trace;
 	enum bt_ctf_byte_order native_byte_order;
 
@@ -1502,48 +1962,15 @@ int bt_ctf_stream_flush(struct bt_ctf_stream *stream)
 	assert(trace);
 	native_byte_order = bt_ctf_trace_get_native_byte_order(trace);
 
-	ret = auto_populate_packet_header(stream);
-	if (ret) {
-		BT_LOGW_STR("Cannot automatically populate the stream's packet header field.");
-		ret = -1;
-		goto end;
-	}
-
-	ret = auto_populate_packet_context(stream);
-	if (ret) {
-		BT_LOGW_STR("Cannot automatically populate the stream's packet context field.");
-		ret = -1;
-		goto end;
-	}
-
-	/* mmap the next packet */
-	BT_LOGV("Seeking to the next packet: pos-offset=%" PRId64,
-		stream->pos.offset);
-	bt_ctf_stream_pos_packet_seek(&stream->pos, 0, SEEK_CUR);
-	assert(stream->pos.packet_size % 8 == 0);
-
-	if (stream->packet_header) {
-		BT_LOGV_STR("Serializing packet header field.");
-		ret = bt_ctf_field_serialize(stream->packet_header, &stream->pos,
-			native_byte_order);
+	if (!stream->packet_is_open) {
+		ret = open_packet(stream);
 		if (ret) {
-			BT_LOGW("Cannot serialize stream's packet header field: "
-				"field-addr=%p", stream->packet_header);
-			goto end;
-		}
-	}
-
-	if (stream->packet_context) {
-		/* Write packet context */
-		memcpy(&packet_context_pos, &stream->pos,
-			sizeof(packet_context_pos));
-		BT_LOGV_STR("Serializing packet context field.");
-		ret = bt_ctf_field_serialize(stream->packet_context,
-			&stream->pos, native_byte_order);
-		if (ret) {
-			BT_LOGW("Cannot serialize stream's packet context field: "
-				"field-addr=%p", stream->packet_context);
-			goto end;
+			/*
+			 * open_packet() logs errors and positions the
+			 * stream so that the next packet is mapped at the
+			 * right place.
+			 */
+			goto reset;
 		}
 	}
 
@@ -1561,36 +1988,10 @@ int bt_ctf_stream_flush(struct bt_ctf_stream *stream)
 			i, event, bt_ctf_event_class_get_name(event_class),
 			bt_ctf_event_class_get_id(event_class),
 			stream->pos.offset, stream->pos.packet_size);
-
-		/* Write event header */
-		BT_LOGV_STR("Serializing event's header field.");
-		ret = bt_ctf_field_serialize(event->event_header,
-			&stream->pos, native_byte_order);
-		if (ret) {
-			BT_LOGW("Cannot serialize event's header field: "
-				"field-addr=%p", event->event_header);
-			goto end;
-		}
-
-		/* Write stream event context */
-		if (event->stream_event_context) {
-			BT_LOGV_STR("Serializing event's stream event context field.");
-			ret = bt_ctf_field_serialize(
-				event->stream_event_context, &stream->pos,
-				native_byte_order);
-			if (ret) {
-				BT_LOGW("Cannot serialize event's stream event context field: "
-					"field-addr=%p", event->stream_event_context);
-				goto end;
-			}
-		}
-
-		/* Write event content */
-		ret = bt_ctf_event_serialize(event, &stream->pos,
-			native_byte_order);
+		ret = serialize_event(stream, event, native_byte_order);
 		if (ret) {
-			/* bt_ctf_event_serialize() logs errors */
-			goto end;
+			/* serialize_event() logs errors */
+			goto error;
 		}
 	}
 
@@ -1615,7 +2016,7 @@ int bt_ctf_stream_flush(struct bt_ctf_stream *stream)
 					stream->pos.offset,
 					stream->pos.packet_size);
 				ret = -1;
-				goto end;
+				goto error;
 			}
 		}
 
@@ -1624,31 +2025,75 @@ int bt_ctf_stream_flush(struct bt_ctf_stream *stream)
 		 * position's packet and content sizes have the correct
 		 * values.
 		 *
-		 * Copy base_mma as the packet may have been remapped
-		 * (e.g. when a packet is resized).
+		 * Copy base_mma and buf as the packet may have been
+		 * remapped (e.g. when a packet is resized).
 		 */
-		packet_context_pos.base_mma = stream->pos.base_mma;
+		stream->packet_context_pos.base_mma = stream->pos.base_mma;
+		stream->packet_context_pos.buf = stream->pos.buf;
 		ret = auto_populate_packet_context(stream);
 		if (ret) {
 			BT_LOGW_STR("Cannot automatically populate the stream's packet context field.");
 			ret = -1;
-			goto end;
+			goto error;
 		}
 
 		BT_LOGV("Rewriting (serializing) packet context field.");
 		ret = bt_ctf_field_serialize(stream->packet_context,
-			&packet_context_pos, native_byte_order);
+			&stream->packet_context_pos, native_byte_order);
 		if (ret) {
 			BT_LOGW("Cannot serialize stream's packet context field: "
 				"field-addr=%p", stream->packet_context);
-			goto end;
+			goto error;
+		}
+
+		/*
+		 * In serialize-on-append mode, the packet context could
+		 * have been replaced or modified since the packet was
+		 * opened: it must not overwrite the first event.
+		 */
+		if (stream->packet_context_pos.offset !=
+				stream->packet_payload_offset) {
+			BT_LOGW("Stream's packet context field's size changed since the packet was opened: "
+				"field-addr=%p, expected-end-offset=%" PRId64 ", "
+				"end-offset=%" PRId64,
+				stream->packet_context,
+				stream->packet_payload_offset,
+				stream->packet_context_pos.offset);
+			ret = -1;
+			goto error;
 		}
 	}
 
+	ret = bt_ctf_stream_pos_packet_commit(&stream->pos);
+	if (ret) {
+		BT_LOGW("Cannot write the stream's packet: "
+			"stream-addr=%p, stream-name=\"%s\"",
+			stream, bt_ctf_stream_get_name(stream));
+		goto error;
+	}
+
+	write_packet_index_entry(stream);
 	g_ptr_array_set_size(stream->events, 0);
 	stream->flushed_packet_count++;
 	stream->size += stream->pos.packet_size / CHAR_BIT;
-end:
+	BT_LOGV("Flushed stream's current packet: content-size=%" PRId64 ", "
+		"packet-size=%" PRIu64,
+		stream->pos.offset, stream->pos.packet_size);
+	goto reset;
+
+error:
+	/*
+	 * We failed to write the opened packet. Its size is therefore
+	 * set to 0 to ensure the next mapping is done in the same place
+	 * rather than advancing by "stream->pos.packet_size", which
+	 * would leave a corrupted packet in the trace.
+	 */
+	stream->pos.packet_size = 0;
+
+reset:
+	stream->packet_is_open = false;
+	stream->packet_event_count = 0;
+
 	/* Reset automatically-set fields. */
 	reset_structure_field(stream->packet_context, "timestamp_begin");
 	reset_structure_field(stream->packet_context, "timestamp_end");
@@ -1656,19 +2101,91 @@ end:
 	reset_structure_field(stream->packet_context, "content_size");
 	reset_structure_field(stream->packet_context, "events_discarded");
 
-	if (ret < 0) {
-		/*
-		 * We failed to write the packet. Its size is therefore set to 0
-		 * to ensure the next mapping is done in the same place rather
-		 * than advancing by "stream->pos.packet_size", which would
-		 * leave a corrupted packet in the trace.
-		 */
-		stream->pos.packet_size = 0;
-	} else {
-		BT_LOGV("Flushed stream's current packet: content-size=%" PRId64 ", "
-			"packet-size=%" PRIu64,
-			stream->pos.offset, stream->pos.packet_size);
+end:
+	return ret;
+}
+
+int bt_ctf_stream_set_serialize_on_append(struct bt_ctf_stream *stream,
+		int serialize_on_append)
+{
+	int ret = 0;
+
+	if (!stream) {
+		BT_LOGW_STR("Invalid parameter: stream is NULL.");
+		ret = -1;
+		goto end;
 	}
+
+	if (stream->pos.fd < 0) {
+		BT_LOGW_STR("Invalid parameter: stream is not a CTF writer stream.");
+		ret = -1;
+		goto end;
+	}
+
+	if (stream->packet_is_open || stream->events->len > 0) {
+		BT_LOGW("Invalid parameter: stream's current packet is not empty: "
+			"stream-addr=%p, stream-name=\"%s\"",
+			stream, bt_ctf_stream_get_name(stream));
+		ret = -1;
+		goto end;
+	}
+
+	stream->serialize_on_append = (bool) serialize_on_append;
+	BT_LOGV("Set stream's serialize-on-append mode: "
+		"stream-addr=%p, stream-name=\"%s\", serialize-on-append=%d",
+		stream, bt_ctf_stream_get_name(stream), serialize_on_append);
+
+end:
+	return ret;
+}
+
+int bt_ctf_stream_set_packet_allocation(struct bt_ctf_stream *stream,
+		uint64_t packet_size, uint64_t preallocation_size,
+		int buffered)
+{
+	int ret = 0;
+
+	if (!stream) {
+		BT_LOGW_STR("Invalid parameter: stream is NULL.");
+		ret = -1;
+		goto end;
+	}
+
+	if (stream->pos.fd < 0) {
+		BT_LOGW_STR("Invalid parameter: stream is not a CTF writer stream.");
+		ret = -1;
+		goto end;
+	}
+
+	if (packet_size == 0 || packet_size > UINT64_MAX / CHAR_BIT ||
+			preallocation_size > (uint64_t) INT64_MAX) {
+		BT_LOGW("Invalid parameter: invalid packet or preallocation size: "
+			"stream-addr=%p, stream-name=\"%s\", "
+			"packet-size=%" PRIu64 ", preallocation-size=%" PRIu64,
+			stream, bt_ctf_stream_get_name(stream),
+			packet_size, preallocation_size);
+		ret = -1;
+		goto end;
+	}
+
+	if (stream->packet_is_open || stream->events->len > 0) {
+		BT_LOGW("Invalid parameter: stream's current packet is not empty: "
+			"stream-addr=%p, stream-name=\"%s\"",
+			stream, bt_ctf_stream_get_name(stream));
+		ret = -1;
+		goto end;
+	}
+
+	bt_ctf_stream_pos_set_packet_allocation(&stream->pos,
+		packet_size * CHAR_BIT, (off_t) preallocation_size,
+		(bool) buffered);
+	BT_LOGV("Set stream's packet allocation: "
+		"stream-addr=%p, stream-name=\"%s\", "
+		"packet-size=%" PRIu64 ", preallocation-size=%" PRIu64 ", "
+		"buffered=%d", stream, bt_ctf_stream_get_name(stream),
+		packet_size, preallocation_size, buffered);
+
+end:
 	return ret;
 }
 
@@ -1731,6 +2248,13 @@ void bt_ctf_stream_destroy(struct bt_object *obj)
 		}
 	}
 
+	if (stream->index_fd >= 0) {
+		if (close(stream->index_fd)) {
+			BT_LOGE("Failed to close stream index file: %s: "
+				"errno=%d", strerror(errno), errno);
+		}
+	}
+
 	if (stream->events) {
 		BT_LOGD_STR("Putting events.");
 		g_ptr_array_free(stream->events, TRUE);
@@ -28,9 +28,16 @@
  * SOFTWARE.
  */
 
+#define BT_LOG_TAG "CTF-WRITER-SERIALIZE"
+#include <babeltrace/lib-logging-internal.h>
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <inttypes.h>
 #include <babeltrace/ctf-ir/field-types.h>
 #include <babeltrace/ctf-ir/field-types-internal.h>
 #include <babeltrace/ctf-ir/fields.h>
@@ -177,22 +184,18 @@ int integer_write(struct bt_ctf_stream_pos *pos, union intval value,
 
 	if (!is_signed) {
 		if (byte_order == BT_CTF_BYTE_ORDER_LITTLE_ENDIAN)
-			bt_bitfield_write_le(mmap_align_addr(pos->base_mma) +
-				pos->mmap_base_offset, unsigned char,
-				pos->offset, size, value.unsignd);
+			bt_bitfield_write_le(bt_ctf_stream_pos_get_base_addr(pos),
+				unsigned char, pos->offset, size, value.unsignd);
 		else
-			bt_bitfield_write_be(mmap_align_addr(pos->base_mma) +
-				pos->mmap_base_offset, unsigned char,
-				pos->offset, size, value.unsignd);
+			bt_bitfield_write_be(bt_ctf_stream_pos_get_base_addr(pos),
+				unsigned char, pos->offset, size, value.unsignd);
 	} else {
 		if (byte_order == BT_CTF_BYTE_ORDER_LITTLE_ENDIAN)
-			bt_bitfield_write_le(mmap_align_addr(pos->base_mma) +
-				pos->mmap_base_offset, unsigned char,
-				pos->offset, size, value.signd);
+			bt_bitfield_write_le(bt_ctf_stream_pos_get_base_addr(pos),
+				unsigned char, pos->offset, size, value.signd);
 		else
-			bt_bitfield_write_be(mmap_align_addr(pos->base_mma) +
-				pos->mmap_base_offset, unsigned char,
-				pos->offset, size, value.signd);
+			bt_bitfield_write_be(bt_ctf_stream_pos_get_base_addr(pos),
+				unsigned char, pos->offset, size, value.signd);
 	}
 
 	if (!bt_ctf_stream_pos_move(pos, size))
@@ -265,39 +268,226 @@ int bt_ctf_field_floating_point_write(
 		byte_order);
 }
 
-BT_HIDDEN
-void bt_ctf_stream_pos_packet_seek(struct bt_ctf_stream_pos *pos, size_t index,
-	int whence)
+/*
+ * Makes sure that the file space up to `end` bytes is allocated,
+ * preallocating at least `pos->prealloc_len` bytes at once.
+ */
+static
+int preallocate(struct bt_ctf_stream_pos *pos, off_t end)
 {
-	int ret;
+	int ret = 0;
+	off_t new_end = end;
 
-	assert(whence == SEEK_CUR && index == 0);
+	if (end <= pos->prealloc_end) {
+		goto end;
+	}
+
+	if (pos->prealloc_end + pos->prealloc_len > new_end) {
+		new_end = pos->prealloc_end + pos->prealloc_len;
+	}
+
+	do {
+		ret = bt_posix_fallocate(pos->fd, pos->prealloc_end,
+			new_end - pos->prealloc_end);
+	} while (ret == EINTR);
+	if (ret) {
+		BT_LOGE("Failed to preallocate file space: %s: fd=%d, "
+			"offset=%jd, len=%jd", strerror(ret), pos->fd,
+			(intmax_t) pos->prealloc_end,
+			(intmax_t) (new_end - pos->prealloc_end));
+		ret = -1;
+		goto end;
+	}
+
+	BT_LOGV("Preallocated file space: fd=%d, offset=%jd, len=%jd",
+		pos->fd, (intmax_t) pos->prealloc_end,
+		(intmax_t) (new_end - pos->prealloc_end));
+	pos->prealloc_end = new_end;
+
+end:
+	return ret;
+}
+
+static
+int unmap_packet(struct bt_ctf_stream_pos *pos)
+{
+	int ret = 0;
 
 	if (pos->base_mma) {
-		/* unmap old base */
 		ret = munmap_align(pos->base_mma);
+		pos->base_mma = NULL;
 		if (ret) {
-			// FIXME: this can legitimately fail?
-			abort();
+			BT_LOGE("Failed to perform an aligned memory unmapping: "
+				"%s: ret=%d, errno=%d", strerror(errno), ret,
+				errno);
+			ret = -1;
 		}
+	}
+
+	if (pos->buf && !pos->buffered) {
+		g_free(pos->buf);
+		pos->buf = NULL;
+		pos->buf_len = 0;
+	}
+
+	return ret;
+}
+
+/*
+ * Maps (or, in buffered mode, allocates) the current packet once
+ * `pos->packet_size` is set. The first `old_len` bytes of the
+ * packet's buffer are kept.
+ */
+static
+int map_packet(struct bt_ctf_stream_pos *pos, size_t old_len)
+{
+	int ret;
+	size_t len = pos->packet_size / CHAR_BIT;
+
+	ret = preallocate(pos, pos->mmap_offset + (off_t) len);
+	if (ret) {
+		goto end;
+	}
+
+	if (pos->buffered) {
+		if (len > pos->buf_len) {
+			pos->buf = g_realloc(pos->buf, len);
+			pos->buf_len = len;
+		}
+
+		/* The padding of a packet is made of zeros */
+		memset(pos->buf + old_len, 0, len - old_len);
+		goto end;
+	}
+
+	pos->base_mma = mmap_align(len, pos->prot, pos->flags, pos->fd,
+		pos->mmap_offset);
+	if (pos->base_mma == MAP_FAILED) {
+		BT_LOGE("Failed to perform an aligned memory mapping: %s: "
+			"fd=%d, offset=%jd, len=%zu", strerror(errno),
+			pos->fd, (intmax_t) pos->mmap_offset, len);
 		pos->base_mma = NULL;
+		ret = -1;
+	}
+
+end:
+	return ret;
+}
+
+BT_HIDDEN
+int bt_ctf_stream_pos_packet_seek(struct bt_ctf_stream_pos *pos, size_t index,
+	int whence)
+{
+	int ret;
+
+	assert(whence == SEEK_CUR && index == 0);
+
+	ret = unmap_packet(pos);
+	if (ret) {
+		/*
+		 * Keep the position: the current packet is written,
+		 * so that the next seek must still map the next packet
+		 * after it.
+		 */
+		goto end;
 	}
 
 	/* The writer will add padding */
 	pos->mmap_offset += pos->packet_size / CHAR_BIT;
-	pos->packet_size = PACKET_LEN_INCREMENT;
-	do {
-		ret = bt_posix_fallocate(pos->fd, pos->mmap_offset,
-			pos->packet_size / CHAR_BIT);
-	} while (ret == EINTR);
-	assert(ret == 0);
+	pos->packet_size = pos->packet_len_increment;
 	pos->offset = 0;
+	ret = map_packet(pos, 0);
+	if (ret) {
+		goto error;
+	}
 
-	/* map new base. Need mapping length from header. */
-	pos->base_mma = mmap_align(pos->packet_size / CHAR_BIT, pos->prot,
-		pos->flags, pos->fd, pos->mmap_offset);
-	if (pos->base_mma == MAP_FAILED) {
-		// FIXME: this can legitimately fail?
-		abort();
+	goto end;
+
+error:
+	/* Retry at the same offset */
+	pos->packet_size = 0;
+
+end:
+	return ret;
+}
+
+BT_HIDDEN
+int bt_ctf_stream_pos_increase_packet_size(struct bt_ctf_stream_pos *pos)
+{
+	int ret = 0;
+	size_t old_len = pos->packet_size / CHAR_BIT;
+
+	BT_LOGV("Increasing packet size: pos-offset=%" PRId64 ", "
+		"cur-packet-size=%" PRIu64,
+		pos->offset, pos->packet_size);
+
+	if (!pos->buffered) {
+		ret = unmap_packet(pos);
+		if (ret) {
+			goto error;
+		}
+	}
+
+	pos->packet_size += pos->packet_len_increment;
+	ret = map_packet(pos, old_len);
+	if (ret) {
+		goto error;
+	}
+
+	BT_LOGV("Increased packet size: pos-offset=%" PRId64 ", "
+		"new-packet-size=%" PRIu64,
+		pos->offset, pos->packet_size);
+	assert(pos->packet_size % 8 == 0);
+	goto end;
+
+error:
+	/*
+	 * Map the packet again with its previous size so that what is
+	 * already serialized can still be written. The packet is not
+	 * mapped anymore if this fails too.
+	 */
+	pos->packet_size = old_len * CHAR_BIT;
+
+	if (!pos->buffered && !pos->base_mma) {
+		(void) map_packet(pos, old_len);
 	}
+
+end:
+	return ret;
+}
+
+BT_HIDDEN
+int bt_ctf_stream_pos_packet_commit(struct bt_ctf_stream_pos *pos)
+{
+	int ret = 0;
+	size_t len = pos->packet_size / CHAR_BIT;
+	size_t written = 0;
+
+	if (!pos->buffered) {
+		goto end;
+	}
+
+	assert(pos->buf);
+
+	while (written < len) {
+		ssize_t write_ret = pwrite(pos->fd, pos->buf + written,
+			len - written, pos->mmap_offset + (off_t) written);
+
+		if (write_ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			BT_LOGE("Failed to write packet: %s: fd=%d, "
+				"offset=%jd, len=%zu", strerror(errno),
+				pos->fd, (intmax_t) pos->mmap_offset, len);
+			ret = -1;
+			goto end;
+		}
+
+		written += (size_t) write_ret;
+	}
+
+end:
+	return ret;
 }
@@ -57,6 +57,7 @@ void bt_clock_class_priority_map_destroy(struct bt_object *obj)
 		g_hash_table_destroy(cc_prio_map->prios);
 	}
 
+	bt_object_pool_finalize(&cc_prio_map->event_notif_pool);
 	g_free(cc_prio_map);
 }
 
@@ -87,6 +88,13 @@ struct bt_clock_class_priority_map *bt_clock_class_priority_map_create()
 		goto error;
 	}
 
+	/* Recycled event notifications hold no references */
+	if (bt_object_pool_initialize(&cc_prio_map->event_notif_pool,
+			g_free)) {
+		BT_LOGE_STR("Failed to initialize event notification pool.");
+		goto error;
+	}
+
 	BT_LOGD("Created clock class priority map object: addr=%p",
 		cc_prio_map);
 	goto end;
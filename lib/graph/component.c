@@ -85,7 +85,7 @@ void bt_component_destroy(struct bt_object *obj)
 	 * bt_put(): the reference count would go from 1 to 0 again and
 	 * this function would be called again.
 	 */
-	obj->ref_count.count++;
+	(void) bt_ref_get(&obj->ref_count);
 	component = container_of(obj, struct bt_component, base);
 	BT_LOGD("Destroying component: addr=%p, name=\"%s\", graph-addr=%p",
 		component, bt_component_get_name(component),
@@ -267,6 +267,7 @@ enum bt_component_status bt_component_create(
 	bt_object_init(component, bt_component_destroy);
 	component->class = bt_get(component_class);
 	component->destroy = component_destroy_funcs[type];
+	component->poll_fd = -1;
 	component->name = g_string_new(name);
 	if (!component->name) {
 		BT_LOGE_STR("Failed to allocate one GString.");
@@ -362,6 +363,28 @@ end:
 	return ret;
 }
 
+enum bt_component_status bt_private_component_set_poll_fd(
+		struct bt_private_component *private_component, int fd)
+{
+	struct bt_component *component =
+		bt_component_from_private(private_component);
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+
+	if (!component) {
+		BT_LOGW_STR("Invalid parameter: component is NULL.");
+		ret = BT_COMPONENT_STATUS_INVALID;
+		goto end;
+	}
+
+	component->poll_fd = fd < 0 ? -1 : fd;
+	BT_LOGV("Set component's poll file descriptor: "
+		"comp-addr=%p, comp-name=\"%s\", fd=%d",
+		component, bt_component_get_name(component), fd);
+
+end:
+	return ret;
+}
+
 BT_HIDDEN
 void bt_component_set_graph(struct bt_component *component,
 		struct bt_graph *graph)
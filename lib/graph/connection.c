@@ -80,7 +80,7 @@ void bt_connection_try_remove_from_graph(struct bt_connection *connection)
 {
 	void *graph = bt_object_borrow_parent(&connection->base);
 
-	if (connection->base.ref_count.count > 0 ||
+	if (bt_object_get_ref_count(&connection->base) > 0 ||
 			connection->downstream_port ||
 			connection->upstream_port ||
 			connection->iterators->len > 0) {
@@ -40,6 +40,9 @@
 #include <babeltrace/values.h>
 #include <babeltrace/values-internal.h>
 #include <unistd.h>
+#include <poll.h>
+#include <limits.h>
+#include <errno.h>
 #include <glib.h>
 
 struct bt_graph_listener {
@@ -80,7 +83,7 @@ void bt_graph_destroy(struct bt_object *obj)
 	 * ensures that this function is not called two times.
 	 */
 	BT_LOGD("Destroying graph: addr=%p", graph);
-	obj->ref_count.count++;
+	(void) bt_ref_get(&obj->ref_count);
 
 	/*
 	 * Cancel the graph to disallow some operations, like creating
@@ -529,6 +532,77 @@ end:
 	return status;
 }
 
+enum bt_graph_status bt_graph_wait(struct bt_graph *graph,
+		int64_t timeout_us)
+{
+	enum bt_graph_status status = BT_GRAPH_STATUS_OK;
+	struct pollfd *fds = NULL;
+	nfds_t nfds = 0;
+	int timeout_ms;
+	int ret;
+	guint i;
+
+	if (!graph) {
+		BT_LOGW_STR("Invalid parameter: graph is NULL.");
+		status = BT_GRAPH_STATUS_INVALID;
+		goto end;
+	}
+
+	if (graph->canceled) {
+		status = BT_GRAPH_STATUS_CANCELED;
+		goto end;
+	}
+
+	fds = g_new0(struct pollfd, graph->components->len);
+	for (i = 0; i < graph->components->len; i++) {
+		struct bt_component *comp =
+			g_ptr_array_index(graph->components, i);
+
+		if (comp->poll_fd < 0) {
+			continue;
+		}
+
+		fds[nfds].fd = comp->poll_fd;
+		fds[nfds].events = POLLIN;
+		nfds++;
+	}
+
+	if (timeout_us < 0) {
+		timeout_ms = -1;
+	} else if (timeout_us >= (int64_t) INT_MAX * 1000) {
+		timeout_ms = INT_MAX;
+	} else {
+		/* Round up: never return before the timeout. */
+		timeout_ms = (int) ((timeout_us + 999) / 1000);
+	}
+
+	BT_LOGV("Waiting for graph's components: addr=%p, fd-count=%u, "
+		"timeout-ms=%d", graph, (unsigned int) nfds, timeout_ms);
+	ret = poll(fds, nfds, timeout_ms);
+	if (ret < 0) {
+		if (errno != EINTR) {
+			BT_LOGE("Cannot poll components' file descriptors: "
+				"addr=%p, errno=%d", graph, errno);
+			status = BT_GRAPH_STATUS_ERROR;
+			goto end;
+		}
+
+		/* Interrupted by a signal, possibly the one canceling the graph. */
+		status = BT_GRAPH_STATUS_AGAIN;
+	} else if (ret == 0) {
+		status = BT_GRAPH_STATUS_AGAIN;
+	}
+
+	if (graph->canceled) {
+		BT_LOGD("Graph was canceled while waiting: addr=%p", graph);
+		status = BT_GRAPH_STATUS_CANCELED;
+	}
+
+end:
+	g_free(fds);
+	return status;
+}
+
 static
 int add_listener(GArray *listeners, void *func, void *data)
 {
@@ -51,8 +51,16 @@
 #include <babeltrace/graph/port.h>
 #include <babeltrace/types.h>
 #include <stdint.h>
+#include <pthread.h>
+#include <inttypes.h>
 #include <stdlib.h>
 
+/*
+ * Maximum number of notifications to get from the upstream component
+ * at once when the iterator's queue is empty.
+ */
+#define NOTIF_BATCH_CAPACITY	64
+
 struct stream_state {
 	struct bt_ctf_stream *stream; /* owned by this */
 	struct bt_ctf_packet *cur_packet; /* owned by this */
@@ -106,8 +114,44 @@ void stream_destroy_listener(struct bt_ctf_stream *stream, void *data)
 {
 	struct bt_notification_iterator *iterator = data;
 
-	/* Remove associated stream state */
-	g_hash_table_remove(iterator->stream_states, stream);
+	/*
+	 * This can be called by any thread: defer the removal of the
+	 * associated stream state to the thread which uses the
+	 * iterator (see remove_destroyed_stream_states()).
+	 */
+	pthread_mutex_lock(&iterator->destroyed_streams_lock);
+	g_ptr_array_add(iterator->destroyed_streams, stream);
+	__atomic_store_n(&iterator->has_destroyed_streams, true,
+		__ATOMIC_RELEASE);
+	pthread_mutex_unlock(&iterator->destroyed_streams_lock);
+}
+
+/*
+ * Removes the states of the streams which were destroyed since the last
+ * call. This must be called before looking up a stream state, because
+ * a new stream could be allocated at the address of a destroyed one.
+ */
+static inline
+void remove_destroyed_stream_states(struct bt_notification_iterator *iterator)
+{
+	guint i;
+
+	if (likely(!__atomic_load_n(&iterator->has_destroyed_streams,
+			__ATOMIC_ACQUIRE))) {
+		return;
+	}
+
+	pthread_mutex_lock(&iterator->destroyed_streams_lock);
+
+	for (i = 0; i < iterator->destroyed_streams->len; i++) {
+		g_hash_table_remove(iterator->stream_states,
+			iterator->destroyed_streams->pdata[i]);
+	}
+
+	g_ptr_array_set_size(iterator->destroyed_streams, 0);
+	__atomic_store_n(&iterator->has_destroyed_streams, false,
+		__ATOMIC_RELAXED);
+	pthread_mutex_unlock(&iterator->destroyed_streams_lock);
 }
 
 static
@@ -254,6 +298,13 @@ void apply_actions(struct bt_notification_iterator *iterator)
 			bt_ctf_stream_add_destroy_listener(
 				action->payload.set_stream_state_is_ended.stream_state->stream,
 				stream_destroy_listener, iterator);
+
+			/* An ended stream state can be removed at any time */
+			if (iterator->last_event_stream_state ==
+					action->payload.set_stream_state_is_ended.stream_state) {
+				iterator->last_event_stream_state = NULL;
+			}
+
 			action->payload.set_stream_state_is_ended.stream_state->is_ended = BT_TRUE;
 			BT_PUT(action->payload.set_stream_state_is_ended.stream_state->stream);
 			break;
@@ -314,7 +365,7 @@ void bt_notification_iterator_destroy(struct bt_object *obj)
 	 * reference count would go from 1 to 0 again and this function
 	 * would be called again.
 	 */
-	obj->ref_count.count++;
+	(void) bt_ref_get(&obj->ref_count);
 	iterator = container_of(obj, struct bt_notification_iterator, base);
 	BT_LOGD("Destroying notification iterator object: addr=%p",
 		iterator);
@@ -342,6 +393,10 @@ void bt_notification_iterator_destroy(struct bt_object *obj)
 		GHashTableIter ht_iter;
 		gpointer stream_gptr, stream_state_gptr;
 
+		if (iterator->destroyed_streams) {
+			remove_destroyed_stream_states(iterator);
+		}
+
 		g_hash_table_iter_init(&ht_iter, iterator->stream_states);
 
 		while (g_hash_table_iter_next(&ht_iter, &stream_gptr, &stream_state_gptr)) {
@@ -356,6 +411,12 @@ void bt_notification_iterator_destroy(struct bt_object *obj)
 		g_hash_table_destroy(iterator->stream_states);
 	}
 
+	if (iterator->destroyed_streams) {
+		g_ptr_array_free(iterator->destroyed_streams, TRUE);
+		(void) pthread_mutex_destroy(
+			&iterator->destroyed_streams_lock);
+	}
+
 	if (iterator->actions) {
 		g_array_free(iterator->actions, TRUE);
 	}
@@ -564,6 +625,21 @@ enum bt_connection_status bt_notification_iterator_create(
 		goto end;
 	}
 
+	iterator->destroyed_streams = g_ptr_array_new();
+	if (!iterator->destroyed_streams) {
+		BT_LOGE_STR("Failed to allocate a GPtrArray.");
+		status = BT_CONNECTION_STATUS_NOMEM;
+		goto end;
+	}
+
+	if (pthread_mutex_init(&iterator->destroyed_streams_lock, NULL)) {
+		BT_LOGE_STR("Failed to initialize a mutex.");
+		g_ptr_array_free(iterator->destroyed_streams, TRUE);
+		iterator->destroyed_streams = NULL;
+		status = BT_CONNECTION_STATUS_ERROR;
+		goto end;
+	}
+
 	iterator->queue = g_queue_new();
 	if (!iterator->queue) {
 		BT_LOGE_STR("Failed to allocate a GQueue.");
@@ -578,6 +654,34 @@ enum bt_connection_status bt_notification_iterator_create(
 		goto end;
 	}
 
+	switch (type) {
+	case BT_COMPONENT_CLASS_TYPE_SOURCE:
+	{
+		struct bt_component_class_source *source_class =
+			container_of(upstream_comp->class,
+				struct bt_component_class_source, parent);
+
+		iterator->next_method = source_class->methods.iterator.next;
+		iterator->next_batch_method =
+			source_class->methods.iterator.next_batch;
+		break;
+	}
+	case BT_COMPONENT_CLASS_TYPE_FILTER:
+	{
+		struct bt_component_class_filter *filter_class =
+			container_of(upstream_comp->class,
+				struct bt_component_class_filter, parent);
+
+		iterator->next_method = filter_class->methods.iterator.next;
+		iterator->next_batch_method =
+			filter_class->methods.iterator.next_batch;
+		break;
+	}
+	default:
+		abort();
+	}
+
+	assert(iterator->next_method);
 	iterator->upstream_component = upstream_comp;
 	iterator->upstream_port = upstream_port;
 	iterator->connection = connection;
@@ -1308,8 +1412,33 @@ int enqueue_notification_and_automatic(
 
 	assert(notif);
 
+	if (likely(notif->type == BT_NOTIFICATION_TYPE_EVENT &&
+			iterator->last_event_stream_state)) {
+		notif_event = bt_notification_event_borrow_event(notif);
+		assert(notif_event);
+
+		if (bt_ctf_event_borrow_packet(notif_event) ==
+				iterator->last_event_stream_state->cur_packet) {
+			/*
+			 * Same packet as the last validated event
+			 * notification: the stream is known, mapped to
+			 * our upstream port, and not ended, and there's
+			 * no automatic notification to generate.
+			 */
+			if (is_subscribed_to_notification_type(iterator,
+					BT_NOTIFICATION_TYPE_EVENT)) {
+				g_queue_push_head(iterator->queue,
+					bt_get(notif));
+				bt_notification_freeze(notif);
+			}
+
+			goto end;
+		}
+	}
+
 	BT_LOGV("Enqueuing user notification and automatic notifications: "
 		"iter-addr=%p, notif-addr=%p", iterator, notif);
+	remove_destroyed_stream_states(iterator);
 
 	// TODO: Skip most of this if the iterator is only subscribed
 	//       to event/inactivity notifications.
@@ -1405,6 +1534,13 @@ handle_notif:
 	}
 
 	apply_actions(iterator);
+
+	if (notif->type == BT_NOTIFICATION_TYPE_EVENT) {
+		iterator->last_event_stream_state = g_hash_table_lookup(
+			iterator->stream_states, notif_stream);
+		assert(iterator->last_event_stream_state);
+	}
+
 	BT_LOGV("Enqueued user notification and automatic notifications: "
 		"iter-addr=%p, notif-addr=%p", iterator, notif);
 	goto end;
@@ -1424,6 +1560,7 @@ int handle_end(struct bt_notification_iterator *iterator)
 	int ret = 0;
 
 	BT_LOGV("Handling end of iteration: addr=%p", iterator);
+	remove_destroyed_stream_states(iterator);
 
 	/*
 	 * Emit a "stream end" notification for each non-ended stream
@@ -1467,17 +1604,65 @@ end:
 	return ret;
 }
 
+/*
+ * Gets up to `capacity` notifications from the upstream component's
+ * "next" method, for a component class which has no "next batch"
+ * method.
+ */
 static
-enum bt_notification_iterator_status ensure_queue_has_notifications(
-		struct bt_notification_iterator *iterator)
+enum bt_notification_iterator_status next_batch_from_next_method(
+		struct bt_notification_iterator *iterator,
+		struct bt_notification **notifs, uint64_t capacity,
+		uint64_t *count)
 {
 	struct bt_private_notification_iterator *priv_iterator =
 		bt_private_notification_iterator_from_notification_iterator(iterator);
-	bt_component_class_notification_iterator_next_method next_method = NULL;
 	struct bt_notification_iterator_next_return next_return = {
 		.status = BT_NOTIFICATION_ITERATOR_STATUS_OK,
 		.notification = NULL,
 	};
+
+	*count = 0;
+
+	while (*count < capacity) {
+		next_return = iterator->next_method(priv_iterator);
+
+		/*
+		 * The returned notification is only valid with the
+		 * BT_NOTIFICATION_ITERATOR_STATUS_OK status: otherwise
+		 * this field could be garbage.
+		 */
+		if (next_return.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			break;
+		}
+
+		if (!next_return.notification) {
+			BT_LOGW_STR("User method returned BT_NOTIFICATION_ITERATOR_STATUS_OK, but notification is NULL.");
+			next_return.status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			break;
+		}
+
+		notifs[*count] = next_return.notification;
+		(*count)++;
+
+		if (iterator->state != BT_NOTIFICATION_ITERATOR_STATE_ACTIVE) {
+			/* The user's method cancelled its own iterator */
+			break;
+		}
+	}
+
+	return next_return.status;
+}
+
+static
+enum bt_notification_iterator_status ensure_queue_has_notifications(
+		struct bt_notification_iterator *iterator)
+{
+	struct bt_private_notification_iterator *priv_iterator =
+		bt_private_notification_iterator_from_notification_iterator(iterator);
+	struct bt_notification *notifs[NOTIF_BATCH_CAPACITY];
+	uint64_t count = 0;
+	uint64_t i = 0;
 	enum bt_notification_iterator_status status =
 		BT_NOTIFICATION_ITERATOR_STATUS_OK;
 	int ret;
@@ -1514,49 +1699,32 @@ enum bt_notification_iterator_status ensure_queue_has_notifications(
 		break;
 	}
 
-	assert(iterator->upstream_component);
-	assert(iterator->upstream_component->class);
-
-	/* Pick the appropriate "next" method */
-	switch (iterator->upstream_component->class->type) {
-	case BT_COMPONENT_CLASS_TYPE_SOURCE:
-	{
-		struct bt_component_class_source *source_class =
-			container_of(iterator->upstream_component->class,
-				struct bt_component_class_source, parent);
-
-		assert(source_class->methods.iterator.next);
-		next_method = source_class->methods.iterator.next;
-		break;
-	}
-	case BT_COMPONENT_CLASS_TYPE_FILTER:
-	{
-		struct bt_component_class_filter *filter_class =
-			container_of(iterator->upstream_component->class,
-				struct bt_component_class_filter, parent);
-
-		assert(filter_class->methods.iterator.next);
-		next_method = filter_class->methods.iterator.next;
-		break;
-	}
-	default:
-		abort();
-	}
+	assert(iterator->next_method);
 
 	/*
-	 * Call the user's "next" method to get the next notification
-	 * and status.
+	 * Call the user's "next batch" method, or its "next" method
+	 * repeatedly, to get the next notifications and status.
 	 */
-	assert(next_method);
-
 	while (iterator->queue->length == 0) {
-		BT_LOGD_STR("Calling user's \"next\" method.");
-		next_return = next_method(priv_iterator);
-		BT_LOGD("User method returned: status=%s",
-			bt_notification_iterator_status_string(next_return.status));
-		if (next_return.status < 0) {
+		count = 0;
+		i = 0;
+
+		if (iterator->next_batch_method) {
+			BT_LOGD_STR("Calling user's \"next batch\" method.");
+			status = iterator->next_batch_method(priv_iterator,
+				notifs, NOTIF_BATCH_CAPACITY, &count);
+		} else {
+			BT_LOGD_STR("Calling user's \"next\" method.");
+			status = next_batch_from_next_method(iterator, notifs,
+				NOTIF_BATCH_CAPACITY, &count);
+		}
+
+		BT_LOGD("User method returned: status=%s, count=%" PRIu64,
+			bt_notification_iterator_status_string(status), count);
+		assert(count <= NOTIF_BATCH_CAPACITY);
+
+		if (status < 0) {
 			BT_LOGW_STR("User method failed.");
-			status = next_return.status;
 			goto end;
 		}
 
@@ -1571,22 +1739,35 @@ enum bt_notification_iterator_status ensure_queue_has_notifications(
 			 * created. In this case, said connection is
 			 * ended, and all its notification iterators are
 			 * finalized.
-			 *
-			 * Only bt_put() the returned notification if
-			 * the status is
-			 * BT_NOTIFICATION_ITERATOR_STATUS_OK because
-			 * otherwise this field could be garbage.
 			 */
-			if (next_return.status ==
-					BT_NOTIFICATION_ITERATOR_STATUS_OK) {
-				bt_put(next_return.notification);
-			}
-
 			status = BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
 			goto end;
 		}
 
-		switch (next_return.status) {
+		/*
+		 * We know the notifications are valid. Before we push
+		 * each one to the head of the queue, push the
+		 * appropriate automatic notifications if any.
+		 */
+		for (i = 0; i < count; i++) {
+			if (!notifs[i]) {
+				BT_LOGW("User method returned a NULL notification: "
+					"index=%" PRIu64, i);
+				status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+				goto end;
+			}
+
+			ret = enqueue_notification_and_automatic(iterator,
+				notifs[i]);
+			BT_PUT(notifs[i]);
+			if (ret) {
+				BT_LOGW("Cannot enqueue notification and automatic notifications.");
+				status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+				goto end;
+			}
+		}
+
+		switch (status) {
 		case BT_NOTIFICATION_ITERATOR_STATUS_END:
 			ret = handle_end(iterator);
 			if (ret) {
@@ -1599,33 +1780,23 @@ enum bt_notification_iterator_status ensure_queue_has_notifications(
 				BT_NOTIFICATION_ITERATOR_STATE_ACTIVE);
 			iterator->state = BT_NOTIFICATION_ITERATOR_STATE_ENDED;
 
-			if (iterator->queue->length == 0) {
-				status = BT_NOTIFICATION_ITERATOR_STATUS_END;
+			if (iterator->queue->length > 0) {
+				status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
 			}
 
 			BT_LOGD("Set new status: status=%s",
 				bt_notification_iterator_status_string(status));
 			goto end;
 		case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
-			status = BT_NOTIFICATION_ITERATOR_STATUS_AGAIN;
-			goto end;
-		case BT_NOTIFICATION_ITERATOR_STATUS_OK:
-			if (!next_return.notification) {
-				BT_LOGW_STR("User method returned BT_NOTIFICATION_ITERATOR_STATUS_OK, but notification is NULL.");
-				status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
-				goto end;
+			/* Deliver what we have first */
+			if (iterator->queue->length > 0) {
+				status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
 			}
 
-			/*
-			 * We know the notification is valid. Before we
-			 * push it to the head of the queue, push the
-			 * appropriate automatic notifications if any.
-			 */
-			ret = enqueue_notification_and_automatic(iterator,
-				next_return.notification);
-			BT_PUT(next_return.notification);
-			if (ret) {
-				BT_LOGW("Cannot enqueue notification and automatic notifications.");
+			goto end;
+		case BT_NOTIFICATION_ITERATOR_STATUS_OK:
+			if (count == 0) {
+				BT_LOGW_STR("User method returned BT_NOTIFICATION_ITERATOR_STATUS_OK, but no notifications.");
 				status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
 				goto end;
 			}
@@ -1637,6 +1808,11 @@ enum bt_notification_iterator_status ensure_queue_has_notifications(
 	}
 
 end:
+	/* Put the notifications which were not enqueued */
+	for (; i < count; i++) {
+		bt_put(notifs[i]);
+	}
+
 	return status;
 }
 
@@ -1676,6 +1852,63 @@ end:
 	return status;
 }
 
+enum bt_notification_iterator_status
+bt_notification_iterator_next_batch(struct bt_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	enum bt_notification_iterator_status status;
+
+	if (!iterator) {
+		BT_LOGW_STR("Invalid parameter: notification iterator is NULL.");
+		status = BT_NOTIFICATION_ITERATOR_STATUS_INVALID;
+		goto end;
+	}
+
+	if (!notifications || !count) {
+		BT_LOGW("Invalid parameter: notification array or count is NULL: "
+			"iter-addr=%p, notifs-addr=%p, count-addr=%p",
+			iterator, notifications, count);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_INVALID;
+		goto end;
+	}
+
+	if (capacity == 0) {
+		BT_LOGW("Invalid parameter: capacity is 0: iter-addr=%p",
+			iterator);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_INVALID;
+		goto end;
+	}
+
+	BT_LOGD("Notification iterator's \"next batch\": iter-addr=%p, "
+		"capacity=%" PRIu64, iterator, capacity);
+	*count = 0;
+	status = ensure_queue_has_notifications(iterator);
+	if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		/* Not an error */
+		goto end;
+	}
+
+	/*
+	 * Move as many notifications as possible from the tail of the
+	 * queue to the user's array. The last one also becomes the
+	 * iterator's current notification.
+	 */
+	assert(iterator->queue->length > 0);
+
+	while (*count < capacity && iterator->queue->length > 0) {
+		notifications[*count] = g_queue_pop_tail(iterator->queue);
+		assert(notifications[*count]);
+		(*count)++;
+	}
+
+	bt_put(iterator->current_notification);
+	iterator->current_notification = bt_get(notifications[*count - 1]);
+
+end:
+	return status;
+}
+
 struct bt_component *bt_notification_iterator_get_component(
 		struct bt_notification_iterator *iterator)
 {
@@ -1691,12 +1924,151 @@ bt_private_notification_iterator_get_private_component(
 			bt_notification_iterator_from_private(private_iterator)));
 }
 
+static
+void reset_stream_states(struct bt_notification_iterator *iterator)
+{
+	GHashTableIter ht_iter;
+	gpointer stream_gptr, stream_state_gptr;
+
+	/*
+	 * Ended stream states do not own their stream anymore: they
+	 * are only kept alive by our destroy listener, which we need
+	 * to remove before removing the state itself.
+	 */
+	remove_destroyed_stream_states(iterator);
+	g_hash_table_iter_init(&ht_iter, iterator->stream_states);
+
+	while (g_hash_table_iter_next(&ht_iter, &stream_gptr,
+			&stream_state_gptr)) {
+		struct stream_state *stream_state = stream_state_gptr;
+
+		assert(stream_gptr);
+
+		if (stream_state->is_ended) {
+			bt_ctf_stream_remove_destroy_listener(
+				(void *) stream_gptr, stream_destroy_listener,
+				iterator);
+		}
+	}
+
+	iterator->last_event_stream_state = NULL;
+	g_hash_table_remove_all(iterator->stream_states);
+}
+
+static
+void flush_queue(struct bt_notification_iterator *iterator)
+{
+	struct bt_notification *notif;
+
+	while ((notif = g_queue_pop_tail(iterator->queue))) {
+		bt_put(notif);
+	}
+
+	BT_PUT(iterator->current_notification);
+}
+
 enum bt_notification_iterator_status bt_notification_iterator_seek_time(
 		struct bt_notification_iterator *iterator,
 		enum bt_notification_iterator_seek_origin seek_origin,
 		int64_t time)
 {
-	enum bt_notification_iterator_status ret =
-			BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED;
-	return ret;
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	bt_component_class_notification_iterator_seek_time_method
+		seek_method = NULL;
+
+	if (!iterator) {
+		BT_LOGW_STR("Invalid parameter: notification iterator is NULL.");
+		status = BT_NOTIFICATION_ITERATOR_STATUS_INVALID;
+		goto end;
+	}
+
+	BT_LOGD("Seeking notification iterator: iter-addr=%p, "
+		"seek-origin=%d, time=%" PRId64, iterator, seek_origin, time);
+
+	if (seek_origin != BT_NOTIFICATION_ITERATOR_SEEK_ORIGIN_EPOCH) {
+		BT_LOGW("Unsupported seek origin: iter-addr=%p, "
+			"seek-origin=%d", iterator, seek_origin);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED;
+		goto end;
+	}
+
+	switch (iterator->state) {
+	case BT_NOTIFICATION_ITERATOR_STATE_FINALIZED_AND_ENDED:
+	case BT_NOTIFICATION_ITERATOR_STATE_FINALIZED:
+		BT_LOGW_STR("Notification iterator's \"seek time\" called, but it is finalized.");
+		status = BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
+		goto end;
+	default:
+		break;
+	}
+
+	assert(iterator->upstream_component);
+	assert(iterator->upstream_component->class);
+
+	/* Pick the appropriate "seek time" method */
+	switch (iterator->upstream_component->class->type) {
+	case BT_COMPONENT_CLASS_TYPE_SOURCE:
+	{
+		struct bt_component_class_source *source_class =
+			container_of(iterator->upstream_component->class,
+				struct bt_component_class_source, parent);
+
+		seek_method = source_class->methods.iterator.seek_time;
+		break;
+	}
+	case BT_COMPONENT_CLASS_TYPE_FILTER:
+	{
+		struct bt_component_class_filter *filter_class =
+			container_of(iterator->upstream_component->class,
+				struct bt_component_class_filter, parent);
+
+		seek_method = filter_class->methods.iterator.seek_time;
+		break;
+	}
+	default:
+		abort();
+	}
+
+	if (!seek_method) {
+		BT_LOGD("Upstream component class has no \"seek time\" method: "
+			"iter-addr=%p", iterator);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED;
+		goto end;
+	}
+
+	BT_LOGD_STR("Calling user's \"seek time\" method.");
+	status = seek_method(
+		bt_private_notification_iterator_from_notification_iterator(iterator),
+		time);
+	BT_LOGD("User method returned: status=%s",
+		bt_notification_iterator_status_string(status));
+	if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		goto end;
+	}
+
+	/*
+	 * The upstream iterator is now positioned somewhere else: what
+	 * we have queued and what we know about the streams' states
+	 * belong to the previous position. After a successful seek,
+	 * the iterator behaves as if it was just created: the
+	 * automatic "stream begin" and "packet begin" notifications
+	 * are emitted again if the upstream iterator does not emit
+	 * them itself.
+	 */
+	flush_queue(iterator);
+	clear_actions(iterator);
+	reset_stream_states(iterator);
+
+	if (iterator->state == BT_NOTIFICATION_ITERATOR_STATE_ENDED) {
+		BT_LOGD("Updating notification iterator's state: "
+			"new-state=BT_NOTIFICATION_ITERATOR_STATE_ACTIVE");
+		iterator->state = BT_NOTIFICATION_ITERATOR_STATE_ACTIVE;
+	}
+
+	BT_LOGD("Seeked notification iterator: iter-addr=%p, time=%" PRId64,
+		iterator, time);
+
+end:
+	return status;
 }
@@ -36,15 +36,32 @@
 #include <babeltrace/types.h>
 #include <stdbool.h>
 
+/*
+ * The notification of a pooled event (see bt_ctf_event_create_pooled())
+ * goes back to the event notification pool of its clock class priority
+ * map when it's released, instead of being freed.
+ */
 static
-void bt_notification_event_destroy(struct bt_object *obj)
+void bt_notification_event_release(struct bt_object *obj)
 {
 	struct bt_notification_event *notification =
 			(struct bt_notification_event *) obj;
+	struct bt_clock_class_priority_map *cc_prio_map =
+			notification->cc_prio_map;
+	bool recycle = notification->event->is_pooled;
 
 	BT_PUT(notification->event);
-	BT_PUT(notification->cc_prio_map);
-	g_free(notification);
+
+	if (!recycle || bt_object_pool_recycle_object(
+			&cc_prio_map->event_notif_pool, notification)) {
+		g_free(notification);
+	}
+
+	/*
+	 * Put the map last: this could destroy it, and its pool with
+	 * this notification.
+	 */
+	bt_put(cc_prio_map);
 }
 
 static
@@ -155,13 +172,22 @@ struct bt_notification *bt_notification_event_create(struct bt_ctf_event *event,
 		goto error;
 	}
 
-	notification = g_new0(struct bt_notification_event, 1);
+	if (event->is_pooled) {
+		notification = bt_object_pool_get_object(
+			&cc_prio_map->event_notif_pool);
+	}
+
 	if (!notification) {
-		goto error;
+		notification = g_new0(struct bt_notification_event, 1);
+		if (!notification) {
+			goto error;
+		}
 	}
+
 	bt_notification_init(&notification->parent,
 			BT_NOTIFICATION_TYPE_EVENT,
-			bt_notification_event_destroy);
+			bt_notification_event_release);
+	notification->parent.frozen = BT_FALSE;
 	notification->event = bt_get(event);
 	notification->cc_prio_map = bt_get(cc_prio_map);
 	if (!validate_clock_classes(notification)) {
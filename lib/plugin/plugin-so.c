@@ -469,6 +469,10 @@ enum bt_plugin_status bt_plugin_so_init(
 					cc_full_descr->iterator_methods.seek_time =
 						cur_cc_descr_attr->value.notif_iter_seek_time_method;
 					break;
+				case BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_NEXT_BATCH_METHOD:
+					cc_full_descr->iterator_methods.next_batch =
+						cur_cc_descr_attr->value.notif_iter_next_batch_method;
+					break;
 				default:
 					/*
 					 * WARN-level logging because
@@ -690,6 +694,18 @@ enum bt_plugin_status bt_plugin_so_init(
 				}
 			}
 
+			if (cc_full_descr->iterator_methods.next_batch) {
+				ret = bt_component_class_source_set_notification_iterator_next_batch_method(
+					comp_class,
+					cc_full_descr->iterator_methods.next_batch);
+				if (ret) {
+					BT_LOGE_STR("Cannot set source component class's notification iterator next batch method.");
+					status = BT_PLUGIN_STATUS_ERROR;
+					BT_PUT(comp_class);
+					goto end;
+				}
+			}
+
 			if (cc_full_descr->iterator_methods.seek_time) {
 				ret = bt_component_class_source_set_notification_iterator_seek_time_method(
 					comp_class,
@@ -727,6 +743,18 @@ enum bt_plugin_status bt_plugin_so_init(
 				}
 			}
 
+			if (cc_full_descr->iterator_methods.next_batch) {
+				ret = bt_component_class_filter_set_notification_iterator_next_batch_method(
+					comp_class,
+					cc_full_descr->iterator_methods.next_batch);
+				if (ret) {
+					BT_LOGE_STR("Cannot set filter component class's notification iterator next batch method.");
+					status = BT_PLUGIN_STATUS_ERROR;
+					BT_PUT(comp_class);
+					goto end;
+				}
+			}
+
 			if (cc_full_descr->iterator_methods.seek_time) {
 				ret = bt_component_class_filter_set_notification_iterator_seek_time_method(
 					comp_class,
@@ -33,6 +33,7 @@
 void *bt_get(void *ptr)
 {
 	struct bt_object *obj = ptr;
+	unsigned long old_count;
 
 	if (unlikely(!obj)) {
 		goto end;
@@ -42,17 +43,21 @@ void *bt_get(void *ptr)
 		goto end;
 	}
 
-	if (unlikely(obj->parent && bt_object_get_ref_count(obj) == 0)) {
+	old_count = bt_ref_get(&obj->ref_count);
+	BT_LOGV("Incremented object's reference count: %lu -> %lu: "
+		"addr=%p, cur-count=%lu, new-count=%lu",
+		old_count, old_count + 1, ptr, old_count, old_count + 1);
+
+	/*
+	 * Only the thread which brings the reference count from 0 to
+	 * 1 gets the parent, even if other threads get the same object
+	 * concurrently.
+	 */
+	if (unlikely(obj->parent && old_count == 0)) {
 		BT_LOGV("Incrementing object's parent's reference count: "
 			"addr=%p, parent-addr=%p", ptr, obj->parent);
 		bt_get(obj->parent);
 	}
-	BT_LOGV("Incrementing object's reference count: %lu -> %lu: "
-		"addr=%p, cur-count=%lu, new-count=%lu",
-		obj->ref_count.count, obj->ref_count.count + 1,
-		ptr,
-		obj->ref_count.count, obj->ref_count.count + 1);
-	bt_ref_get(&obj->ref_count);
 
 end:
 	return obj;
@@ -77,8 +82,8 @@ void bt_put(void *ptr)
 
 	BT_LOGV("Decrementing object's reference count: %lu -> %lu: "
 		"addr=%p, cur-count=%lu, new-count=%lu",
-		obj->ref_count.count, obj->ref_count.count - 1,
+		bt_object_get_ref_count(obj), bt_object_get_ref_count(obj) - 1,
 		ptr,
-		obj->ref_count.count, obj->ref_count.count - 1);
+		bt_object_get_ref_count(obj), bt_object_get_ref_count(obj) - 1);
 	bt_ref_put(&obj->ref_count);
 }
@@ -34,6 +34,7 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <string.h>
+#include <babeltrace/babeltrace-internal.h>
 #include <babeltrace/bitfield-internal.h>
 #include <babeltrace/ctf-ir/field-types.h>
 #include <babeltrace/ctf-ir/field-types-internal.h>
@@ -49,19 +50,74 @@
 #define BITS_TO_BYTES_CEIL(_x)		DIV8((_x) + 7)
 #define IN_BYTE_OFFSET(_at)		((_at) & 7)
 
+/*
+ * Decoding information of a field type, resolved once from the IR
+ * field type when the BTR first meets it, and then kept in the BTR's
+ * cache so that decoding a field does not need to query the IR field
+ * type again.
+ */
+struct type_info {
+	/* Field type (owned by this) */
+	struct bt_ctf_field_type *type;
+
+	/* Field type's ID */
+	enum bt_ctf_field_type_id id;
+
+	/* Alignment (bits), 1 for variant field types */
+	unsigned int alignment;
+
+	/*
+	 * Size (bits) of a basic field, that is, of an integer,
+	 * floating point number, or enumeration field.
+	 */
+	int64_t size;
+
+	/*
+	 * Byte order of a basic field (byte order of the container
+	 * type for an enumeration field type).
+	 */
+	enum bt_ctf_byte_order bo;
+
+	/* True if this is a signed integer (or enumeration) type */
+	bool is_signed;
+
+	/*
+	 * Readers of a whole 8, 16, 32, or 64-bit basic field starting
+	 * on a byte boundary, chosen once according to the field's size
+	 * and byte order. NULL if the generic bit array readers must be
+	 * used.
+	 */
+	uint64_t (*read_aligned_uint)(const unsigned char *);
+	int64_t (*read_aligned_sint)(const unsigned char *);
+
+	/* True if this is a compound type */
+	bool is_compound;
+
+	/* Field count of a structure, length of an array */
+	int64_t length;
+
+	/*
+	 * Decoding information of the fields of a structure (`length`
+	 * entries), or of the element of an array or sequence (one
+	 * entry). Weak references: the BTR's cache owns them. NULL for
+	 * variant field types since the selected type is dynamic.
+	 */
+	struct type_info **children;
+};
+
 /* A visit stack entry */
 struct stack_entry {
 	/*
-	 * Current type of base field, one of:
+	 * Decoding information of current type of base field, one of:
 	 *
 	 *   * Structure
 	 *   * Array
 	 *   * Sequence
 	 *   * Variant
 	 *
-	 * Owned by this.
+	 * Weak reference: the BTR's cache owns it.
 	 */
-	struct bt_ctf_field_type *base_type;
+	struct type_info *base_info;
 
 	/* Length of base field (always 1 for variant types) */
 	int64_t base_len;
@@ -72,8 +128,8 @@ struct stack_entry {
 
 /* Visit stack */
 struct stack {
-	/* Entries (struct stack_entry *) (top is last element) */
-	GPtrArray *entries;
+	/* Entries (struct stack_entry) (top is last element) */
+	GArray *entries;
 };
 
 /* Reading states */
@@ -91,8 +147,16 @@ struct bt_ctf_btr {
 	/* Bisit stack */
 	struct stack *stack;
 
-	/* Current basic field type */
-	struct bt_ctf_field_type *cur_basic_field_type;
+	/*
+	 * Cache of decoding information: struct bt_ctf_field_type *
+	 * (weak; the value holds a reference) to struct type_info *
+	 * (owned by this). Field types are frozen when the BTR reads
+	 * them, so their decoding information never changes.
+	 */
+	GHashTable *type_infos;
+
+	/* Decoding information of current basic field type (weak) */
+	struct type_info *cur_basic_info;
 
 	/* Current state */
 	enum btr_state state;
@@ -177,12 +241,298 @@ const char *btr_state_string(enum btr_state state)
 }
 
 static
-void stack_entry_free_func(gpointer data)
+void type_info_destroy(gpointer data)
+{
+	struct type_info *info = data;
+
+	if (!info) {
+		return;
+	}
+
+	BT_PUT(info->type);
+	g_free(info->children);
+	g_free(info);
+}
+
+static
+struct type_info *get_type_info(struct bt_ctf_btr *btr,
+		struct bt_ctf_field_type *field_type);
+
+static
+int set_basic_type_info(struct bt_ctf_btr *btr, struct type_info *info,
+		struct bt_ctf_field_type *field_type)
+{
+	int ret = 0;
+
+	switch (bt_ctf_field_type_get_type_id(field_type)) {
+	case BT_CTF_FIELD_TYPE_ID_INTEGER:
+		info->size = bt_ctf_field_type_integer_get_size(field_type);
+		info->is_signed =
+			bt_ctf_field_type_integer_get_signed(field_type) == 1;
+		info->bo = bt_ctf_field_type_get_byte_order(field_type);
+		break;
+	case BT_CTF_FIELD_TYPE_ID_FLOAT:
+	{
+		int exp_dig, mant_dig;
+
+		exp_dig =
+			bt_ctf_field_type_floating_point_get_exponent_digits(
+				field_type);
+		mant_dig =
+			bt_ctf_field_type_floating_point_get_mantissa_digits(
+				field_type);
+		assert(exp_dig >= 0);
+		assert(mant_dig >= 0);
+		info->size = exp_dig + mant_dig;
+		info->bo = bt_ctf_field_type_get_byte_order(field_type);
+
+		if (info->size == 32) {
+			assert(mant_dig == 24);
+			assert(exp_dig == 8);
+		} else if (info->size == 64) {
+			assert(mant_dig == 53);
+			assert(exp_dig == 11);
+		}
+		break;
+	}
+	case BT_CTF_FIELD_TYPE_ID_ENUM:
+	{
+		struct bt_ctf_field_type *int_type;
+
+		int_type = bt_ctf_field_type_enumeration_get_container_type(
+			field_type);
+		assert(int_type);
+		ret = set_basic_type_info(btr, info, int_type);
+		BT_PUT(int_type);
+		break;
+	}
+	default:
+		ret = -1;
+		break;
+	}
+
+	if (ret == 0 && info->size < 1) {
+		BT_LOGW("Cannot get basic field type's size: "
+			"btr-addr=%p, ft-addr=%p, ft-id=%s",
+			btr, field_type,
+			bt_ctf_field_type_id_string(
+				bt_ctf_field_type_get_type_id(field_type)));
+		ret = -1;
+	}
+
+	return ret;
+}
+
+static
+void set_aligned_readers(struct type_info *info)
+{
+	bool be;
+
+	switch (info->bo) {
+	case BT_CTF_BYTE_ORDER_BIG_ENDIAN:
+	case BT_CTF_BYTE_ORDER_NETWORK:
+		be = true;
+		break;
+	case BT_CTF_BYTE_ORDER_LITTLE_ENDIAN:
+		be = false;
+		break;
+	default:
+		return;
+	}
+
+	switch (info->size) {
+	case 8:
+		info->read_aligned_uint = be ? bt_bitfield_read_aligned_be_u8 :
+			bt_bitfield_read_aligned_le_u8;
+		info->read_aligned_sint = be ? bt_bitfield_read_aligned_be_s8 :
+			bt_bitfield_read_aligned_le_s8;
+		break;
+	case 16:
+		info->read_aligned_uint = be ? bt_bitfield_read_aligned_be_u16 :
+			bt_bitfield_read_aligned_le_u16;
+		info->read_aligned_sint = be ? bt_bitfield_read_aligned_be_s16 :
+			bt_bitfield_read_aligned_le_s16;
+		break;
+	case 32:
+		info->read_aligned_uint = be ? bt_bitfield_read_aligned_be_u32 :
+			bt_bitfield_read_aligned_le_u32;
+		info->read_aligned_sint = be ? bt_bitfield_read_aligned_be_s32 :
+			bt_bitfield_read_aligned_le_s32;
+		break;
+	case 64:
+		info->read_aligned_uint = be ? bt_bitfield_read_aligned_be_u64 :
+			bt_bitfield_read_aligned_le_u64;
+		info->read_aligned_sint = be ? bt_bitfield_read_aligned_be_s64 :
+			bt_bitfield_read_aligned_le_s64;
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Creates the decoding information of `field_type`, and of all the
+ * field types it contains, and adds them to the BTR's cache.
+ */
+static
+struct type_info *create_type_info(struct bt_ctf_btr *btr,
+		struct bt_ctf_field_type *field_type)
+{
+	struct type_info *info;
+	int alignment;
+	int ret = 0;
+	int64_t i;
+
+	BT_LOGV("Creating field type's decoding information: "
+		"btr-addr=%p, ft-addr=%p, ft-id=%s",
+		btr, field_type, bt_ctf_field_type_id_string(
+			bt_ctf_field_type_get_type_id(field_type)));
+	info = g_new0(struct type_info, 1);
+	if (!info) {
+		BT_LOGE_STR("Failed to allocate one field type decoding information.");
+		goto error;
+	}
+
+	info->type = bt_get(field_type);
+	info->id = bt_ctf_field_type_get_type_id(field_type);
+	info->bo = BT_CTF_BYTE_ORDER_UNKNOWN;
+	alignment = bt_ctf_field_type_get_alignment(field_type);
+	if (alignment < 0) {
+		BT_LOGW("Cannot get field type's alignment: "
+			"btr-addr=%p, ft-addr=%p, ft-id=%s",
+			btr, field_type,
+			bt_ctf_field_type_id_string(info->id));
+		goto error;
+	}
+
+	/*
+	 * 0 means "undefined" for variants; what we really want is 1
+	 * (always aligned)
+	 */
+	info->alignment = alignment == 0 ? 1 : (unsigned int) alignment;
+
+	switch (info->id) {
+	case BT_CTF_FIELD_TYPE_ID_INTEGER:
+	case BT_CTF_FIELD_TYPE_ID_FLOAT:
+	case BT_CTF_FIELD_TYPE_ID_ENUM:
+		ret = set_basic_type_info(btr, info, field_type);
+		if (ret) {
+			goto error;
+		}
+
+		set_aligned_readers(info);
+		break;
+	case BT_CTF_FIELD_TYPE_ID_STRING:
+		break;
+	case BT_CTF_FIELD_TYPE_ID_STRUCT:
+		info->is_compound = true;
+		info->length = (int64_t)
+			bt_ctf_field_type_structure_get_field_count(field_type);
+		if (info->length < 0) {
+			goto error;
+		}
+
+		info->children = g_new0(struct type_info *,
+			MAX(info->length, 1));
+		if (!info->children) {
+			BT_LOGE_STR("Failed to allocate an array of field type decoding information.");
+			goto error;
+		}
+
+		for (i = 0; i < info->length; i++) {
+			struct bt_ctf_field_type *child_type = NULL;
+
+			ret = bt_ctf_field_type_structure_get_field(field_type,
+				NULL, &child_type, i);
+			if (ret) {
+				goto error;
+			}
+
+			info->children[i] = get_type_info(btr, child_type);
+			bt_put(child_type);
+			if (!info->children[i]) {
+				goto error;
+			}
+		}
+		break;
+	case BT_CTF_FIELD_TYPE_ID_ARRAY:
+	case BT_CTF_FIELD_TYPE_ID_SEQUENCE:
+	{
+		struct bt_ctf_field_type *elem_type;
+
+		info->is_compound = true;
+
+		if (info->id == BT_CTF_FIELD_TYPE_ID_ARRAY) {
+			info->length = bt_ctf_field_type_array_get_length(
+				field_type);
+			if (info->length < 0) {
+				goto error;
+			}
+
+			elem_type = bt_ctf_field_type_array_get_element_type(
+				field_type);
+		} else {
+			elem_type = bt_ctf_field_type_sequence_get_element_type(
+				field_type);
+		}
+
+		if (!elem_type) {
+			goto error;
+		}
+
+		info->children = g_new0(struct type_info *, 1);
+		if (!info->children) {
+			BT_LOGE_STR("Failed to allocate an array of field type decoding information.");
+			bt_put(elem_type);
+			goto error;
+		}
+
+		info->children[0] = get_type_info(btr, elem_type);
+		bt_put(elem_type);
+		if (!info->children[0]) {
+			goto error;
+		}
+		break;
+	}
+	case BT_CTF_FIELD_TYPE_ID_VARIANT:
+		info->is_compound = true;
+		break;
+	default:
+		BT_LOGW("Unknown field type ID: btr-addr=%p, ft-addr=%p, "
+			"ft-id=%d", btr, field_type, info->id);
+		goto error;
+	}
+
+	g_hash_table_insert(btr->type_infos, field_type, info);
+	goto end;
+
+error:
+	BT_LOGW("Cannot create field type's decoding information: "
+		"btr-addr=%p, ft-addr=%p", btr, field_type);
+	type_info_destroy(info);
+	info = NULL;
+
+end:
+	return info;
+}
+
+/*
+ * Returns the decoding information of `field_type` (weak reference),
+ * creating it if the BTR's cache does not contain it yet.
+ */
+static
+struct type_info *get_type_info(struct bt_ctf_btr *btr,
+		struct bt_ctf_field_type *field_type)
 {
-	struct stack_entry *entry = data;
+	struct type_info *info;
+
+	assert(field_type);
+	info = g_hash_table_lookup(btr->type_infos, field_type);
+	if (likely(info)) {
+		return info;
+	}
 
-	BT_PUT(entry->base_type);
-	g_free(entry);
+	return create_type_info(btr, field_type);
 }
 
 static
@@ -196,9 +546,10 @@ struct stack *stack_new(void)
 		goto error;
 	}
 
-	stack->entries = g_ptr_array_new_with_free_func(stack_entry_free_func);
+	stack->entries = g_array_sized_new(FALSE, FALSE,
+		sizeof(struct stack_entry), 16);
 	if (!stack->entries) {
-		BT_LOGE_STR("Failed to allocate a GPtrArray.");
+		BT_LOGE_STR("Failed to allocate a GArray.");
 		goto error;
 	}
 
@@ -219,38 +570,34 @@ void stack_destroy(struct stack *stack)
 	}
 
 	BT_LOGD("Destroying stack: addr=%p", stack);
-	g_ptr_array_free(stack->entries, TRUE);
+	g_array_free(stack->entries, TRUE);
 	g_free(stack);
 }
 
 static inline
 int64_t get_compound_field_type_length(struct bt_ctf_btr *btr,
-		struct bt_ctf_field_type *field_type)
+		struct type_info *info)
 {
 	int64_t length;
 
-	switch (bt_ctf_field_type_get_type_id(field_type)) {
+	switch (info->id) {
 	case BT_CTF_FIELD_TYPE_ID_STRUCT:
-		length = (int64_t) bt_ctf_field_type_structure_get_field_count(
-			field_type);
+	case BT_CTF_FIELD_TYPE_ID_ARRAY:
+		length = info->length;
 		break;
 	case BT_CTF_FIELD_TYPE_ID_VARIANT:
 		/* Variant field types always "contain" a single type */
 		length = 1;
 		break;
-	case BT_CTF_FIELD_TYPE_ID_ARRAY:
-		length = bt_ctf_field_type_array_get_length(field_type);
-		break;
 	case BT_CTF_FIELD_TYPE_ID_SEQUENCE:
-		length = btr->user.cbs.query.get_sequence_length(field_type,
+		length = btr->user.cbs.query.get_sequence_length(info->type,
 			btr->user.data);
 		break;
 	default:
 		BT_LOGW("Cannot get field type's field count: btr-addr=%p, "
 			"ft-addr=%p, ft-id=%s",
-			btr, field_type,
-			bt_ctf_field_type_id_string(
-				bt_ctf_field_type_get_type_id(field_type)));
+			btr, info->type,
+			bt_ctf_field_type_id_string(info->id));
 		length = BT_CTF_BTR_STATUS_ERROR;
 	}
 
@@ -258,55 +605,44 @@ int64_t get_compound_field_type_length(struct bt_ctf_btr *btr,
 }
 
 static
-int stack_push(struct stack *stack, struct bt_ctf_field_type *base_type,
+int stack_push(struct stack *stack, struct type_info *base_info,
 	size_t base_len)
 {
-	int ret = 0;
-	struct stack_entry *entry;
+	struct stack_entry entry;
 
 	assert(stack);
-	assert(base_type);
+	assert(base_info);
 
 	BT_LOGV("Pushing field type on stack: stack-addr=%p, "
 		"ft-addr=%p, ft-id=%s, base-length=%zu, "
 		"stack-size-before=%u, stack-size-after=%u",
-		stack, base_type, bt_ctf_field_type_id_string(
-			bt_ctf_field_type_get_type_id(base_type)),
+		stack, base_info->type,
+		bt_ctf_field_type_id_string(base_info->id),
 		base_len, stack->entries->len, stack->entries->len + 1);
-	entry = g_new0(struct stack_entry, 1);
-	if (!entry) {
-		BT_LOGE("Failed to allocate one stack entry: stack-addr=%p",
-			stack);
-		ret = BT_CTF_BTR_STATUS_ERROR;
-		goto end;
-	}
-
-	entry->base_type = base_type;
-	bt_get(entry->base_type);
-	entry->base_len = base_len;
-	g_ptr_array_add(stack->entries, entry);
-
-end:
-	return ret;
+	entry.base_info = base_info;
+	entry.base_len = base_len;
+	entry.index = 0;
+	g_array_append_val(stack->entries, entry);
+	return 0;
 }
 
 static
 int stack_push_with_len(struct bt_ctf_btr *btr,
-		struct bt_ctf_field_type *base_type)
+		struct type_info *base_info)
 {
 	int ret = 0;
-	int64_t base_len = get_compound_field_type_length(btr, base_type);
+	int64_t base_len = get_compound_field_type_length(btr, base_info);
 
 	if (base_len < 0) {
 		BT_LOGW("Cannot get compound field type's field count: "
 			"btr-addr=%p, ft-addr=%p, ft-id=%s",
-			btr, base_type, bt_ctf_field_type_id_string(
-				bt_ctf_field_type_get_type_id(base_type)));
+			btr, base_info->type,
+			bt_ctf_field_type_id_string(base_info->id));
 		ret = BT_CTF_BTR_STATUS_ERROR;
 		goto end;
 	}
 
-	ret = stack_push(btr->stack, base_type, (size_t) base_len);
+	ret = stack_push(btr->stack, base_info, (size_t) base_len);
 
 end:
 	return ret;
@@ -328,7 +664,7 @@ void stack_pop(struct stack *stack)
 	BT_LOGV("Popping from stack: "
 		"stack-addr=%p, stack-size-before=%u, stack-size-after=%u",
 		stack, stack->entries->len, stack->entries->len - 1);
-	g_ptr_array_remove_index(stack->entries, stack->entries->len - 1);
+	g_array_set_size(stack->entries, stack->entries->len - 1);
 }
 
 static inline
@@ -341,11 +677,7 @@ static
 void stack_clear(struct stack *stack)
 {
 	assert(stack);
-
-	if (!stack_empty(stack)) {
-		g_ptr_array_remove_range(stack->entries, 0, stack_size(stack));
-	}
-
+	g_array_set_size(stack->entries, 0);
 	assert(stack_empty(stack));
 }
 
@@ -355,7 +687,8 @@ struct stack_entry *stack_top(struct stack *stack)
 	assert(stack);
 	assert(stack_size(stack));
 
-	return g_ptr_array_index(stack->entries, stack->entries->len - 1);
+	return &g_array_index(stack->entries, struct stack_entry,
+		stack->entries->len - 1);
 }
 
 static inline
@@ -409,50 +742,6 @@ size_t buf_at_from_addr(struct bt_ctf_btr *btr)
 	return btr->buf.offset + btr->buf.at;
 }
 
-static inline
-int get_basic_field_type_size(struct bt_ctf_btr *btr,
-		struct bt_ctf_field_type *field_type)
-{
-	int size;
-
-	switch (bt_ctf_field_type_get_type_id(field_type)) {
-	case BT_CTF_FIELD_TYPE_ID_INTEGER:
-		size = bt_ctf_field_type_integer_get_size(field_type);
-		break;
-	case BT_CTF_FIELD_TYPE_ID_FLOAT:
-	{
-		int exp_dig, mant_dig;
-
-		exp_dig =
-			bt_ctf_field_type_floating_point_get_exponent_digits(
-				field_type);
-		mant_dig =
-			bt_ctf_field_type_floating_point_get_mantissa_digits(
-				field_type);
-		assert(exp_dig >= 0);
-		assert(mant_dig >= 0);
-		size = exp_dig + mant_dig;
-		break;
-	}
-	case BT_CTF_FIELD_TYPE_ID_ENUM:
-	{
-		struct bt_ctf_field_type *int_type;
-
-		int_type = bt_ctf_field_type_enumeration_get_container_type(
-			field_type);
-		assert(int_type);
-		size = get_basic_field_type_size(btr, int_type);
-		BT_PUT(int_type);
-		break;
-	}
-	default:
-		size = BT_CTF_BTR_STATUS_ERROR;
-		break;
-	}
-
-	return size;
-}
-
 static
 void stitch_reset(struct bt_ctf_btr *btr)
 {
@@ -504,9 +793,17 @@ void stitch_set_from_remaining_buf(struct bt_ctf_btr *btr)
 
 static inline
 enum bt_ctf_btr_status read_unsigned_bitfield(const uint8_t *buf, size_t at,
-		int64_t field_size, enum bt_ctf_byte_order bo, uint64_t *v)
+		struct type_info *info, uint64_t *v)
 {
 	enum bt_ctf_btr_status status = BT_CTF_BTR_STATUS_OK;
+	int64_t field_size = info->size;
+	enum bt_ctf_byte_order bo = info->bo;
+
+	if (likely(info->read_aligned_uint && IN_BYTE_OFFSET(at) == 0)) {
+		/* Fast path: whole byte-aligned field */
+		*v = info->read_aligned_uint(&buf[DIV8(at)]);
+		goto end;
+	}
 
 	switch (bo) {
 	case BT_CTF_BYTE_ORDER_BIG_ENDIAN:
@@ -521,6 +818,7 @@ enum bt_ctf_btr_status read_unsigned_bitfield(const uint8_t *buf, size_t at,
 		abort();
 	}
 
+end:
 	BT_LOGV("Read unsigned bit array: cur=%zu, size=%" PRId64 ", "
 		"bo=%s, val=%" PRIu64, at, field_size,
 		bt_ctf_byte_order_string(bo), *v);
@@ -529,9 +827,17 @@ enum bt_ctf_btr_status read_unsigned_bitfield(const uint8_t *buf, size_t at,
 
 static inline
 enum bt_ctf_btr_status read_signed_bitfield(const uint8_t *buf, size_t at,
-		int64_t field_size, enum bt_ctf_byte_order bo, int64_t *v)
+		struct type_info *info, int64_t *v)
 {
 	enum bt_ctf_btr_status status = BT_CTF_BTR_STATUS_OK;
+	int64_t field_size = info->size;
+	enum bt_ctf_byte_order bo = info->bo;
+
+	if (likely(info->read_aligned_sint && IN_BYTE_OFFSET(at) == 0)) {
+		/* Fast path: whole byte-aligned field */
+		*v = info->read_aligned_sint(&buf[DIV8(at)]);
+		goto end;
+	}
 
 	switch (bo) {
 	case BT_CTF_BYTE_ORDER_BIG_ENDIAN:
@@ -546,6 +852,7 @@ enum bt_ctf_btr_status read_signed_bitfield(const uint8_t *buf, size_t at,
 		abort();
 	}
 
+end:
 	BT_LOGV("Read signed bit array: cur=%zu, size=%" PRId64 ", "
 		"bo=%s, val=%" PRId64, at, field_size,
 		bt_ctf_byte_order_string(bo), *v);
@@ -609,14 +916,13 @@ static
 enum bt_ctf_btr_status read_basic_float_and_call_cb(struct bt_ctf_btr *btr,
 		const uint8_t *buf, size_t at)
 {
-	int ret;
 	double dblval;
 	int64_t field_size;
 	enum bt_ctf_byte_order bo;
 	enum bt_ctf_btr_status status = BT_CTF_BTR_STATUS_OK;
 
-	field_size = get_basic_field_type_size(btr, btr->cur_basic_field_type);
-	bo = bt_ctf_field_type_get_byte_order(btr->cur_basic_field_type);
+	field_size = btr->cur_basic_info->size;
+	bo = btr->cur_basic_info->bo;
 	btr->cur_bo = bo;
 
 	switch (field_size) {
@@ -628,13 +934,8 @@ enum bt_ctf_btr_status read_basic_float_and_call_cb(struct bt_ctf_btr *btr,
 			float f;
 		} f32;
 
-		ret = bt_ctf_field_type_floating_point_get_mantissa_digits(
-			btr->cur_basic_field_type);
-		assert(ret == 24);
-		ret = bt_ctf_field_type_floating_point_get_exponent_digits(
-			btr->cur_basic_field_type);
-		assert(ret == 8);
-		status = read_unsigned_bitfield(buf, at, field_size, bo, &v);
+		status = read_unsigned_bitfield(buf, at,
+			btr->cur_basic_info, &v);
 		if (status != BT_CTF_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read unsigned 32-bit bit array for floating point number field: "
 				"btr-addr=%p, status=%s",
@@ -653,14 +954,8 @@ enum bt_ctf_btr_status read_basic_float_and_call_cb(struct bt_ctf_btr *btr,
 			double d;
 		} f64;
 
-		ret = bt_ctf_field_type_floating_point_get_mantissa_digits(
-			btr->cur_basic_field_type);
-		assert(ret == 53);
-		ret = bt_ctf_field_type_floating_point_get_exponent_digits(
-			btr->cur_basic_field_type);
-		assert(ret == 11);
-		status = read_unsigned_bitfield(buf, at, field_size, bo,
-			&f64.u);
+		status = read_unsigned_bitfield(buf, at,
+			btr->cur_basic_info, &f64.u);
 		if (status != BT_CTF_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read unsigned 64-bit bit array for floating point number field: "
 				"btr-addr=%p, status=%s",
@@ -685,7 +980,7 @@ enum bt_ctf_btr_status read_basic_float_and_call_cb(struct bt_ctf_btr *btr,
 	if (btr->user.cbs.types.floating_point) {
 		BT_LOGV("Calling user function (floating point number).");
 		status = btr->user.cbs.types.floating_point(dblval,
-			btr->cur_basic_field_type, btr->user.data);
+			btr->cur_basic_info->type, btr->user.data);
 		BT_LOGV("User function returned: status=%s",
 			bt_ctf_btr_status_string(status));
 		if (status != BT_CTF_BTR_STATUS_OK) {
@@ -698,28 +993,19 @@ end:
 	return status;
 }
 
-static inline
-enum bt_ctf_btr_status read_basic_int_and_call(struct bt_ctf_btr *btr,
-		const uint8_t *buf, size_t at,
-		struct bt_ctf_field_type *int_type,
-		struct bt_ctf_field_type *orig_type)
+static
+enum bt_ctf_btr_status read_basic_int_and_call_cb(struct bt_ctf_btr *btr,
+		const uint8_t *buf, size_t at)
 {
-	int signd;
-	int64_t field_size;
 	enum bt_ctf_byte_order bo;
 	enum bt_ctf_btr_status status = BT_CTF_BTR_STATUS_OK;
 
-	signd = bt_ctf_field_type_integer_get_signed(int_type);
-	field_size = get_basic_field_type_size(btr, int_type);
-	if (field_size < 1) {
-		BT_LOGW("Cannot get integer field type's size: "
-			"btr=%p, at=%zu, ft-addr=%p",
-			btr, at, int_type);
-		status = BT_CTF_BTR_STATUS_ERROR;
-		goto end;
-	}
-
-	bo = bt_ctf_field_type_get_byte_order(int_type);
+	/*
+	 * For an enumeration type, the current basic field type's
+	 * decoding information contains the size, byte order, and
+	 * signedness of its container integer type.
+	 */
+	bo = btr->cur_basic_info->bo;
 
 	/*
 	 * Update current byte order now because we could be reading
@@ -728,10 +1014,11 @@ enum bt_ctf_btr_status read_basic_int_and_call(struct bt_ctf_btr *btr,
 	 */
 	btr->cur_bo = bo;
 
-	if (signd) {
+	if (btr->cur_basic_info->is_signed) {
 		int64_t v;
 
-		status = read_signed_bitfield(buf, at, field_size, bo, &v);
+		status = read_signed_bitfield(buf, at,
+			btr->cur_basic_info, &v);
 		if (status != BT_CTF_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read signed bit array for signed integer field: "
 				"btr-addr=%p, status=%s",
@@ -742,7 +1029,7 @@ enum bt_ctf_btr_status read_basic_int_and_call(struct bt_ctf_btr *btr,
 		if (btr->user.cbs.types.signed_int) {
 			BT_LOGV("Calling user function (signed integer).");
 			status = btr->user.cbs.types.signed_int(v,
-				btr->cur_basic_field_type, btr->user.data);
+				btr->cur_basic_info->type, btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_ctf_btr_status_string(status));
 			if (status != BT_CTF_BTR_STATUS_OK) {
@@ -754,7 +1041,8 @@ enum bt_ctf_btr_status read_basic_int_and_call(struct bt_ctf_btr *btr,
 	} else {
 		uint64_t v;
 
-		status = read_unsigned_bitfield(buf, at, field_size, bo, &v);
+		status = read_unsigned_bitfield(buf, at,
+			btr->cur_basic_info, &v);
 		if (status != BT_CTF_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read unsigned bit array for unsigned integer field: "
 				"btr-addr=%p, status=%s",
@@ -765,7 +1053,7 @@ enum bt_ctf_btr_status read_basic_int_and_call(struct bt_ctf_btr *btr,
 		if (btr->user.cbs.types.unsigned_int) {
 			BT_LOGV("Calling user function (unsigned integer).");
 			status = btr->user.cbs.types.unsigned_int(v,
-				btr->cur_basic_field_type, btr->user.data);
+				btr->cur_basic_info->type, btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_ctf_btr_status_string(status));
 			if (status != BT_CTF_BTR_STATUS_OK) {
@@ -780,30 +1068,6 @@ end:
 	return status;
 }
 
-static
-enum bt_ctf_btr_status read_basic_int_and_call_cb(struct bt_ctf_btr *btr,
-		const uint8_t *buf, size_t at)
-{
-	return read_basic_int_and_call(btr, buf, at, btr->cur_basic_field_type,
-		btr->cur_basic_field_type);
-}
-
-static
-enum bt_ctf_btr_status read_basic_enum_and_call_cb(struct bt_ctf_btr *btr,
-		const uint8_t *buf, size_t at)
-{
-	struct bt_ctf_field_type *int_field_type;
-	enum bt_ctf_btr_status status = BT_CTF_BTR_STATUS_OK;
-
-	int_field_type = bt_ctf_field_type_enumeration_get_container_type(
-		btr->cur_basic_field_type);
-	assert(int_field_type);
-	status = read_basic_int_and_call(btr, buf, at,
-		int_field_type, btr->cur_basic_field_type);
-	bt_put(int_field_type);
-	return status;
-}
-
 static inline
 enum bt_ctf_btr_status read_basic_type_and_call_continue(struct bt_ctf_btr *btr,
 		read_basic_and_call_cb_t read_basic_and_call_cb)
@@ -819,15 +1083,7 @@ enum bt_ctf_btr_status read_basic_type_and_call_continue(struct bt_ctf_btr *btr,
 		goto end;
 	}
 
-	field_size = get_basic_field_type_size(btr, btr->cur_basic_field_type);
-	if (field_size < 1) {
-		BT_LOGW("Cannot get basic field type's size: "
-			"btr-addr=%p, ft-addr=%p",
-			btr, btr->cur_basic_field_type);
-		status = BT_CTF_BTR_STATUS_ERROR;
-		goto end;
-	}
-
+	field_size = btr->cur_basic_info->size;
 	available = available_bits(btr);
 	needed_bits = field_size - btr->stitch.at;
 	BT_LOGV("Continuing basic field decoding: "
@@ -842,7 +1098,7 @@ enum bt_ctf_btr_status read_basic_type_and_call_continue(struct bt_ctf_btr *btr,
 		if (status != BT_CTF_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read basic field: "
 				"btr-addr=%p, ft-addr=%p, status=%s",
-				btr, btr->cur_basic_field_type,
+				btr, btr->cur_basic_info->type,
 				bt_ctf_btr_status_string(status));
 			goto end;
 		}
@@ -883,16 +1139,8 @@ enum bt_ctf_btr_status read_basic_type_and_call_begin(struct bt_ctf_btr *btr,
 		goto end;
 	}
 
-	field_size = get_basic_field_type_size(btr, btr->cur_basic_field_type);
-	if (field_size < 1) {
-		BT_LOGW("Cannot get basic field type's size: "
-			"btr-addr=%p, ft-addr=%p",
-			btr, btr->cur_basic_field_type);
-		status = BT_CTF_BTR_STATUS_ERROR;
-		goto end;
-	}
-
-	bo = bt_ctf_field_type_get_byte_order(btr->cur_basic_field_type);
+	field_size = btr->cur_basic_info->size;
+	bo = btr->cur_basic_info->bo;
 	status = validate_contiguous_bo(btr, bo);
 	if (status != BT_CTF_BTR_STATUS_OK) {
 		/* validate_contiguous_bo() logs errors */
@@ -908,7 +1156,7 @@ enum bt_ctf_btr_status read_basic_type_and_call_begin(struct bt_ctf_btr *btr,
 		if (status != BT_CTF_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read basic field: "
 				"btr-addr=%p, ft-addr=%p, status=%s",
-				btr, btr->cur_basic_field_type,
+				btr, btr->cur_basic_info->type,
 				bt_ctf_btr_status_string(status));
 			goto end;
 		}
@@ -974,7 +1222,7 @@ enum bt_ctf_btr_status read_basic_enum_type_and_call_begin(
 		struct bt_ctf_btr *btr)
 {
 	return read_basic_type_and_call_begin(btr,
-		read_basic_enum_and_call_cb);
+		read_basic_int_and_call_cb);
 }
 
 static inline
@@ -982,7 +1230,7 @@ enum bt_ctf_btr_status read_basic_enum_type_and_call_continue(
 		struct bt_ctf_btr *btr)
 {
 	return read_basic_type_and_call_continue(btr,
-		read_basic_enum_and_call_cb);
+		read_basic_int_and_call_cb);
 }
 
 static inline
@@ -1010,7 +1258,7 @@ enum bt_ctf_btr_status read_basic_string_type_and_call(
 	if (begin && btr->user.cbs.types.string_begin) {
 		BT_LOGV("Calling user function (string, beginning).");
 		status = btr->user.cbs.types.string_begin(
-			btr->cur_basic_field_type, btr->user.data);
+			btr->cur_basic_info->type, btr->user.data);
 		BT_LOGV("User function returned: status=%s",
 			bt_ctf_btr_status_string(status));
 		if (status != BT_CTF_BTR_STATUS_OK) {
@@ -1026,7 +1274,7 @@ enum bt_ctf_btr_status read_basic_string_type_and_call(
 			BT_LOGV("Calling user function (substring).");
 			status = btr->user.cbs.types.string(
 				(const char *) first_chr,
-				available_bytes, btr->cur_basic_field_type,
+				available_bytes, btr->cur_basic_info->type,
 				btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_ctf_btr_status_string(status));
@@ -1049,7 +1297,7 @@ enum bt_ctf_btr_status read_basic_string_type_and_call(
 			BT_LOGV("Calling user function (substring).");
 			status = btr->user.cbs.types.string(
 				(const char *) first_chr,
-				result_len, btr->cur_basic_field_type,
+				result_len, btr->cur_basic_info->type,
 				btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_ctf_btr_status_string(status));
@@ -1064,7 +1312,7 @@ enum bt_ctf_btr_status read_basic_string_type_and_call(
 		if (btr->user.cbs.types.string_end) {
 			BT_LOGV("Calling user function (string, end).");
 			status = btr->user.cbs.types.string_end(
-				btr->cur_basic_field_type, btr->user.data);
+				btr->cur_basic_info->type, btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_ctf_btr_status_string(status));
 			if (status != BT_CTF_BTR_STATUS_OK) {
@@ -1097,9 +1345,9 @@ enum bt_ctf_btr_status read_basic_begin_state(struct bt_ctf_btr *btr)
 {
 	enum bt_ctf_btr_status status;
 
-	assert(btr->cur_basic_field_type);
+	assert(btr->cur_basic_info);
 
-	switch (bt_ctf_field_type_get_type_id(btr->cur_basic_field_type)) {
+	switch (btr->cur_basic_info->id) {
 	case BT_CTF_FIELD_TYPE_ID_INTEGER:
 		status = read_basic_int_type_and_call_begin(btr);
 		break;
@@ -1115,10 +1363,8 @@ enum bt_ctf_btr_status read_basic_begin_state(struct bt_ctf_btr *btr)
 	default:
 		BT_LOGF("Unknown basic field type ID: "
 			"btr-addr=%p, ft-addr=%p, ft-id=%s",
-			btr, btr->cur_basic_field_type,
-			bt_ctf_field_type_id_string(
-				bt_ctf_field_type_get_type_id(
-					btr->cur_basic_field_type)));
+			btr, btr->cur_basic_info->type,
+			bt_ctf_field_type_id_string(btr->cur_basic_info->id));
 		abort();
 	}
 
@@ -1130,9 +1376,9 @@ enum bt_ctf_btr_status read_basic_continue_state(struct bt_ctf_btr *btr)
 {
 	enum bt_ctf_btr_status status;
 
-	assert(btr->cur_basic_field_type);
+	assert(btr->cur_basic_info);
 
-	switch (bt_ctf_field_type_get_type_id(btr->cur_basic_field_type)) {
+	switch (btr->cur_basic_info->id) {
 	case BT_CTF_FIELD_TYPE_ID_INTEGER:
 		status = read_basic_int_type_and_call_continue(btr);
 		break;
@@ -1148,10 +1394,8 @@ enum bt_ctf_btr_status read_basic_continue_state(struct bt_ctf_btr *btr)
 	default:
 		BT_LOGF("Unknown basic field type ID: "
 			"btr-addr=%p, ft-addr=%p, ft-id=%s",
-			btr, btr->cur_basic_field_type,
-			bt_ctf_field_type_id_string(
-				bt_ctf_field_type_get_type_id(
-					btr->cur_basic_field_type)));
+			btr, btr->cur_basic_info->type,
+			bt_ctf_field_type_id_string(btr->cur_basic_info->id));
 		abort();
 	}
 
@@ -1169,32 +1413,12 @@ size_t bits_to_skip_to_align_to(struct bt_ctf_btr *btr, size_t align)
 
 static inline
 enum bt_ctf_btr_status align_type_state(struct bt_ctf_btr *btr,
-		struct bt_ctf_field_type *field_type, enum btr_state next_state)
+		struct type_info *info, enum btr_state next_state)
 {
-	int field_alignment;
+	unsigned int field_alignment = info->alignment;
 	size_t skip_bits;
 	enum bt_ctf_btr_status status = BT_CTF_BTR_STATUS_OK;
 
-	/* Get field's alignment */
-	field_alignment = bt_ctf_field_type_get_alignment(field_type);
-	if (field_alignment < 0) {
-		BT_LOGW("Cannot get field type's alignment: "
-			"btr-addr=%p, ft-addr=%p, ft-id=%s",
-			btr, field_type,
-			bt_ctf_field_type_id_string(
-				bt_ctf_field_type_get_type_id(field_type)));
-		status = BT_CTF_BTR_STATUS_ERROR;
-		goto end;
-	}
-
-	/*
-	 * 0 means "undefined" for variants; what we really want is 1
-	 * (always aligned)
-	 */
-	if (field_alignment == 0) {
-		field_alignment = 1;
-	}
-
 	/* Compute how many bits we need to skip */
 	skip_bits = bits_to_skip_to_align_to(btr, field_alignment);
 
@@ -1229,21 +1453,12 @@ end:
 	return status;
 }
 
-static inline
-bool is_compound_type(struct bt_ctf_field_type *field_type)
-{
-	enum bt_ctf_field_type_id id = bt_ctf_field_type_get_type_id(field_type);
-
-	return id == BT_CTF_FIELD_TYPE_ID_STRUCT || id == BT_CTF_FIELD_TYPE_ID_ARRAY ||
-		id == BT_CTF_FIELD_TYPE_ID_SEQUENCE || id == BT_CTF_FIELD_TYPE_ID_VARIANT;
-}
-
 static inline
 enum bt_ctf_btr_status next_field_state(struct bt_ctf_btr *btr)
 {
 	int ret;
 	struct stack_entry *top;
-	struct bt_ctf_field_type *next_field_type = NULL;
+	struct type_info *next_info = NULL;
 	enum bt_ctf_btr_status status = BT_CTF_BTR_STATUS_OK;
 
 	if (stack_empty(btr->stack)) {
@@ -1257,7 +1472,7 @@ enum bt_ctf_btr_status next_field_state(struct bt_ctf_btr *btr)
 		if (btr->user.cbs.types.compound_end) {
 			BT_LOGV("Calling user function (compound, end).");
 			status = btr->user.cbs.types.compound_end(
-				top->base_type, btr->user.data);
+				top->base_info->type, btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_ctf_btr_status_string(status));
 			if (status != BT_CTF_BTR_STATUS_OK) {
@@ -1279,53 +1494,49 @@ enum bt_ctf_btr_status next_field_state(struct bt_ctf_btr *btr)
 		top->index++;
 	}
 
-	/* Get next field's type */
-	switch (bt_ctf_field_type_get_type_id(top->base_type)) {
+	/* Get next field's decoding information */
+	switch (top->base_info->id) {
 	case BT_CTF_FIELD_TYPE_ID_STRUCT:
-		ret = bt_ctf_field_type_structure_get_field(
-			top->base_type, NULL, &next_field_type,
-			top->index);
-		if (ret) {
-			next_field_type = NULL;
-		}
+		next_info = top->base_info->children[top->index];
 		break;
 	case BT_CTF_FIELD_TYPE_ID_ARRAY:
-		next_field_type =
-			bt_ctf_field_type_array_get_element_type(
-				top->base_type);
-		break;
 	case BT_CTF_FIELD_TYPE_ID_SEQUENCE:
-		next_field_type =
-			bt_ctf_field_type_sequence_get_element_type(
-				top->base_type);
+		next_info = top->base_info->children[0];
 		break;
 	case BT_CTF_FIELD_TYPE_ID_VARIANT:
+	{
+		struct bt_ctf_field_type *next_field_type;
+
 		/* Variant types are dynamic: query the user, he should know! */
 		next_field_type =
 			btr->user.cbs.query.get_variant_type(
-				top->base_type, btr->user.data);
+				top->base_info->type, btr->user.data);
+		if (next_field_type) {
+			next_info = get_type_info(btr, next_field_type);
+			bt_put(next_field_type);
+		}
 		break;
+	}
 	default:
 		break;
 	}
 
-	if (!next_field_type) {
+	if (!next_info) {
 		BT_LOGW("Cannot get the field type of the next field: "
 			"btr-addr=%p, base-ft-addr=%p, base-ft-id=%s, "
 			"index=%" PRId64,
-			btr, top->base_type,
-			bt_ctf_field_type_id_string(
-				bt_ctf_field_type_get_type_id(top->base_type)),
+			btr, top->base_info->type,
+			bt_ctf_field_type_id_string(top->base_info->id),
 			top->index);
 		status = BT_CTF_BTR_STATUS_ERROR;
 		goto end;
 	}
 
-	if (is_compound_type(next_field_type)) {
+	if (next_info->is_compound) {
 		if (btr->user.cbs.types.compound_begin) {
 			BT_LOGV("Calling user function (compound, begin).");
 			status = btr->user.cbs.types.compound_begin(
-				next_field_type, btr->user.data);
+				next_info->type, btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_ctf_btr_status_string(status));
 			if (status != BT_CTF_BTR_STATUS_OK) {
@@ -1335,7 +1546,7 @@ enum bt_ctf_btr_status next_field_state(struct bt_ctf_btr *btr)
 			}
 		}
 
-		ret = stack_push_with_len(btr, next_field_type);
+		ret = stack_push_with_len(btr, next_info);
 		if (ret) {
 			/* stack_push_with_len() logs errors */
 			status = BT_CTF_BTR_STATUS_ERROR;
@@ -1349,16 +1560,16 @@ enum bt_ctf_btr_status next_field_state(struct bt_ctf_btr *btr)
 		BT_LOGV("Replacing current basic field type: "
 			"btr-addr=%p, cur-basic-ft-addr=%p, "
 			"next-basic-ft-addr=%p",
-			btr, btr->cur_basic_field_type, next_field_type);
-		BT_MOVE(btr->cur_basic_field_type, next_field_type);
+			btr, btr->cur_basic_info ?
+				btr->cur_basic_info->type : NULL,
+			next_info->type);
+		btr->cur_basic_info = next_info;
 
 		/* Next state: align a basic type */
 		btr->state = BTR_STATE_ALIGN_BASIC;
 	}
 
 end:
-	BT_PUT(next_field_type);
-
 	return status;
 }
 
@@ -1375,11 +1586,11 @@ enum bt_ctf_btr_status handle_state(struct bt_ctf_btr *btr)
 		status = next_field_state(btr);
 		break;
 	case BTR_STATE_ALIGN_BASIC:
-		status = align_type_state(btr, btr->cur_basic_field_type,
+		status = align_type_state(btr, btr->cur_basic_info,
 			BTR_STATE_READ_BASIC_BEGIN);
 		break;
 	case BTR_STATE_ALIGN_COMPOUND:
-		status = align_type_state(btr, stack_top(btr->stack)->base_type,
+		status = align_type_state(btr, stack_top(btr->stack)->base_info,
 			BTR_STATE_NEXT_FIELD);
 		break;
 	case BTR_STATE_READ_BASIC_BEGIN:
@@ -1416,6 +1627,15 @@ struct bt_ctf_btr *bt_ctf_btr_create(struct bt_ctf_btr_cbs cbs, void *data)
 		goto end;
 	}
 
+	btr->type_infos = g_hash_table_new_full(g_direct_hash,
+		g_direct_equal, NULL, type_info_destroy);
+	if (!btr->type_infos) {
+		BT_LOGE_STR("Failed to allocate a GHashTable.");
+		bt_ctf_btr_destroy(btr);
+		btr = NULL;
+		goto end;
+	}
+
 	btr->state = BTR_STATE_NEXT_FIELD;
 	btr->user.cbs = cbs;
 	btr->user.data = data;
@@ -1432,7 +1652,11 @@ void bt_ctf_btr_destroy(struct bt_ctf_btr *btr)
 	}
 
 	BT_LOGD("Destroying BTR: addr=%p", btr);
-	BT_PUT(btr->cur_basic_field_type);
+
+	if (btr->type_infos) {
+		g_hash_table_destroy(btr->type_infos);
+	}
+
 	g_free(btr);
 }
 
@@ -1441,7 +1665,7 @@ void reset(struct bt_ctf_btr *btr)
 {
 	BT_LOGD("Resetting BTR: addr=%p", btr);
 	stack_clear(btr->stack);
-	BT_PUT(btr->cur_basic_field_type);
+	btr->cur_basic_info = NULL;
 	stitch_reset(btr);
 	btr->buf.addr = NULL;
 	btr->last_bo = BT_CTF_BYTE_ORDER_UNKNOWN;
@@ -1462,6 +1686,8 @@ size_t bt_ctf_btr_start(struct bt_ctf_btr *btr,
 	size_t offset, size_t packet_offset, size_t sz,
 	enum bt_ctf_btr_status *status)
 {
+	struct type_info *info;
+
 	assert(btr);
 	assert(buf);
 	assert(sz > 0);
@@ -1481,7 +1707,14 @@ size_t bt_ctf_btr_start(struct bt_ctf_btr *btr,
 		btr, type, buf, sz, offset, packet_offset);
 
 	/* Set root type */
-	if (is_compound_type(type)) {
+	info = get_type_info(btr, type);
+	if (!info) {
+		/* get_type_info() logs errors */
+		*status = BT_CTF_BTR_STATUS_ERROR;
+		goto end;
+	}
+
+	if (info->is_compound) {
 		/* Compound type: push on visit stack */
 		int stack_ret;
 
@@ -1498,7 +1731,7 @@ size_t bt_ctf_btr_start(struct bt_ctf_btr *btr,
 			}
 		}
 
-		stack_ret = stack_push_with_len(btr, type);
+		stack_ret = stack_push_with_len(btr, info);
 		if (stack_ret) {
 			/* stack_push_with_len() logs errors */
 			*status = BT_CTF_BTR_STATUS_ERROR;
@@ -1508,8 +1741,7 @@ size_t bt_ctf_btr_start(struct bt_ctf_btr *btr,
 		btr->state = BTR_STATE_ALIGN_COMPOUND;
 	} else {
 		/* Basic type: set as current basic type */
-		btr->cur_basic_field_type = type;
-		bt_get(btr->cur_basic_field_type);
+		btr->cur_basic_info = info;
 		btr->state = BTR_STATE_ALIGN_BASIC;
 	}
 
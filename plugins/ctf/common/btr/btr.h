@@ -46,6 +46,11 @@
  * one or more buffer of bytes. It does not know CTF dynamic scopes,
  * events, or streams. Sequence lengths and selected variant types are
  * requested to the user when needed.
+ *
+ * The first time a binary type reader meets a field type, it resolves
+ * its decoding properties (alignment, size, byte order, signedness,
+ * and nested field types) once and caches them for the reader's
+ * lifetime. The field types to decode must therefore be frozen.
  */
 
 /**
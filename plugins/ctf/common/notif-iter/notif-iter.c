@@ -148,7 +148,8 @@ struct bt_ctf_notif_iter {
 	 *
 	 * This is set when a dynamic scope field is first created by
 	 * btr_compound_begin_cb(). It points to one of the fields in
-	 * dscopes below.
+	 * dscopes below. If this field already exists, it is reused
+	 * instead of being created.
 	 */
 	struct bt_ctf_field **cur_dscope_field;
 
@@ -162,12 +163,27 @@ struct bt_ctf_notif_iter {
 	/* Current packet (NULL if not created yet) */
 	struct bt_ctf_packet *packet;
 
+	/*
+	 * Current event (NULL if not created yet), created from its
+	 * class's event pool as soon as the event class is known so
+	 * that the event context and payload fields of a recycled event
+	 * are decoded again in place.
+	 */
+	struct bt_ctf_event *event;
+
 	/*
 	 * Current timestamp_end field (to consider before switching packets).
 	 */
 	struct bt_ctf_field *cur_timestamp_end;
 
-	/* Database of current dynamic scopes (owned by this) */
+	/*
+	 * Database of current dynamic scopes (owned by this).
+	 *
+	 * Once an event is created, stream_event_header and
+	 * stream_event_context are the fields which the event had
+	 * before (they are only owned by this), to decode the next
+	 * event's into.
+	 */
 	struct {
 		struct bt_ctf_field *trace_packet_header;
 		struct bt_ctf_field *stream_packet_context;
@@ -538,7 +554,6 @@ enum bt_ctf_notif_iter_status read_dscope_begin_state(
 		goto end;
 	}
 
-	bt_put(*dscope_field);
 	notit->cur_dscope_field = dscope_field;
 	BT_LOGV("Starting BTR: notit-addr=%p, btr-addr=%p, ft-addr=%p",
 		notit, notit->btr, dscope_field_type);
@@ -628,6 +643,8 @@ end:
 static
 void put_event_dscopes(struct bt_ctf_notif_iter *notit)
 {
+	BT_LOGV_STR("Putting event.");
+	BT_PUT(notit->event);
 	BT_LOGV_STR("Putting event header field.");
 	BT_PUT(notit->dscopes.stream_event_header);
 	BT_LOGV_STR("Putting stream event context field.");
@@ -673,6 +690,7 @@ enum bt_ctf_notif_iter_status read_packet_header_begin_state(
 		"notit-addr=%p, trace-addr=%p, trace-name=\"%s\", ft-addr=%p",
 		notit, notit->meta.trace,
 		bt_ctf_trace_get_name(notit->meta.trace), packet_header_type);
+	BT_PUT(notit->dscopes.trace_packet_header);
 	ret = read_dscope_begin_state(notit, packet_header_type,
 		STATE_AFTER_TRACE_PACKET_HEADER,
 		STATE_DSCOPE_TRACE_PACKET_HEADER_CONTINUE,
@@ -1011,6 +1029,7 @@ enum bt_ctf_notif_iter_status read_packet_context_begin_state(
 		bt_ctf_stream_class_get_name(notit->meta.stream_class),
 		bt_ctf_stream_class_get_id(notit->meta.stream_class),
 		packet_context_type);
+	BT_PUT(notit->dscopes.stream_packet_context);
 	status = read_dscope_begin_state(notit, packet_context_type,
 		STATE_AFTER_STREAM_PACKET_CONTEXT,
 		STATE_DSCOPE_STREAM_PACKET_CONTEXT_CONTINUE,
@@ -1155,7 +1174,13 @@ enum bt_ctf_notif_iter_status read_event_header_begin_state(
 		goto end;
 	}
 
-	put_event_dscopes(notit);
+	/*
+	 * Keep the stream event header and context fields: they are
+	 * decoded again in place (see create_event()).
+	 */
+	BT_PUT(notit->event);
+	BT_PUT(notit->dscopes.event_context);
+	BT_PUT(notit->dscopes.event_payload);
 	BT_LOGV("Decoding event header field: "
 		"notit-addr=%p, stream-class-addr=%p, "
 		"stream-class-name=\"%s\", stream-class-id=%" PRId64 ", "
@@ -1363,6 +1388,30 @@ enum bt_ctf_notif_iter_status after_event_header_state(
 		goto end;
 	}
 
+	/*
+	 * Create the event now, possibly recycled, to decode the event
+	 * context and payload fields directly into its own fields.
+	 */
+	BT_PUT(notit->event);
+	notit->event = bt_ctf_event_create_pooled(notit->meta.event_class);
+	if (!notit->event) {
+		BT_LOGE("Cannot create event: "
+			"notit-addr=%p, event-class-addr=%p, "
+			"event-class-name=\"%s\", "
+			"event-class-id=%" PRId64,
+			notit, notit->meta.event_class,
+			bt_ctf_event_class_get_name(notit->meta.event_class),
+			bt_ctf_event_class_get_id(notit->meta.event_class));
+		status = BT_CTF_NOTIF_ITER_STATUS_ERROR;
+		goto end;
+	}
+
+	BT_PUT(notit->dscopes.event_context);
+	notit->dscopes.event_context =
+		bt_ctf_event_get_event_context(notit->event);
+	BT_PUT(notit->dscopes.event_payload);
+	notit->dscopes.event_payload =
+		bt_ctf_event_get_event_payload(notit->event);
 	notit->state = STATE_DSCOPE_STREAM_EVENT_CONTEXT_BEGIN;
 
 end:
@@ -1642,10 +1691,28 @@ enum bt_ctf_notif_iter_status handle_state(struct bt_ctf_notif_iter *notit)
 	return status;
 }
 
-/**
- * Resets the internal state of a CTF notification iterator.
- */
 static
+void reset_clock_states(struct bt_ctf_notif_iter *notit)
+{
+	GHashTableIter iter;
+	gpointer clock_class;
+	uint64_t *clock_state;
+
+	if (!notit->clock_states) {
+		return;
+	}
+
+	g_hash_table_iter_init(&iter, notit->clock_states);
+
+	while (g_hash_table_iter_next(&iter, &clock_class,
+			(gpointer) &clock_state)) {
+		if (clock_state) {
+			*clock_state = 0;
+		}
+	}
+}
+
+BT_HIDDEN
 void bt_ctf_notif_iter_reset(struct bt_ctf_notif_iter *notit)
 {
 	assert(notit);
@@ -1654,7 +1721,9 @@ void bt_ctf_notif_iter_reset(struct bt_ctf_notif_iter *notit)
 	BT_PUT(notit->meta.stream_class);
 	BT_PUT(notit->meta.event_class);
 	BT_PUT(notit->packet);
+	BT_PUT(notit->cur_timestamp_end);
 	put_all_dscopes(notit);
+	reset_clock_states(notit);
 	notit->buf.addr = NULL;
 	notit->buf.sz = 0;
 	notit->buf.at = 0;
@@ -2197,8 +2266,22 @@ enum bt_ctf_btr_status btr_compound_begin_cb(
 
 	/* Create field */
 	if (stack_empty(notit->stack)) {
-		/* Root: create dynamic scope field */
-		*notit->cur_dscope_field = bt_ctf_field_create(type);
+		/* Root: create dynamic scope field, or reuse it */
+		if (*notit->cur_dscope_field) {
+			struct bt_ctf_field_type *cur_type =
+				bt_ctf_field_get_type(
+					*notit->cur_dscope_field);
+
+			bt_put(cur_type);
+			if (cur_type != type) {
+				BT_PUT(*notit->cur_dscope_field);
+			}
+		}
+
+		if (!*notit->cur_dscope_field) {
+			*notit->cur_dscope_field = bt_ctf_field_create(type);
+		}
+
 		field = *notit->cur_dscope_field;
 
 		/*
@@ -2519,6 +2602,35 @@ end:
 	return ret;
 }
 
+/*
+ * Sets the field *dscope_field to the event with set_field(), and
+ * replaces *dscope_field with the field which the event had before.
+ *
+ * Since the event comes from its class's event pool, the field it had
+ * before is reset and only owned by this once it's replaced: the next
+ * event's field is decoded into it.
+ */
+static
+int swap_event_dscope_field(struct bt_ctf_event *event,
+		struct bt_ctf_field **dscope_field,
+		struct bt_ctf_field *(*get_field)(struct bt_ctf_event *),
+		int (*set_field)(struct bt_ctf_event *, struct bt_ctf_field *))
+{
+	struct bt_ctf_field *prev_field = get_field(event);
+	int ret;
+
+	ret = set_field(event, *dscope_field);
+	if (ret) {
+		goto end;
+	}
+
+	BT_MOVE(*dscope_field, prev_field);
+
+end:
+	bt_put(prev_field);
+	return ret;
+}
+
 static
 struct bt_ctf_event *create_event(struct bt_ctf_notif_iter *notit)
 {
@@ -2533,22 +2645,15 @@ struct bt_ctf_event *create_event(struct bt_ctf_notif_iter *notit)
 		bt_ctf_event_class_get_name(notit->meta.event_class),
 		bt_ctf_event_class_get_id(notit->meta.event_class));
 
-	/* Create event object. */
-	event = bt_ctf_event_create(notit->meta.event_class);
-	if (!event) {
-		BT_LOGE("Cannot create event: "
-			"notit-addr=%p, event-class-addr=%p, "
-			"event-class-name=\"%s\", "
-			"event-class-id=%" PRId64,
-			notit, notit->meta.event_class,
-			bt_ctf_event_class_get_name(notit->meta.event_class),
-			bt_ctf_event_class_get_id(notit->meta.event_class));
-		goto error;
-	}
+	/* The event object was created by after_event_header_state(). */
+	assert(notit->event);
+	event = notit->event;
+	notit->event = NULL;
 
 	/* Set header, stream event context, context, and payload fields. */
-	ret = bt_ctf_event_set_header(event,
-		notit->dscopes.stream_event_header);
+	ret = swap_event_dscope_field(event,
+		&notit->dscopes.stream_event_header,
+		bt_ctf_event_get_header, bt_ctf_event_set_header);
 	if (ret) {
 		BT_LOGE("Cannot set event's header field: "
 			"notit-addr=%p, event-addr=%p, event-class-addr=%p, "
@@ -2561,8 +2666,10 @@ struct bt_ctf_event *create_event(struct bt_ctf_notif_iter *notit)
 		goto error;
 	}
 
-	ret = bt_ctf_event_set_stream_event_context(event,
-		notit->dscopes.stream_event_context);
+	ret = swap_event_dscope_field(event,
+		&notit->dscopes.stream_event_context,
+		bt_ctf_event_get_stream_event_context,
+		bt_ctf_event_set_stream_event_context);
 	if (ret) {
 		BT_LOGE("Cannot set event's context field: "
 			"notit-addr=%p, event-addr=%p, event-class-addr=%p, "
@@ -2603,6 +2710,14 @@ struct bt_ctf_event *create_event(struct bt_ctf_notif_iter *notit)
 		goto error;
 	}
 
+	/*
+	 * Do not keep the event's context and payload fields: the event
+	 * must be their only owner for them to be reused once the event
+	 * is recycled.
+	 */
+	BT_PUT(notit->dscopes.event_context);
+	BT_PUT(notit->dscopes.event_payload);
+
 	ret = set_event_clocks(event, notit);
 	if (ret) {
 		BT_LOGE("Cannot set event's clock values: "
@@ -259,6 +259,20 @@ struct bt_ctf_notif_iter *bt_ctf_notif_iter_create(struct bt_ctf_trace *trace,
 BT_HIDDEN
 void bt_ctf_notif_iter_destroy(struct bt_ctf_notif_iter *notif_iter);
 
+/**
+ * Resets the internal state of a CTF notification iterator.
+ *
+ * The iterator forgets its current buffer, packet, and clock values.
+ * The next call to bt_ctf_notif_iter_get_next_notification() requests
+ * new bytes from the medium and starts decoding a new packet at the
+ * beginning of those bytes. This is used by a medium which changes
+ * its position in the data stream, for example to seek.
+ *
+ * @param notif_iter		CTF notification iterator
+ */
+BT_HIDDEN
+void bt_ctf_notif_iter_reset(struct bt_ctf_notif_iter *notif_iter);
+
 /**
  * Returns the next notification from a CTF notification iterator.
  *
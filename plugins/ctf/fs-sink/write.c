@@ -455,6 +455,16 @@ struct bt_ctf_stream *insert_new_stream(
 		goto error;
 	}
 
+	/*
+	 * Packets are copied as a whole: serialize the events as they
+	 * come instead of keeping a whole packet's events in memory.
+	 */
+	if (bt_ctf_stream_set_serialize_on_append(writer_stream, 1)) {
+		fprintf(writer_component->err, "[error] %s in %s:%d\n",
+				__func__, __FILE__, __LINE__);
+		goto error;
+	}
+
 	g_hash_table_insert(fs_writer->stream_map, (gpointer) stream,
 			writer_stream);
 
@@ -29,6 +29,10 @@
 #include <stdbool.h>
 #include <glib.h>
 #include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <babeltrace/compat/mman-internal.h>
 #include <babeltrace/endian-internal.h>
 #include <babeltrace/ctf-ir/stream.h>
@@ -44,9 +48,53 @@
 #include "data-stream-file.h"
 #include <string.h>
 
+#ifdef __linux__
+# include <sys/vfs.h>
+#endif
+
 #define BT_LOG_TAG "PLUGIN-CTF-FS-SRC-DS"
 #include "logging.h"
 
+/* Default maximum length of a mapping, in pages */
+#define DS_FILE_DEFAULT_MMAP_WINDOW_PAGES	2048
+
+/* Maximum length of data to read ahead at once, in bytes */
+#define DS_FILE_MAX_READAHEAD_LEN		(8 * 1024 * 1024)
+
+/* Capacity of each buffer of the pread() mode, in bytes */
+#define DS_FILE_READ_BUF_CAPACITY		(4 * 1024 * 1024)
+
+#ifdef __linux__
+/* File system magic numbers of network and FUSE file systems */
+#define DS_FILE_NFS_SUPER_MAGIC			0x6969
+#define DS_FILE_SMB_SUPER_MAGIC			0x517b
+#define DS_FILE_CIFS_SUPER_MAGIC		0xff534d42
+#define DS_FILE_SMB2_SUPER_MAGIC		0xfe534d42
+#define DS_FILE_FUSE_SUPER_MAGIC		0x65735546
+#define DS_FILE_CEPH_SUPER_MAGIC		0x00c36400
+#define DS_FILE_V9FS_SUPER_MAGIC		0x01021997
+#define DS_FILE_AFS_SUPER_MAGIC			0x5346414f
+#endif /* __linux__ */
+
+/*
+ * Thread which reads the buffer following the current one of a data
+ * stream file in the pread() mode.
+ */
+struct ctf_fs_ds_file_prefetcher {
+	pthread_t tid;
+
+	/* Protects the members below */
+	pthread_mutex_t lock;
+
+	/* Signaled when `pending_buf` or `quit` changes */
+	pthread_cond_t cond;
+
+	/* Buffer which the thread is asked to read into, or NULL */
+	struct ctf_fs_ds_file_read_buf *pending_buf;
+
+	bool quit;
+};
+
 static inline
 size_t remaining_mmap_bytes(struct ctf_fs_ds_file *ds_file)
 {
@@ -117,6 +165,7 @@ enum bt_ctf_notif_iter_medium_status ds_file_mmap_next(
 		goto error;
 	}
 
+	(void) bt_madvise_sequential(ds_file->mmap_addr, ds_file->mmap_len);
 	goto end;
 error:
 	ds_file_munmap(ds_file);
@@ -125,6 +174,34 @@ end:
 	return ret;
 }
 
+/*
+ * Makes sure that at least the next DS_FILE_MAX_READAHEAD_LEN bytes (or
+ * the next mapping's length, if it's smaller) following the current
+ * request offset are being read into the page cache, so that the page
+ * faults which accessing them causes, even through a future mapping,
+ * don't wait for I/O.
+ */
+static inline
+void ds_file_readahead(struct ctf_fs_ds_file *ds_file)
+{
+	off_t cur_offset = ds_file->mmap_offset + ds_file->request_offset;
+	off_t readahead_len = (off_t) MIN(ds_file->mmap_max_len,
+		DS_FILE_MAX_READAHEAD_LEN);
+
+	if (likely(cur_offset + readahead_len <= ds_file->readahead_offset ||
+			ds_file->readahead_offset >= ds_file->file->size)) {
+		return;
+	}
+
+	if (ds_file->readahead_offset < cur_offset) {
+		ds_file->readahead_offset = cur_offset;
+	}
+
+	(void) bt_fadvise_willneed(fileno(ds_file->file->fp),
+		ds_file->readahead_offset, readahead_len);
+	ds_file->readahead_offset += readahead_len;
+}
+
 static
 enum bt_ctf_notif_iter_medium_status medop_request_bytes(
 		size_t request_sz, uint8_t **buffer_addr,
@@ -162,6 +239,7 @@ enum bt_ctf_notif_iter_medium_status medop_request_bytes(
 		}
 	}
 
+	ds_file_readahead(ds_file);
 	*buffer_sz = MIN(remaining_mmap_bytes(ds_file), request_sz);
 	*buffer_addr = ((uint8_t *) ds_file->mmap_addr) + ds_file->request_offset;
 	ds_file->request_offset += *buffer_sz;
@@ -174,6 +252,437 @@ end:
 	return status;
 }
 
+/*
+ * Returns whether or not the file system of `ds_file` is a network
+ * or FUSE file system, on which memory-mapping performs badly.
+ */
+static
+bool ds_file_is_on_remote_fs(struct ctf_fs_ds_file *ds_file)
+{
+#ifdef __linux__
+	struct statfs buf;
+
+	if (fstatfs(fileno(ds_file->file->fp), &buf)) {
+		BT_LOGW("Cannot get file system information of file \"%s\": %s",
+			ds_file->file->path->str, strerror(errno));
+		return false;
+	}
+
+	switch ((uint32_t) buf.f_type) {
+	case DS_FILE_NFS_SUPER_MAGIC:
+	case DS_FILE_SMB_SUPER_MAGIC:
+	case DS_FILE_CIFS_SUPER_MAGIC:
+	case DS_FILE_SMB2_SUPER_MAGIC:
+	case DS_FILE_FUSE_SUPER_MAGIC:
+	case DS_FILE_CEPH_SUPER_MAGIC:
+	case DS_FILE_V9FS_SUPER_MAGIC:
+	case DS_FILE_AFS_SUPER_MAGIC:
+		return true;
+	default:
+		return false;
+	}
+#else
+	return false;
+#endif /* __linux__ */
+}
+
+static inline
+size_t remaining_read_buf_bytes(struct ctf_fs_ds_file *ds_file)
+{
+	return ds_file->read.bufs[ds_file->read.cur_buf].len -
+		ds_file->read.request_offset;
+}
+
+/*
+ * Reads, with pread(), as many bytes as possible (up to the buffer
+ * capacity) of the data stream file at `offset` into `buf`.
+ */
+static
+void ds_file_read_buf_fill(struct ctf_fs_ds_file *ds_file,
+		struct ctf_fs_ds_file_read_buf *buf, off_t offset)
+{
+	buf->offset = offset;
+	buf->len = 0;
+	buf->status = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK;
+
+	while (buf->len < ds_file->read.buf_capacity) {
+		size_t len = ds_file->read.buf_capacity - buf->len;
+		ssize_t ret = pread(ds_file->read.fd, buf->addr + buf->len,
+			len, offset + buf->len);
+
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			BT_LOGE("Cannot read file \"%s\" at offset %jd: %s",
+				ds_file->file->path->str,
+				(intmax_t) (offset + buf->len),
+				strerror(errno));
+			buf->status = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_ERROR;
+			break;
+		}
+
+		buf->len += (size_t) ret;
+
+		/*
+		 * End of file. With O_DIRECT, a short read also means
+		 * that the end of the file is reached, and reading at
+		 * a non-aligned offset would fail anyway.
+		 */
+		if (ret == 0 || (ds_file->read.fd_is_direct &&
+				(size_t) ret < len)) {
+			break;
+		}
+	}
+}
+
+static
+void *ds_file_prefetcher_thread_func(void *data)
+{
+	struct ctf_fs_ds_file *ds_file = data;
+	struct ctf_fs_ds_file_prefetcher *prefetcher =
+		ds_file->read.prefetcher;
+
+	pthread_mutex_lock(&prefetcher->lock);
+
+	while (!prefetcher->quit) {
+		struct ctf_fs_ds_file_read_buf *buf = prefetcher->pending_buf;
+
+		if (!buf) {
+			pthread_cond_wait(&prefetcher->cond, &prefetcher->lock);
+			continue;
+		}
+
+		pthread_mutex_unlock(&prefetcher->lock);
+		ds_file_read_buf_fill(ds_file, buf, buf->offset);
+		pthread_mutex_lock(&prefetcher->lock);
+		prefetcher->pending_buf = NULL;
+		pthread_cond_broadcast(&prefetcher->cond);
+	}
+
+	pthread_mutex_unlock(&prefetcher->lock);
+	return NULL;
+}
+
+/* Waits until the prefetching thread is done reading its buffer. */
+static
+void ds_file_prefetcher_wait(struct ctf_fs_ds_file_prefetcher *prefetcher)
+{
+	pthread_mutex_lock(&prefetcher->lock);
+
+	while (prefetcher->pending_buf) {
+		pthread_cond_wait(&prefetcher->cond, &prefetcher->lock);
+	}
+
+	pthread_mutex_unlock(&prefetcher->lock);
+}
+
+/*
+ * Makes the prefetching thread read the data stream file at `offset`
+ * into the buffer which is not the current one. The prefetching thread
+ * must not be reading.
+ */
+static
+void ds_file_prefetcher_start(struct ctf_fs_ds_file *ds_file, off_t offset)
+{
+	struct ctf_fs_ds_file_prefetcher *prefetcher =
+		ds_file->read.prefetcher;
+	struct ctf_fs_ds_file_read_buf *buf =
+		&ds_file->read.bufs[!ds_file->read.cur_buf];
+
+	if (offset >= ds_file->file->size) {
+		/* Nothing to prefetch: never use this buffer as is */
+		buf->offset = offset;
+		buf->len = 0;
+		buf->status = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_EOF;
+		return;
+	}
+
+	buf->offset = offset;
+	pthread_mutex_lock(&prefetcher->lock);
+	assert(!prefetcher->pending_buf);
+	prefetcher->pending_buf = buf;
+	pthread_cond_signal(&prefetcher->cond);
+	pthread_mutex_unlock(&prefetcher->lock);
+}
+
+/*
+ * Makes the current buffer contain the data stream file's data at
+ * `offset`, using the prefetched buffer if it's the right one.
+ */
+static
+enum bt_ctf_notif_iter_medium_status ds_file_read_buf_load(
+		struct ctf_fs_ds_file *ds_file, off_t offset)
+{
+	struct ctf_fs_ds_file_read_buf *buf;
+	bool prefetched = false;
+
+	if (offset >= ds_file->file->size) {
+		BT_LOGD("Reached end of file \"%s\" (%p)",
+			ds_file->file->path->str, ds_file->file->fp);
+		return BT_CTF_NOTIF_ITER_MEDIUM_STATUS_EOF;
+	}
+
+	if (ds_file->read.prefetcher) {
+		struct ctf_fs_ds_file_read_buf *prefetched_buf =
+			&ds_file->read.bufs[!ds_file->read.cur_buf];
+
+		ds_file_prefetcher_wait(ds_file->read.prefetcher);
+
+		if (prefetched_buf->offset == offset &&
+				prefetched_buf->status ==
+					BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK) {
+			ds_file->read.cur_buf = !ds_file->read.cur_buf;
+			prefetched = true;
+		}
+	}
+
+	buf = &ds_file->read.bufs[ds_file->read.cur_buf];
+
+	if (!prefetched) {
+		ds_file_read_buf_fill(ds_file, buf, offset);
+	}
+
+	ds_file->read.request_offset = 0;
+
+	if (buf->status != BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK) {
+		/*
+		 * Keep the requested offset with no valid bytes so that
+		 * the next request reads this buffer again from there.
+		 */
+		buf->offset = offset;
+		buf->len = 0;
+		return buf->status;
+	}
+
+	if (buf->len == 0) {
+		/* The file was truncated since it was opened */
+		BT_LOGW("Reached end of file \"%s\" (%p) before its expected size",
+			ds_file->file->path->str, ds_file->file->fp);
+		return BT_CTF_NOTIF_ITER_MEDIUM_STATUS_EOF;
+	}
+
+	if (ds_file->read.prefetcher) {
+		ds_file_prefetcher_start(ds_file, buf->offset + buf->len);
+	}
+
+	return BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK;
+}
+
+static
+enum bt_ctf_notif_iter_medium_status medop_pread_request_bytes(
+		size_t request_sz, uint8_t **buffer_addr,
+		size_t *buffer_sz, void *data)
+{
+	enum bt_ctf_notif_iter_medium_status status =
+		BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK;
+	struct ctf_fs_ds_file *ds_file = data;
+	struct ctf_fs_ds_file_read_buf *buf;
+
+	if (request_sz == 0) {
+		goto end;
+	}
+
+	/* Check if we have at least one buffered byte left */
+	if (remaining_read_buf_bytes(ds_file) == 0) {
+		buf = &ds_file->read.bufs[ds_file->read.cur_buf];
+		status = ds_file_read_buf_load(ds_file,
+			buf->offset + buf->len);
+		if (status != BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK) {
+			goto end;
+		}
+	}
+
+	buf = &ds_file->read.bufs[ds_file->read.cur_buf];
+	*buffer_sz = MIN(remaining_read_buf_bytes(ds_file), request_sz);
+	*buffer_addr = buf->addr + ds_file->read.request_offset;
+	ds_file->read.request_offset += *buffer_sz;
+
+end:
+	return status;
+}
+
+static
+int ds_file_pread_seek(struct ctf_fs_ds_file *ds_file, off_t offset)
+{
+	const size_t page_size = bt_common_get_page_size();
+	struct ctf_fs_ds_file_read_buf *buf =
+		&ds_file->read.bufs[ds_file->read.cur_buf];
+	off_t buf_offset;
+	int ret = 0;
+
+	if (buf->len > 0 && offset >= buf->offset &&
+			(size_t) (offset - buf->offset) < buf->len) {
+		/* Already read: only move the request offset */
+		ds_file->read.request_offset = offset - buf->offset;
+		goto end;
+	}
+
+	if (offset >= ds_file->file->size) {
+		/* Next request returns EOF */
+		buf->offset = ds_file->file->size;
+		buf->len = 0;
+		ds_file->read.request_offset = 0;
+		goto end;
+	}
+
+	/* Read from the page containing the requested offset */
+	buf_offset = offset & ~((off_t) page_size - 1);
+	if (ds_file_read_buf_load(ds_file, buf_offset) !=
+			BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK) {
+		BT_LOGE("Cannot read file \"%s\" (%p) at offset %jd",
+			ds_file->file->path->str, ds_file->file->fp,
+			(intmax_t) buf_offset);
+		goto error;
+	}
+
+	buf = &ds_file->read.bufs[ds_file->read.cur_buf];
+	if ((size_t) (offset - buf_offset) > buf->len) {
+		BT_LOGE("File \"%s\" (%p) is shorter than expected",
+			ds_file->file->path->str, ds_file->file->fp);
+		goto error;
+	}
+
+	ds_file->read.request_offset = offset - buf_offset;
+	goto end;
+
+error:
+	ret = -1;
+
+end:
+	return ret;
+}
+
+static
+int ds_file_pread_init(struct ctf_fs_ds_file *ds_file,
+		struct ctf_fs_ds_file_config *config)
+{
+	const size_t page_size = bt_common_get_page_size();
+	unsigned int nr_bufs;
+	unsigned int i;
+	int ret = 0;
+
+	ds_file->read.fd = fileno(ds_file->file->fp);
+
+	if (config->direct_io) {
+#ifdef O_DIRECT
+		int fd = open(ds_file->file->path->str, O_RDONLY | O_DIRECT);
+
+		if (fd < 0) {
+			BT_LOGW("Cannot open file \"%s\" with O_DIRECT: reading it through the page cache: %s",
+				ds_file->file->path->str, strerror(errno));
+		} else {
+			ds_file->read.fd = fd;
+			ds_file->read.fd_is_direct = true;
+		}
+#else
+		BT_LOGW("Direct I/O is not supported on this platform: reading file \"%s\" through the page cache",
+			ds_file->file->path->str);
+#endif /* O_DIRECT */
+	}
+
+	/* No need for a buffer which is larger than the file */
+	ds_file->read.buf_capacity = MIN(DS_FILE_READ_BUF_CAPACITY,
+		((size_t) ds_file->file->size + page_size - 1) &
+			~(page_size - 1));
+	if (ds_file->read.buf_capacity == 0) {
+		ds_file->read.buf_capacity = page_size;
+	}
+
+	/* Prefetching only helps if there's more than one buffer to read */
+	nr_bufs = config->prefetch &&
+		(size_t) ds_file->file->size > ds_file->read.buf_capacity ?
+		2 : 1;
+
+	for (i = 0; i < nr_bufs; i++) {
+		struct ctf_fs_ds_file_read_buf *buf = &ds_file->read.bufs[i];
+
+		/* Page-aligned, as required by O_DIRECT */
+		buf->alloc_addr = g_malloc(ds_file->read.buf_capacity +
+			page_size);
+		if (!buf->alloc_addr) {
+			BT_LOGE_STR("Failed to allocate a read buffer.");
+			goto error;
+		}
+
+		buf->addr = (uint8_t *) (((uintptr_t) buf->alloc_addr +
+			page_size - 1) & ~((uintptr_t) page_size - 1));
+		buf->offset = -1;
+	}
+
+	/* The first request reads from the beginning of the file */
+	ds_file->read.bufs[0].offset = 0;
+	ds_file->read.bufs[0].len = 0;
+
+	if (nr_bufs == 2) {
+		struct ctf_fs_ds_file_prefetcher *prefetcher =
+			g_new0(struct ctf_fs_ds_file_prefetcher, 1);
+
+		if (!prefetcher) {
+			BT_LOGE_STR("Failed to allocate one prefetcher.");
+			goto error;
+		}
+
+		pthread_mutex_init(&prefetcher->lock, NULL);
+		pthread_cond_init(&prefetcher->cond, NULL);
+		ds_file->read.prefetcher = prefetcher;
+
+		if (pthread_create(&prefetcher->tid, NULL,
+				ds_file_prefetcher_thread_func, ds_file)) {
+			BT_LOGE("Cannot create prefetching thread: %s",
+				strerror(errno));
+			pthread_cond_destroy(&prefetcher->cond);
+			pthread_mutex_destroy(&prefetcher->lock);
+			g_free(prefetcher);
+			ds_file->read.prefetcher = NULL;
+			goto error;
+		}
+	}
+
+	goto end;
+
+error:
+	ret = -1;
+
+end:
+	return ret;
+}
+
+static
+void ds_file_pread_fini(struct ctf_fs_ds_file *ds_file)
+{
+	struct ctf_fs_ds_file_prefetcher *prefetcher =
+		ds_file->read.prefetcher;
+	unsigned int i;
+
+	if (prefetcher) {
+		pthread_mutex_lock(&prefetcher->lock);
+		prefetcher->quit = true;
+		pthread_cond_broadcast(&prefetcher->cond);
+		pthread_mutex_unlock(&prefetcher->lock);
+		(void) pthread_join(prefetcher->tid, NULL);
+		pthread_cond_destroy(&prefetcher->cond);
+		pthread_mutex_destroy(&prefetcher->lock);
+		g_free(prefetcher);
+		ds_file->read.prefetcher = NULL;
+	}
+
+	for (i = 0; i < 2; i++) {
+		g_free(ds_file->read.bufs[i].alloc_addr);
+		ds_file->read.bufs[i].alloc_addr = NULL;
+	}
+
+	if (ds_file->read.fd_is_direct) {
+		if (close(ds_file->read.fd)) {
+			BT_LOGE("Cannot close file \"%s\": %s",
+				ds_file->file->path->str, strerror(errno));
+		}
+
+		ds_file->read.fd_is_direct = false;
+	}
+}
+
 static
 struct bt_ctf_stream *medop_get_stream(
 		struct bt_ctf_stream_class *stream_class, void *data)
@@ -203,7 +712,12 @@ static struct bt_ctf_notif_iter_medium_ops medops = {
 	.request_bytes = medop_request_bytes,
 	.get_stream = medop_get_stream,
 };
-static
+
+static struct bt_ctf_notif_iter_medium_ops pread_medops = {
+	.request_bytes = medop_pread_request_bytes,
+	.get_stream = medop_get_stream,
+};
+BT_HIDDEN
 struct ctf_fs_ds_index *ctf_fs_ds_index_create(size_t length)
 {
 	struct ctf_fs_ds_index *index = g_new0(struct ctf_fs_ds_index, 1);
@@ -498,6 +1012,167 @@ error:
 	goto end;
 }
 
+static
+int get_packet_context_uint_field(struct bt_ctf_field *packet_context_field,
+		const char *name, uint64_t *value)
+{
+	int ret = -1;
+	struct bt_ctf_field *field;
+
+	field = bt_ctf_field_structure_get_field_by_name(packet_context_field,
+		name);
+	if (!field) {
+		goto end;
+	}
+
+	ret = bt_ctf_field_unsigned_integer_get_value(field, value);
+
+end:
+	bt_put(field);
+	return ret;
+}
+
+/*
+ * Builds an index by decoding only the header and context of each
+ * packet of the data stream file, jumping from one packet to the
+ * next one using the packet context's `packet_size` field.
+ */
+static
+struct ctf_fs_ds_index *build_index_from_stream_file(
+		struct ctf_fs_ds_file *ds_file)
+{
+	int ret;
+	struct ctf_fs_ds_index *index = NULL;
+	struct bt_ctf_clock_class *timestamp_begin_cc = NULL;
+	struct bt_ctf_clock_class *timestamp_end_cc = NULL;
+	struct bt_ctf_field *packet_context_field = NULL;
+	off_t current_packet_offset = 0;
+
+	BT_LOGD("Indexing stream file %s", ds_file->file->path->str);
+
+	ret = get_ds_file_packet_bounds_clock_classes(ds_file,
+			&timestamp_begin_cc, &timestamp_end_cc);
+	if (ret) {
+		BT_LOGD("Cannot get clock classes of \"timestamp_begin\" and \"timestamp_end\" fields");
+		goto error;
+	}
+
+	index = ctf_fs_ds_index_create(0);
+	if (!index) {
+		goto error;
+	}
+
+	while (current_packet_offset < ds_file->file->size) {
+		struct ctf_fs_ds_index_entry index_entry = { 0 };
+		uint64_t packet_size_bits;
+		uint64_t content_size_bits;
+
+		ret = ctf_fs_ds_file_seek(ds_file, current_packet_offset);
+		if (ret) {
+			goto error;
+		}
+
+		BT_PUT(packet_context_field);
+		ret = ctf_fs_ds_file_get_packet_header_context_fields(ds_file,
+			NULL, &packet_context_field);
+		if (ret || !packet_context_field) {
+			BT_LOGW("Cannot decode packet context of stream file %s at offset %jd",
+				ds_file->file->path->str,
+				(intmax_t) current_packet_offset);
+			goto error;
+		}
+
+		if (get_packet_context_uint_field(packet_context_field,
+				"packet_size", &packet_size_bits)) {
+			/*
+			 * Without a packet size, the packet is the
+			 * remaining of the file: this is only valid
+			 * for the first (and only) packet.
+			 */
+			if (current_packet_offset != 0) {
+				BT_LOGW("Missing \"packet_size\" field in packet context of stream file %s",
+					ds_file->file->path->str);
+				goto error;
+			}
+
+			packet_size_bits = (uint64_t) ds_file->file->size *
+				CHAR_BIT;
+		}
+
+		if (!get_packet_context_uint_field(packet_context_field,
+				"content_size", &content_size_bits) &&
+				content_size_bits > packet_size_bits) {
+			BT_LOGW("Invalid packet: content size > packet size");
+			goto error;
+		}
+
+		if (packet_size_bits == 0 || packet_size_bits % CHAR_BIT) {
+			BT_LOGW("Invalid packet size encountered in stream file %s",
+				ds_file->file->path->str);
+			goto error;
+		}
+
+		index_entry.offset = current_packet_offset;
+		index_entry.packet_size = packet_size_bits / CHAR_BIT;
+
+		if (index_entry.packet_size > (uint64_t) (ds_file->file->size -
+				current_packet_offset)) {
+			BT_LOGW("Invalid packet size encountered in stream file %s: packet goes beyond the end of the file",
+				ds_file->file->path->str);
+			goto error;
+		}
+
+		if (get_packet_context_uint_field(packet_context_field,
+				"timestamp_begin", &index_entry.timestamp_begin) ||
+				get_packet_context_uint_field(packet_context_field,
+				"timestamp_end", &index_entry.timestamp_end)) {
+			BT_LOGD("Cannot get packet time bounds of stream file %s",
+				ds_file->file->path->str);
+			goto error;
+		}
+
+		if (index_entry.timestamp_end < index_entry.timestamp_begin) {
+			BT_LOGW("Invalid packet time bounds encountered in stream file %s",
+				ds_file->file->path->str);
+			goto error;
+		}
+
+		/* Convert the packet's bound to nanoseconds since Epoch. */
+		ret = convert_cycles_to_ns(timestamp_begin_cc,
+				index_entry.timestamp_begin,
+				&index_entry.timestamp_begin_ns);
+		if (ret) {
+			goto error;
+		}
+		ret = convert_cycles_to_ns(timestamp_end_cc,
+				index_entry.timestamp_end,
+				&index_entry.timestamp_end_ns);
+		if (ret) {
+			goto error;
+		}
+
+		g_array_append_val(index->entries, index_entry);
+		current_packet_offset += index_entry.packet_size;
+	}
+
+	/* Leave the data stream file at its first packet */
+	ret = ctf_fs_ds_file_seek(ds_file, 0);
+	if (ret) {
+		goto error;
+	}
+
+end:
+	bt_put(packet_context_field);
+	bt_put(timestamp_begin_cc);
+	bt_put(timestamp_end_cc);
+	return index;
+
+error:
+	ctf_fs_ds_index_destroy(index);
+	index = NULL;
+	goto end;
+}
+
 BT_HIDDEN
 struct ctf_fs_ds_file *ctf_fs_ds_file_create(
 		struct ctf_fs_trace *ctf_fs_trace,
@@ -524,13 +1199,36 @@ struct ctf_fs_ds_file *ctf_fs_ds_file_create(
 		goto error;
 	}
 
+	ds_file->io_mode = ctf_fs_trace->ds_file_config.io_mode;
+	if (ds_file->io_mode == CTF_FS_DS_FILE_IO_MODE_AUTO) {
+		ds_file->io_mode = ds_file_is_on_remote_fs(ds_file) ?
+			CTF_FS_DS_FILE_IO_MODE_PREAD :
+			CTF_FS_DS_FILE_IO_MODE_MMAP;
+	}
+
+	if (ds_file->io_mode == CTF_FS_DS_FILE_IO_MODE_PREAD) {
+		BT_LOGD("Reading data stream file \"%s\" with pread()", path);
+		ret = ds_file_pread_init(ds_file,
+			&ctf_fs_trace->ds_file_config);
+		if (ret) {
+			goto error;
+		}
+	}
+
 	ds_file->notif_iter = bt_ctf_notif_iter_create(
-		ctf_fs_trace->metadata->trace, page_size, medops, ds_file);
+		ctf_fs_trace->metadata->trace, page_size,
+		ds_file->io_mode == CTF_FS_DS_FILE_IO_MODE_PREAD ?
+			pread_medops : medops,
+		ds_file);
 	if (!ds_file->notif_iter) {
 		goto error;
 	}
 
-	ds_file->mmap_max_len = page_size * 2048;
+	ds_file->mmap_max_len = ctf_fs_trace->ds_file_config.mmap_window_size;
+	if (ds_file->mmap_max_len == 0) {
+		ds_file->mmap_max_len =
+			page_size * DS_FILE_DEFAULT_MMAP_WINDOW_PAGES;
+	}
 
 	goto end;
 
@@ -547,7 +1245,18 @@ BT_HIDDEN
 struct ctf_fs_ds_index *ctf_fs_ds_file_build_index(
 		struct ctf_fs_ds_file *ds_file)
 {
-	return build_index_from_idx_file(ds_file);
+	struct ctf_fs_ds_index *index;
+
+	index = build_index_from_idx_file(ds_file);
+	if (index) {
+		goto end;
+	}
+
+	BT_LOGD("Failed to build index from .idx file; "
+		"falling back to stream indexing.");
+	index = build_index_from_stream_file(ds_file);
+end:
+	return index;
 }
 
 BT_HIDDEN
@@ -561,6 +1270,10 @@ void ctf_fs_ds_file_destroy(struct ctf_fs_ds_file *ds_file)
 	bt_put(ds_file->stream);
 	(void) ds_file_munmap(ds_file);
 
+	if (ds_file->io_mode == CTF_FS_DS_FILE_IO_MODE_PREAD) {
+		ds_file_pread_fini(ds_file);
+	}
+
 	if (ds_file->file) {
 		ctf_fs_file_destroy(ds_file->file);
 	}
@@ -609,6 +1322,72 @@ struct bt_notification_iterator_next_return ctf_fs_ds_file_next(
 	return ret;
 }
 
+BT_HIDDEN
+int ctf_fs_ds_file_seek(struct ctf_fs_ds_file *ds_file, off_t offset)
+{
+	const size_t page_size = bt_common_get_page_size();
+	off_t offset_in_page;
+	int ret = 0;
+
+	assert(ds_file);
+	assert(offset >= 0);
+	BT_LOGD("Seeking data stream file: path=\"%s\", offset=%jd",
+		ds_file->file->path->str, (intmax_t) offset);
+
+	bt_ctf_notif_iter_reset(ds_file->notif_iter);
+	ds_file->end_reached = false;
+	ds_file->readahead_offset = offset;
+
+	if (ds_file->io_mode == CTF_FS_DS_FILE_IO_MODE_PREAD) {
+		ret = ds_file_pread_seek(ds_file, offset);
+		goto end;
+	}
+
+	if (ds_file->mmap_addr && offset >= ds_file->mmap_offset &&
+			(size_t) (offset - ds_file->mmap_offset) <
+				ds_file->mmap_valid_len) {
+		/* Already mapped: only move the request offset */
+		ds_file->request_offset = offset - ds_file->mmap_offset;
+		goto end;
+	}
+
+	if (ds_file_munmap(ds_file)) {
+		goto error;
+	}
+
+	ds_file->request_offset = 0;
+	ds_file->mmap_valid_len = 0;
+
+	if (offset >= ds_file->file->size) {
+		/* Next request returns EOF */
+		ds_file->mmap_offset = ds_file->file->size;
+		goto end;
+	}
+
+	/* Map the page containing the requested offset */
+	offset_in_page = offset & (page_size - 1);
+	ds_file->mmap_offset = offset - offset_in_page;
+
+	switch (ds_file_mmap_next(ds_file)) {
+	case BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK:
+		break;
+	default:
+		BT_LOGE("Cannot memory-map region of file \"%s\" (%p) at offset %jd",
+			ds_file->file->path->str, ds_file->file->fp,
+			(intmax_t) ds_file->mmap_offset);
+		goto error;
+	}
+
+	ds_file->request_offset = offset_in_page;
+	goto end;
+
+error:
+	ret = -1;
+
+end:
+	return ret;
+}
+
 BT_HIDDEN
 int ctf_fs_ds_file_get_packet_header_context_fields(
 		struct ctf_fs_ds_file *ds_file,
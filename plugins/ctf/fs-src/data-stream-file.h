@@ -30,7 +30,7 @@
 #include <babeltrace/ctf-ir/trace.h>
 
 #include "../common/notif-iter/notif-iter.h"
-#include "lttng-index.h"
+#include <babeltrace/lttng-index-internal.h>
 
 struct ctf_fs_component;
 struct ctf_fs_file;
@@ -84,6 +84,61 @@ struct ctf_fs_ds_file_info {
 	uint64_t begin_ns;
 };
 
+enum ctf_fs_ds_file_io_mode {
+	/* Choose according to the file system of the data stream file */
+	CTF_FS_DS_FILE_IO_MODE_AUTO = 0,
+
+	/* Memory-map the data stream file */
+	CTF_FS_DS_FILE_IO_MODE_MMAP,
+
+	/* Read the data stream file into buffers with pread() */
+	CTF_FS_DS_FILE_IO_MODE_PREAD,
+};
+
+/* How to read the data stream files of a trace. */
+struct ctf_fs_ds_file_config {
+	enum ctf_fs_ds_file_io_mode io_mode;
+
+	/*
+	 * Maximum length of the regions of the data stream files to
+	 * memory-map at once, SIZE_MAX to map whole files, or 0 for
+	 * the default length.
+	 */
+	size_t mmap_window_size;
+
+	/* pread() mode: bypass the page cache (O_DIRECT) */
+	bool direct_io;
+
+	/*
+	 * pread() mode: read the following buffer on a dedicated thread
+	 * while the current one is decoded.
+	 */
+	bool prefetch;
+};
+
+/* Buffer of the pread() mode. */
+struct ctf_fs_ds_file_read_buf {
+	/* Owned by this */
+	uint8_t *alloc_addr;
+
+	/* Page-aligned address within `alloc_addr` */
+	uint8_t *addr;
+
+	/* Offset, in the file, of the first byte of `addr` */
+	off_t offset;
+
+	/* Number of valid bytes at `addr` */
+	size_t len;
+
+	/*
+	 * Status of the last read into this buffer: its data is only
+	 * valid when this is BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK.
+	 */
+	enum bt_ctf_notif_iter_medium_status status;
+};
+
+struct ctf_fs_ds_file_prefetcher;
+
 struct ctf_fs_ds_file {
 	/* Owned by this */
 	struct ctf_fs_file *file;
@@ -97,6 +152,11 @@ struct ctf_fs_ds_file {
 	/* Owned by this */
 	struct bt_ctf_notif_iter *notif_iter;
 
+	/* CTF_FS_DS_FILE_IO_MODE_MMAP or CTF_FS_DS_FILE_IO_MODE_PREAD */
+	enum ctf_fs_ds_file_io_mode io_mode;
+
+	/* CTF_FS_DS_FILE_IO_MODE_MMAP mode */
+
 	void *mmap_addr;
 
 	/* Max length of chunk to mmap() when updating the current mapping. */
@@ -117,6 +177,43 @@ struct ctf_fs_ds_file {
 	 */
 	off_t request_offset;
 
+	/*
+	 * Offset in the file up to which the data was requested to be
+	 * read ahead into the page cache.
+	 */
+	off_t readahead_offset;
+
+	/* CTF_FS_DS_FILE_IO_MODE_PREAD mode */
+	struct {
+		/*
+		 * File descriptor to read from: the one of `file`, or,
+		 * if `fd_is_direct` is true, an owned one opened with
+		 * O_DIRECT.
+		 */
+		int fd;
+		bool fd_is_direct;
+
+		/* Capacity of each buffer, a multiple of the page size */
+		size_t buf_capacity;
+
+		/*
+		 * The buffer at index `cur_buf` is the one which the
+		 * notification iterator reads from. The other one is
+		 * the prefetched buffer, if there's a prefetcher.
+		 */
+		struct ctf_fs_ds_file_read_buf bufs[2];
+		unsigned int cur_buf;
+
+		/*
+		 * Offset, in the current buffer, of the address to
+		 * return on the next request.
+		 */
+		size_t request_offset;
+
+		/* Owned by this, NULL if there's no prefetching thread */
+		struct ctf_fs_ds_file_prefetcher *prefetcher;
+	} read;
+
 	bool end_reached;
 };
 
@@ -138,10 +235,21 @@ BT_HIDDEN
 struct bt_notification_iterator_next_return ctf_fs_ds_file_next(
 		struct ctf_fs_ds_file *stream);
 
+/*
+ * Positions the data stream file so that the next notification is
+ * decoded from the packet starting at `offset` bytes from the beginning
+ * of the file. `offset` must be the offset of a packet.
+ */
+BT_HIDDEN
+int ctf_fs_ds_file_seek(struct ctf_fs_ds_file *ds_file, off_t offset);
+
 BT_HIDDEN
 struct ctf_fs_ds_index *ctf_fs_ds_file_build_index(
 		struct ctf_fs_ds_file *ds_file);
 
+BT_HIDDEN
+struct ctf_fs_ds_index *ctf_fs_ds_index_create(size_t length);
+
 BT_HIDDEN
 void ctf_fs_ds_index_destroy(struct ctf_fs_ds_index *index);
 
@@ -30,17 +30,20 @@
 #include <babeltrace/ctf-ir/clock-class.h>
 #include <babeltrace/ctf-ir/stream.h>
 #include <babeltrace/ctf-ir/fields.h>
+#include <babeltrace/ctf-ir/event.h>
 #include <babeltrace/graph/private-port.h>
 #include <babeltrace/graph/private-component.h>
 #include <babeltrace/graph/private-component-source.h>
 #include <babeltrace/graph/private-notification-iterator.h>
 #include <babeltrace/graph/component.h>
 #include <babeltrace/graph/notification-iterator.h>
+#include <babeltrace/graph/notification-event.h>
 #include <babeltrace/graph/clock-class-priority-map.h>
 #include <plugins-common.h>
 #include <glib.h>
 #include <assert.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <stdbool.h>
 #include "fs.h"
 #include "metadata.h"
@@ -48,12 +51,19 @@
 #include "file.h"
 #include "../common/metadata/decoder.h"
 #include "query.h"
+#include "index-cache.h"
 
 #define BT_LOG_TAG "PLUGIN-CTF-FS-SRC"
 #include "logging.h"
 
+/*
+ * Makes the iterator read the current data stream file. If the packets
+ * of this file are decoded by the iterator's packet decoder, the
+ * decoder starts at the packet of index entry `first_entry_index`.
+ */
 static
-int notif_iter_data_set_current_ds_file(struct ctf_fs_notif_iter_data *notif_iter_data)
+int notif_iter_data_set_current_ds_file(struct ctf_fs_notif_iter_data *notif_iter_data,
+		size_t first_entry_index)
 {
 	struct ctf_fs_ds_file_info *ds_file_info;
 	int ret = 0;
@@ -65,6 +75,19 @@ int notif_iter_data_set_current_ds_file(struct ctf_fs_notif_iter_data *notif_ite
 		notif_iter_data->ds_file_info_index);
 
 	ctf_fs_ds_file_destroy(notif_iter_data->ds_file);
+	notif_iter_data->ds_file = NULL;
+
+	if (notif_iter_data->packet_decoder && ds_file_info->index) {
+		/*
+		 * The packets of an indexed file can be decoded
+		 * independently from each other.
+		 */
+		ret = ctf_fs_packet_decoder_set_ds_file_info(
+			notif_iter_data->packet_decoder, ds_file_info,
+			first_entry_index);
+		goto end;
+	}
+
 	notif_iter_data->ds_file = ctf_fs_ds_file_create(
 		notif_iter_data->ds_file_group->ctf_fs_trace,
 		notif_iter_data->ds_file_group->stream,
@@ -73,9 +96,22 @@ int notif_iter_data_set_current_ds_file(struct ctf_fs_notif_iter_data *notif_ite
 		ret = -1;
 	}
 
+end:
 	return ret;
 }
 
+static
+struct bt_notification_iterator_next_return notif_iter_data_next_from_ds_file(
+		struct ctf_fs_notif_iter_data *notif_iter_data)
+{
+	if (notif_iter_data->ds_file) {
+		return ctf_fs_ds_file_next(notif_iter_data->ds_file);
+	}
+
+	assert(notif_iter_data->packet_decoder);
+	return ctf_fs_packet_decoder_next(notif_iter_data->packet_decoder);
+}
+
 static
 void ctf_fs_notif_iter_data_destroy(
 		struct ctf_fs_notif_iter_data *notif_iter_data)
@@ -85,19 +121,18 @@ void ctf_fs_notif_iter_data_destroy(
 	}
 
 	ctf_fs_ds_file_destroy(notif_iter_data->ds_file);
+	ctf_fs_packet_decoder_destroy(notif_iter_data->packet_decoder);
 	g_free(notif_iter_data);
 }
 
-struct bt_notification_iterator_next_return ctf_fs_iterator_next(
-		struct bt_private_notification_iterator *iterator)
+static
+struct bt_notification_iterator_next_return ctf_fs_iterator_next_one(
+		struct ctf_fs_notif_iter_data *notif_iter_data)
 {
 	struct bt_notification_iterator_next_return next_ret;
-	struct ctf_fs_notif_iter_data *notif_iter_data =
-		bt_private_notification_iterator_get_user_data(iterator);
 	int ret;
 
-	assert(notif_iter_data->ds_file);
-	next_ret = ctf_fs_ds_file_next(notif_iter_data->ds_file);
+	next_ret = notif_iter_data_next_from_ds_file(notif_iter_data);
 	if (next_ret.status == BT_NOTIFICATION_ITERATOR_STATUS_END) {
 		assert(!next_ret.notification);
 		notif_iter_data->ds_file_info_index++;
@@ -115,13 +150,13 @@ struct bt_notification_iterator_next_return ctf_fs_iterator_next(
 		 * Open and start reading the next stream file within
 		 * our stream file group.
 		 */
-		ret = notif_iter_data_set_current_ds_file(notif_iter_data);
+		ret = notif_iter_data_set_current_ds_file(notif_iter_data, 0);
 		if (ret) {
 			next_ret.status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
 			goto end;
 		}
 
-		next_ret = ctf_fs_ds_file_next(notif_iter_data->ds_file);
+		next_ret = notif_iter_data_next_from_ds_file(notif_iter_data);
 
 		/*
 		 * We should not get BT_NOTIFICATION_ITERATOR_STATUS_END
@@ -138,6 +173,260 @@ end:
 	return next_ret;
 }
 
+/*
+ * Returns whether or not `notif` is an event notification which
+ * occurs before `time` (ns from EPOCH), according to the clock class
+ * having the highest priority in its clock class priority map.
+ */
+static
+bool notif_is_event_before(struct bt_notification *notif, int64_t time)
+{
+	struct bt_clock_class_priority_map *cc_prio_map = NULL;
+	struct bt_ctf_clock_class *clock_class = NULL;
+	struct bt_ctf_clock_value *clock_value = NULL;
+	struct bt_ctf_event *event = NULL;
+	int64_t ts_ns;
+	bool before = false;
+
+	if (bt_notification_get_type(notif) != BT_NOTIFICATION_TYPE_EVENT) {
+		goto end;
+	}
+
+	cc_prio_map = bt_notification_event_get_clock_class_priority_map(notif);
+	if (!cc_prio_map) {
+		goto end;
+	}
+
+	clock_class = bt_clock_class_priority_map_get_highest_priority_clock_class(
+		cc_prio_map);
+	if (!clock_class) {
+		goto end;
+	}
+
+	event = bt_notification_event_get_event(notif);
+	assert(event);
+	clock_value = bt_ctf_event_get_clock_value(event, clock_class);
+	if (!clock_value) {
+		goto end;
+	}
+
+	if (bt_ctf_clock_value_get_value_ns_from_epoch(clock_value, &ts_ns)) {
+		goto end;
+	}
+
+	before = ts_ns < time;
+
+end:
+	bt_put(cc_prio_map);
+	bt_put(clock_class);
+	bt_put(clock_value);
+	bt_put(event);
+	return before;
+}
+
+static
+struct bt_notification_iterator_next_return ctf_fs_iterator_do_next(
+		struct ctf_fs_notif_iter_data *notif_iter_data)
+{
+	struct bt_notification_iterator_next_return next_ret;
+
+	while (true) {
+		next_ret = ctf_fs_iterator_next_one(notif_iter_data);
+		if (!notif_iter_data->seek_pending ||
+				next_ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			break;
+		}
+
+		/*
+		 * A seek positions the data stream file at the
+		 * beginning of the packet which contains the seek
+		 * time: skip the events which precede it.
+		 */
+		if (!notif_is_event_before(next_ret.notification,
+				notif_iter_data->seek_time_ns)) {
+			if (bt_notification_get_type(next_ret.notification) ==
+					BT_NOTIFICATION_TYPE_EVENT) {
+				notif_iter_data->seek_pending = false;
+			}
+
+			break;
+		}
+
+		BT_PUT(next_ret.notification);
+	}
+
+	return next_ret;
+}
+
+struct bt_notification_iterator_next_return ctf_fs_iterator_next(
+		struct bt_private_notification_iterator *iterator)
+{
+	struct ctf_fs_notif_iter_data *notif_iter_data =
+		bt_private_notification_iterator_get_user_data(iterator);
+
+	return ctf_fs_iterator_do_next(notif_iter_data);
+}
+
+enum bt_notification_iterator_status ctf_fs_iterator_next_batch(
+		struct bt_private_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	struct bt_notification_iterator_next_return next_ret = {
+		.status = BT_NOTIFICATION_ITERATOR_STATUS_OK,
+		.notification = NULL,
+	};
+	struct ctf_fs_notif_iter_data *notif_iter_data =
+		bt_private_notification_iterator_get_user_data(iterator);
+
+	/*
+	 * Stop at the first non-OK status: the notifications decoded
+	 * so far are delivered before it.
+	 */
+	*count = 0;
+
+	while (*count < capacity) {
+		next_ret = ctf_fs_iterator_do_next(notif_iter_data);
+		if (next_ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			break;
+		}
+
+		notifications[*count] = next_ret.notification;
+		(*count)++;
+	}
+
+	return next_ret.status;
+}
+
+/*
+ * Returns the index of the data stream file info in `ds_file_group`
+ * which contains `time` (ns from EPOCH), that is, the last one
+ * beginning at or before `time`, or 0 if `time` precedes all of them.
+ */
+static
+size_t find_ds_file_info_index(struct ctf_fs_ds_file_group *ds_file_group,
+		int64_t time)
+{
+	size_t low = 0;
+	size_t high = ds_file_group->ds_file_infos->len;
+
+	/* Find the first file info beginning after `time` */
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		struct ctf_fs_ds_file_info *ds_file_info = g_ptr_array_index(
+			ds_file_group->ds_file_infos, mid);
+
+		if (time < 0 || (uint64_t) time < ds_file_info->begin_ns) {
+			high = mid;
+		} else {
+			low = mid + 1;
+		}
+	}
+
+	return low == 0 ? 0 : low - 1;
+}
+
+/*
+ * Returns the index of the first entry of `index` which ends at or
+ * after `time` (ns from EPOCH), or the number of entries if there's
+ * no such entry.
+ */
+static
+size_t find_ds_index_entry_index(struct ctf_fs_ds_index *index,
+		int64_t time)
+{
+	size_t low = 0;
+	size_t high = index->entries->len;
+
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		struct ctf_fs_ds_index_entry *entry = &g_array_index(
+			index->entries, struct ctf_fs_ds_index_entry, mid);
+
+		if (entry->timestamp_end_ns < time) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+enum bt_notification_iterator_status ctf_fs_iterator_seek_time(
+		struct bt_private_notification_iterator *iterator,
+		int64_t time)
+{
+	struct ctf_fs_notif_iter_data *notif_iter_data =
+		bt_private_notification_iterator_get_user_data(iterator);
+	struct ctf_fs_ds_file_group *ds_file_group;
+	struct ctf_fs_ds_file_info *ds_file_info;
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	size_t entry_index = 0;
+	off_t offset = 0;
+	int ret;
+
+	assert(notif_iter_data);
+	ds_file_group = notif_iter_data->ds_file_group;
+	BT_LOGD("Seeking CTF file system source notification iterator: "
+		"time=%" PRId64, time);
+	notif_iter_data->ds_file_info_index =
+		find_ds_file_info_index(ds_file_group, time);
+	ds_file_info = g_ptr_array_index(ds_file_group->ds_file_infos,
+		notif_iter_data->ds_file_info_index);
+
+	if (ds_file_info->index) {
+		entry_index = find_ds_index_entry_index(ds_file_info->index,
+			time);
+
+		if (entry_index < ds_file_info->index->entries->len) {
+			offset = g_array_index(ds_file_info->index->entries,
+				struct ctf_fs_ds_index_entry,
+				entry_index).offset;
+		} else if (notif_iter_data->ds_file_info_index + 1 <
+				ds_file_group->ds_file_infos->len) {
+			/* Seek time is between this file and the next one */
+			notif_iter_data->ds_file_info_index++;
+			entry_index = 0;
+		} else {
+			/* Seek time is after the last packet */
+			offset = (off_t) -1;
+		}
+	}
+
+	ret = notif_iter_data_set_current_ds_file(notif_iter_data,
+		entry_index);
+	if (ret) {
+		status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+		goto end;
+	}
+
+	if (!notif_iter_data->ds_file) {
+		/* The packet decoder starts at the right packet */
+		goto set_seek_time;
+	}
+
+	if (offset == (off_t) -1) {
+		offset = notif_iter_data->ds_file->file->size;
+	}
+
+	if (offset > 0) {
+		ret = ctf_fs_ds_file_seek(notif_iter_data->ds_file, offset);
+		if (ret) {
+			status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto end;
+		}
+	}
+
+set_seek_time:
+	notif_iter_data->seek_time_ns = time;
+	notif_iter_data->seek_pending = true;
+
+end:
+	return status;
+}
+
 void ctf_fs_iterator_finalize(struct bt_private_notification_iterator *it)
 {
 	void *notif_iter_data =
@@ -169,7 +458,19 @@ enum bt_notification_iterator_status ctf_fs_iterator_init(
 	}
 
 	notif_iter_data->ds_file_group = port_data->ds_file_group;
-	iret = notif_iter_data_set_current_ds_file(notif_iter_data);
+
+	if (port_data->ctf_fs->decoding_threads > 0) {
+		notif_iter_data->packet_decoder = ctf_fs_packet_decoder_create(
+			port_data->ds_file_group->ctf_fs_trace,
+			port_data->ds_file_group->stream,
+			port_data->ctf_fs->decoding_threads);
+		if (!notif_iter_data->packet_decoder) {
+			ret = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto error;
+		}
+	}
+
+	iret = notif_iter_data_set_current_ds_file(notif_iter_data, 0);
 	if (iret) {
 		ret = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
 		goto error;
@@ -210,6 +511,10 @@ void ctf_fs_destroy(struct ctf_fs_component *ctf_fs)
 		g_ptr_array_free(ctf_fs->port_data, TRUE);
 	}
 
+	if (ctf_fs->index_cache_dir) {
+		g_string_free(ctf_fs->index_cache_dir, TRUE);
+	}
+
 	g_free(ctf_fs);
 }
 
@@ -299,6 +604,7 @@ int create_one_port_for_trace(struct ctf_fs_component *ctf_fs,
 	}
 
 	port_data->ds_file_group = ds_file_group;
+	port_data->ctf_fs = ctf_fs;
 	ret = bt_private_component_source_add_output_private_port(
 		ctf_fs->priv_comp, port_name->str, port_data, NULL);
 	if (ret) {
@@ -520,7 +826,7 @@ end:
 	return ds_file_info;
 }
 
-static
+BT_HIDDEN
 void ctf_fs_ds_file_group_destroy(struct ctf_fs_ds_file_group *ds_file_group)
 {
 	if (!ds_file_group) {
@@ -535,7 +841,7 @@ void ctf_fs_ds_file_group_destroy(struct ctf_fs_ds_file_group *ds_file_group)
 	g_free(ds_file_group);
 }
 
-static
+BT_HIDDEN
 struct ctf_fs_ds_file_group *ctf_fs_ds_file_group_create(
 		struct ctf_fs_trace *ctf_fs_trace,
 		struct bt_ctf_stream_class *stream_class,
@@ -579,7 +885,7 @@ end:
 	return ds_file_group;
 }
 
-static
+BT_HIDDEN
 int ctf_fs_ds_file_group_add_ds_file_info(
 		struct ctf_fs_ds_file_group *ds_file_group,
 		const char *path, uint64_t begin_ns,
@@ -898,7 +1204,9 @@ end:
 
 BT_HIDDEN
 struct ctf_fs_trace *ctf_fs_trace_create(const char *path, const char *name,
-		struct ctf_fs_metadata_config *metadata_config)
+		struct ctf_fs_metadata_config *metadata_config,
+		struct ctf_fs_ds_file_config *ds_file_config,
+		const char *index_cache_dir)
 {
 	struct ctf_fs_trace *ctf_fs_trace;
 	int ret;
@@ -908,6 +1216,10 @@ struct ctf_fs_trace *ctf_fs_trace_create(const char *path, const char *name,
 		goto end;
 	}
 
+	if (ds_file_config) {
+		ctf_fs_trace->ds_file_config = *ds_file_config;
+	}
+
 	ctf_fs_trace->path = g_string_new(path);
 	if (!ctf_fs_trace->path) {
 		goto error;
@@ -934,9 +1246,25 @@ struct ctf_fs_trace *ctf_fs_trace_create(const char *path, const char *name,
 		goto error;
 	}
 
-	ret = create_ds_file_groups(ctf_fs_trace);
-	if (ret) {
-		goto error;
+	if (index_cache_dir) {
+		ret = ctf_fs_index_cache_load(ctf_fs_trace, index_cache_dir,
+			metadata_config);
+		if (ret < 0) {
+			goto error;
+		}
+	}
+
+	if (!index_cache_dir || ret > 0) {
+		ret = create_ds_file_groups(ctf_fs_trace);
+		if (ret) {
+			goto error;
+		}
+
+		if (index_cache_dir && ctf_fs_index_cache_save(ctf_fs_trace,
+				index_cache_dir, metadata_config)) {
+			BT_LOGW("Cannot write index cache file of trace `%s` in `%s`.",
+				path, index_cache_dir);
+		}
 	}
 
 	ret = create_cc_prio_map(ctf_fs_trace);
@@ -1181,7 +1509,10 @@ int create_ctf_fs_traces(struct ctf_fs_component *ctf_fs,
 		GString *trace_name = tn_node->data;
 
 		ctf_fs_trace = ctf_fs_trace_create(trace_path->str,
-				trace_name->str, &ctf_fs->metadata_config);
+				trace_name->str, &ctf_fs->metadata_config,
+				&ctf_fs->ds_file_config,
+				ctf_fs->index_cache_dir ?
+					ctf_fs->index_cache_dir->str : NULL);
 		if (!ctf_fs_trace) {
 			BT_LOGE("Cannot create trace for `%s`.",
 				trace_path->str);
@@ -1300,6 +1631,135 @@ struct ctf_fs_component *ctf_fs_create(struct bt_private_component *priv_comp,
 		BT_PUT(value);
 	}
 
+	value = bt_value_map_get(params, "index-cache-dir");
+	if (value) {
+		const char *index_cache_dir;
+
+		if (!bt_value_is_string(value)) {
+			BT_LOGE("index-cache-dir should be a string");
+			goto error;
+		}
+		ret = bt_value_string_get(value, &index_cache_dir);
+		assert(ret == 0);
+		ctf_fs->index_cache_dir = g_string_new(index_cache_dir);
+		if (!ctf_fs->index_cache_dir) {
+			goto error;
+		}
+		BT_PUT(value);
+	}
+
+	value = bt_value_map_get(params, "decoding-threads");
+	if (value) {
+		int64_t decoding_threads;
+
+		if (!bt_value_is_integer(value)) {
+			BT_LOGE("decoding-threads should be an integer");
+			goto error;
+		}
+		ret = bt_value_integer_get(value, &decoding_threads);
+		assert(ret == 0);
+		if (decoding_threads < 0 || decoding_threads > UINT_MAX) {
+			BT_LOGE("Invalid decoding-threads value: %" PRId64,
+				decoding_threads);
+			goto error;
+		}
+		ctf_fs->decoding_threads = (unsigned int) decoding_threads;
+		BT_PUT(value);
+	}
+
+	value = bt_value_map_get(params, "io-mode");
+	if (value) {
+		const char *io_mode;
+
+		if (!bt_value_is_string(value)) {
+			BT_LOGE("io-mode should be a string");
+			goto error;
+		}
+		ret = bt_value_string_get(value, &io_mode);
+		assert(ret == 0);
+		if (strcmp(io_mode, "auto") == 0) {
+			ctf_fs->ds_file_config.io_mode =
+				CTF_FS_DS_FILE_IO_MODE_AUTO;
+		} else if (strcmp(io_mode, "mmap") == 0) {
+			ctf_fs->ds_file_config.io_mode =
+				CTF_FS_DS_FILE_IO_MODE_MMAP;
+		} else if (strcmp(io_mode, "pread") == 0) {
+			ctf_fs->ds_file_config.io_mode =
+				CTF_FS_DS_FILE_IO_MODE_PREAD;
+		} else {
+			BT_LOGE("Invalid io-mode value: `%s` (expecting `auto`, `mmap`, or `pread`)",
+				io_mode);
+			goto error;
+		}
+		BT_PUT(value);
+	}
+
+	value = bt_value_map_get(params, "direct-io");
+	if (value) {
+		bt_bool direct_io;
+
+		if (!bt_value_is_bool(value)) {
+			BT_LOGE("direct-io should be a boolean");
+			goto error;
+		}
+		ret = bt_value_bool_get(value, &direct_io);
+		assert(ret == 0);
+		ctf_fs->ds_file_config.direct_io = !!direct_io;
+		BT_PUT(value);
+	}
+
+	ctf_fs->ds_file_config.prefetch = true;
+	value = bt_value_map_get(params, "prefetch");
+	if (value) {
+		bt_bool prefetch;
+
+		if (!bt_value_is_bool(value)) {
+			BT_LOGE("prefetch should be a boolean");
+			goto error;
+		}
+		ret = bt_value_bool_get(value, &prefetch);
+		assert(ret == 0);
+		ctf_fs->ds_file_config.prefetch = !!prefetch;
+		BT_PUT(value);
+	}
+
+	value = bt_value_map_get(params, "mmap-window-size");
+	if (value) {
+		int64_t mmap_window_size;
+		const int64_t page_size = bt_common_get_page_size();
+
+		if (!bt_value_is_integer(value)) {
+			BT_LOGE("mmap-window-size should be an integer");
+			goto error;
+		}
+		ret = bt_value_integer_get(value, &mmap_window_size);
+		assert(ret == 0);
+		if (mmap_window_size < 0 ||
+				(uint64_t) mmap_window_size > SIZE_MAX - page_size) {
+			BT_LOGE("Invalid mmap-window-size value: %" PRId64,
+				mmap_window_size);
+			goto error;
+		}
+
+		if (mmap_window_size == 0) {
+			/*
+			 * Map whole data stream files, but only where the
+			 * address space is large enough for it.
+			 */
+			if (sizeof(void *) >= 8) {
+				ctf_fs->ds_file_config.mmap_window_size = SIZE_MAX;
+			} else {
+				BT_LOGW_STR("Cannot map whole data stream files on this host: using the default mmap-window-size.");
+			}
+		} else {
+			/* Round up to the next page */
+			ctf_fs->ds_file_config.mmap_window_size = (size_t)
+				((mmap_window_size + page_size - 1) &
+					~(page_size - 1));
+		}
+		BT_PUT(value);
+	}
+
 	ctf_fs->port_data = g_ptr_array_new_with_free_func(port_data_destroy);
 	if (!ctf_fs->port_data) {
 		goto error;
@@ -34,6 +34,7 @@
 #include <babeltrace/graph/clock-class-priority-map.h>
 #include "data-stream-file.h"
 #include "metadata.h"
+#include "packet-decoder.h"
 
 BT_HIDDEN
 extern bool ctf_fs_debug;
@@ -71,6 +72,21 @@ struct ctf_fs_component {
 	GPtrArray *traces;
 
 	struct ctf_fs_metadata_config metadata_config;
+
+	/*
+	 * Owned by this, NULL if there's no persistent index cache.
+	 * See index-cache.h.
+	 */
+	GString *index_cache_dir;
+
+	/*
+	 * Number of threads which decode the packets of an indexed
+	 * data stream file for each notification iterator, 0 to decode
+	 * them serially. See packet-decoder.h.
+	 */
+	unsigned int decoding_threads;
+
+	struct ctf_fs_ds_file_config ds_file_config;
 };
 
 struct ctf_fs_trace {
@@ -88,6 +104,8 @@ struct ctf_fs_trace {
 
 	/* Owned by this */
 	GString *name;
+
+	struct ctf_fs_ds_file_config ds_file_config;
 };
 
 struct ctf_fs_ds_file_group {
@@ -112,17 +130,34 @@ struct ctf_fs_ds_file_group {
 struct ctf_fs_port_data {
 	/* Weak, belongs to ctf_fs_trace */
 	struct ctf_fs_ds_file_group *ds_file_group;
+
+	/* Weak */
+	struct ctf_fs_component *ctf_fs;
 };
 
 struct ctf_fs_notif_iter_data {
 	/* Weak, belongs to ctf_fs_trace */
 	struct ctf_fs_ds_file_group *ds_file_group;
 
-	/* Owned by this */
+	/*
+	 * Owned by this. NULL when the current data stream file's
+	 * packets are decoded by `packet_decoder`.
+	 */
 	struct ctf_fs_ds_file *ds_file;
 
+	/* Owned by this, NULL if the packets are decoded serially */
+	struct ctf_fs_packet_decoder *packet_decoder;
+
 	/* Which file the iterator is _currently_ operating on */
 	size_t ds_file_info_index;
+
+	/*
+	 * True if the iterator was seeked and must skip the event
+	 * notifications which occur before `seek_time_ns` (ns from
+	 * EPOCH).
+	 */
+	bool seek_pending;
+	int64_t seek_time_ns;
 };
 
 BT_HIDDEN
@@ -138,7 +173,29 @@ struct bt_value *ctf_fs_query(struct bt_component_class *comp_class,
 
 BT_HIDDEN
 struct ctf_fs_trace *ctf_fs_trace_create(const char *path, const char *name,
-		struct ctf_fs_metadata_config *config);
+		struct ctf_fs_metadata_config *config,
+		struct ctf_fs_ds_file_config *ds_file_config,
+		const char *index_cache_dir);
+
+BT_HIDDEN
+struct ctf_fs_ds_file_group *ctf_fs_ds_file_group_create(
+		struct ctf_fs_trace *ctf_fs_trace,
+		struct bt_ctf_stream_class *stream_class,
+		uint64_t stream_instance_id);
+
+BT_HIDDEN
+void ctf_fs_ds_file_group_destroy(struct ctf_fs_ds_file_group *ds_file_group);
+
+/*
+ * Inserts a data stream file info in `ds_file_group`, keeping its data
+ * stream file infos sorted by beginning time. The ownership of `index`
+ * is transferred.
+ */
+BT_HIDDEN
+int ctf_fs_ds_file_group_add_ds_file_info(
+		struct ctf_fs_ds_file_group *ds_file_group,
+		const char *path, uint64_t begin_ns,
+		struct ctf_fs_ds_index *index);
 
 BT_HIDDEN
 void ctf_fs_trace_destroy(struct ctf_fs_trace *trace);
@@ -160,4 +217,15 @@ BT_HIDDEN
 struct bt_notification_iterator_next_return ctf_fs_iterator_next(
 		struct bt_private_notification_iterator *iterator);
 
+BT_HIDDEN
+enum bt_notification_iterator_status ctf_fs_iterator_next_batch(
+		struct bt_private_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count);
+
+BT_HIDDEN
+enum bt_notification_iterator_status ctf_fs_iterator_seek_time(
+		struct bt_private_notification_iterator *iterator,
+		int64_t time);
+
 #endif /* BABELTRACE_PLUGIN_CTF_FS_H */
@@ -0,0 +1,723 @@
+/*
+ * index-cache.c
+ *
+ * Babeltrace CTF file system Reader Component persistent index cache
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <babeltrace/ctf-ir/stream.h>
+#include <babeltrace/ctf-ir/stream-class.h>
+#include <babeltrace/ctf-ir/trace.h>
+#include "fs.h"
+#include "data-stream-file.h"
+#include "index-cache.h"
+
+#define BT_LOG_TAG "PLUGIN-CTF-FS-SRC-INDEX-CACHE"
+#include "logging.h"
+
+#define INDEX_CACHE_MAGIC		0x62746978	/* "btix" */
+#define INDEX_CACHE_VERSION		2
+#define INDEX_CACHE_FILE_SUFFIX		".bt-index"
+#define INDEX_CACHE_NO_INDEX		UINT64_C(-1)
+
+/*
+ * All the fields of a cache file are written in the native byte order:
+ * a cache file written on a machine with another byte order fails the
+ * magic number check and is rebuilt.
+ */
+struct index_cache_hdr {
+	uint32_t magic;
+	uint32_t version;
+	int64_t clock_class_offset_s;
+	int64_t clock_class_offset_ns;
+	uint64_t metadata_size;
+	int64_t metadata_mtime_ns;
+	int64_t trace_dir_mtime_ns;
+	uint64_t ds_file_group_count;
+} __attribute__((__packed__));
+
+struct index_cache_ds_file_group_hdr {
+	int64_t stream_class_id;
+	uint64_t stream_instance_id;
+	uint64_t ds_file_info_count;
+} __attribute__((__packed__));
+
+/* Followed by `path_len` bytes of path, then `entry_count` entries */
+struct index_cache_ds_file_info_hdr {
+	uint64_t path_len;
+	uint64_t size;
+	int64_t mtime_ns;
+	uint64_t begin_ns;
+	uint64_t entry_count;
+} __attribute__((__packed__));
+
+/*
+ * Returns the modification time of `st` in nanoseconds: a file can be
+ * rewritten with the same size within the same second.
+ */
+static
+int64_t get_stat_mtime_ns(const GStatBuf *st)
+{
+#if defined(__APPLE__)
+	return (int64_t) st->st_mtimespec.tv_sec * 1000000000 +
+		(int64_t) st->st_mtimespec.tv_nsec;
+#elif defined(__MINGW32__)
+	return (int64_t) st->st_mtime * 1000000000;
+#else
+	return (int64_t) st->st_mtim.tv_sec * 1000000000 +
+		(int64_t) st->st_mtim.tv_nsec;
+#endif
+}
+
+/* Gets the size and the modification time (ns) of the file at `path` */
+static
+int stat_path(const char *path, uint64_t *size, int64_t *mtime_ns)
+{
+	GStatBuf st;
+	int ret = g_stat(path, &st);
+
+	if (ret) {
+		BT_LOGD("Cannot stat `%s`: %s", path, strerror(errno));
+		goto end;
+	}
+
+	if (size) {
+		*size = (uint64_t) st.st_size;
+	}
+
+	*mtime_ns = get_stat_mtime_ns(&st);
+
+end:
+	return ret;
+}
+
+static
+GString *get_cache_file_path(struct ctf_fs_trace *ctf_fs_trace,
+		const char *cache_dir)
+{
+	GString *path = NULL;
+	gchar *checksum;
+
+	/* One cache file per trace directory */
+	checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA1,
+		ctf_fs_trace->path->str, -1);
+	if (!checksum) {
+		goto end;
+	}
+
+	path = g_string_new(NULL);
+	if (!path) {
+		goto end;
+	}
+
+	g_string_printf(path, "%s" G_DIR_SEPARATOR_S "%s" INDEX_CACHE_FILE_SUFFIX,
+		cache_dir, checksum);
+
+end:
+	g_free(checksum);
+	return path;
+}
+
+static
+int fill_header(struct index_cache_hdr *hdr,
+		struct ctf_fs_trace *ctf_fs_trace,
+		struct ctf_fs_metadata_config *metadata_config)
+{
+	int ret;
+	uint64_t size;
+	int64_t mtime_ns;
+	GString *metadata_path = g_string_new(NULL);
+
+	if (!metadata_path) {
+		ret = -1;
+		goto end;
+	}
+
+	memset(hdr, 0, sizeof(*hdr));
+	hdr->magic = INDEX_CACHE_MAGIC;
+	hdr->version = INDEX_CACHE_VERSION;
+
+	if (metadata_config) {
+		hdr->clock_class_offset_s =
+			metadata_config->clock_class_offset_s;
+		hdr->clock_class_offset_ns =
+			metadata_config->clock_class_offset_ns;
+	}
+
+	g_string_printf(metadata_path, "%s" G_DIR_SEPARATOR_S "%s",
+		ctf_fs_trace->path->str, CTF_FS_METADATA_FILENAME);
+	/* The header is packed: do not take its members' address */
+	ret = stat_path(metadata_path->str, &size, &mtime_ns);
+	if (ret) {
+		goto end;
+	}
+
+	hdr->metadata_size = size;
+	hdr->metadata_mtime_ns = mtime_ns;
+
+	/*
+	 * Adding or removing a data stream file changes the trace
+	 * directory's modification time.
+	 */
+	ret = stat_path(ctf_fs_trace->path->str, NULL, &mtime_ns);
+	if (ret) {
+		goto end;
+	}
+
+	hdr->trace_dir_mtime_ns = mtime_ns;
+
+end:
+	if (metadata_path) {
+		g_string_free(metadata_path, TRUE);
+	}
+
+	return ret;
+}
+
+/* Returns a pointer to the next `size` bytes of the buffer, or NULL */
+static
+const char *consume(const char **pos, const char *end, size_t size)
+{
+	const char *ret = NULL;
+
+	if ((size_t) (end - *pos) < size) {
+		goto end;
+	}
+
+	ret = *pos;
+	*pos += size;
+
+end:
+	return ret;
+}
+
+/*
+ * A data stream file group or info read from an index cache file. The
+ * whole cache file is read and validated into such records before any
+ * data stream file group, and thus any stream, is created: a stale
+ * cache file must not leave streams in the trace, since the groups
+ * created without the cache would then have conflicting stream IDs.
+ */
+struct index_cache_ds_file_group_rec {
+	struct index_cache_ds_file_group_hdr hdr;
+	/* Owned by this */
+	struct bt_ctf_stream_class *stream_class;
+	/* Index of the group's first info record */
+	guint first_info_rec;
+};
+
+struct index_cache_ds_file_info_rec {
+	struct index_cache_ds_file_info_hdr hdr;
+	/* Within the mapped cache file, not null-terminated */
+	const char *path;
+	/* Within the mapped cache file, NULL if there's no index */
+	const char *entries;
+};
+
+static
+int read_ds_file_info_rec(GArray *info_recs, const char **pos,
+		const char *end)
+{
+	int ret = 1;
+	struct index_cache_ds_file_info_rec info_rec = { 0 };
+	const char *data;
+	gchar *path = NULL;
+	uint64_t cur_size;
+	int64_t cur_mtime_ns;
+
+	data = consume(pos, end, sizeof(info_rec.hdr));
+	if (!data) {
+		goto end;
+	}
+
+	memcpy(&info_rec.hdr, data, sizeof(info_rec.hdr));
+	info_rec.path = consume(pos, end, info_rec.hdr.path_len);
+	if (!info_rec.path) {
+		goto end;
+	}
+
+	path = g_strndup(info_rec.path, info_rec.hdr.path_len);
+	if (!path) {
+		ret = -1;
+		goto end;
+	}
+
+	if (stat_path(path, &cur_size, &cur_mtime_ns) ||
+			cur_size != info_rec.hdr.size ||
+			cur_mtime_ns != info_rec.hdr.mtime_ns) {
+		BT_LOGD("Data stream file changed since the index cache was written: "
+			"path=\"%s\"", path);
+		goto end;
+	}
+
+	if (info_rec.hdr.entry_count != INDEX_CACHE_NO_INDEX) {
+		if (info_rec.hdr.entry_count > SIZE_MAX /
+				sizeof(struct ctf_fs_ds_index_entry)) {
+			goto end;
+		}
+
+		info_rec.entries = consume(pos, end,
+			info_rec.hdr.entry_count *
+			sizeof(struct ctf_fs_ds_index_entry));
+		if (!info_rec.entries) {
+			goto end;
+		}
+	}
+
+	g_array_append_val(info_recs, info_rec);
+	ret = 0;
+
+end:
+	g_free(path);
+	return ret;
+}
+
+static
+int read_ds_file_group_rec(struct ctf_fs_trace *ctf_fs_trace,
+		GArray *group_recs, GArray *info_recs,
+		const char **pos, const char *end)
+{
+	int ret = 1;
+	struct index_cache_ds_file_group_rec group_rec = { 0 };
+	const char *data;
+	uint64_t i;
+
+	data = consume(pos, end, sizeof(group_rec.hdr));
+	if (!data) {
+		goto end;
+	}
+
+	memcpy(&group_rec.hdr, data, sizeof(group_rec.hdr));
+	group_rec.first_info_rec = info_recs->len;
+
+	for (i = 0; i < group_rec.hdr.ds_file_info_count; i++) {
+		ret = read_ds_file_info_rec(info_recs, pos, end);
+		if (ret) {
+			goto end;
+		}
+	}
+
+	group_rec.stream_class = bt_ctf_trace_get_stream_class_by_id(
+		ctf_fs_trace->metadata->trace, group_rec.hdr.stream_class_id);
+	if (!group_rec.stream_class) {
+		BT_LOGD("Index cache refers to an unknown stream class: "
+			"id=%" PRId64, group_rec.hdr.stream_class_id);
+		ret = 1;
+		goto end;
+	}
+
+	/* Ownership of the stream class is transferred */
+	g_array_append_val(group_recs, group_rec);
+	ret = 0;
+
+end:
+	return ret;
+}
+
+static
+int load_ds_file_info(struct ctf_fs_ds_file_group *ds_file_group,
+		struct index_cache_ds_file_info_rec *info_rec)
+{
+	int ret = -1;
+	struct ctf_fs_ds_index *index = NULL;
+	gchar *path;
+
+	path = g_strndup(info_rec->path, info_rec->hdr.path_len);
+	if (!path) {
+		goto end;
+	}
+
+	if (info_rec->entries) {
+		index = ctf_fs_ds_index_create(info_rec->hdr.entry_count);
+		if (!index) {
+			goto end;
+		}
+
+		memcpy(index->entries->data, info_rec->entries,
+			info_rec->hdr.entry_count *
+			sizeof(struct ctf_fs_ds_index_entry));
+	}
+
+	/* Ownership of index is transferred */
+	ret = ctf_fs_ds_file_group_add_ds_file_info(ds_file_group, path,
+		info_rec->hdr.begin_ns, index) ? -1 : 0;
+	index = NULL;
+
+end:
+	ctf_fs_ds_index_destroy(index);
+	g_free(path);
+	return ret;
+}
+
+static
+int load_ds_file_group(struct ctf_fs_trace *ctf_fs_trace,
+		struct index_cache_ds_file_group_rec *group_rec,
+		GArray *info_recs)
+{
+	int ret = -1;
+	struct ctf_fs_ds_file_group *ds_file_group;
+	uint64_t i;
+
+	ds_file_group = ctf_fs_ds_file_group_create(ctf_fs_trace,
+		group_rec->stream_class, group_rec->hdr.stream_instance_id);
+	if (!ds_file_group) {
+		goto end;
+	}
+
+	for (i = 0; i < group_rec->hdr.ds_file_info_count; i++) {
+		ret = load_ds_file_info(ds_file_group,
+			&g_array_index(info_recs,
+				struct index_cache_ds_file_info_rec,
+				group_rec->first_info_rec + i));
+		if (ret) {
+			goto end;
+		}
+	}
+
+	g_ptr_array_add(ctf_fs_trace->ds_file_groups, ds_file_group);
+	ds_file_group = NULL;
+	ret = 0;
+
+end:
+	ctf_fs_ds_file_group_destroy(ds_file_group);
+	return ret;
+}
+
+BT_HIDDEN
+int ctf_fs_index_cache_load(struct ctf_fs_trace *ctf_fs_trace,
+		const char *cache_dir,
+		struct ctf_fs_metadata_config *metadata_config)
+{
+	int ret = 1;
+	GString *cache_file_path = NULL;
+	GMappedFile *mapped_file = NULL;
+	struct index_cache_hdr expected_hdr;
+	struct index_cache_hdr hdr;
+	GArray *group_recs = NULL;
+	GArray *info_recs = NULL;
+	const char *pos, *end, *data;
+	uint64_t i;
+
+	assert(ctf_fs_trace->ds_file_groups->len == 0);
+	cache_file_path = get_cache_file_path(ctf_fs_trace, cache_dir);
+	if (!cache_file_path) {
+		ret = -1;
+		goto end;
+	}
+
+	mapped_file = g_mapped_file_new(cache_file_path->str, FALSE, NULL);
+	if (!mapped_file) {
+		BT_LOGD("No index cache file for trace: "
+			"trace-path=\"%s\", cache-file-path=\"%s\"",
+			ctf_fs_trace->path->str, cache_file_path->str);
+		goto end;
+	}
+
+	if (fill_header(&expected_hdr, ctf_fs_trace, metadata_config)) {
+		goto end;
+	}
+
+	pos = g_mapped_file_get_contents(mapped_file);
+	end = pos + g_mapped_file_get_length(mapped_file);
+	data = consume(&pos, end, sizeof(hdr));
+	if (!data) {
+		BT_LOGW("Invalid index cache file: file size < header size: "
+			"path=\"%s\"", cache_file_path->str);
+		goto end;
+	}
+
+	memcpy(&hdr, data, sizeof(hdr));
+	expected_hdr.ds_file_group_count = hdr.ds_file_group_count;
+
+	if (memcmp(&hdr, &expected_hdr, sizeof(hdr)) != 0) {
+		BT_LOGD("Index cache file is stale: path=\"%s\"",
+			cache_file_path->str);
+		goto end;
+	}
+
+	group_recs = g_array_new(FALSE, FALSE,
+		sizeof(struct index_cache_ds_file_group_rec));
+	info_recs = g_array_new(FALSE, FALSE,
+		sizeof(struct index_cache_ds_file_info_rec));
+	if (!group_recs || !info_recs) {
+		ret = -1;
+		goto end;
+	}
+
+	/* Validate the whole cache file before creating anything */
+	for (i = 0; i < hdr.ds_file_group_count; i++) {
+		ret = read_ds_file_group_rec(ctf_fs_trace, group_recs,
+			info_recs, &pos, end);
+		if (ret) {
+			goto end;
+		}
+	}
+
+	if (pos != end) {
+		BT_LOGW("Invalid index cache file: unexpected trailing data: "
+			"path=\"%s\"", cache_file_path->str);
+		ret = 1;
+		goto end;
+	}
+
+	for (i = 0; i < group_recs->len; i++) {
+		ret = load_ds_file_group(ctf_fs_trace,
+			&g_array_index(group_recs,
+				struct index_cache_ds_file_group_rec, i),
+			info_recs);
+		if (ret) {
+			goto end;
+		}
+	}
+
+	BT_LOGD("Loaded stream file groups from index cache file: "
+		"trace-path=\"%s\", cache-file-path=\"%s\", group-count=%u",
+		ctf_fs_trace->path->str, cache_file_path->str,
+		ctf_fs_trace->ds_file_groups->len);
+	ret = 0;
+
+end:
+	if (ret) {
+		/*
+		 * Start over without the cache. When ret > 0, the
+		 * cache file was found invalid before any group was
+		 * created.
+		 */
+		assert(ret < 0 || ctf_fs_trace->ds_file_groups->len == 0);
+		g_ptr_array_set_size(ctf_fs_trace->ds_file_groups, 0);
+	}
+
+	if (group_recs) {
+		for (i = 0; i < group_recs->len; i++) {
+			bt_put(g_array_index(group_recs,
+				struct index_cache_ds_file_group_rec,
+				i).stream_class);
+		}
+
+		g_array_free(group_recs, TRUE);
+	}
+
+	if (info_recs) {
+		g_array_free(info_recs, TRUE);
+	}
+
+	if (mapped_file) {
+		g_mapped_file_unref(mapped_file);
+	}
+
+	if (cache_file_path) {
+		g_string_free(cache_file_path, TRUE);
+	}
+
+	return ret;
+}
+
+static
+int write_ds_file_info(FILE *fp, struct ctf_fs_ds_file_info *ds_file_info)
+{
+	int ret = -1;
+	struct index_cache_ds_file_info_hdr info_hdr = { 0 };
+	uint64_t size;
+	int64_t mtime_ns;
+
+	info_hdr.path_len = ds_file_info->path->len;
+	info_hdr.begin_ns = ds_file_info->begin_ns;
+
+	if (stat_path(ds_file_info->path->str, &size, &mtime_ns)) {
+		goto end;
+	}
+
+	info_hdr.size = size;
+	info_hdr.mtime_ns = mtime_ns;
+
+	if (ds_file_info->index) {
+		info_hdr.entry_count = ds_file_info->index->entries->len;
+	} else {
+		info_hdr.entry_count = INDEX_CACHE_NO_INDEX;
+	}
+
+	if (fwrite(&info_hdr, sizeof(info_hdr), 1, fp) != 1) {
+		goto end;
+	}
+
+	if (fwrite(ds_file_info->path->str, 1, info_hdr.path_len, fp) !=
+			info_hdr.path_len) {
+		goto end;
+	}
+
+	if (ds_file_info->index && ds_file_info->index->entries->len > 0) {
+		if (fwrite(ds_file_info->index->entries->data,
+				sizeof(struct ctf_fs_ds_index_entry),
+				ds_file_info->index->entries->len, fp) !=
+				ds_file_info->index->entries->len) {
+			goto end;
+		}
+	}
+
+	ret = 0;
+
+end:
+	return ret;
+}
+
+static
+int write_ds_file_group(FILE *fp, struct ctf_fs_ds_file_group *ds_file_group)
+{
+	int ret = -1;
+	struct index_cache_ds_file_group_hdr group_hdr = { 0 };
+	struct bt_ctf_stream_class *stream_class;
+	size_t i;
+
+	stream_class = bt_ctf_stream_get_class(ds_file_group->stream);
+	assert(stream_class);
+	group_hdr.stream_class_id = bt_ctf_stream_class_get_id(stream_class);
+	bt_put(stream_class);
+	group_hdr.stream_instance_id =
+		(uint64_t) bt_ctf_stream_get_id(ds_file_group->stream);
+	group_hdr.ds_file_info_count = ds_file_group->ds_file_infos->len;
+
+	if (fwrite(&group_hdr, sizeof(group_hdr), 1, fp) != 1) {
+		goto end;
+	}
+
+	for (i = 0; i < ds_file_group->ds_file_infos->len; i++) {
+		ret = write_ds_file_info(fp,
+			g_ptr_array_index(ds_file_group->ds_file_infos, i));
+		if (ret) {
+			goto end;
+		}
+	}
+
+	ret = 0;
+
+end:
+	return ret;
+}
+
+BT_HIDDEN
+int ctf_fs_index_cache_save(struct ctf_fs_trace *ctf_fs_trace,
+		const char *cache_dir,
+		struct ctf_fs_metadata_config *metadata_config)
+{
+	int ret = -1;
+	GString *cache_file_path = NULL;
+	GString *tmp_file_path = NULL;
+	struct index_cache_hdr hdr;
+	FILE *fp = NULL;
+	size_t i;
+
+	if (g_mkdir_with_parents(cache_dir, 0755)) {
+		BT_LOGW("Cannot create index cache directory `%s`: %s",
+			cache_dir, strerror(errno));
+		goto end;
+	}
+
+	cache_file_path = get_cache_file_path(ctf_fs_trace, cache_dir);
+	if (!cache_file_path) {
+		goto end;
+	}
+
+	tmp_file_path = g_string_new(cache_file_path->str);
+	if (!tmp_file_path) {
+		goto end;
+	}
+
+	g_string_append_printf(tmp_file_path, ".tmp.%d", (int) getpid());
+
+	if (fill_header(&hdr, ctf_fs_trace, metadata_config)) {
+		goto end;
+	}
+
+	hdr.ds_file_group_count = ctf_fs_trace->ds_file_groups->len;
+
+	/*
+	 * Write a temporary file and rename it so that a concurrent
+	 * reader never sees a partial cache file.
+	 */
+	fp = g_fopen(tmp_file_path->str, "wb");
+	if (!fp) {
+		BT_LOGW("Cannot open index cache file `%s` for writing: %s",
+			tmp_file_path->str, strerror(errno));
+		goto end;
+	}
+
+	if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1) {
+		goto end;
+	}
+
+	for (i = 0; i < ctf_fs_trace->ds_file_groups->len; i++) {
+		if (write_ds_file_group(fp,
+				g_ptr_array_index(ctf_fs_trace->ds_file_groups, i))) {
+			goto end;
+		}
+	}
+
+	if (fclose(fp)) {
+		fp = NULL;
+		goto end;
+	}
+
+	fp = NULL;
+
+	if (g_rename(tmp_file_path->str, cache_file_path->str)) {
+		BT_LOGW("Cannot rename index cache file `%s` to `%s`: %s",
+			tmp_file_path->str, cache_file_path->str,
+			strerror(errno));
+		goto end;
+	}
+
+	BT_LOGD("Wrote index cache file: trace-path=\"%s\", "
+		"cache-file-path=\"%s\"", ctf_fs_trace->path->str,
+		cache_file_path->str);
+	ret = 0;
+
+end:
+	if (fp) {
+		fclose(fp);
+	}
+
+	if (ret && tmp_file_path) {
+		(void) g_unlink(tmp_file_path->str);
+	}
+
+	if (tmp_file_path) {
+		g_string_free(tmp_file_path, TRUE);
+	}
+
+	if (cache_file_path) {
+		g_string_free(cache_file_path, TRUE);
+	}
+
+	return ret;
+}
@@ -0,0 +1,66 @@
+#ifndef CTF_FS_INDEX_CACHE_H
+#define CTF_FS_INDEX_CACHE_H
+
+/*
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <babeltrace/babeltrace-internal.h>
+#include "metadata.h"
+
+struct ctf_fs_trace;
+
+/*
+ * The index cache holds, for a given trace directory, the resolved
+ * stream file groups of the trace: which data stream files belong to
+ * which stream, in which order, and their packet indexes. It is stored
+ * in a single file per trace within a user-provided cache directory.
+ *
+ * A cache file is stale as soon as the trace directory, its metadata
+ * file, or one of its data stream files has a different size or
+ * modification time than when the cache file was written, or if the
+ * clock class offsets of the metadata configuration are different.
+ */
+
+/*
+ * Creates the stream file groups of `ctf_fs_trace` from its cache file
+ * in `cache_dir`.
+ *
+ * Returns 0 if the stream file groups were created from the cache
+ * file, 1 if there's no valid cache file for this trace (in which case
+ * the trace's stream file groups are left empty), or a negative value
+ * on error.
+ */
+BT_HIDDEN
+int ctf_fs_index_cache_load(struct ctf_fs_trace *ctf_fs_trace,
+		const char *cache_dir,
+		struct ctf_fs_metadata_config *metadata_config);
+
+/*
+ * Writes the stream file groups of `ctf_fs_trace` to its cache file in
+ * `cache_dir`, replacing any existing one.
+ */
+BT_HIDDEN
+int ctf_fs_index_cache_save(struct ctf_fs_trace *ctf_fs_trace,
+		const char *cache_dir,
+		struct ctf_fs_metadata_config *metadata_config);
+
+#endif /* CTF_FS_INDEX_CACHE_H */
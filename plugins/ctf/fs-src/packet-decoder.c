@@ -0,0 +1,541 @@
+/*
+ * packet-decoder.c
+ *
+ * Babeltrace CTF file system Reader Component multithreaded packet decoder
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <pthread.h>
+#include <glib.h>
+#include <babeltrace/ref.h>
+#include <babeltrace/graph/notification.h>
+#include <babeltrace/graph/notification-iterator.h>
+#include "fs.h"
+#include "data-stream-file.h"
+#include "packet-decoder.h"
+
+#define BT_LOG_TAG "PLUGIN-CTF-FS-SRC-PACKET-DECODER"
+#include "logging.h"
+
+/*
+ * Number of packets which can be decoded ahead of the consumer for
+ * each decoding thread.
+ */
+#define PACKET_DECODER_PACKETS_PER_THREAD	2
+
+enum decoded_packet_state {
+	/* Not part of the current data stream file's packets */
+	DECODED_PACKET_STATE_UNUSED,
+
+	/* Waiting for a decoding thread */
+	DECODED_PACKET_STATE_QUEUED,
+
+	/* Being decoded by a decoding thread */
+	DECODED_PACKET_STATE_DECODING,
+
+	/* Decoded: its notifications are ready to be consumed */
+	DECODED_PACKET_STATE_DECODED,
+};
+
+struct decoded_packet {
+	enum decoded_packet_state state;
+
+	/* Index of this packet's entry in the data stream file's index */
+	size_t entry_index;
+
+	/*
+	 * Array of struct bt_notification *, owned by this. Only the
+	 * decoding thread which decodes this packet modifies it while
+	 * its state is DECODED_PACKET_STATE_DECODING, and only the
+	 * consumer accesses it otherwise.
+	 */
+	GPtrArray *notifs;
+
+	/* Index, in `notifs`, of the next notification to consume */
+	guint next_notif_index;
+
+	/* Status to return after the last notification of `notifs` */
+	enum bt_notification_iterator_status status;
+};
+
+struct decoding_thread {
+	/* Weak */
+	struct ctf_fs_packet_decoder *decoder;
+
+	pthread_t tid;
+	bool tid_is_valid;
+
+	/*
+	 * Owned by this, private to the thread: the data stream file
+	 * which is opened to decode the packets of `ds_file_info`.
+	 */
+	struct ctf_fs_ds_file *ds_file;
+
+	/* Weak, belongs to a data stream file group */
+	struct ctf_fs_ds_file_info *ds_file_info;
+};
+
+struct ctf_fs_packet_decoder {
+	/* Weak */
+	struct ctf_fs_trace *ctf_fs_trace;
+
+	/* Owned by this */
+	struct bt_ctf_stream *stream;
+
+	/* Array of struct decoding_thread *, owned by this */
+	GPtrArray *threads;
+
+	/*
+	 * Circular window of `window_size` packets, owned by this. The
+	 * packet at `window_head` is the one which the consumer gets
+	 * notifications from, and the next ones are its following
+	 * packets, in order.
+	 */
+	struct decoded_packet *window;
+	size_t window_size;
+	size_t window_head;
+
+	/* Weak, belongs to a data stream file group */
+	struct ctf_fs_ds_file_info *ds_file_info;
+
+	/* Index of the next index entry to add to the window */
+	size_t next_entry_index;
+
+	/*
+	 * Protects the states and entry indexes of the packets of the
+	 * window, `ds_file_info`, and `quit`.
+	 */
+	pthread_mutex_t lock;
+
+	/* Signaled when a packet is queued or when quitting */
+	pthread_cond_t queued_cond;
+
+	/* Signaled when a packet is decoded */
+	pthread_cond_t decoded_cond;
+
+	bool quit;
+};
+
+static
+void decoded_packet_clear(struct decoded_packet *packet)
+{
+	guint i;
+
+	for (i = packet->next_notif_index; i < packet->notifs->len; i++) {
+		bt_put(g_ptr_array_index(packet->notifs, i));
+	}
+
+	g_ptr_array_set_size(packet->notifs, 0);
+	packet->next_notif_index = 0;
+	packet->status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	packet->state = DECODED_PACKET_STATE_UNUSED;
+}
+
+/* Call with the decoder's lock held. */
+static
+void queue_next_packet(struct ctf_fs_packet_decoder *decoder,
+		struct decoded_packet *packet)
+{
+	assert(packet->state == DECODED_PACKET_STATE_UNUSED);
+
+	if (!decoder->ds_file_info ||
+			decoder->next_entry_index >=
+				decoder->ds_file_info->index->entries->len) {
+		return;
+	}
+
+	packet->entry_index = decoder->next_entry_index;
+	packet->state = DECODED_PACKET_STATE_QUEUED;
+	decoder->next_entry_index++;
+	pthread_cond_signal(&decoder->queued_cond);
+}
+
+/*
+ * Returns the first queued packet of the window, in packet order, or
+ * NULL if there's none. Call with the decoder's lock held.
+ */
+static
+struct decoded_packet *find_queued_packet(
+		struct ctf_fs_packet_decoder *decoder)
+{
+	size_t i;
+
+	for (i = 0; i < decoder->window_size; i++) {
+		struct decoded_packet *packet = &decoder->window[
+			(decoder->window_head + i) % decoder->window_size];
+
+		if (packet->state == DECODED_PACKET_STATE_QUEUED) {
+			return packet;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Decodes the notifications of the packet starting at `offset` in the
+ * data stream file of `ds_file_info` into `packet`, up to and
+ * including its "packet end" notification.
+ */
+static
+void decode_packet(struct decoding_thread *thread,
+		struct ctf_fs_ds_file_info *ds_file_info, off_t offset,
+		struct decoded_packet *packet)
+{
+	struct bt_notification_iterator_next_return next_ret;
+
+	if (thread->ds_file_info != ds_file_info) {
+		ctf_fs_ds_file_destroy(thread->ds_file);
+		thread->ds_file_info = NULL;
+		thread->ds_file = ctf_fs_ds_file_create(
+			thread->decoder->ctf_fs_trace, thread->decoder->stream,
+			ds_file_info->path->str);
+		if (!thread->ds_file) {
+			BT_LOGE("Cannot create data stream file: path=\"%s\"",
+				ds_file_info->path->str);
+			goto error;
+		}
+
+		thread->ds_file_info = ds_file_info;
+	}
+
+	if (ctf_fs_ds_file_seek(thread->ds_file, offset)) {
+		goto error;
+	}
+
+	while (true) {
+		next_ret = ctf_fs_ds_file_next(thread->ds_file);
+		if (next_ret.status == BT_NOTIFICATION_ITERATOR_STATUS_END) {
+			break;
+		}
+
+		if (next_ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			BT_LOGE("Cannot decode packet: path=\"%s\", offset=%jd",
+				ds_file_info->path->str, (intmax_t) offset);
+			goto error;
+		}
+
+		g_ptr_array_add(packet->notifs, next_ret.notification);
+
+		if (bt_notification_get_type(next_ret.notification) ==
+				BT_NOTIFICATION_TYPE_PACKET_END) {
+			break;
+		}
+	}
+
+	packet->status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	return;
+
+error:
+	packet->status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+}
+
+static
+void *decoding_thread_func(void *data)
+{
+	struct decoding_thread *thread = data;
+	struct ctf_fs_packet_decoder *decoder = thread->decoder;
+
+	pthread_mutex_lock(&decoder->lock);
+
+	while (!decoder->quit) {
+		struct decoded_packet *packet = find_queued_packet(decoder);
+		struct ctf_fs_ds_file_info *ds_file_info;
+		off_t offset;
+
+		if (!packet) {
+			pthread_cond_wait(&decoder->queued_cond,
+				&decoder->lock);
+			continue;
+		}
+
+		/*
+		 * The data stream file info cannot change while one
+		 * of its packets is being decoded: see
+		 * ctf_fs_packet_decoder_set_ds_file_info().
+		 */
+		packet->state = DECODED_PACKET_STATE_DECODING;
+		ds_file_info = decoder->ds_file_info;
+		offset = (off_t) g_array_index(ds_file_info->index->entries,
+			struct ctf_fs_ds_index_entry,
+			packet->entry_index).offset;
+		pthread_mutex_unlock(&decoder->lock);
+		decode_packet(thread, ds_file_info, offset, packet);
+		pthread_mutex_lock(&decoder->lock);
+		packet->state = DECODED_PACKET_STATE_DECODED;
+		pthread_cond_broadcast(&decoder->decoded_cond);
+	}
+
+	pthread_mutex_unlock(&decoder->lock);
+	return NULL;
+}
+
+static
+void decoding_thread_destroy(void *data)
+{
+	struct decoding_thread *thread = data;
+
+	if (!thread) {
+		return;
+	}
+
+	/* The decoder joined the thread before */
+	ctf_fs_ds_file_destroy(thread->ds_file);
+	g_free(thread);
+}
+
+BT_HIDDEN
+struct ctf_fs_packet_decoder *ctf_fs_packet_decoder_create(
+		struct ctf_fs_trace *ctf_fs_trace,
+		struct bt_ctf_stream *stream, unsigned int nr_threads)
+{
+	struct ctf_fs_packet_decoder *decoder;
+	unsigned int i;
+
+	assert(ctf_fs_trace);
+	assert(stream);
+	assert(nr_threads > 0);
+	BT_LOGD("Creating packet decoder: stream-addr=%p, nr-threads=%u",
+		stream, nr_threads);
+	decoder = g_new0(struct ctf_fs_packet_decoder, 1);
+	if (!decoder) {
+		BT_LOGE_STR("Failed to allocate one packet decoder.");
+		goto error;
+	}
+
+	decoder->ctf_fs_trace = ctf_fs_trace;
+	decoder->stream = bt_get(stream);
+	pthread_mutex_init(&decoder->lock, NULL);
+	pthread_cond_init(&decoder->queued_cond, NULL);
+	pthread_cond_init(&decoder->decoded_cond, NULL);
+	decoder->window_size = nr_threads * PACKET_DECODER_PACKETS_PER_THREAD;
+	decoder->window = g_new0(struct decoded_packet, decoder->window_size);
+	if (!decoder->window) {
+		BT_LOGE_STR("Failed to allocate the packet decoder's window.");
+		goto error;
+	}
+
+	for (i = 0; i < decoder->window_size; i++) {
+		decoder->window[i].notifs = g_ptr_array_new();
+		if (!decoder->window[i].notifs) {
+			BT_LOGE_STR("Failed to allocate a GPtrArray.");
+			goto error;
+		}
+	}
+
+	decoder->threads = g_ptr_array_new_with_free_func(
+		decoding_thread_destroy);
+	if (!decoder->threads) {
+		BT_LOGE_STR("Failed to allocate a GPtrArray.");
+		goto error;
+	}
+
+	for (i = 0; i < nr_threads; i++) {
+		struct decoding_thread *thread =
+			g_new0(struct decoding_thread, 1);
+
+		if (!thread) {
+			BT_LOGE_STR("Failed to allocate one decoding thread.");
+			goto error;
+		}
+
+		thread->decoder = decoder;
+		g_ptr_array_add(decoder->threads, thread);
+
+		if (pthread_create(&thread->tid, NULL, decoding_thread_func,
+				thread)) {
+			BT_LOGE("Cannot create decoding thread: %s",
+				strerror(errno));
+			goto error;
+		}
+
+		thread->tid_is_valid = true;
+	}
+
+	goto end;
+
+error:
+	ctf_fs_packet_decoder_destroy(decoder);
+	decoder = NULL;
+
+end:
+	return decoder;
+}
+
+BT_HIDDEN
+void ctf_fs_packet_decoder_destroy(struct ctf_fs_packet_decoder *decoder)
+{
+	size_t i;
+
+	if (!decoder) {
+		return;
+	}
+
+	BT_LOGD("Destroying packet decoder: addr=%p", decoder);
+
+	if (decoder->threads) {
+		pthread_mutex_lock(&decoder->lock);
+		decoder->quit = true;
+		pthread_cond_broadcast(&decoder->queued_cond);
+		pthread_mutex_unlock(&decoder->lock);
+
+		for (i = 0; i < decoder->threads->len; i++) {
+			struct decoding_thread *thread =
+				g_ptr_array_index(decoder->threads, i);
+
+			if (thread->tid_is_valid) {
+				(void) pthread_join(thread->tid, NULL);
+			}
+		}
+
+		g_ptr_array_free(decoder->threads, TRUE);
+	}
+
+	if (decoder->window) {
+		for (i = 0; i < decoder->window_size; i++) {
+			struct decoded_packet *packet = &decoder->window[i];
+
+			if (packet->notifs) {
+				decoded_packet_clear(packet);
+				g_ptr_array_free(packet->notifs, TRUE);
+			}
+		}
+
+		g_free(decoder->window);
+	}
+
+	pthread_cond_destroy(&decoder->decoded_cond);
+	pthread_cond_destroy(&decoder->queued_cond);
+	pthread_mutex_destroy(&decoder->lock);
+	bt_put(decoder->stream);
+	g_free(decoder);
+}
+
+BT_HIDDEN
+int ctf_fs_packet_decoder_set_ds_file_info(
+		struct ctf_fs_packet_decoder *decoder,
+		struct ctf_fs_ds_file_info *ds_file_info,
+		size_t first_entry_index)
+{
+	size_t i;
+
+	assert(decoder);
+	assert(ds_file_info);
+	assert(ds_file_info->index);
+	BT_LOGD("Setting packet decoder's data stream file: "
+		"decoder-addr=%p, path=\"%s\", first-entry-index=%zu",
+		decoder, ds_file_info->path->str, first_entry_index);
+	pthread_mutex_lock(&decoder->lock);
+
+	/* Make sure no decoding thread starts decoding a packet */
+	for (i = 0; i < decoder->window_size; i++) {
+		if (decoder->window[i].state == DECODED_PACKET_STATE_QUEUED) {
+			decoder->window[i].state = DECODED_PACKET_STATE_UNUSED;
+		}
+	}
+
+	/* Wait for the packets which are currently decoded */
+	for (i = 0; i < decoder->window_size; i++) {
+		while (decoder->window[i].state ==
+				DECODED_PACKET_STATE_DECODING) {
+			pthread_cond_wait(&decoder->decoded_cond,
+				&decoder->lock);
+		}
+	}
+
+	for (i = 0; i < decoder->window_size; i++) {
+		decoded_packet_clear(&decoder->window[i]);
+	}
+
+	decoder->ds_file_info = ds_file_info;
+	decoder->next_entry_index = first_entry_index;
+	decoder->window_head = 0;
+
+	for (i = 0; i < decoder->window_size; i++) {
+		queue_next_packet(decoder, &decoder->window[i]);
+	}
+
+	pthread_mutex_unlock(&decoder->lock);
+	return 0;
+}
+
+BT_HIDDEN
+struct bt_notification_iterator_next_return ctf_fs_packet_decoder_next(
+		struct ctf_fs_packet_decoder *decoder)
+{
+	struct bt_notification_iterator_next_return next_ret = {
+		.status = BT_NOTIFICATION_ITERATOR_STATUS_OK,
+		.notification = NULL,
+	};
+
+	assert(decoder);
+
+	while (true) {
+		struct decoded_packet *packet =
+			&decoder->window[decoder->window_head];
+
+		pthread_mutex_lock(&decoder->lock);
+
+		while (packet->state == DECODED_PACKET_STATE_QUEUED ||
+				packet->state == DECODED_PACKET_STATE_DECODING) {
+			pthread_cond_wait(&decoder->decoded_cond,
+				&decoder->lock);
+		}
+
+		pthread_mutex_unlock(&decoder->lock);
+
+		if (packet->state == DECODED_PACKET_STATE_UNUSED) {
+			/* All the packets of the file are consumed */
+			next_ret.status = BT_NOTIFICATION_ITERATOR_STATUS_END;
+			goto end;
+		}
+
+		if (packet->next_notif_index < packet->notifs->len) {
+			/* Move the notification to the caller */
+			next_ret.notification = g_ptr_array_index(
+				packet->notifs, packet->next_notif_index);
+			packet->next_notif_index++;
+			goto end;
+		}
+
+		if (packet->status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			next_ret.status = packet->status;
+			goto end;
+		}
+
+		/* Reuse this slot for the next packet of the file */
+		pthread_mutex_lock(&decoder->lock);
+		decoded_packet_clear(packet);
+		queue_next_packet(decoder, packet);
+		decoder->window_head = (decoder->window_head + 1) %
+			decoder->window_size;
+		pthread_mutex_unlock(&decoder->lock);
+	}
+
+end:
+	return next_ret;
+}
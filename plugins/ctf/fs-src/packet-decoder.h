@@ -0,0 +1,81 @@
+#ifndef CTF_FS_PACKET_DECODER_H
+#define CTF_FS_PACKET_DECODER_H
+
+/*
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stddef.h>
+#include <babeltrace/babeltrace-internal.h>
+#include <babeltrace/ctf-ir/stream.h>
+#include <babeltrace/graph/notification-iterator.h>
+
+struct ctf_fs_trace;
+struct ctf_fs_ds_file_info;
+struct ctf_fs_packet_decoder;
+
+/*
+ * A packet decoder decodes the packets of an indexed data stream file
+ * on a pool of threads.
+ *
+ * Each packet of an indexed data stream file is independently
+ * decodable: it starts at a known offset and its context contains a
+ * `timestamp_begin` field which sets the stream's clock. Each decoding
+ * thread therefore opens its own data stream file and decodes whole
+ * packets, ahead of the consumer, into batches of notifications. The
+ * consumer gets the notifications of those batches in packet order, so
+ * that the notifications are the same, and in the same order, as if
+ * the data stream file was decoded serially.
+ */
+
+/*
+ * Creates a packet decoder with `nr_threads` decoding threads for the
+ * data stream files of `stream`.
+ */
+BT_HIDDEN
+struct ctf_fs_packet_decoder *ctf_fs_packet_decoder_create(
+		struct ctf_fs_trace *ctf_fs_trace,
+		struct bt_ctf_stream *stream, unsigned int nr_threads);
+
+BT_HIDDEN
+void ctf_fs_packet_decoder_destroy(struct ctf_fs_packet_decoder *decoder);
+
+/*
+ * Discards the packets which are currently decoded and starts decoding
+ * the packets of `ds_file_info`, which must have an index, from its
+ * index entry `first_entry_index`.
+ */
+BT_HIDDEN
+int ctf_fs_packet_decoder_set_ds_file_info(
+		struct ctf_fs_packet_decoder *decoder,
+		struct ctf_fs_ds_file_info *ds_file_info,
+		size_t first_entry_index);
+
+/*
+ * Returns the next notification of the current data stream file, or
+ * the BT_NOTIFICATION_ITERATOR_STATUS_END status once all its packets
+ * are consumed.
+ */
+BT_HIDDEN
+struct bt_notification_iterator_next_return ctf_fs_packet_decoder_next(
+		struct ctf_fs_packet_decoder *decoder);
+
+#endif /* CTF_FS_PACKET_DECODER_H */
@@ -49,10 +49,8 @@ enum bt_ctf_notif_iter_medium_status medop_request_bytes(
 	struct lttng_live_trace *trace = stream->trace;
 	struct lttng_live_session *session = trace->session;
 	struct lttng_live_component *lttng_live = session->lttng_live;
-	uint64_t recv_len = 0;
 	uint64_t len_left;
 	uint64_t read_len;
-	//int i;
 
 	len_left = stream->base_offset + stream->len - stream->offset;
 	if (!len_left) {
@@ -60,14 +58,14 @@ enum bt_ctf_notif_iter_medium_status medop_request_bytes(
 		status = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_AGAIN;
 		return status;
 	}
-	read_len = MIN(request_sz, stream->buflen);
-	read_len = MIN(read_len, len_left);
-	status = lttng_live_get_stream_bytes(lttng_live,
-			stream, stream->buf, stream->offset,
-			read_len, &recv_len);
-	*buffer_addr = stream->buf;
-	*buffer_sz = recv_len;
-	stream->offset += recv_len;
+	status = lttng_live_get_stream_bytes(lttng_live, stream);
+	if (status != BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK) {
+		return status;
+	}
+	read_len = MIN(request_sz, stream->recv_offset - stream->offset);
+	*buffer_addr = stream->buf + (stream->offset - stream->base_offset);
+	*buffer_sz = read_len;
+	stream->offset += read_len;
 	return status;
 }
 
@@ -203,6 +201,7 @@ void lttng_live_stream_iterator_destroy(struct lttng_live_stream_iterator *strea
 	if (stream->notif_iter) {
 		bt_ctf_notif_iter_destroy(stream->notif_iter);
 	}
+	lttng_live_forget_stream_packet_requests(lttng_live, stream);
 	g_free(stream->buf);
 	BT_PUT(stream->packet_end_notif_queue);
 	bt_list_del(&stream->node);
@@ -214,3 +213,38 @@ void lttng_live_stream_iterator_destroy(struct lttng_live_stream_iterator *strea
 	lttng_live_unref_trace(stream->trace);
 	g_free(stream);
 }
+
+/*
+ * Make the packet described by "index" the current packet of the stream
+ * and start transferring it, so that its first bytes are on their way
+ * by the time they are decoded.
+ */
+BT_HIDDEN
+enum bt_ctf_lttng_live_iterator_status lttng_live_stream_iterator_set_packet(
+		struct lttng_live_stream_iterator *stream,
+		const struct packet_index *index)
+{
+	struct lttng_live_component *lttng_live =
+		stream->trace->session->lttng_live;
+	uint64_t len = index->packet_size / CHAR_BIT;
+
+	lttng_live_detach_stream_packet_buffer(lttng_live, stream);
+	if (len > stream->buflen) {
+		/* Previous packet is entirely consumed: no need to copy it. */
+		g_free(stream->buf);
+		stream->buf = g_new(uint8_t, len);
+		stream->buflen = len;
+	}
+	stream->base_offset = index->offset;
+	stream->offset = index->offset;
+	stream->request_offset = index->offset;
+	stream->recv_offset = index->offset;
+	stream->len = len;
+	if (lttng_live_request_stream_bytes(lttng_live, stream)) {
+		if (lttng_live_is_canceled(lttng_live)) {
+			return BT_CTF_LTTNG_LIVE_ITERATOR_STATUS_AGAIN;
+		}
+		return BT_CTF_LTTNG_LIVE_ITERATOR_STATUS_ERROR;
+	}
+	return BT_CTF_LTTNG_LIVE_ITERATOR_STATUS_OK;
+}
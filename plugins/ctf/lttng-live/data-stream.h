@@ -41,4 +41,8 @@ struct lttng_live_stream_iterator *lttng_live_stream_iterator_create(
 
 void lttng_live_stream_iterator_destroy(struct lttng_live_stream_iterator *stream);
 
+enum bt_ctf_lttng_live_iterator_status lttng_live_stream_iterator_set_packet(
+		struct lttng_live_stream_iterator *stream,
+		const struct packet_index *index);
+
 #endif /* LTTNG_LIVE_DATA_STREAM_H */
@@ -91,6 +91,8 @@ struct lttng_live_stream_iterator {
 	uint64_t base_offset;		/* base offset in current index. */
 	uint64_t len;			/* len to read in current index. */
 	uint64_t offset;		/* offset in current index. */
+	uint64_t request_offset;	/* end of requested bytes. */
+	uint64_t recv_offset;		/* end of received bytes. */
 
 	int64_t last_returned_inactivity_timestamp;
 	int64_t current_inactivity_timestamp;
@@ -100,6 +102,11 @@ struct lttng_live_stream_iterator {
 	uint64_t current_packet_end_timestamp;
 	struct bt_notification *packet_end_notif_queue;
 
+	/*
+	 * Bytes of the current packet, from `base_offset` to
+	 * `recv_offset`. The rest of the packet is received in place
+	 * as the responses to its pending GET_PACKET requests arrive.
+	 */
 	uint8_t *buf;
 	size_t buflen;
 
@@ -166,6 +173,9 @@ struct lttng_live_session {
 	/* List of struct lttng_live_trace */
 	struct bt_list_head traces;
 
+	/* Number of GET_PACKET requests waiting for a response. */
+	unsigned int nr_pending_packet_requests;
+
 	bool attached;
 	bool new_streams_needed;
 	bool lazy_stream_notif_init;
@@ -185,6 +195,7 @@ struct lttng_live_component {
 
 	GString *url;
 	size_t max_query_size;
+	unsigned int max_pending_packet_requests;	/* per session */
 	struct lttng_live_component_options options;
 
 	struct bt_private_port *no_stream_port;	/* weak */
@@ -251,10 +262,19 @@ enum bt_ctf_lttng_live_iterator_status lttng_live_get_next_index(
 		struct lttng_live_component *lttng_live,
 		struct lttng_live_stream_iterator *stream,
 		struct packet_index *index);
+int lttng_live_request_stream_bytes(struct lttng_live_component *lttng_live,
+		struct lttng_live_stream_iterator *stream);
 enum bt_ctf_notif_iter_medium_status lttng_live_get_stream_bytes(
 		struct lttng_live_component *lttng_live,
-		struct lttng_live_stream_iterator *stream, uint8_t *buf, uint64_t offset,
-		uint64_t req_len, uint64_t *recv_len);
+		struct lttng_live_stream_iterator *stream);
+int lttng_live_receive_available_packet_responses(
+		struct lttng_live_component *lttng_live);
+void lttng_live_detach_stream_packet_buffer(
+		struct lttng_live_component *lttng_live,
+		struct lttng_live_stream_iterator *stream);
+void lttng_live_forget_stream_packet_requests(
+		struct lttng_live_component *lttng_live,
+		struct lttng_live_stream_iterator *stream);
 
 int lttng_live_add_port(struct lttng_live_component *lttng_live,
 		struct lttng_live_stream_iterator *stream_iter);
@@ -57,6 +57,7 @@
 #include "lttng-live-internal.h"
 
 #define MAX_QUERY_SIZE		(256*1024)
+#define MAX_PENDING_PACKET_REQUESTS	8
 
 #define print_dbg(fmt, ...)	BT_LOGD(fmt, ## __VA_ARGS__)
 
@@ -443,9 +444,7 @@ enum bt_ctf_lttng_live_iterator_status lttng_live_iterator_next_handle_one_no_da
 		}
 		goto end;
 	}
-	lttng_live_stream->base_offset = index.offset;
-	lttng_live_stream->offset = index.offset;
-	lttng_live_stream->len = index.packet_size / CHAR_BIT;
+	ret = lttng_live_stream_iterator_set_packet(lttng_live_stream, &index);
 end:
 	if (ret == BT_CTF_LTTNG_LIVE_ITERATOR_STATUS_OK) {
 		ret = lttng_live_iterator_next_check_stream_state(
@@ -702,6 +701,14 @@ enum bt_ctf_lttng_live_iterator_status lttng_live_iterator_next_handle_one_activ
 		ret = BT_CTF_LTTNG_LIVE_ITERATOR_STATUS_OK;
 		break;
 	case BT_CTF_NOTIF_ITER_STATUS_AGAIN:
+		if (lttng_live_stream->state == LTTNG_LIVE_STREAM_ACTIVE_DATA) {
+			/*
+			 * The packet's next bytes are still in transit:
+			 * let the graph wait for the control socket.
+			 */
+			ret = BT_CTF_LTTNG_LIVE_ITERATOR_STATUS_AGAIN;
+			break;
+		}
 		/*
 		 * Continue immediately (end of packet). The next
 		 * get_index may return AGAIN to delay the following
@@ -810,6 +817,15 @@ end:
 		print_dbg("continue");
 		goto retry;
 	case BT_CTF_LTTNG_LIVE_ITERATOR_STATUS_AGAIN:
+		/*
+		 * Consume what is already received so that the graph
+		 * only wakes up when more bytes arrive.
+		 */
+		if (lttng_live_receive_available_packet_responses(lttng_live)
+				&& !lttng_live_is_canceled(lttng_live)) {
+			next_return.status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			break;
+		}
 		next_return.status = BT_NOTIFICATION_ITERATOR_STATUS_AGAIN;
 		print_dbg("again");
 		break;
@@ -1062,6 +1078,7 @@ struct lttng_live_component *lttng_live_component_create(struct bt_value *params
 	}
 	/* TODO: make this an overridable parameter. */
 	lttng_live->max_query_size = MAX_QUERY_SIZE;
+	lttng_live->max_pending_packet_requests = MAX_PENDING_PACKET_REQUESTS;
 	BT_INIT_LIST_HEAD(&lttng_live->sessions);
 	value = bt_value_map_get(params, "url");
 	if (!value || bt_value_is_null(value) || !bt_value_is_string(value)) {
@@ -1087,6 +1104,10 @@ struct lttng_live_component *lttng_live_component_create(struct bt_value *params
 		goto error;
 	}
 	lttng_live->private_component = private_component;
+	if (bt_private_component_set_poll_fd(private_component,
+			lttng_live->viewer_connection->control_sock)) {
+		goto error;
+	}
 
 	goto end;
 
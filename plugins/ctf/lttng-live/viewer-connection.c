@@ -48,7 +48,37 @@
 #include "data-stream.h"
 #include "metadata.h"
 
-static ssize_t lttng_live_recv(struct bt_live_viewer_connection *viewer_connection,
+/*
+ * Wait until the control socket, which is non-blocking, is ready for
+ * "events" (POLLIN or POLLOUT).
+ *
+ * Returns 0 when ready, -1 on error or if the graph is canceled.
+ */
+static int wait_control_sock(struct bt_live_viewer_connection *viewer_connection,
+		short events)
+{
+	struct pollfd pfd;
+
+	pfd.fd = viewer_connection->control_sock;
+	pfd.events = events;
+	pfd.revents = 0;
+	for (;;) {
+		int ret = poll(&pfd, 1, -1);
+
+		if (ret > 0) {
+			return 0;
+		}
+		if (ret < 0 && errno == EINTR) {
+			if (lttng_live_is_canceled(viewer_connection->lttng_live)) {
+				return -1;
+			}
+			continue;
+		}
+		return -1;
+	}
+}
+
+static ssize_t lttng_live_recv_raw(struct bt_live_viewer_connection *viewer_connection,
 		void *buf, size_t len)
 {
 	ssize_t ret;
@@ -57,48 +87,327 @@ static ssize_t lttng_live_recv(struct bt_live_viewer_connection *viewer_connecti
 			viewer_connection->lttng_live;
 	int fd = viewer_connection->control_sock;
 
-	do {
+	while (to_copy > 0) {
 		ret = recv(fd, buf + copied, to_copy, 0);
 		if (ret > 0) {
 			assert(ret <= to_copy);
 			copied += ret;
 			to_copy -= ret;
+			continue;
 		}
-		if (ret < 0 && errno == EINTR) {
+		if (ret == 0) {
+			/* Orderly shutdown. */
+			return 0;
+		}
+		if (errno == EINTR) {
 			if (lttng_live_is_canceled(lttng_live)) {
-				break;
-			} else {
-				continue;
+				return -1;
 			}
+			continue;
 		}
-	} while (ret > 0 && to_copy > 0);
-	if (ret > 0)
-		ret = copied;
-	/* ret = 0 means orderly shutdown, ret < 0 is error. */
-	return ret;
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			if (wait_control_sock(viewer_connection, POLLIN)) {
+				return -1;
+			}
+			continue;
+		}
+		return -1;
+	}
+	return copied;
 }
 
+/*
+ * Receive the bytes of "buf" which are not received yet ("*copied" of
+ * them are). If "blocking" is false, only the bytes which are available
+ * on the control socket are received.
+ *
+ * Returns 0 once all of "buf" is received, 1 if the rest is not
+ * available yet, -1 on error or if the connection is closed.
+ */
+static int lttng_live_recv_partial(
+		struct bt_live_viewer_connection *viewer_connection,
+		void *buf, size_t len, size_t *copied, bool blocking)
+{
+	struct lttng_live_component *lttng_live =
+			viewer_connection->lttng_live;
+	int fd = viewer_connection->control_sock;
+	ssize_t ret;
+
+	while (*copied < len) {
+		ret = recv(fd, buf + *copied, len - *copied, 0);
+		if (ret > 0) {
+			*copied += ret;
+			continue;
+		}
+		if (ret == 0) {
+			BT_LOGI("Remote side has closed connection");
+			return -1;
+		}
+		if (errno == EINTR) {
+			if (lttng_live_is_canceled(lttng_live)) {
+				return -1;
+			}
+			continue;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			if (!blocking) {
+				return 1;
+			}
+			if (wait_control_sock(viewer_connection, POLLIN)) {
+				return -1;
+			}
+			continue;
+		}
+		BT_LOGE("Error receiving get_data response: %s",
+			strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * A GET_PACKET request which is sent to the relay daemon and waiting for
+ * a response. The relay daemon answers the commands of a connection in
+ * order, so its response follows the ones of the requests ahead of it in
+ * the connection's `pending_packet_requests` queue.
+ */
+struct lttng_live_packet_request {
+	/* NULL once the stream is destroyed: the response is discarded. */
+	struct lttng_live_stream_iterator *stream;
+	uint64_t offset;
+	uint32_t len;
+
+	/*
+	 * Response, received as its bytes become available on the
+	 * control socket. Only the oldest request's response can be
+	 * partially received.
+	 */
+	struct lttng_viewer_trace_packet rp;
+	size_t rp_recv_len;
+	bool rp_received;
+
+	/* Status and data length of the response, once `rp` is received. */
+	enum bt_ctf_notif_iter_medium_status status;
+	uint32_t data_len;
+	size_t data_recv_len;
+
+	/*
+	 * Whether the response carries the stream's next bytes, which
+	 * are then received in place in the stream's packet buffer.
+	 * Otherwise they are received in `discard_buf`.
+	 */
+	bool is_next_bytes;
+	uint8_t *data;
+	uint8_t *discard_buf;
+};
+
+/* GET_PACKET command and request, sent at once. */
+struct lttng_live_packet_request_msg {
+	struct lttng_viewer_cmd cmd;
+	struct lttng_viewer_get_packet rq;
+} __attribute__((__packed__));
+
 static ssize_t lttng_live_send(struct bt_live_viewer_connection *viewer_connection,
 		const void *buf, size_t len)
 {
 	struct lttng_live_component *lttng_live =
 			viewer_connection->lttng_live;
 	int fd = viewer_connection->control_sock;
+	size_t copied = 0;
 	ssize_t ret;
 
-	for (;;) {
-		ret = bt_send_nosigpipe(fd, buf, len);
-		if (ret < 0 && errno == EINTR) {
+	while (copied < len) {
+		ret = bt_send_nosigpipe(fd, (const uint8_t *) buf + copied,
+			len - copied);
+		if (ret >= 0) {
+			copied += ret;
+			continue;
+		}
+		if (errno == EINTR) {
 			if (lttng_live_is_canceled(lttng_live)) {
-				break;
-			} else {
-				continue;
+				return -1;
 			}
-		} else {
+			continue;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			if (wait_control_sock(viewer_connection, POLLOUT)) {
+				return -1;
+			}
+			continue;
+		}
+		return -1;
+	}
+	return copied;
+}
+
+/*
+ * Handle the header of a GET_PACKET response, once it is received, and
+ * choose where its data is received.
+ *
+ * Returns 0 on success, -1 if the response is invalid.
+ */
+static
+int handle_packet_response_header(
+		struct bt_live_viewer_connection *viewer_connection,
+		struct lttng_live_packet_request *req)
+{
+	struct lttng_live_component *lttng_live =
+			viewer_connection->lttng_live;
+	struct lttng_live_stream_iterator *req_stream = req->stream;
+	uint32_t flags;
+
+	req->rp_received = true;
+	req->status = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK;
+	req->is_next_bytes = req_stream &&
+		req->offset == req_stream->recv_offset;
+	flags = be32toh(req->rp.flags);
+
+	switch (be32toh(req->rp.status)) {
+	case LTTNG_VIEWER_GET_PACKET_OK:
+		req->data_len = be32toh(req->rp.len);
+		BT_LOGD("get_data_packet: Ok, packet size : %" PRIu32 "",
+			req->data_len);
+		if (req->data_len == 0 || req->data_len > req->len) {
+			BT_LOGE("get_data_packet: unexpected length: "
+				"requested %" PRIu32 ", received %" PRIu32,
+				req->len, req->data_len);
+			return -1;
+		}
+		break;
+	case LTTNG_VIEWER_GET_PACKET_RETRY:
+		/* Unimplemented by relay daemon */
+		BT_LOGD("get_data_packet: retry");
+		req->status = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_AGAIN;
+		break;
+	case LTTNG_VIEWER_GET_PACKET_ERR:
+		if ((flags & LTTNG_VIEWER_FLAG_NEW_METADATA) && req_stream) {
+			BT_LOGD("get_data_packet: new metadata needed, try again later");
+			req_stream->trace->new_metadata_needed = true;
+		}
+		if (flags & LTTNG_VIEWER_FLAG_NEW_STREAM) {
+			BT_LOGD("get_data_packet: new streams needed, try again later");
+			lttng_live_need_new_streams(lttng_live);
+		}
+		if (flags & (LTTNG_VIEWER_FLAG_NEW_METADATA
+				| LTTNG_VIEWER_FLAG_NEW_STREAM)) {
+			req->status = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_AGAIN;
 			break;
 		}
+		BT_LOGE("get_data_packet: error");
+		return -1;
+	case LTTNG_VIEWER_GET_PACKET_EOF:
+		req->status = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_EOF;
+		break;
+	default:
+		BT_LOGE("get_data_packet: unknown");
+		return -1;
 	}
-	return ret;
+
+	if (req->data_len > 0) {
+		if (req->is_next_bytes) {
+			req->data = req_stream->buf +
+				(req->offset - req_stream->base_offset);
+		} else {
+			req->discard_buf = g_new(uint8_t, req->data_len);
+			req->data = req->discard_buf;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Receive the response to the oldest pending GET_PACKET request, or
+ * what is available of it if "blocking" is false.
+ *
+ * The bytes are received in place in the stream's packet buffer. If the
+ * response is shorter than requested, the rest of the request is
+ * requested again: the responses to the requests which follow it for
+ * the same stream are then stale and discarded.
+ *
+ * Once the response is received, "stream" is set to the stream whose
+ * next bytes the response is for, or NULL if the response is discarded,
+ * and "status" to the status of the response for this stream.
+ *
+ * Returns 0 once the response is received, 1 if the rest of it is not
+ * available yet (non-blocking only), -1 if the connection is unusable.
+ */
+static
+int receive_packet_response(struct bt_live_viewer_connection *viewer_connection,
+		bool blocking, struct lttng_live_stream_iterator **stream,
+		enum bt_ctf_notif_iter_medium_status *status)
+{
+	struct lttng_live_packet_request *req;
+	struct lttng_live_stream_iterator *req_stream;
+	int ret;
+
+	req = g_queue_peek_head(viewer_connection->pending_packet_requests);
+	assert(req);
+	if (!req->rp_received) {
+		ret = lttng_live_recv_partial(viewer_connection, &req->rp,
+			sizeof(req->rp), &req->rp_recv_len, blocking);
+		if (ret) {
+			return ret;
+		}
+		if (handle_packet_response_header(viewer_connection, req)) {
+			return -1;
+		}
+	}
+	if (req->data_len > 0) {
+		ret = lttng_live_recv_partial(viewer_connection, req->data,
+			req->data_len, &req->data_recv_len, blocking);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	/* Response is complete. */
+	(void) g_queue_pop_head(viewer_connection->pending_packet_requests);
+	req_stream = req->stream;
+	if (req_stream) {
+		req_stream->trace->session->nr_pending_packet_requests--;
+	}
+	if (req->is_next_bytes) {
+		req_stream->recv_offset += req->data_len;
+		if (req->data_len < req->len) {
+			/* Request the missing bytes again. */
+			req_stream->request_offset = req_stream->recv_offset;
+		}
+	}
+	*stream = req->is_next_bytes ? req_stream : NULL;
+	*status = req->status;
+	g_free(req->discard_buf);
+	g_free(req);
+	return 0;
+}
+
+/*
+ * Receive the responses to all the pending GET_PACKET requests, which
+ * must be done before receiving the response to any other command: the
+ * command itself can be sent while they are still in flight.
+ */
+static
+int receive_pending_packet_responses(
+		struct bt_live_viewer_connection *viewer_connection)
+{
+	while (!g_queue_is_empty(viewer_connection->pending_packet_requests)) {
+		struct lttng_live_stream_iterator *stream;
+		enum bt_ctf_notif_iter_medium_status status;
+
+		if (receive_packet_response(viewer_connection, true, &stream,
+				&status)) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static ssize_t lttng_live_recv(struct bt_live_viewer_connection *viewer_connection,
+		void *buf, size_t len)
+{
+	if (receive_pending_packet_responses(viewer_connection)) {
+		return -1;
+	}
+	return lttng_live_recv_raw(viewer_connection, buf, len);
 }
 
 static int parse_url(struct bt_live_viewer_connection *viewer_connection)
@@ -225,7 +534,7 @@ static int lttng_live_connect_viewer(struct bt_live_viewer_connection *viewer_co
 {
 	struct hostent *host;
 	struct sockaddr_in server_addr;
-	int ret;
+	int ret, flags;
 
 	if (parse_url(viewer_connection)) {
 		goto error;
@@ -253,6 +562,17 @@ static int lttng_live_connect_viewer(struct bt_live_viewer_connection *viewer_co
 		BT_LOGE("Connection failed: %s", strerror(errno));
 		goto error;
 	}
+	/*
+	 * Never block on the socket: the data requests return AGAIN when
+	 * their response is still in transit, and the graph waits for the
+	 * socket to become readable.
+	 */
+	flags = fcntl(viewer_connection->control_sock, F_GETFL, 0);
+	if (flags < 0 || fcntl(viewer_connection->control_sock, F_SETFL,
+			flags | O_NONBLOCK) < 0) {
+		BT_LOGE("Cannot make socket non-blocking: %s", strerror(errno));
+		goto error;
+	}
 	if (lttng_live_handshake(viewer_connection)) {
 		goto error;
 	}
@@ -1214,114 +1534,112 @@ error:
 	return retstatus;
 }
 
+/*
+ * Send GET_PACKET requests for the bytes of the stream's current packet
+ * which are not requested yet, as long as the stream's session has less
+ * than `max_pending_packet_requests` pending requests. The responses are
+ * received when the bytes are needed, or before the next command.
+ */
 BT_HIDDEN
-enum bt_ctf_notif_iter_medium_status lttng_live_get_stream_bytes(struct lttng_live_component *lttng_live,
-		struct lttng_live_stream_iterator *stream, uint8_t *buf, uint64_t offset,
-		uint64_t req_len, uint64_t *recv_len)
+int lttng_live_request_stream_bytes(struct lttng_live_component *lttng_live,
+		struct lttng_live_stream_iterator *stream)
 {
-	enum bt_ctf_notif_iter_medium_status retstatus = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK;
-	struct lttng_viewer_cmd cmd;
-	struct lttng_viewer_get_packet rq;
-	struct lttng_viewer_trace_packet rp;
-	ssize_t ret_len;
-	uint32_t flags, status;
 	struct bt_live_viewer_connection *viewer_connection =
 			lttng_live->viewer_connection;
-	struct lttng_live_trace *trace = stream->trace;
-
-	BT_LOGD("lttng_live_get_stream_bytes: offset=%" PRIu64 ", req_len=%" PRIu64,
-			offset, req_len);
-	cmd.cmd = htobe32(LTTNG_VIEWER_GET_PACKET);
-	cmd.data_size = htobe64((uint64_t) sizeof(rq));
-	cmd.cmd_version = htobe32(0);
-
-	memset(&rq, 0, sizeof(rq));
-	rq.stream_id = htobe64(stream->viewer_stream_id);
-	rq.offset = htobe64(offset);
-	rq.len = htobe32(req_len);
-
-	ret_len = lttng_live_send(viewer_connection, &cmd, sizeof(cmd));
-	if (ret_len < 0) {
-		BT_LOGE("Error sending cmd: %s", strerror(errno));
-		goto error;
-	}
-	assert(ret_len == sizeof(cmd));
+	struct lttng_live_session *session = stream->trace->session;
+	uint64_t end_offset = stream->base_offset + stream->len;
+
+	while (stream->request_offset < end_offset &&
+			session->nr_pending_packet_requests <
+				lttng_live->max_pending_packet_requests) {
+		struct lttng_live_packet_request_msg msg;
+		struct lttng_live_packet_request *req;
+		uint64_t req_len;
+		ssize_t ret_len;
+
+		req_len = MIN(end_offset - stream->request_offset,
+			lttng_live->max_query_size);
+		BT_LOGD("lttng_live_request_stream_bytes: offset=%" PRIu64
+			", req_len=%" PRIu64, stream->request_offset, req_len);
+		msg.cmd.cmd = htobe32(LTTNG_VIEWER_GET_PACKET);
+		msg.cmd.data_size = htobe64((uint64_t) sizeof(msg.rq));
+		msg.cmd.cmd_version = htobe32(0);
+		memset(&msg.rq, 0, sizeof(msg.rq));
+		msg.rq.stream_id = htobe64(stream->viewer_stream_id);
+		msg.rq.offset = htobe64(stream->request_offset);
+		msg.rq.len = htobe32(req_len);
+
+		ret_len = lttng_live_send(viewer_connection, &msg,
+			sizeof(msg));
+		if (ret_len < 0) {
+			BT_LOGE("Error sending get_data request: %s",
+				strerror(errno));
+			return -1;
+		}
+		assert(ret_len == sizeof(msg));
 
-	ret_len = lttng_live_send(viewer_connection, &rq, sizeof(rq));
-	if (ret_len < 0) {
-		BT_LOGE("Error sending get_data request: %s", strerror(errno));
-		goto error;
+		req = g_new0(struct lttng_live_packet_request, 1);
+		req->stream = stream;
+		req->offset = stream->request_offset;
+		req->len = req_len;
+		g_queue_push_tail(viewer_connection->pending_packet_requests,
+			req);
+		session->nr_pending_packet_requests++;
+		stream->request_offset += req_len;
 	}
-	assert(ret_len == sizeof(rq));
+	return 0;
+}
 
-	ret_len = lttng_live_recv(viewer_connection, &rp, sizeof(rp));
-	if (ret_len == 0) {
-		BT_LOGI("Remote side has closed connection");
-		goto error;
-	}
-	if (ret_len < 0) {
-		BT_LOGE("Error receiving get_data response: %s", strerror(errno));
-		goto error;
-	}
-	if (ret_len != sizeof(rp)) {
-		BT_LOGE("get_data_packet: expected %zu"
-				", received %zd", sizeof(rp),
-				ret_len);
-		goto error;
-	}
+/*
+ * Receive the bytes of the stream's current packet at its current
+ * offset, receiving the responses to the requests ahead of them on the
+ * way, then request the bytes which follow them so that they are
+ * transferred while the received ones are decoded.
+ *
+ * This never waits for the relay daemon: if the bytes are still in
+ * transit, BT_CTF_NOTIF_ITER_MEDIUM_STATUS_AGAIN is returned and the
+ * graph waits for the control socket to become readable.
+ */
+BT_HIDDEN
+enum bt_ctf_notif_iter_medium_status lttng_live_get_stream_bytes(
+		struct lttng_live_component *lttng_live,
+		struct lttng_live_stream_iterator *stream)
+{
+	enum bt_ctf_notif_iter_medium_status retstatus =
+			BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK;
+	struct bt_live_viewer_connection *viewer_connection =
+			lttng_live->viewer_connection;
 
-	flags = be32toh(rp.flags);
-	status = be32toh(rp.status);
+	while (stream->recv_offset <= stream->offset) {
+		struct lttng_live_stream_iterator *resp_stream;
+		enum bt_ctf_notif_iter_medium_status resp_status;
+		int ret;
 
-	switch (status) {
-	case LTTNG_VIEWER_GET_PACKET_OK:
-		req_len = be32toh(rp.len);
-		BT_LOGD("get_data_packet: Ok, packet size : %" PRIu64 "", req_len);
-		break;
-	case LTTNG_VIEWER_GET_PACKET_RETRY:
-		/* Unimplemented by relay daemon */
-		BT_LOGD("get_data_packet: retry");
-		retstatus = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_AGAIN;
-		goto end;
-	case LTTNG_VIEWER_GET_PACKET_ERR:
-		if (flags & LTTNG_VIEWER_FLAG_NEW_METADATA) {
-			BT_LOGD("get_data_packet: new metadata needed, try again later");
-			trace->new_metadata_needed = true;
+		if (stream->request_offset == stream->recv_offset &&
+				lttng_live_request_stream_bytes(lttng_live,
+					stream)) {
+			goto error;
 		}
-		if (flags & LTTNG_VIEWER_FLAG_NEW_STREAM) {
-			BT_LOGD("get_data_packet: new streams needed, try again later");
-			lttng_live_need_new_streams(lttng_live);
+		ret = receive_packet_response(viewer_connection, false,
+			&resp_stream, &resp_status);
+		if (ret < 0) {
+			goto error;
 		}
-		if (flags & (LTTNG_VIEWER_FLAG_NEW_METADATA
-				| LTTNG_VIEWER_FLAG_NEW_STREAM)) {
+		if (ret > 0) {
+			BT_LOGV("Stream bytes in transit: offset=%" PRIu64,
+				stream->offset);
 			retstatus = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_AGAIN;
 			goto end;
 		}
-		BT_LOGE("get_data_packet: error");
-		goto error;
-	case LTTNG_VIEWER_GET_PACKET_EOF:
-		retstatus = BT_CTF_NOTIF_ITER_MEDIUM_STATUS_EOF;
-		goto end;
-	default:
-		BT_LOGE("get_data_packet: unknown");
-		goto error;
-	}
-
-	if (req_len == 0) {
-		goto error;
-	}
-
-	ret_len = lttng_live_recv(viewer_connection, buf, req_len);
-	if (ret_len == 0) {
-		BT_LOGI("Remote side has closed connection");
-		goto error;
+		if (resp_stream == stream &&
+				resp_status != BT_CTF_NOTIF_ITER_MEDIUM_STATUS_OK) {
+			retstatus = resp_status;
+			goto end;
+		}
 	}
-	if (ret_len < 0) {
-		BT_LOGE("Error receiving trace packet: %s", strerror(errno));
+	if (lttng_live_request_stream_bytes(lttng_live, stream)) {
 		goto error;
 	}
-	assert(ret_len == req_len);
-	*recv_len = ret_len;
 end:
 	return retstatus;
 
@@ -1334,6 +1652,90 @@ error:
 	return retstatus;
 }
 
+/*
+ * Receive the GET_PACKET responses which are available on the control
+ * socket, without waiting. Once this returns, the socket is only
+ * readable again when more bytes arrive, so that the graph does not
+ * wake up for bytes which nobody asked for yet.
+ */
+BT_HIDDEN
+int lttng_live_receive_available_packet_responses(
+		struct lttng_live_component *lttng_live)
+{
+	struct bt_live_viewer_connection *viewer_connection =
+			lttng_live->viewer_connection;
+
+	while (!g_queue_is_empty(viewer_connection->pending_packet_requests)) {
+		struct lttng_live_stream_iterator *stream;
+		enum bt_ctf_notif_iter_medium_status status;
+		int ret;
+
+		ret = receive_packet_response(viewer_connection, false,
+			&stream, &status);
+		if (ret < 0) {
+			return -1;
+		}
+		if (ret > 0) {
+			break;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Stop receiving the partially received GET_PACKET response of a stream
+ * in place: the stream's packet buffer is about to be freed or reused.
+ * The rest of the response is discarded.
+ */
+BT_HIDDEN
+void lttng_live_detach_stream_packet_buffer(
+		struct lttng_live_component *lttng_live,
+		struct lttng_live_stream_iterator *stream)
+{
+	struct lttng_live_packet_request *req;
+
+	if (!lttng_live->viewer_connection) {
+		return;
+	}
+	/* Only the oldest response can be partially received. */
+	req = g_queue_peek_head(
+		lttng_live->viewer_connection->pending_packet_requests);
+	if (!req || req->stream != stream || !req->is_next_bytes) {
+		return;
+	}
+	req->is_next_bytes = false;
+	if (req->data) {
+		req->discard_buf = g_new(uint8_t, req->data_len);
+		req->data = req->discard_buf;
+	}
+}
+
+/*
+ * Forget the pending GET_PACKET requests of a stream which is about to
+ * be destroyed: their responses are discarded when they are received.
+ */
+BT_HIDDEN
+void lttng_live_forget_stream_packet_requests(
+		struct lttng_live_component *lttng_live,
+		struct lttng_live_stream_iterator *stream)
+{
+	GList *node;
+
+	if (!lttng_live->viewer_connection) {
+		return;
+	}
+	lttng_live_detach_stream_packet_buffer(lttng_live, stream);
+	for (node = lttng_live->viewer_connection->pending_packet_requests->head;
+			node; node = g_list_next(node)) {
+		struct lttng_live_packet_request *req = node->data;
+
+		if (req->stream == stream) {
+			req->stream = NULL;
+			stream->trace->session->nr_pending_packet_requests--;
+		}
+	}
+}
+
 /*
  * Request new streams for a session.
  */
@@ -1442,6 +1844,10 @@ struct bt_live_viewer_connection *
 	if (!viewer_connection->url) {
 		goto error;
 	}
+	viewer_connection->pending_packet_requests = g_queue_new();
+	if (!viewer_connection->pending_packet_requests) {
+		goto error;
+	}
 
 	BT_LOGD("Establishing connection to url \"%s\"...", url);
 	if (lttng_live_connect_viewer(viewer_connection)) {
@@ -1453,6 +1859,9 @@ struct bt_live_viewer_connection *
 error_report:
 	BT_LOGW("Failure to establish connection to url \"%s\"", url);
 error:
+	if (viewer_connection->pending_packet_requests) {
+		g_queue_free(viewer_connection->pending_packet_requests);
+	}
 	g_free(viewer_connection);
 	return NULL;
 }
@@ -1472,5 +1881,15 @@ void bt_live_viewer_connection_destroy(struct bt_live_viewer_connection *viewer_
 	if (viewer_connection->session_name) {
 		g_string_free(viewer_connection->session_name, TRUE);
 	}
+	if (viewer_connection->pending_packet_requests) {
+		struct lttng_live_packet_request *req;
+
+		while ((req = g_queue_pop_head(
+				viewer_connection->pending_packet_requests))) {
+			g_free(req->discard_buf);
+			g_free(req);
+		}
+		g_queue_free(viewer_connection->pending_packet_requests);
+	}
 	g_free(viewer_connection);
 }
@@ -54,6 +54,12 @@ struct bt_live_viewer_connection {
 	int32_t major;
 	int32_t minor;
 
+	/*
+	 * GET_PACKET requests (struct lttng_live_packet_request) which
+	 * are sent and waiting for a response, oldest first.
+	 */
+	GQueue *pending_packet_requests;
+
 	struct lttng_live_component *lttng_live;
 };
 
@@ -52,6 +52,31 @@
  */
 #define ADDR_STR_LEN 20
 
+/* Function symbol of an ELF symbol table. */
+struct bin_info_elf_func_sym {
+	uint64_t addr;
+	/* Index of the section holding the symbol's name. */
+	size_t strtab_index;
+	/* Offset of the symbol's name within this section. */
+	size_t name_offset;
+	/* Position in the symbol tables, to break address ties. */
+	guint order;
+};
+
+/* Address range of a DWARF CU or function (subprogram) DIE. */
+struct bin_info_addr_range {
+	uint64_t low_addr;
+	uint64_t high_addr;
+	/* Highest high address of this range and of the ones before it. */
+	uint64_t max_high_addr;
+	/* Index of the DIE's CU in the `dwarf_cus` array. */
+	guint cu_index;
+	/* Offset of the DIE in the DWARF info. */
+	Dwarf_Off die_offset;
+	/* Position of the DIE in a walk of the CUs and their DIEs. */
+	guint order;
+};
+
 BT_HIDDEN
 int bin_info_init(void)
 {
@@ -119,6 +144,22 @@ void bin_info_destroy(struct bin_info *bin)
 		return;
 	}
 
+	if (bin->elf_func_syms) {
+		g_array_free(bin->elf_func_syms, TRUE);
+	}
+	if (bin->dwarf_cus) {
+		g_array_free(bin->dwarf_cus, TRUE);
+	}
+	if (bin->dwarf_cu_ranges) {
+		g_array_free(bin->dwarf_cu_ranges, TRUE);
+	}
+	if (bin->dwarf_func_ranges) {
+		g_array_free(bin->dwarf_func_ranges, TRUE);
+	}
+
+	symbol_cache_destroy(bin->sym_cache);
+	g_free(bin->cache_dir);
+
 	dwarf_end(bin->dwarf_info);
 
 	free(bin->debug_info_dir);
@@ -159,6 +200,11 @@ int bin_info_set_build_id(struct bin_info *bin, uint8_t *build_id,
 	 */
 	bin->is_elf_only = false;
 
+	/* The symbol cache might also be found with it. */
+	if (!bin->sym_cache) {
+		bin->is_sym_cache_set = false;
+	}
+
 	return 0;
 
 error:
@@ -188,6 +234,11 @@ int bin_info_set_debug_link(struct bin_info *bin, const char *filename,
 	 */
 	bin->is_elf_only = false;
 
+	/* The symbol cache might also be found with it. */
+	if (!bin->sym_cache) {
+		bin->is_sym_cache_set = false;
+	}
+
 	return 0;
 
 error:
@@ -195,6 +246,25 @@ error:
 	return -1;
 }
 
+BT_HIDDEN
+int bin_info_set_cache_dir(struct bin_info *bin, const char *cache_dir)
+{
+	if (!bin || !cache_dir) {
+		goto error;
+	}
+
+	g_free(bin->cache_dir);
+	bin->cache_dir = g_strdup(cache_dir);
+	if (!bin->cache_dir) {
+		goto error;
+	}
+
+	return 0;
+
+error:
+	return -1;
+}
+
 /**
  * Tries to read DWARF info from the location given by path, and
  * attach it to the given bin_info instance if it exists.
@@ -600,103 +670,94 @@ error:
 	return -1;
 }
 
-/**
- * Try to find the symbol closest to an address within a given ELF
- * section.
- *
- * Only function symbols are taken into account. The symbol's address
- * must precede `addr`. A symbol with a closer address might exist
- * after `addr` but is irrelevant because it cannot encompass `addr`.
- *
- * On success, if found, the out parameters `sym` and `shdr` are
- * set. On failure or if none are found, they remain unchanged.
- *
- * @param scn		ELF section in which to look for the address
- * @param addr		Virtual memory address for which to find the
- *			nearest function symbol
- * @param sym		Out parameter, the nearest function symbol
- * @param shdr		Out parameter, the section header for scn
- * @returns		0 on success, -1 on failure
- */
 static
-int bin_info_get_nearest_symbol_from_section(Elf_Scn *scn, uint64_t addr,
-		GElf_Sym **sym, GElf_Shdr **shdr)
+gint compare_elf_func_syms(gconstpointer a, gconstpointer b)
 {
-	int i;
-	size_t symbol_count;
-	Elf_Data *data = NULL;
-	GElf_Shdr *_shdr = NULL;
-	GElf_Sym *nearest_sym = NULL;
-
-	if (!scn || !sym || !shdr) {
-		goto error;
-	}
+	const struct bin_info_elf_func_sym *sym_a = a;
+	const struct bin_info_elf_func_sym *sym_b = b;
 
-	_shdr = g_new0(GElf_Shdr, 1);
-	if (!_shdr) {
-		goto error;
+	if (sym_a->addr != sym_b->addr) {
+		return sym_a->addr < sym_b->addr ? -1 : 1;
 	}
 
-	_shdr = gelf_getshdr(scn, _shdr);
-	if (!_shdr) {
-		goto error;
-	}
+	return sym_a->order < sym_b->order ? -1 :
+		(sym_a->order > sym_b->order ? 1 : 0);
+}
 
-	if (_shdr->sh_type != SHT_SYMTAB) {
-		/*
-		 * We are only interested in symbol table (symtab)
-		 * sections, skip this one.
-		 */
-		goto end;
-	}
+/**
+ * Build the array of the function symbols of all the symbol table
+ * (symtab) sections of an executable, sorted by address.
+ *
+ * @param bin		bin_info instance, with its ELF file set
+ * @returns		0 on success, -1 on failure
+ */
+static
+int bin_info_build_elf_func_syms(struct bin_info *bin)
+{
+	GArray *syms;
+	Elf_Scn *scn = NULL;
+	guint order = 0;
 
-	data = elf_getdata(scn, NULL);
-	if (!data) {
+	syms = g_array_new(FALSE, FALSE,
+			sizeof(struct bin_info_elf_func_sym));
+	if (!syms) {
 		goto error;
 	}
 
-	symbol_count = _shdr->sh_size / _shdr->sh_entsize;
-
-	for (i = 0; i < symbol_count; ++i) {
-		GElf_Sym *cur_sym = NULL;
+	while ((scn = elf_nextscn(bin->elf_file, scn))) {
+		GElf_Shdr shdr;
+		Elf_Data *data;
+		size_t symbol_count, i;
 
-		cur_sym = g_new0(GElf_Sym, 1);
-		if (!cur_sym) {
+		if (!gelf_getshdr(scn, &shdr)) {
 			goto error;
 		}
-		cur_sym = gelf_getsym(data, i, cur_sym);
-		if (!cur_sym) {
-			goto error;
-		}
-		if (GELF_ST_TYPE(cur_sym->st_info) != STT_FUNC) {
-			/* We're only interested in the functions. */
-			g_free(cur_sym);
+
+		if (shdr.sh_type != SHT_SYMTAB || shdr.sh_entsize == 0) {
+			/*
+			 * We are only interested in symbol table (symtab)
+			 * sections, skip this one.
+			 */
 			continue;
 		}
 
-		if (cur_sym->st_value <= addr &&
-				(!nearest_sym ||
-				cur_sym->st_value > nearest_sym->st_value)) {
-			g_free(nearest_sym);
-			nearest_sym = cur_sym;
-		} else {
-			g_free(cur_sym);
+		data = elf_getdata(scn, NULL);
+		if (!data) {
+			goto error;
 		}
-	}
 
-end:
-	if (nearest_sym) {
-		*sym = nearest_sym;
-		*shdr = _shdr;
-	} else {
-		g_free(_shdr);
+		symbol_count = shdr.sh_size / shdr.sh_entsize;
+		for (i = 0; i < symbol_count; i++) {
+			GElf_Sym sym;
+			struct bin_info_elf_func_sym func_sym;
+
+			if (!gelf_getsym(data, i, &sym)) {
+				goto error;
+			}
+
+			if (GELF_ST_TYPE(sym.st_info) != STT_FUNC) {
+				/* We're only interested in the functions. */
+				continue;
+			}
+
+			func_sym.addr = sym.st_value;
+			func_sym.strtab_index = shdr.sh_link;
+			func_sym.name_offset = sym.st_name;
+			func_sym.order = order++;
+			g_array_append_val(syms, func_sym);
+		}
 	}
 
+	g_array_sort(syms, compare_elf_func_syms);
+	BT_LOGD("Built ELF function symbol table: path=\"%s\", count=%u",
+		bin->elf_path, syms->len);
+	bin->elf_func_syms = syms;
 	return 0;
 
 error:
-	g_free(nearest_sym);
-	g_free(_shdr);
+	if (syms) {
+		g_array_free(syms, TRUE);
+	}
 	return -1;
 }
 
@@ -708,6 +769,10 @@ error:
  * followed by the offset in bytes between the address and the symbol
  * (in hex), separated by a '+' character.
  *
+ * Only function symbols are taken into account. The symbol's address
+ * must precede `addr`. A symbol with a closer address might exist
+ * after `addr` but is irrelevant because it cannot encompass `addr`.
+ *
  * If found, the out parameter `func_name` is set on success. On failure,
  * it remains unchanged.
  *
@@ -722,16 +787,10 @@ static
 int bin_info_lookup_elf_function_name(struct bin_info *bin, uint64_t addr,
 		char **func_name)
 {
-	/*
-	 * TODO (possible optimisation): if an ELF has no symtab
-	 * section, it has been stripped. Therefore, it would be wise
-	 * to store a flag indicating the stripped status after the
-	 * first iteration to prevent subsequent ones.
-	 */
 	int ret = 0;
-	Elf_Scn *scn = NULL;
-	GElf_Sym *sym = NULL;
-	GElf_Shdr *shdr = NULL;
+	GArray *syms;
+	guint low = 0, high;
+	struct bin_info_elf_func_sym *sym;
 	char *sym_name = NULL;
 
 	/* Set ELF file if it hasn't been accessed yet. */
@@ -743,126 +802,398 @@ int bin_info_lookup_elf_function_name(struct bin_info *bin, uint64_t addr,
 		}
 	}
 
-	scn = elf_nextscn(bin->elf_file, scn);
-	if (!scn) {
+	if (!bin->elf_func_syms) {
+		ret = bin_info_build_elf_func_syms(bin);
+		if (ret) {
+			goto error;
+		}
+	}
+
+	/* Find the first symbol after `addr`. */
+	syms = bin->elf_func_syms;
+	high = syms->len;
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+
+		if (g_array_index(syms, struct bin_info_elf_func_sym,
+				mid).addr <= addr) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	if (low == 0) {
+		/* No function symbol precedes `addr`. */
+		return 0;
+	}
+
+	/* Nearest symbol; the first one at its address. */
+	sym = &g_array_index(syms, struct bin_info_elf_func_sym, low - 1);
+	while (low > 1 && g_array_index(syms, struct bin_info_elf_func_sym,
+			low - 2).addr == sym->addr) {
+		low--;
+		sym = &g_array_index(syms, struct bin_info_elf_func_sym,
+				low - 1);
+	}
+
+	sym_name = elf_strptr(bin->elf_file, sym->strtab_index,
+			sym->name_offset);
+	if (!sym_name) {
 		goto error;
 	}
 
-	while (scn && !sym) {
-		ret = bin_info_get_nearest_symbol_from_section(
-				scn, addr, &sym, &shdr);
-		if (ret) {
-			goto error;
+	ret = bin_info_append_offset_str(sym_name, sym->addr, addr,
+					func_name);
+	if (ret) {
+		goto error;
+	}
+
+	return 0;
+
+error:
+	return -1;
+}
+
+static
+gint compare_addr_ranges(gconstpointer a, gconstpointer b)
+{
+	const struct bin_info_addr_range *range_a = a;
+	const struct bin_info_addr_range *range_b = b;
+
+	if (range_a->low_addr != range_b->low_addr) {
+		return range_a->low_addr < range_b->low_addr ? -1 : 1;
+	}
+
+	return range_a->order < range_b->order ? -1 :
+		(range_a->order > range_b->order ? 1 : 0);
+}
+
+/**
+ * Sort an array of address ranges by low address and compute their
+ * running maximum high address, which bounds the backward scan of
+ * addr_ranges_find().
+ *
+ * @param ranges	Array of struct bin_info_addr_range
+ */
+static
+void addr_ranges_sort(GArray *ranges)
+{
+	uint64_t max_high_addr = 0;
+	guint i;
+
+	g_array_sort(ranges, compare_addr_ranges);
+	for (i = 0; i < ranges->len; i++) {
+		struct bin_info_addr_range *range = &g_array_index(ranges,
+				struct bin_info_addr_range, i);
+
+		if (range->high_addr > max_high_addr) {
+			max_high_addr = range->high_addr;
 		}
 
-		scn = elf_nextscn(bin->elf_file, scn);
+		range->max_high_addr = max_high_addr;
 	}
+}
 
-	if (sym) {
-		sym_name = elf_strptr(bin->elf_file, shdr->sh_link,
-				sym->st_name);
-		if (!sym_name) {
-			goto error;
+/**
+ * Find the range containing a given address.
+ *
+ * If several ranges contain the address, the one found first by a walk
+ * of the DIEs is returned.
+ *
+ * @param ranges	Sorted array of struct bin_info_addr_range
+ * @param addr		Address for which to find the range
+ * @returns		The range, or NULL if none contains `addr`
+ */
+static
+struct bin_info_addr_range *addr_ranges_find(GArray *ranges, uint64_t addr)
+{
+	struct bin_info_addr_range *found = NULL;
+	guint low = 0, high = ranges->len;
+
+	/* Find the first range starting after `addr`. */
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+
+		if (g_array_index(ranges, struct bin_info_addr_range,
+				mid).low_addr <= addr) {
+			low = mid + 1;
+		} else {
+			high = mid;
 		}
+	}
 
-		ret = bin_info_append_offset_str(sym_name, sym->st_value, addr,
-						func_name);
-		if (ret) {
-			goto error;
+	/*
+	 * Scan the ranges starting at or before `addr` backwards, as
+	 * long as one of them could still contain it.
+	 */
+	while (low > 0) {
+		struct bin_info_addr_range *range = &g_array_index(ranges,
+				struct bin_info_addr_range, low - 1);
+
+		if (range->max_high_addr <= addr) {
+			break;
+		}
+
+		if (addr < range->high_addr &&
+				(!found || range->order < found->order)) {
+			found = range;
 		}
+
+		low--;
 	}
 
-	g_free(shdr);
-	g_free(sym);
-	return 0;
+	return found;
+}
 
-error:
-	g_free(shdr);
-	g_free(sym);
-	return ret;
+/**
+ * Append the address ranges of a DIE to an array of ranges.
+ *
+ * A DIE without address ranges, or whose address ranges cannot be
+ * read, is skipped.
+ *
+ * @param ranges	Array of struct bin_info_addr_range
+ * @param die		DIE of which to append the ranges
+ * @param cu_index	Index of the DIE's CU in the `dwarf_cus` array
+ * @param order		Position of the DIE in a walk of the DIEs
+ */
+static
+void append_die_addr_ranges(GArray *ranges, struct bt_dwarf_die *die,
+		guint cu_index, guint order)
+{
+	Dwarf_Addr base, start, end;
+	ptrdiff_t offset = 0;
+
+	while ((offset = dwarf_ranges(die->dwarf_die, offset, &base,
+			&start, &end)) > 0) {
+		struct bin_info_addr_range range;
+
+		if (start >= end) {
+			continue;
+		}
+
+		range.low_addr = start;
+		range.high_addr = end;
+		range.max_high_addr = 0;
+		range.cu_index = cu_index;
+		range.die_offset = dwarf_dieoffset(die->dwarf_die);
+		range.order = order;
+		g_array_append_val(ranges, range);
+	}
+
+	if (offset < 0) {
+		BT_LOGD("Cannot read DIE address ranges: %s",
+			dwarf_errmsg(-1));
+	}
 }
 
 /**
- * Get the name of the function containing a given address within a
- * given compile unit (CU).
+ * Find the CU containing the DIE at a given offset.
  *
- * If found, the out parameter `func_name` is set on success. On
- * failure, it remains unchanged.
+ * @param cus		Array of struct bt_dwarf_cu, sorted by offset
+ * @param die_offset	Offset of the DIE in the DWARF info
+ * @param cu_index	Out parameter, index of the CU in `cus`
+ * @returns		0 if found, -1 if not
+ */
+static
+int dwarf_cus_find(GArray *cus, Dwarf_Off die_offset, guint *cu_index)
+{
+	guint low = 0, high = cus->len;
+
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+		struct bt_dwarf_cu *cu = &g_array_index(cus,
+				struct bt_dwarf_cu, mid);
+
+		if (die_offset < cu->offset) {
+			high = mid;
+		} else if (die_offset >= cu->next_offset) {
+			low = mid + 1;
+		} else {
+			*cu_index = mid;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Build the tables of the DWARF info's CUs and of the address ranges
+ * of these CUs and of their functions (subprogram DIEs), walking all
+ * the CUs once.
  *
- * @param cu		bt_dwarf_cu instance which may contain the address
- * @param addr		Virtual memory address for which to find the
- *			function name
- * @param func_name	Out parameter, the function name
+ * The CU ranges come from the .debug_aranges section when it is
+ * present, and from the CU DIEs otherwise.
+ *
+ * @param bin		bin_info instance, with its DWARF info set
  * @returns		0 on success, -1 on failure
  */
 static
-int bin_info_lookup_cu_function_name(struct bt_dwarf_cu *cu, uint64_t addr,
-		char **func_name)
+int bin_info_build_dwarf_ranges(struct bin_info *bin)
 {
-	int ret = 0;
-	bool found = false;
+	int ret;
+	struct bt_dwarf_cu *cu = NULL;
 	struct bt_dwarf_die *die = NULL;
-
-	if (!cu || !func_name) {
+	GArray *cus = NULL, *cu_ranges = NULL, *func_ranges = NULL;
+	Dwarf_Aranges *aranges = NULL;
+	size_t arange_count = 0, i;
+	guint order = 0;
+
+	cus = g_array_new(FALSE, FALSE, sizeof(struct bt_dwarf_cu));
+	cu_ranges = g_array_new(FALSE, FALSE,
+			sizeof(struct bin_info_addr_range));
+	func_ranges = g_array_new(FALSE, FALSE,
+			sizeof(struct bin_info_addr_range));
+	if (!cus || !cu_ranges || !func_ranges) {
 		goto error;
 	}
 
-	die = bt_dwarf_die_create(cu);
-	if (!die) {
+	if (dwarf_getaranges(bin->dwarf_info, &aranges, &arange_count)) {
+		arange_count = 0;
+	}
+
+	cu = bt_dwarf_cu_create(bin->dwarf_info);
+	if (!cu) {
 		goto error;
 	}
 
-	while (bt_dwarf_die_next(die) == 0) {
-		int tag;
+	while ((ret = bt_dwarf_cu_next(cu)) == 0) {
+		guint cu_index = cus->len;
 
-		ret = bt_dwarf_die_get_tag(die, &tag);
-		if (ret) {
+		g_array_append_val(cus, *cu);
+		die = bt_dwarf_die_create(cu);
+		if (!die) {
 			goto error;
 		}
 
-		if (tag == DW_TAG_subprogram) {
-			ret = bt_dwarf_die_contains_addr(die, addr, &found);
+		if (arange_count == 0) {
+			append_die_addr_ranges(cu_ranges, die, cu_index,
+					cu_index);
+		}
+
+		while ((ret = bt_dwarf_die_next(die)) == 0) {
+			int tag;
+
+			ret = bt_dwarf_die_get_tag(die, &tag);
 			if (ret) {
 				goto error;
 			}
 
-			if (found) {
-				break;
+			if (tag == DW_TAG_subprogram) {
+				append_die_addr_ranges(func_ranges, die,
+						cu_index, order++);
 			}
 		}
-	}
 
-	if (found) {
-		uint64_t low_addr = 0;
-		char *die_name = NULL;
-
-		ret = bt_dwarf_die_get_name(die, &die_name);
-		if (ret) {
+		if (ret < 0) {
 			goto error;
 		}
 
-		ret = dwarf_lowpc(die->dwarf_die, &low_addr);
-		if (ret) {
-			free(die_name);
+		bt_dwarf_die_destroy(die);
+		die = NULL;
+	}
+
+	if (ret < 0) {
+		goto error;
+	}
+
+	for (i = 0; i < arange_count; i++) {
+		Dwarf_Arange *arange = dwarf_onearange(aranges, i);
+		struct bin_info_addr_range range;
+		Dwarf_Addr start;
+		Dwarf_Word length;
+		Dwarf_Off cu_die_offset;
+		guint cu_index;
+
+		if (!arange || dwarf_getarangeinfo(arange, &start, &length,
+				&cu_die_offset)) {
 			goto error;
 		}
 
-		ret = bin_info_append_offset_str(die_name, low_addr, addr,
-						func_name);
-		free(die_name);
-		if (ret) {
-			goto error;
+		if (length == 0 ||
+				dwarf_cus_find(cus, cu_die_offset, &cu_index)) {
+			continue;
 		}
-	}
 
-	bt_dwarf_die_destroy(die);
+		range.low_addr = start;
+		range.high_addr = start + length;
+		range.max_high_addr = 0;
+		range.cu_index = cu_index;
+		range.die_offset = cu_die_offset;
+		range.order = cu_index;
+		g_array_append_val(cu_ranges, range);
+	}
+
+	addr_ranges_sort(cu_ranges);
+	addr_ranges_sort(func_ranges);
+	BT_LOGD("Built DWARF address range tables: path=\"%s\", "
+		"cu-count=%u, cu-range-count=%u, func-range-count=%u, "
+		"from-aranges=%d", bin->dwarf_path, cus->len, cu_ranges->len,
+		func_ranges->len, arange_count > 0);
+	bin->dwarf_cus = cus;
+	bin->dwarf_cu_ranges = cu_ranges;
+	bin->dwarf_func_ranges = func_ranges;
+	bt_dwarf_cu_destroy(cu);
 	return 0;
 
 error:
 	bt_dwarf_die_destroy(die);
+	bt_dwarf_cu_destroy(cu);
+	if (cus) {
+		g_array_free(cus, TRUE);
+	}
+	if (cu_ranges) {
+		g_array_free(cu_ranges, TRUE);
+	}
+	if (func_ranges) {
+		g_array_free(func_ranges, TRUE);
+	}
 	return -1;
 }
 
+/**
+ * Get the function (subprogram) DIE containing a given address within
+ * an executable's DWARF info.
+ *
+ * On success, the out parameter `die` is set if found, and must be
+ * destroyed with bt_dwarf_die_destroy(). On failure, it remains
+ * unchanged.
+ *
+ * @param bin		bin_info instance, with its DWARF info set
+ * @param addr		Address for which to find the function
+ * @param die		Out parameter, the function's DIE
+ * @returns		0 on success, -1 on failure
+ */
+static
+int bin_info_lookup_dwarf_function_die(struct bin_info *bin, uint64_t addr,
+		struct bt_dwarf_die **die)
+{
+	struct bin_info_addr_range *range;
+	struct bt_dwarf_die *_die;
+
+	if (!bin->dwarf_func_ranges) {
+		if (bin_info_build_dwarf_ranges(bin)) {
+			return -1;
+		}
+	}
+
+	range = addr_ranges_find(bin->dwarf_func_ranges, addr);
+	if (!range) {
+		return 0;
+	}
+
+	_die = bt_dwarf_die_create_at_offset(&g_array_index(bin->dwarf_cus,
+			struct bt_dwarf_cu, range->cu_index),
+			range->die_offset, 1);
+	if (!_die) {
+		return -1;
+	}
+
+	*die = _die;
+	return 0;
+}
+
 /**
  * Get the name of the function containing a given address within an
  * executable using DWARF debug info.
@@ -882,56 +1213,456 @@ int bin_info_lookup_dwarf_function_name(struct bin_info *bin, uint64_t addr,
 		char **func_name)
 {
 	int ret = 0;
-	char *_func_name = NULL;
-	struct bt_dwarf_cu *cu = NULL;
+	uint64_t low_addr = 0;
+	char *die_name = NULL;
+	struct bt_dwarf_die *die = NULL;
 
 	if (!bin || !func_name) {
 		goto error;
 	}
 
-	cu = bt_dwarf_cu_create(bin->dwarf_info);
-	if (!cu) {
+	ret = bin_info_lookup_dwarf_function_die(bin, addr, &die);
+	if (ret || !die) {
 		goto error;
 	}
 
-	while (bt_dwarf_cu_next(cu) == 0) {
-		ret = bin_info_lookup_cu_function_name(cu, addr, &_func_name);
-		if (ret) {
-			goto error;
-		}
+	ret = bt_dwarf_die_get_name(die, &die_name);
+	if (ret) {
+		goto error;
+	}
 
-		if (_func_name) {
-			break;
-		}
+	ret = dwarf_lowpc(die->dwarf_die, &low_addr);
+	if (ret) {
+		goto error;
 	}
 
-	if (_func_name) {
-		*func_name = _func_name;
-	} else {
+	ret = bin_info_append_offset_str(die_name, low_addr, addr,
+					func_name);
+	if (ret) {
 		goto error;
 	}
 
-	bt_dwarf_cu_destroy(cu);
+	free(die_name);
+	bt_dwarf_die_destroy(die);
 	return 0;
 
 error:
-	bt_dwarf_cu_destroy(cu);
+	free(die_name);
+	bt_dwarf_die_destroy(die);
 	return -1;
 }
 
-BT_HIDDEN
-int bin_info_lookup_function_name(struct bin_info *bin,
-		uint64_t addr, char **func_name)
-{
-	int ret = 0;
+/**
+ * Add the source lines of a CU to a symbol cache builder.
+ *
+ * Only the last line at a given address is kept, which is the one
+ * dwarf_getsrc_die() finds for this address.
+ *
+ * @param builder	Symbol cache builder
+ * @param cu_die	DIE of the CU
+ * @param cu_index	Index of the CU in the `dwarf_cus` array
+ * @returns		0 on success, -1 on failure
+ */
+static
+int symbol_cache_add_cu_lines(struct symbol_cache_builder *builder,
+		struct bt_dwarf_die *cu_die, guint cu_index)
+{
+	Dwarf_Lines *lines;
+	size_t line_count, i;
+
+	if (dwarf_getsrclines(cu_die->dwarf_die, &lines, &line_count)) {
+		/* No line info for this CU. */
+		return 0;
+	}
+
+	for (i = 0; i < line_count; i++) {
+		Dwarf_Line *line = dwarf_onesrcline(lines, i);
+		Dwarf_Line *next_line;
+		Dwarf_Addr line_addr, next_line_addr;
+		const char *filename;
+		bool end_sequence;
+		int line_no;
+
+		if (!line || dwarf_lineaddr(line, &line_addr)) {
+			return -1;
+		}
+
+		if (i + 1 < line_count) {
+			next_line = dwarf_onesrcline(lines, i + 1);
+			if (next_line &&
+					!dwarf_lineaddr(next_line, &next_line_addr) &&
+					next_line_addr == line_addr) {
+				continue;
+			}
+		}
+
+		if (dwarf_lineendsequence(line, &end_sequence) ||
+				end_sequence) {
+			continue;
+		}
+
+		filename = dwarf_linesrc(line, NULL, NULL);
+		if (!filename || dwarf_lineno(line, &line_no)) {
+			continue;
+		}
+
+		if (symbol_cache_builder_add_line(builder, line_addr, filename,
+				line_no, cu_index)) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Add the inlined subroutines of a function to a symbol cache builder.
+ *
+ * @param builder	Symbol cache builder
+ * @param die		Subprogram (function) DIE; its position is advanced
+ * @returns		0 on success, -1 on failure
+ */
+static
+int symbol_cache_add_func_inlines(struct symbol_cache_builder *builder,
+		struct bt_dwarf_die *die)
+{
+	if (bt_dwarf_die_child(die)) {
+		/* No children. */
+		return 0;
+	}
+
+	do {
+		Dwarf_Addr base, start, end;
+		ptrdiff_t offset = 0;
+		char *call_file = NULL;
+		uint64_t call_line;
+		int tag;
+
+		if (bt_dwarf_die_get_tag(die, &tag)) {
+			return -1;
+		}
+
+		if (tag != DW_TAG_inlined_subroutine) {
+			continue;
+		}
+
+		if (bt_dwarf_die_get_call_file(die, &call_file)) {
+			continue;
+		}
+
+		if (bt_dwarf_die_get_call_line(die, &call_line)) {
+			free(call_file);
+			continue;
+		}
+
+		while ((offset = dwarf_ranges(die->dwarf_die, offset, &base,
+				&start, &end)) > 0) {
+			if (start < end && symbol_cache_builder_add_inline(
+					builder, start, end, call_file,
+					call_line)) {
+				free(call_file);
+				return -1;
+			}
+		}
+
+		free(call_file);
+	} while (bt_dwarf_die_next(die) == 0);
+
+	return 0;
+}
+
+/**
+ * Add a function, its address ranges and its inlined subroutines to a
+ * symbol cache builder.
+ *
+ * @param builder	Symbol cache builder
+ * @param die		Subprogram (function) DIE
+ * @param cu_index	Index of the DIE's CU in the `dwarf_cus` array
+ * @param order		Position of the DIE in a walk of the DIEs
+ * @returns		0 on success, -1 on failure
+ */
+static
+int symbol_cache_add_func(struct symbol_cache_builder *builder,
+		struct bt_dwarf_die *die, guint cu_index, guint order)
+{
+	int ret = 0;
+	char *name = NULL;
+	Dwarf_Addr entry_addr = 0, base, start, end;
+	ptrdiff_t offset = 0;
+	bool has_range = false;
+	struct bt_dwarf_die *child_die = NULL;
+
+	/*
+	 * Without its name and entry address, the function is still
+	 * added so that lookups within it fail like they would with
+	 * the DWARF info.
+	 */
+	if (bt_dwarf_die_get_name(die, &name) ||
+			dwarf_lowpc(die->dwarf_die, &entry_addr)) {
+		free(name);
+		name = NULL;
+	}
+
+	ret = symbol_cache_builder_add_func(builder, name, entry_addr,
+			cu_index, order);
+	if (ret) {
+		goto end;
+	}
+
+	while ((offset = dwarf_ranges(die->dwarf_die, offset, &base,
+			&start, &end)) > 0) {
+		if (start >= end) {
+			continue;
+		}
+
+		ret = symbol_cache_builder_add_func_range(builder, start, end);
+		if (ret) {
+			goto end;
+		}
+
+		has_range = true;
+	}
+
+	if (!has_range) {
+		goto end;
+	}
+
+	/* Walk the children with a DIE of its own, not to move `die`. */
+	child_die = bt_dwarf_die_create_at_offset(die->cu,
+			dwarf_dieoffset(die->dwarf_die), die->depth);
+	if (!child_die) {
+		ret = -1;
+		goto end;
+	}
+
+	ret = symbol_cache_add_func_inlines(builder, child_die);
+
+end:
+	bt_dwarf_die_destroy(child_die);
+	free(name);
+	return ret;
+}
+
+/**
+ * Build the symbol cache of an executable from its DWARF info.
+ *
+ * @param bin		bin_info instance, with its DWARF info set
+ * @returns		The new symbol cache, or NULL on failure
+ */
+static
+struct symbol_cache *bin_info_build_symbol_cache(struct bin_info *bin)
+{
+	struct symbol_cache_builder *builder = NULL;
+	struct symbol_cache *cache = NULL;
+	struct bt_dwarf_die *die = NULL;
+	guint i, order = 0;
+	int ret;
+
+	if (!bin->dwarf_func_ranges) {
+		if (bin_info_build_dwarf_ranges(bin)) {
+			goto end;
+		}
+	}
+
+	builder = symbol_cache_builder_create();
+	if (!builder) {
+		goto end;
+	}
+
+	for (i = 0; i < bin->dwarf_cu_ranges->len; i++) {
+		struct bin_info_addr_range *range = &g_array_index(
+				bin->dwarf_cu_ranges,
+				struct bin_info_addr_range, i);
+
+		ret = symbol_cache_builder_add_cu_range(builder,
+				range->low_addr, range->high_addr,
+				range->cu_index);
+		if (ret) {
+			goto end;
+		}
+	}
+
+	for (i = 0; i < bin->dwarf_cus->len; i++) {
+		die = bt_dwarf_die_create(&g_array_index(bin->dwarf_cus,
+				struct bt_dwarf_cu, i));
+		if (!die) {
+			goto end;
+		}
+
+		ret = symbol_cache_add_cu_lines(builder, die, i);
+		if (ret) {
+			goto end;
+		}
+
+		/* Same walk and order as bin_info_build_dwarf_ranges(). */
+		while ((ret = bt_dwarf_die_next(die)) == 0) {
+			int tag;
+
+			ret = bt_dwarf_die_get_tag(die, &tag);
+			if (ret) {
+				goto end;
+			}
+
+			if (tag != DW_TAG_subprogram) {
+				continue;
+			}
+
+			ret = symbol_cache_add_func(builder, die, i, order++);
+			if (ret) {
+				goto end;
+			}
+		}
+
+		if (ret < 0) {
+			goto end;
+		}
+
+		bt_dwarf_die_destroy(die);
+		die = NULL;
+	}
+
+	cache = symbol_cache_builder_build(builder);
+
+end:
+	bt_dwarf_die_destroy(die);
+	symbol_cache_builder_destroy(builder);
+	return cache;
+}
+
+/**
+ * Get the path of the symbol cache file of an executable, named after
+ * its build ID or, failing that, after its debug link.
+ *
+ * @param bin		bin_info instance
+ * @returns		The path, to free with g_free(), or NULL if the
+ *			executable has neither
+ */
+static
+char *bin_info_get_symbol_cache_path(struct bin_info *bin)
+{
+	GString *path;
+	size_t i;
+
+	if (bin->build_id) {
+		path = g_string_new(bin->cache_dir);
+		g_string_append_c(path, '/');
+		for (i = 0; i < bin->build_id_len; i++) {
+			g_string_append_printf(path, "%02x",
+				(unsigned int) bin->build_id[i]);
+		}
+		g_string_append(path, ".symcache");
+		return g_string_free(path, FALSE);
+	}
+
+	if (bin->dbg_link_filename) {
+		return g_strdup_printf("%s/%s-%08" PRIx32 ".symcache",
+			bin->cache_dir, bin->dbg_link_filename,
+			bin->dbg_link_crc);
+	}
+
+	return NULL;
+}
+
+/**
+ * Set the symbol cache of an executable, if it has a symbol cache
+ * directory: load its symbol cache file, or build the symbol cache
+ * from the DWARF info and save it to this file.
+ *
+ * Executables without DWARF info are not cached.
+ *
+ * @param bin		bin_info instance
+ */
+static
+void bin_info_set_symbol_cache(struct bin_info *bin)
+{
+	char *path;
+	struct symbol_cache *cache;
+
+	if (!bin->cache_dir || bin->is_sym_cache_set) {
+		return;
+	}
+
+	path = bin_info_get_symbol_cache_path(bin);
+	if (!path) {
+		/* Nothing identifies the executable's contents (yet). */
+		return;
+	}
+
+	bin->is_sym_cache_set = true;
+	cache = symbol_cache_load(path);
+	if (cache) {
+		goto end;
+	}
+
+	if (!bin->dwarf_info && !bin->is_elf_only) {
+		if (bin_info_set_dwarf_info(bin)) {
+			bin->is_elf_only = true;
+		}
+	}
+
+	if (bin->is_elf_only) {
+		goto end;
+	}
+
+	cache = bin_info_build_symbol_cache(bin);
+	if (!cache) {
+		BT_LOGD("Failed to build symbol cache: path=\"%s\"",
+			bin->elf_path);
+		goto end;
+	}
+
+	if (symbol_cache_save(cache, path)) {
+		BT_LOGW("Failed to save symbol cache: path=\"%s\"", path);
+	}
+
+end:
+	bin->sym_cache = cache;
+	g_free(path);
+}
+
+/**
+ * Get the name of the function containing a given address within an
+ * executable using its symbol cache.
+ *
+ * If found, the out parameter `func_name` is set on success. On
+ * failure, it remains unchanged.
+ *
+ * @param bin		bin_info instance, with its symbol cache set
+ * @param addr		Virtual memory address for which to find the
+ *			function name
+ * @param func_name	Out parameter, the function name
+ * @returns		0 on success, -1 on failure
+ */
+static
+int bin_info_lookup_cached_function_name(struct bin_info *bin,
+		uint64_t addr, char **func_name)
+{
+	const char *name;
+	uint64_t entry_addr;
+
+	if (symbol_cache_lookup_function(bin->sym_cache, addr, &name,
+			&entry_addr)) {
+		return -1;
+	}
+
+	return bin_info_append_offset_str(name, entry_addr, addr, func_name);
+}
+
+BT_HIDDEN
+int bin_info_lookup_function_name(struct bin_info *bin,
+		uint64_t addr, char **func_name)
+{
+	int ret = 0;
 	char *_func_name = NULL;
 
 	if (!bin || !func_name) {
 		goto error;
 	}
 
+	bin_info_set_symbol_cache(bin);
+
 	/* Set DWARF info if it hasn't been accessed yet. */
-	if (!bin->dwarf_info && !bin->is_elf_only) {
+	if (!bin->sym_cache && !bin->dwarf_info && !bin->is_elf_only) {
 		ret = bin_info_set_dwarf_info(bin);
 		if (ret) {
 			BT_LOGD_STR("Failed to set bin dwarf info, falling back to ELF lookup.");
@@ -952,7 +1683,11 @@ int bin_info_lookup_function_name(struct bin_info *bin,
 		addr -= bin->low_addr;
 	}
 
-	if (bin->is_elf_only) {
+	if (bin->sym_cache) {
+		ret = bin_info_lookup_cached_function_name(bin, addr,
+				&_func_name);
+		BT_LOGD("Failed to lookup function name (cache): ret=%d", ret);
+	} else if (bin->is_elf_only) {
 		ret = bin_info_lookup_elf_function_name(bin, addr, &_func_name);
 		BT_LOGD("Failed to lookup function name (ELF): ret=%d", ret);
 	} else {
@@ -1064,97 +1799,65 @@ error:
 }
 
 /**
- * Lookup the source location for a given address within a CU, making
- * the assumption that it is contained within an inline routine in a
- * function.
+ * Lookup the source location for a given address within a function,
+ * making the assumption that it is contained within an inline routine
+ * in this function.
  *
- * @param cu		bt_dwarf_cu instance in which to look for the address
+ * On success, the out parameter `src_loc` is set if found. On
+ * failure, it remains unchanged.
+ *
+ * @param die		Subprogram (function) DIE containing the address;
+ *			its position is advanced
  * @param addr		The address for which to look for
  * @param src_loc	Out parameter, the source location (filename and
  *			line number) for the address
  * @returns		0 on success, -1 on failure
  */
 static
-int bin_info_lookup_cu_src_loc_inl(struct bt_dwarf_cu *cu, uint64_t addr,
+int bin_info_lookup_die_src_loc_inl(struct bt_dwarf_die *die, uint64_t addr,
 		struct source_location **src_loc)
 {
 	int ret = 0;
 	bool found = false;
-	struct bt_dwarf_die *die = NULL;
+	char *filename = NULL;
+	uint64_t line_no;
 	struct source_location *_src_loc = NULL;
 
-	if (!cu || !src_loc) {
+	if (!die || !src_loc) {
 		goto error;
 	}
 
-	die = bt_dwarf_die_create(cu);
-	if (!die) {
-		goto error;
+	/*
+	 * Try to find an inlined subroutine child of this DIE
+	 * containing addr. A function without children has none.
+	 */
+	ret = bin_info_child_die_has_address(die, addr, &found);
+	if (ret || !found) {
+		return 0;
 	}
 
-	while (bt_dwarf_die_next(die) == 0) {
-		int tag;
-
-		ret = bt_dwarf_die_get_tag(die, &tag);
-		if (ret) {
-			goto error;
-		}
-
-		if (tag == DW_TAG_subprogram) {
-			bool contains = false;
-
-			ret = bt_dwarf_die_contains_addr(die, addr, &contains);
-			if (ret) {
-				goto error;
-			}
-
-			if (contains) {
-				/*
-				 * Try to find an inlined subroutine
-				 * child of this DIE containing addr.
-				 */
-				ret = bin_info_child_die_has_address(die, addr,
-						&found);
-				if(ret) {
-					goto error;
-				}
-
-				goto end;
-			}
-		}
+	_src_loc = g_new0(struct source_location, 1);
+	if (!_src_loc) {
+		goto error;
 	}
 
-end:
-	if (found) {
-		char *filename = NULL;
-		uint64_t line_no;
-
-		_src_loc = g_new0(struct source_location, 1);
-		if (!_src_loc) {
-			goto error;
-		}
-
-		ret = bt_dwarf_die_get_call_file(die, &filename);
-		if (ret) {
-			goto error;
-		}
-		ret = bt_dwarf_die_get_call_line(die, &line_no);
-		if (ret) {
-			free(filename);
-			goto error;
-		}
-
-		_src_loc->filename = filename;
-		_src_loc->line_no = line_no;
-		*src_loc = _src_loc;
+	ret = bt_dwarf_die_get_call_file(die, &filename);
+	if (ret) {
+		goto error;
+	}
+	ret = bt_dwarf_die_get_call_line(die, &line_no);
+	if (ret) {
+		free(filename);
+		goto error;
 	}
 
-	bt_dwarf_die_destroy(die);
+	_src_loc->filename = filename;
+	_src_loc->line_no = line_no;
+	*src_loc = _src_loc;
 	return 0;
 
 error:
 	source_location_destroy(_src_loc);
-	bt_dwarf_die_destroy(die);
 	return -1;
 }
 
@@ -1237,81 +1940,30 @@ error:
 	return -1;
 }
 
-/**
- * Get the source location (file name and line number) for a given
- * address within a compile unit (CU).
- *
- * On success, the out parameter `src_loc` is set if found. On
- * failure, it remains unchanged.
- *
- * @param cu		bt_dwarf_cu instance for the compile unit which
- *			may contain the address
- * @param addr		Virtual memory address for which to find the
- *			source location
- * @param src_loc	Out parameter, the source location
- * @returns		0 on success, -1 on failure
- */
-static
-int bin_info_lookup_cu_src_loc(struct bt_dwarf_cu *cu, uint64_t addr,
-		struct source_location **src_loc)
-{
-	int ret = 0;
-	struct source_location *_src_loc = NULL;
-
-	if (!cu || !src_loc) {
-		goto error;
-	}
-
-	ret = bin_info_lookup_cu_src_loc_inl(cu, addr, &_src_loc);
-	if (ret) {
-		goto error;
-	}
-
-	if (_src_loc) {
-		goto end;
-	}
-
-	ret = bin_info_lookup_cu_src_loc_no_inl(cu, addr, &_src_loc);
-	if (ret) {
-		goto error;
-	}
-
-	if (_src_loc) {
-		goto end;
-	}
-
-end:
-	if (_src_loc) {
-		*src_loc = _src_loc;
-	}
-
-	return 0;
-
-error:
-	source_location_destroy(_src_loc);
-	return -1;
-}
-
 BT_HIDDEN
 int bin_info_lookup_source_location(struct bin_info *bin, uint64_t addr,
 		struct source_location **src_loc)
 {
+	int ret;
 	struct bt_dwarf_cu *cu = NULL;
+	struct bt_dwarf_die *die = NULL;
 	struct source_location *_src_loc = NULL;
 
 	if (!bin || !src_loc) {
 		goto error;
 	}
 
+	bin_info_set_symbol_cache(bin);
+
 	/* Set DWARF info if it hasn't been accessed yet. */
-	if (!bin->dwarf_info && !bin->is_elf_only) {
+	if (!bin->sym_cache && !bin->dwarf_info && !bin->is_elf_only) {
 		if (bin_info_set_dwarf_info(bin)) {
 			/* Failed to set DWARF info. */
 			bin->is_elf_only = true;
 		}
 	}
 
-	if (bin->is_elf_only) {
+	if (!bin->sym_cache && bin->is_elf_only) {
 		/* We cannot lookup source location without DWARF info. */
 		goto error;
 	}
@@ -1328,25 +1980,64 @@ int bin_info_lookup_source_location(struct bin_info *bin, uint64_t addr,
 		addr -= bin->low_addr;
 	}
 
-	cu = bt_dwarf_cu_create(bin->dwarf_info);
-	if (!cu) {
-		goto error;
+	if (bin->sym_cache) {
+		const char *filename;
+		uint64_t line_no;
+
+		ret = symbol_cache_lookup_source_location(bin->sym_cache,
+				addr, &filename, &line_no);
+		if (ret < 0) {
+			goto error;
+		}
+
+		if (ret == 0) {
+			_src_loc = g_new0(struct source_location, 1);
+			if (!_src_loc) {
+				goto error;
+			}
+
+			_src_loc->filename = strdup(filename);
+			if (!_src_loc->filename) {
+				goto error;
+			}
+
+			_src_loc->line_no = line_no;
+			*src_loc = _src_loc;
+		}
+
+		return 0;
 	}
 
-	while (bt_dwarf_cu_next(cu) == 0) {
-		int ret;
+	ret = bin_info_lookup_dwarf_function_die(bin, addr, &die);
+	if (ret) {
+		goto error;
+	}
 
-		ret = bin_info_lookup_cu_src_loc(cu, addr, &_src_loc);
+	if (die) {
+		/* The address' function tells its CU. */
+		cu = die->cu;
+		ret = bin_info_lookup_die_src_loc_inl(die, addr, &_src_loc);
 		if (ret) {
 			goto error;
 		}
+	} else {
+		struct bin_info_addr_range *range;
 
-		if (_src_loc) {
-			break;
+		range = addr_ranges_find(bin->dwarf_cu_ranges, addr);
+		if (range) {
+			cu = &g_array_index(bin->dwarf_cus, struct bt_dwarf_cu,
+					range->cu_index);
 		}
 	}
 
-	bt_dwarf_cu_destroy(cu);
+	if (!_src_loc && cu) {
+		ret = bin_info_lookup_cu_src_loc_no_inl(cu, addr, &_src_loc);
+		if (ret) {
+			goto error;
+		}
+	}
+
+	bt_dwarf_die_destroy(die);
 	if (_src_loc) {
 		*src_loc = _src_loc;
 	}
@@ -1355,6 +2046,6 @@ int bin_info_lookup_source_location(struct bin_info *bin, uint64_t addr,
 
 error:
 	source_location_destroy(_src_loc);
-	bt_dwarf_cu_destroy(cu);
+	bt_dwarf_die_destroy(die);
 	return -1;
 }
@@ -31,7 +31,9 @@
 #include <stdbool.h>
 #include <gelf.h>
 #include <elfutils/libdw.h>
+#include <glib.h>
 #include <babeltrace/babeltrace-internal.h>
+#include "symbol-cache.h"
 
 #define DEFAULT_DEBUG_DIR "/usr/lib/debug"
 #define DEBUG_SUBDIR ".debug/"
@@ -62,6 +64,18 @@ struct bin_info {
 	int dwarf_fd;
 	/* Configuration. */
 	char *debug_info_dir;
+	/*
+	 * Lookup tables, built on first use (see bin-info.c): function
+	 * symbols sorted by address, the DWARF info's CUs, and the
+	 * address ranges of these CUs and of their functions.
+	 */
+	GArray *elf_func_syms;
+	GArray *dwarf_cus;
+	GArray *dwarf_cu_ranges;
+	GArray *dwarf_func_ranges;
+	/* Optional symbol cache directory, and symbol cache. */
+	char *cache_dir;
+	struct symbol_cache *sym_cache;
 	/* Denotes whether the executable is position independent code. */
 	bool is_pic:1;
 	/*
@@ -69,6 +83,8 @@ struct bin_info {
 	 * DWARF info.
 	 */
 	bool is_elf_only:1;
+	/* Denotes whether the symbol cache was looked up already. */
+	bool is_sym_cache_set:1;
 };
 
 struct source_location {
@@ -139,6 +155,23 @@ BT_HIDDEN
 int bin_info_set_debug_link(struct bin_info *bin, const char *filename,
 		uint32_t crc);
 
+/**
+ * Sets the directory of the symbol cache files for a given bin_info
+ * instance.
+ *
+ * Once the executable's build ID or debug link is known, its function
+ * names and source locations are looked up in its symbol cache file
+ * within this directory, which is first built from the DWARF info if
+ * it doesn't exist, instead of the ELF and DWARF files.
+ *
+ * @param bin		bin_info instance for which to set the
+ *			symbol cache directory
+ * @param cache_dir	Path of the symbol cache directory
+ * @returns		0 on success, -1 on failure
+ */
+BT_HIDDEN
+int bin_info_set_cache_dir(struct bin_info *bin, const char *cache_dir);
+
 /**
  * Returns whether or not the given bin info \p bin contains the
  * address \p addr.
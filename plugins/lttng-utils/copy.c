@@ -1714,21 +1714,30 @@ end:
 	return ret;
 }
 
+/*
+ * Set the debug info field of the writer event's stream event context.
+ * The other fields of this context are the ones of the original event,
+ * grafted by bt_ctf_event_create_extended(): they are not copied.
+ */
 static
-int copy_set_debug_info_stream_event_context(FILE *err,
-		struct bt_ctf_field *event_context,
+int set_debug_info_stream_event_context(FILE *err,
 		struct bt_ctf_event *event,
 		struct bt_ctf_event *writer_event,
 		struct debug_info *debug_info,
 		struct debug_info_component *component)
 {
-	struct bt_ctf_field_type *writer_event_context_type = NULL,
-				 *event_context_type = NULL;
+	struct bt_ctf_field *event_context = NULL;
 	struct bt_ctf_field *writer_event_context = NULL;
-	struct bt_ctf_field *field = NULL, *copy_field = NULL, *debug_field = NULL;
-	struct bt_ctf_field_type *field_type = NULL;
+	struct bt_ctf_field *debug_field = NULL;
 	struct debug_info_source *dbg_info_src;
-	int ret, nr_fields, i;
+	int ret;
+
+	/* Optional field, so it can fail silently. */
+	event_context = bt_ctf_event_get_stream_event_context(event);
+	if (!event_context) {
+		ret = 0;
+		goto end;
+	}
 
 	writer_event_context = bt_ctf_event_get_stream_event_context(writer_event);
 	if (!writer_event_context) {
@@ -1736,89 +1745,30 @@ int copy_set_debug_info_stream_event_context(FILE *err,
 		goto error;
 	}
 
-	writer_event_context_type = bt_ctf_field_get_type(writer_event_context);
-	if (!writer_event_context_type) {
-		fprintf(err, "[error] %s in %s:%d\n", __func__,
-				__FILE__, __LINE__);
-		goto error;
+	/*
+	 * If the context is shared as is, we did not modify it to add
+	 * the debug info fields, or they were set by an earlier pass of
+	 * the debug_info plugin.
+	 */
+	if (writer_event_context == event_context) {
+		ret = 0;
+		goto end;
 	}
 
-	event_context_type = bt_ctf_field_get_type(event_context);
-	if (!event_context_type) {
+	debug_field = bt_ctf_field_structure_get_field(writer_event_context,
+			component->arg_debug_info_field_name);
+	if (!debug_field) {
 		fprintf(err, "[error] %s in %s:%d\n", __func__,
 				__FILE__, __LINE__);
 		goto error;
 	}
 
-	/*
-	 * If it is not a structure, we did not modify it to add the debug info
-	 * fields, so just assign it as is.
-	 */
-	if (bt_ctf_field_type_get_type_id(writer_event_context_type) != BT_CTF_FIELD_TYPE_ID_STRUCT) {
-		ret = bt_ctf_event_set_event_context(writer_event, event_context);
-		goto end;
-	}
-
 	dbg_info_src = lookup_debug_info(err, event, debug_info);
-
-	nr_fields = bt_ctf_field_type_structure_get_field_count(writer_event_context_type);
-	for (i = 0; i < nr_fields; i++) {
-		const char *field_name;
-
-		if (bt_ctf_field_type_structure_get_field(writer_event_context_type,
-					&field_name, &field_type, i) < 0) {
-			fprintf(err, "[error] %s in %s:%d\n", __func__,
-					__FILE__, __LINE__);
-			goto error;
-		}
-
-		/*
-		 * Prevent illegal access in the event_context.
-		 */
-		if (i < bt_ctf_field_type_structure_get_field_count(event_context_type)) {
-			field = bt_ctf_field_structure_get_field_by_index(event_context, i);
-		}
-		/*
-		 * The debug_info field, only exists in the writer event or
-		 * if it was set by a earlier pass of the debug_info plugin.
-		 */
-		if (!strcmp(field_name, component->arg_debug_info_field_name) &&
-				!field) {
-			debug_field = bt_ctf_field_structure_get_field_by_index(
-					writer_event_context, i);
-			if (!debug_field) {
-				fprintf(err, "[error] %s in %s:%d\n", __func__,
-						__FILE__, __LINE__);
-				goto error;
-			}
-			ret = set_debug_info_field(err, debug_field,
-					dbg_info_src, component);
-			if (ret) {
-				fprintf(err, "[error] %s in %s:%d\n", __func__,
-						__FILE__, __LINE__);
-				goto error;
-			}
-			BT_PUT(debug_field);
-		} else {
-			copy_field = bt_ctf_field_copy(field);
-			if (!copy_field) {
-				fprintf(err, "[error] %s in %s:%d\n", __func__,
-						__FILE__, __LINE__);
-				goto error;
-			}
-
-			ret = bt_ctf_field_structure_set_field_by_name(
-					writer_event_context,
-					field_name, copy_field);
-			if (ret) {
-				fprintf(err, "[error] %s in %s:%d\n", __func__,
-						__FILE__, __LINE__);
-				goto error;
-			}
-			BT_PUT(copy_field);
-		}
-		BT_PUT(field_type);
-		BT_PUT(field);
+	ret = set_debug_info_field(err, debug_field, dbg_info_src, component);
+	if (ret) {
+		fprintf(err, "[error] %s in %s:%d\n", __func__,
+				__FILE__, __LINE__);
+		goto error;
 	}
 
 	ret = 0;
@@ -1827,13 +1777,9 @@ int copy_set_debug_info_stream_event_context(FILE *err,
 error:
 	ret = -1;
 end:
-	bt_put(event_context_type);
-	bt_put(writer_event_context_type);
+	bt_put(event_context);
 	bt_put(writer_event_context);
-	bt_put(field);
-	bt_put(copy_field);
 	bt_put(debug_field);
-	bt_put(field_type);
 	return ret;
 }
 
@@ -1947,10 +1893,14 @@ struct bt_ctf_event *debug_info_copy_event(FILE *err, struct bt_ctf_event *event
 		struct debug_info_component *component)
 {
 	struct bt_ctf_event *writer_event = NULL;
-	struct bt_ctf_field *field = NULL, *copy_field = NULL;
 	int ret;
 
-	writer_event = bt_ctf_event_create(writer_event_class);
+	/*
+	 * The writer event shares the header, contexts and payload of
+	 * the original event: only the debug info fields, appended to
+	 * its stream event context, are its own.
+	 */
+	writer_event = bt_ctf_event_create_extended(writer_event_class, event);
 	if (!writer_event) {
 		fprintf(err, "[error] %s in %s:%d\n", __func__, __FILE__,
 				__LINE__);
@@ -1964,77 +1914,19 @@ struct bt_ctf_event *debug_info_copy_event(FILE *err, struct bt_ctf_event *event
 		goto error;
 	}
 
-	/* Optional field, so it can fail silently. */
-	field = bt_ctf_event_get_header(event);
-	if (field) {
-		ret = ctf_copy_event_header(err, event, writer_event_class,
-				writer_event, field);
-		if (ret) {
-			fprintf(err, "[error] %s in %s:%d\n", __func__,
-					__FILE__, __LINE__);
-			goto error;
-		}
-		BT_PUT(field);
-	}
-
-	/* Optional field, so it can fail silently. */
-	field = bt_ctf_event_get_stream_event_context(event);
-	if (field) {
-		ret = copy_set_debug_info_stream_event_context(err,
-				field, event, writer_event, debug_info,
-				component);
-		if (ret < 0) {
-			fprintf(err, "[error] %s in %s:%d\n", __func__,
-					__FILE__, __LINE__);
-			goto error;
-		}
-		BT_PUT(field);
-	}
-
-	/* Optional field, so it can fail silently. */
-	field = bt_ctf_event_get_event_context(event);
-	if (field) {
-		copy_field = bt_ctf_field_copy(field);
-		if (!copy_field) {
-			fprintf(err, "[error] %s in %s:%d\n", __func__,
-					__FILE__, __LINE__);
-			goto error;
-		}
-		ret = bt_ctf_event_set_event_context(writer_event, copy_field);
-		if (ret < 0) {
-			fprintf(err, "[error] %s in %s:%d\n", __func__,
-					__FILE__, __LINE__);
-			goto error;
-		}
-		BT_PUT(copy_field);
-		BT_PUT(field);
-	}
-
-	field = bt_ctf_event_get_event_payload(event);
-	if (!field) {
+	ret = set_debug_info_stream_event_context(err, event, writer_event,
+			debug_info, component);
+	if (ret < 0) {
 		fprintf(err, "[error] %s in %s:%d\n", __func__,
 				__FILE__, __LINE__);
 		goto error;
 	}
-	copy_field = bt_ctf_field_copy(field);
-	if (copy_field) {
-		ret = bt_ctf_event_set_event_payload(writer_event, copy_field);
-		if (ret < 0) {
-			fprintf(err, "[error] %s in %s:%d\n", __func__,
-					__FILE__, __LINE__);
-			goto error;
-		}
-		BT_PUT(copy_field);
-	}
-	BT_PUT(field);
 
 	goto end;
 
 error:
 	BT_PUT(writer_event);
 end:
-	bt_put(copy_field);
-	bt_put(field);
 	return writer_event;
 }
 
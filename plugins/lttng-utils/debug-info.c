@@ -35,6 +35,24 @@
 #include "utils.h"
 #include "copy.h"
 
+/* Maximum number of cached debug info sources per process. */
+#define DEBUG_INFO_SRC_CACHE_SIZE	4096
+
+/* Address range of a bin info, in a process's sorted range array. */
+struct bin_info_range {
+	uint64_t low_addr;
+	uint64_t high_addr;
+	struct bin_info *bin;	/* weak */
+};
+
+/* Cached debug info source of an IP. */
+struct debug_info_src_cache_entry {
+	uint64_t ip;
+	struct debug_info_source *debug_info_src;	/* owned */
+	/* Node in the LRU queue; data is this entry. */
+	GList lru_node;
+};
+
 struct proc_debug_info_sources {
 	/*
 	 * Hash table: base address (pointer to uint64_t) to bin info; owned by
@@ -43,10 +61,26 @@ struct proc_debug_info_sources {
 	GHashTable *baddr_to_bin_info;
 
 	/*
-	 * Hash table: IP (pointer to uint64_t) to (struct debug_info_source *);
-	 * owned by proc_debug_info_sources.
+	 * Array of struct bin_info_range, one per entry of
+	 * baddr_to_bin_info, sorted by low address. The mapped ranges of
+	 * a process do not overlap, so an IP's bin info is found with a
+	 * binary search.
+	 */
+	GArray *bin_ranges;
+
+	/*
+	 * Hash table: IP (pointer to uint64_t within the entry) to
+	 * (struct debug_info_src_cache_entry *); owned by
+	 * proc_debug_info_sources.
 	 */
 	GHashTable *ip_to_debug_info_src;
+
+	/*
+	 * Entries of ip_to_debug_info_src, most recently used first. The
+	 * least recently used entry is evicted when the cache holds
+	 * DEBUG_INFO_SRC_CACHE_SIZE entries.
+	 */
+	GQueue ip_lru;
 };
 
 struct debug_info {
@@ -164,6 +198,14 @@ error:
 	return NULL;
 }
 
+static
+void debug_info_src_cache_entry_destroy(
+		struct debug_info_src_cache_entry *entry)
+{
+	debug_info_source_destroy(entry->debug_info_src);
+	g_free(entry);
+}
+
 static
 void proc_debug_info_sources_destroy(
 		struct proc_debug_info_sources *proc_dbg_info_src)
@@ -172,14 +214,18 @@ void proc_debug_info_sources_destroy(
 		return;
 	}
 
-	if (proc_dbg_info_src->baddr_to_bin_info) {
-		g_hash_table_destroy(proc_dbg_info_src->baddr_to_bin_info);
-	}
-
 	if (proc_dbg_info_src->ip_to_debug_info_src) {
 		g_hash_table_destroy(proc_dbg_info_src->ip_to_debug_info_src);
 	}
 
+	if (proc_dbg_info_src->bin_ranges) {
+		g_array_free(proc_dbg_info_src->bin_ranges, TRUE);
+	}
+
+	if (proc_dbg_info_src->baddr_to_bin_info) {
+		g_hash_table_destroy(proc_dbg_info_src->baddr_to_bin_info);
+	}
+
 	g_free(proc_dbg_info_src);
 }
 
@@ -200,13 +246,21 @@ struct proc_debug_info_sources *proc_debug_info_sources_create(void)
 		goto error;
 	}
 
+	proc_dbg_info_src->bin_ranges = g_array_new(FALSE, FALSE,
+			sizeof(struct bin_info_range));
+	if (!proc_dbg_info_src->bin_ranges) {
+		goto error;
+	}
+
 	proc_dbg_info_src->ip_to_debug_info_src = g_hash_table_new_full(
-			g_int64_hash, g_int64_equal, (GDestroyNotify) g_free,
-			(GDestroyNotify) debug_info_source_destroy);
+			g_int64_hash, g_int64_equal, NULL,
+			(GDestroyNotify) debug_info_src_cache_entry_destroy);
 	if (!proc_dbg_info_src->ip_to_debug_info_src) {
 		goto error;
 	}
 
+	g_queue_init(&proc_dbg_info_src->ip_lru);
+
 end:
 	return proc_dbg_info_src;
 
@@ -248,60 +302,177 @@ end:
 	return proc_dbg_info_src;
 }
 
+/*
+ * Returns the index of the first range of "bin_ranges" which starts
+ * after "addr", that is the insertion position of a range starting at
+ * "addr".
+ */
 static
-struct debug_info_source *proc_debug_info_sources_get_entry(
+guint bin_ranges_upper_bound(GArray *bin_ranges, uint64_t addr)
+{
+	guint low = 0, high = bin_ranges->len;
+
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+
+		if (g_array_index(bin_ranges, struct bin_info_range,
+				mid).low_addr <= addr) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+static
+struct bin_info *proc_debug_info_sources_find_bin(
 		struct proc_debug_info_sources *proc_dbg_info_src, uint64_t ip)
 {
-	struct debug_info_source *debug_info_src = NULL;
-	gpointer key = g_new0(uint64_t, 1);
-	GHashTableIter iter;
-	gpointer baddr, value;
+	GArray *bin_ranges = proc_dbg_info_src->bin_ranges;
+	struct bin_info_range *range;
+	guint pos;
 
-	if (!key) {
-		goto end;
+	pos = bin_ranges_upper_bound(bin_ranges, ip);
+	if (pos == 0) {
+		return NULL;
 	}
 
-	*((uint64_t *) key) = ip;
+	range = &g_array_index(bin_ranges, struct bin_info_range, pos - 1);
+	if (ip >= range->high_addr) {
+		return NULL;
+	}
 
-	/* Look in IP to debug infos hash table first. */
-	debug_info_src = g_hash_table_lookup(
-			proc_dbg_info_src->ip_to_debug_info_src,
-			key);
-	if (debug_info_src) {
-		goto end;
+	return range->bin;
+}
+
+static
+void proc_debug_info_sources_add_bin_range(
+		struct proc_debug_info_sources *proc_dbg_info_src,
+		struct bin_info *bin)
+{
+	struct bin_info_range range = {
+		.low_addr = bin->low_addr,
+		.high_addr = bin->high_addr,
+		.bin = bin,
+	};
+	guint pos;
+
+	pos = bin_ranges_upper_bound(proc_dbg_info_src->bin_ranges,
+			bin->low_addr);
+	g_array_insert_val(proc_dbg_info_src->bin_ranges, pos, range);
+}
+
+static
+void proc_debug_info_sources_remove_bin_range(
+		struct proc_debug_info_sources *proc_dbg_info_src,
+		struct bin_info *bin)
+{
+	GArray *bin_ranges = proc_dbg_info_src->bin_ranges;
+	guint pos;
+
+	/* Ranges starting at the same address are adjacent. */
+	pos = bin_ranges_upper_bound(bin_ranges, bin->low_addr);
+	while (pos > 0) {
+		struct bin_info_range *range = &g_array_index(bin_ranges,
+				struct bin_info_range, pos - 1);
+
+		if (range->low_addr != bin->low_addr) {
+			break;
+		}
+
+		if (range->bin == bin) {
+			g_array_remove_index(bin_ranges, pos - 1);
+			break;
+		}
+
+		pos--;
 	}
+}
 
-	/* Check in all bin_infos. */
-	g_hash_table_iter_init(&iter, proc_dbg_info_src->baddr_to_bin_info);
+/*
+ * Removes the cached debug info sources of the IPs within
+ * [low_addr, high_addr[, which are stale once the binary mapped there
+ * is unloaded or gets new debug information.
+ */
+static
+void proc_debug_info_sources_invalidate_range(
+		struct proc_debug_info_sources *proc_dbg_info_src,
+		uint64_t low_addr, uint64_t high_addr)
+{
+	GList *node = proc_dbg_info_src->ip_lru.head;
 
-	while (g_hash_table_iter_next(&iter, &baddr, &value))
-	{
-		struct bin_info *bin = value;
+	while (node) {
+		struct debug_info_src_cache_entry *entry = node->data;
 
-		if (!bin_info_has_address(value, ip)) {
+		node = node->next;
+		if (entry->ip < low_addr || entry->ip >= high_addr) {
 			continue;
 		}
 
-		/*
-		 * Found; add it to cache.
-		 *
-		 * FIXME: this should be bounded in size (and implement
-		 * a caching policy), and entries should be prunned when
-		 * libraries are unmapped.
-		 */
-		debug_info_src = debug_info_source_create_from_bin(bin, ip);
-		if (debug_info_src) {
-			g_hash_table_insert(
-					proc_dbg_info_src->ip_to_debug_info_src,
-					key, debug_info_src);
-			/* Ownership passed to ht. */
-			key = NULL;
-		}
-		break;
+		g_queue_unlink(&proc_dbg_info_src->ip_lru, &entry->lru_node);
+		g_hash_table_remove(proc_dbg_info_src->ip_to_debug_info_src,
+				&entry->ip);
 	}
+}
 
-end:
-	free(key);
+static
+void proc_debug_info_sources_clear(
+		struct proc_debug_info_sources *proc_dbg_info_src)
+{
+	g_queue_init(&proc_dbg_info_src->ip_lru);
+	g_hash_table_remove_all(proc_dbg_info_src->ip_to_debug_info_src);
+	g_array_set_size(proc_dbg_info_src->bin_ranges, 0);
+	g_hash_table_remove_all(proc_dbg_info_src->baddr_to_bin_info);
+}
+
+static
+struct debug_info_source *proc_debug_info_sources_get_entry(
+		struct proc_debug_info_sources *proc_dbg_info_src, uint64_t ip)
+{
+	struct debug_info_src_cache_entry *entry;
+	struct debug_info_source *debug_info_src;
+	struct bin_info *bin;
+
+	/* Look in IP to debug infos cache first. */
+	entry = g_hash_table_lookup(proc_dbg_info_src->ip_to_debug_info_src,
+			&ip);
+	if (entry) {
+		/* Most recently used. */
+		g_queue_unlink(&proc_dbg_info_src->ip_lru, &entry->lru_node);
+		g_queue_push_head_link(&proc_dbg_info_src->ip_lru,
+				&entry->lru_node);
+		return entry->debug_info_src;
+	}
+
+	bin = proc_debug_info_sources_find_bin(proc_dbg_info_src, ip);
+	if (!bin) {
+		return NULL;
+	}
+
+	debug_info_src = debug_info_source_create_from_bin(bin, ip);
+	if (!debug_info_src) {
+		return NULL;
+	}
+
+	/* Found; add it to cache, evicting the least recently used. */
+	if (proc_dbg_info_src->ip_lru.length >= DEBUG_INFO_SRC_CACHE_SIZE) {
+		GList *lru_node = g_queue_pop_tail_link(
+				&proc_dbg_info_src->ip_lru);
+		struct debug_info_src_cache_entry *lru_entry = lru_node->data;
+
+		g_hash_table_remove(proc_dbg_info_src->ip_to_debug_info_src,
+				&lru_entry->ip);
+	}
+
+	entry = g_new0(struct debug_info_src_cache_entry, 1);
+	entry->ip = ip;
+	entry->debug_info_src = debug_info_src;
+	entry->lru_node.data = entry;
+	g_hash_table_insert(proc_dbg_info_src->ip_to_debug_info_src,
+			&entry->ip, entry);
+	g_queue_push_head_link(&proc_dbg_info_src->ip_lru, &entry->lru_node);
 	return debug_info_src;
 }
 
@@ -425,6 +596,8 @@ void handle_statedump_build_id_event(FILE *err, struct debug_info *debug_info,
 	 * the new build id information.
 	 */
 	bin->is_elf_only = false;
+	proc_debug_info_sources_invalidate_range(proc_dbg_info_src,
+			bin->low_addr, bin->high_addr);
 
 	// TODO
 	//	bin_info_set_build_id(bin, build_id, build_id_len);
@@ -496,6 +669,8 @@ void handle_statedump_debug_link_event(FILE *err, struct debug_info *debug_info,
 	}
 
 	bin_info_set_debug_link(bin, filename, crc32);
+	proc_debug_info_sources_invalidate_range(proc_dbg_info_src,
+			bin->low_addr, bin->high_addr);
 
 end:
 	return;
@@ -597,10 +772,20 @@ void handle_bin_info_event(FILE *err, struct debug_info *debug_info,
 		goto end;
 	}
 
+	if (debug_info->comp->arg_cache_dir) {
+		ret = bin_info_set_cache_dir(bin,
+			debug_info->comp->arg_cache_dir);
+		if (ret) {
+			bin_info_destroy(bin);
+			goto end;
+		}
+	}
+
 	g_hash_table_insert(proc_dbg_info_src->baddr_to_bin_info,
 			key, bin);
 	/* Ownership passed to ht. */
 	key = NULL;
+	proc_debug_info_sources_add_bin_range(proc_dbg_info_src, bin);
 
 end:
 	g_free(key);
@@ -626,6 +811,7 @@ void handle_lib_unload_event(FILE *err, struct debug_info *debug_info,
 		struct bt_ctf_event *event)
 {
 	struct proc_debug_info_sources *proc_dbg_info_src;
+	struct bin_info *bin;
 	uint64_t baddr;
 	int64_t vpid;
 	gpointer key_ptr = NULL;
@@ -653,6 +839,15 @@ void handle_lib_unload_event(FILE *err, struct debug_info *debug_info,
 	}
 
 	key_ptr = (gpointer) &baddr;
+	bin = g_hash_table_lookup(proc_dbg_info_src->baddr_to_bin_info,
+			key_ptr);
+	if (!bin) {
+		goto end;
+	}
+
+	proc_debug_info_sources_invalidate_range(proc_dbg_info_src,
+			bin->low_addr, bin->high_addr);
+	proc_debug_info_sources_remove_bin_range(proc_dbg_info_src, bin);
 	(void) g_hash_table_remove(proc_dbg_info_src->baddr_to_bin_info,
 			key_ptr);
 end:
@@ -679,8 +874,7 @@ void handle_statedump_start(FILE *err, struct debug_info *debug_info,
 		goto end;
 	}
 
-	g_hash_table_remove_all(proc_dbg_info_src->baddr_to_bin_info);
-	g_hash_table_remove_all(proc_dbg_info_src->ip_to_debug_info_src);
+	proc_debug_info_sources_clear(proc_dbg_info_src);
 
 end:
 	return;
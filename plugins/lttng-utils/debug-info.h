@@ -51,6 +51,7 @@ struct debug_info_component {
 	FILE *err;
 	char *arg_debug_info_field_name;
 	const char *arg_debug_dir;
+	const char *arg_cache_dir;
 	bool arg_full_path;
 	const char *arg_target_prefix;
 };
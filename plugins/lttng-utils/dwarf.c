@@ -120,6 +120,43 @@ error:
 	return NULL;
 }
 
+BT_HIDDEN
+struct bt_dwarf_die *bt_dwarf_die_create_at_offset(struct bt_dwarf_cu *cu,
+		Dwarf_Off offset, unsigned int depth)
+{
+	Dwarf_Die *dwarf_die = NULL;
+	struct bt_dwarf_die *die = NULL;
+
+	if (!cu) {
+		goto error;
+	}
+
+	dwarf_die = g_new0(Dwarf_Die, 1);
+	if (!dwarf_die) {
+		goto error;
+	}
+
+	if (!dwarf_offdie(cu->dwarf_info, offset, dwarf_die)) {
+		goto error;
+	}
+
+	die = g_new0(struct bt_dwarf_die, 1);
+	if (!die) {
+		goto error;
+	}
+
+	die->cu = cu;
+	die->dwarf_die = dwarf_die;
+	die->depth = depth;
+
+	return die;
+
+error:
+	g_free(dwarf_die);
+	g_free(die);
+	return NULL;
+}
+
 BT_HIDDEN
 void bt_dwarf_die_destroy(struct bt_dwarf_die *die)
 {
@@ -111,6 +111,22 @@ int bt_dwarf_cu_next(struct bt_dwarf_cu *cu);
 BT_HIDDEN
 struct bt_dwarf_die *bt_dwarf_die_create(struct bt_dwarf_cu *cu);
 
+/**
+ * Instantiate a structure to access the debug information entry (DIE)
+ * at a given offset within the compile unit `cu`, typically one which
+ * was found by a previous walk of the CU's DIEs.
+ *
+ * @param cu		bt_dwarf_cu instance
+ * @param offset	Offset in bytes in the DWARF file to the DIE
+ * @param depth		Depth of the DIE within the CU (see struct
+ *			bt_dwarf_die)
+ * @returns		Pointer to the new bt_dwarf_die on success,
+ *			NULL on failure.
+ */
+BT_HIDDEN
+struct bt_dwarf_die *bt_dwarf_die_create_at_offset(struct bt_dwarf_cu *cu,
+		Dwarf_Off offset, unsigned int depth);
+
 /**
  * Destroy the given bt_dwarf_die instance.
  *
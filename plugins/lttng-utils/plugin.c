@@ -281,6 +281,19 @@ end:
 	return ret;
 }
 
+static
+enum bt_notification_iterator_status debug_info_iterator_seek_time(
+		struct bt_private_notification_iterator *iterator, int64_t time)
+{
+	struct debug_info_iterator *debug_it;
+
+	debug_it = bt_private_notification_iterator_get_user_data(iterator);
+	assert(debug_it);
+
+	return bt_notification_iterator_seek_time(debug_it->input_iterator,
+		BT_NOTIFICATION_ITERATOR_SEEK_ORIGIN_EPOCH, time);
+}
+
 static
 enum bt_notification_iterator_status debug_info_iterator_init(
 		struct bt_private_notification_iterator *iterator,
@@ -401,6 +414,23 @@ enum bt_component_status init_from_params(
 		goto end;
 	}
 
+        value = bt_value_map_get(params, "cache-dir");
+	if (value) {
+		enum bt_value_status value_ret;
+
+		value_ret = bt_value_string_get(value,
+				&debug_info_component->arg_cache_dir);
+		if (value_ret) {
+			ret = BT_COMPONENT_STATUS_INVALID;
+			BT_LOGE_STR("Failed to retrieve cache-dir value. "
+					"Expecting a string");
+		}
+	}
+	bt_put(value);
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		goto end;
+	}
+
         value = bt_value_map_get(params, "target-prefix");
 	if (value) {
 		enum bt_value_status value_ret;
@@ -497,3 +527,5 @@ BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_INIT_METHOD_WITH_ID(
 	lttng_utils, debug_info, debug_info_iterator_init);
 BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_FINALIZE_METHOD_WITH_ID(
 	lttng_utils, debug_info, debug_info_iterator_destroy);
+BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_SEEK_TIME_METHOD_WITH_ID(
+	lttng_utils, debug_info, debug_info_iterator_seek_time);
@@ -0,0 +1,849 @@
+/*
+ * symbol-cache.c
+ *
+ * Babeltrace - Persistent Symbol Cache
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define BT_LOG_TAG "PLUGIN-CTF-LTTNG-UTILS-DEBUG-INFO-FLT-SYMBOL-CACHE"
+#include "logging.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <babeltrace/compat/mman-internal.h>
+#include "symbol-cache.h"
+
+/*
+ * Symbol cache file layout: a header followed by the arrays it
+ * describes, each one aligned on 8 bytes, and by a string table. All
+ * the values are in the host's byte order; a cache file written on a
+ * host of another byte order is rejected, as well as one of another
+ * format version.
+ */
+#define SYMBOL_CACHE_MAGIC		"BTSYMCA"
+#define SYMBOL_CACHE_VERSION		1
+#define SYMBOL_CACHE_BYTE_ORDER		0x01020304
+
+/* String table offset of a missing string. */
+#define SYMBOL_CACHE_NO_STRING		UINT32_MAX
+
+struct symbol_cache_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	/* Offsets are from the beginning of the file. */
+	uint64_t funcs_offset;
+	uint64_t funcs_count;
+	uint64_t inlines_offset;
+	uint64_t inlines_count;
+	uint64_t cu_ranges_offset;
+	uint64_t cu_ranges_count;
+	uint64_t lines_offset;
+	uint64_t lines_count;
+	uint64_t strings_offset;
+	uint64_t strings_size;
+};
+
+/*
+ * Address range of a function or of a CU. Arrays of ranges are sorted
+ * by low address, then by order.
+ */
+struct symbol_cache_range {
+	uint64_t low_addr;
+	uint64_t high_addr;
+	/* Highest high address of this range and of the ones before it. */
+	uint64_t max_high_addr;
+	uint32_t order;
+	uint32_t cu_index;
+};
+
+/* Address range of a function. */
+struct symbol_cache_func {
+	struct symbol_cache_range range;
+	uint64_t entry_addr;
+	/* String table offset of the function's name. */
+	uint32_t name;
+	/* Inlined subroutines, in DIE order. */
+	uint32_t inlines_index;
+	uint32_t inlines_count;
+	uint32_t padding;
+};
+
+/* Address range of a subroutine inlined in a function. */
+struct symbol_cache_inline {
+	uint64_t low_addr;
+	uint64_t high_addr;
+	uint64_t call_line;
+	/* String table offset of the call site's file name. */
+	uint32_t call_file;
+	uint32_t padding;
+};
+
+/* Source line. Lines are sorted by address, then by CU index. */
+struct symbol_cache_line {
+	uint64_t addr;
+	uint64_t line_no;
+	/* String table offset of the line's file name. */
+	uint32_t filename;
+	uint32_t cu_index;
+};
+
+struct symbol_cache {
+	/* Cache file contents, either mapped or allocated. */
+	void *data;
+	size_t size;
+	bool is_mapped;
+	const struct symbol_cache_header *header;
+	const struct symbol_cache_func *funcs;
+	const struct symbol_cache_inline *inlines;
+	const struct symbol_cache_range *cu_ranges;
+	const struct symbol_cache_line *lines;
+	const char *strings;
+};
+
+struct symbol_cache_builder {
+	/* Arrays of struct symbol_cache_func, _inline, _range and _line. */
+	GArray *funcs;
+	GArray *inlines;
+	GArray *cu_ranges;
+	GArray *lines;
+	/* String table, and map from a string to its offset within it. */
+	GString *strings;
+	GHashTable *string_offsets;
+	/* Last function added, and index of its first range. */
+	struct symbol_cache_func cur_func;
+	guint cur_func_ranges_index;
+	bool has_cur_func;
+};
+
+BT_HIDDEN
+struct symbol_cache_builder *symbol_cache_builder_create(void)
+{
+	struct symbol_cache_builder *builder;
+
+	builder = g_new0(struct symbol_cache_builder, 1);
+	if (!builder) {
+		goto error;
+	}
+
+	builder->funcs = g_array_new(FALSE, FALSE,
+			sizeof(struct symbol_cache_func));
+	builder->inlines = g_array_new(FALSE, FALSE,
+			sizeof(struct symbol_cache_inline));
+	builder->cu_ranges = g_array_new(FALSE, FALSE,
+			sizeof(struct symbol_cache_range));
+	builder->lines = g_array_new(FALSE, FALSE,
+			sizeof(struct symbol_cache_line));
+	builder->strings = g_string_new(NULL);
+	builder->string_offsets = g_hash_table_new_full(g_str_hash,
+			g_str_equal, g_free, NULL);
+	if (!builder->funcs || !builder->inlines || !builder->cu_ranges ||
+			!builder->lines || !builder->strings ||
+			!builder->string_offsets) {
+		goto error;
+	}
+
+	return builder;
+
+error:
+	symbol_cache_builder_destroy(builder);
+	return NULL;
+}
+
+BT_HIDDEN
+void symbol_cache_builder_destroy(struct symbol_cache_builder *builder)
+{
+	if (!builder) {
+		return;
+	}
+
+	if (builder->funcs) {
+		g_array_free(builder->funcs, TRUE);
+	}
+	if (builder->inlines) {
+		g_array_free(builder->inlines, TRUE);
+	}
+	if (builder->cu_ranges) {
+		g_array_free(builder->cu_ranges, TRUE);
+	}
+	if (builder->lines) {
+		g_array_free(builder->lines, TRUE);
+	}
+	if (builder->strings) {
+		g_string_free(builder->strings, TRUE);
+	}
+	if (builder->string_offsets) {
+		g_hash_table_destroy(builder->string_offsets);
+	}
+
+	g_free(builder);
+}
+
+/*
+ * Add a string to the string table of a builder, once.
+ *
+ * Returns the string's offset within the string table, or
+ * SYMBOL_CACHE_NO_STRING if `str` is NULL or on failure.
+ */
+static
+uint32_t builder_add_string(struct symbol_cache_builder *builder,
+		const char *str)
+{
+	gpointer offset;
+	char *key;
+
+	if (!str) {
+		return SYMBOL_CACHE_NO_STRING;
+	}
+
+	if (g_hash_table_lookup_extended(builder->string_offsets, str,
+			NULL, &offset)) {
+		return GPOINTER_TO_UINT(offset);
+	}
+
+	if (builder->strings->len + strlen(str) + 1 >=
+			SYMBOL_CACHE_NO_STRING) {
+		BT_LOGW_STR("Symbol cache string table is full.");
+		return SYMBOL_CACHE_NO_STRING;
+	}
+
+	key = g_strdup(str);
+	if (!key) {
+		return SYMBOL_CACHE_NO_STRING;
+	}
+
+	offset = GUINT_TO_POINTER(builder->strings->len);
+	/* Include the null character. */
+	g_string_append_len(builder->strings, str, strlen(str) + 1);
+	g_hash_table_insert(builder->string_offsets, key, offset);
+	return GPOINTER_TO_UINT(offset);
+}
+
+BT_HIDDEN
+int symbol_cache_builder_add_func(struct symbol_cache_builder *builder,
+		const char *name, uint64_t entry_addr, uint32_t cu_index,
+		uint32_t order)
+{
+	struct symbol_cache_func *func = &builder->cur_func;
+
+	memset(func, 0, sizeof(*func));
+	func->range.order = order;
+	func->range.cu_index = cu_index;
+	func->entry_addr = entry_addr;
+	func->name = builder_add_string(builder, name);
+	func->inlines_index = builder->inlines->len;
+	builder->cur_func_ranges_index = builder->funcs->len;
+	builder->has_cur_func = true;
+	return 0;
+}
+
+BT_HIDDEN
+int symbol_cache_builder_add_func_range(struct symbol_cache_builder *builder,
+		uint64_t low_addr, uint64_t high_addr)
+{
+	struct symbol_cache_func func;
+
+	if (!builder->has_cur_func || low_addr >= high_addr) {
+		return -1;
+	}
+
+	func = builder->cur_func;
+	func.range.low_addr = low_addr;
+	func.range.high_addr = high_addr;
+	g_array_append_val(builder->funcs, func);
+	return 0;
+}
+
+BT_HIDDEN
+int symbol_cache_builder_add_inline(struct symbol_cache_builder *builder,
+		uint64_t low_addr, uint64_t high_addr, const char *call_file,
+		uint64_t call_line)
+{
+	struct symbol_cache_inline inl = { 0 };
+	guint i;
+
+	if (!builder->has_cur_func || low_addr >= high_addr) {
+		return -1;
+	}
+
+	inl.low_addr = low_addr;
+	inl.high_addr = high_addr;
+	inl.call_line = call_line;
+	inl.call_file = builder_add_string(builder, call_file);
+	g_array_append_val(builder->inlines, inl);
+
+	/* Account for it in the ranges of its function added so far. */
+	builder->cur_func.inlines_count++;
+	for (i = builder->cur_func_ranges_index; i < builder->funcs->len;
+			i++) {
+		g_array_index(builder->funcs, struct symbol_cache_func,
+			i).inlines_count++;
+	}
+
+	return 0;
+}
+
+BT_HIDDEN
+int symbol_cache_builder_add_cu_range(struct symbol_cache_builder *builder,
+		uint64_t low_addr, uint64_t high_addr, uint32_t cu_index)
+{
+	struct symbol_cache_range range = { 0 };
+
+	if (low_addr >= high_addr) {
+		return -1;
+	}
+
+	range.low_addr = low_addr;
+	range.high_addr = high_addr;
+	range.order = cu_index;
+	range.cu_index = cu_index;
+	g_array_append_val(builder->cu_ranges, range);
+	return 0;
+}
+
+BT_HIDDEN
+int symbol_cache_builder_add_line(struct symbol_cache_builder *builder,
+		uint64_t addr, const char *filename, uint64_t line_no,
+		uint32_t cu_index)
+{
+	struct symbol_cache_line line;
+
+	line.addr = addr;
+	line.line_no = line_no;
+	line.filename = builder_add_string(builder, filename);
+	line.cu_index = cu_index;
+	g_array_append_val(builder->lines, line);
+	return 0;
+}
+
+static
+gint compare_ranges(gconstpointer a, gconstpointer b)
+{
+	const struct symbol_cache_range *range_a = a;
+	const struct symbol_cache_range *range_b = b;
+
+	if (range_a->low_addr != range_b->low_addr) {
+		return range_a->low_addr < range_b->low_addr ? -1 : 1;
+	}
+
+	return range_a->order < range_b->order ? -1 :
+		(range_a->order > range_b->order ? 1 : 0);
+}
+
+static
+gint compare_lines(gconstpointer a, gconstpointer b)
+{
+	const struct symbol_cache_line *line_a = a;
+	const struct symbol_cache_line *line_b = b;
+
+	if (line_a->addr != line_b->addr) {
+		return line_a->addr < line_b->addr ? -1 : 1;
+	}
+
+	return line_a->cu_index < line_b->cu_index ? -1 :
+		(line_a->cu_index > line_b->cu_index ? 1 : 0);
+}
+
+#define RANGE_AT(_ranges, _stride, _i)					\
+	((struct symbol_cache_range *) ((char *) (_ranges) + (_i) * (_stride)))
+
+/*
+ * Sort an array of ranges, each one being the first member of an
+ * element of `stride` bytes, and compute their running maximum high
+ * address.
+ */
+static
+void sort_ranges(GArray *ranges, size_t stride)
+{
+	uint64_t max_high_addr = 0;
+	guint i;
+
+	g_array_sort(ranges, compare_ranges);
+	for (i = 0; i < ranges->len; i++) {
+		struct symbol_cache_range *range =
+			RANGE_AT(ranges->data, stride, i);
+
+		if (range->high_addr > max_high_addr) {
+			max_high_addr = range->high_addr;
+		}
+
+		range->max_high_addr = max_high_addr;
+	}
+}
+
+static
+uint64_t align_offset(uint64_t offset)
+{
+	return (offset + 7) & ~(uint64_t) 7;
+}
+
+static
+struct symbol_cache *symbol_cache_create(void *data, size_t size,
+		bool is_mapped);
+
+BT_HIDDEN
+struct symbol_cache *symbol_cache_builder_build(
+		struct symbol_cache_builder *builder)
+{
+	struct symbol_cache_header header = { { 0 } };
+	uint64_t size;
+	char *data;
+
+	sort_ranges(builder->funcs, sizeof(struct symbol_cache_func));
+	sort_ranges(builder->cu_ranges, sizeof(struct symbol_cache_range));
+	g_array_sort(builder->lines, compare_lines);
+
+	memcpy(header.magic, SYMBOL_CACHE_MAGIC, sizeof(header.magic));
+	header.version = SYMBOL_CACHE_VERSION;
+	header.byte_order = SYMBOL_CACHE_BYTE_ORDER;
+	size = sizeof(header);
+	header.funcs_offset = size;
+	header.funcs_count = builder->funcs->len;
+	size += builder->funcs->len * sizeof(struct symbol_cache_func);
+	header.inlines_offset = size;
+	header.inlines_count = builder->inlines->len;
+	size += builder->inlines->len * sizeof(struct symbol_cache_inline);
+	header.cu_ranges_offset = size;
+	header.cu_ranges_count = builder->cu_ranges->len;
+	size += builder->cu_ranges->len * sizeof(struct symbol_cache_range);
+	header.lines_offset = size;
+	header.lines_count = builder->lines->len;
+	size += builder->lines->len * sizeof(struct symbol_cache_line);
+	header.strings_offset = size;
+	header.strings_size = builder->strings->len;
+	size = align_offset(size + builder->strings->len);
+
+	data = g_malloc0(size);
+	if (!data) {
+		return NULL;
+	}
+
+	memcpy(data, &header, sizeof(header));
+	memcpy(data + header.funcs_offset, builder->funcs->data,
+		builder->funcs->len * sizeof(struct symbol_cache_func));
+	memcpy(data + header.inlines_offset, builder->inlines->data,
+		builder->inlines->len * sizeof(struct symbol_cache_inline));
+	memcpy(data + header.cu_ranges_offset, builder->cu_ranges->data,
+		builder->cu_ranges->len * sizeof(struct symbol_cache_range));
+	memcpy(data + header.lines_offset, builder->lines->data,
+		builder->lines->len * sizeof(struct symbol_cache_line));
+	memcpy(data + header.strings_offset, builder->strings->str,
+		builder->strings->len);
+	BT_LOGD("Built symbol cache: func-range-count=%u, inline-count=%u, "
+		"cu-range-count=%u, line-count=%u, strings-size=%zu",
+		builder->funcs->len, builder->inlines->len,
+		builder->cu_ranges->len, builder->lines->len,
+		builder->strings->len);
+	return symbol_cache_create(data, size, false);
+}
+
+/*
+ * Validate that an array of the cache file contents lies within it.
+ */
+static
+bool is_valid_array(size_t size, uint64_t offset, uint64_t count,
+		size_t elem_size)
+{
+	return offset % 8 == 0 && offset <= size &&
+		count <= (size - offset) / elem_size;
+}
+
+/*
+ * Create a symbol cache from the contents of a cache file, after
+ * validating them. Takes the ownership of `data`, which is freed on
+ * failure.
+ */
+static
+struct symbol_cache *symbol_cache_create(void *data, size_t size,
+		bool is_mapped)
+{
+	struct symbol_cache *cache = NULL;
+	const struct symbol_cache_header *header = data;
+
+	if (size < sizeof(*header) ||
+			memcmp(header->magic, SYMBOL_CACHE_MAGIC,
+				sizeof(header->magic)) ||
+			header->version != SYMBOL_CACHE_VERSION ||
+			header->byte_order != SYMBOL_CACHE_BYTE_ORDER) {
+		BT_LOGD_STR("Invalid symbol cache header.");
+		goto error;
+	}
+
+	if (!is_valid_array(size, header->funcs_offset,
+				header->funcs_count,
+				sizeof(struct symbol_cache_func)) ||
+			!is_valid_array(size, header->inlines_offset,
+				header->inlines_count,
+				sizeof(struct symbol_cache_inline)) ||
+			!is_valid_array(size, header->cu_ranges_offset,
+				header->cu_ranges_count,
+				sizeof(struct symbol_cache_range)) ||
+			!is_valid_array(size, header->lines_offset,
+				header->lines_count,
+				sizeof(struct symbol_cache_line)) ||
+			header->strings_offset > size ||
+			header->strings_size > size - header->strings_offset ||
+			(header->strings_size > 0 &&
+				((const char *) data)[header->strings_offset +
+					header->strings_size - 1] != '\0')) {
+		BT_LOGD_STR("Invalid symbol cache tables.");
+		goto error;
+	}
+
+	cache = g_new0(struct symbol_cache, 1);
+	if (!cache) {
+		goto error;
+	}
+
+	cache->data = data;
+	cache->size = size;
+	cache->is_mapped = is_mapped;
+	cache->header = header;
+	cache->funcs = (const void *) ((const char *) data +
+			header->funcs_offset);
+	cache->inlines = (const void *) ((const char *) data +
+			header->inlines_offset);
+	cache->cu_ranges = (const void *) ((const char *) data +
+			header->cu_ranges_offset);
+	cache->lines = (const void *) ((const char *) data +
+			header->lines_offset);
+	cache->strings = (const char *) data + header->strings_offset;
+	return cache;
+
+error:
+	if (is_mapped) {
+		munmap(data, size);
+	} else {
+		g_free(data);
+	}
+	return NULL;
+}
+
+BT_HIDDEN
+struct symbol_cache *symbol_cache_load(const char *path)
+{
+	int fd;
+	struct stat st;
+	void *data;
+	struct symbol_cache *cache;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		BT_LOGD("No symbol cache file: path=\"%s\"", path);
+		return NULL;
+	}
+
+	if (fstat(fd, &st) || st.st_size <= 0) {
+		close(fd);
+		return NULL;
+	}
+
+	data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		BT_LOGW("Cannot map symbol cache file: path=\"%s\", errno=%d",
+			path, errno);
+		return NULL;
+	}
+
+	cache = symbol_cache_create(data, st.st_size, true);
+	if (!cache) {
+		BT_LOGW("Ignoring invalid symbol cache file: path=\"%s\"",
+			path);
+		return NULL;
+	}
+
+	BT_LOGD("Loaded symbol cache file: path=\"%s\", size=%zu", path,
+		cache->size);
+	return cache;
+}
+
+BT_HIDDEN
+int symbol_cache_save(struct symbol_cache *cache, const char *path)
+{
+	int ret = 0, fd = -1;
+	char *dir_path = NULL, *tmp_path = NULL;
+	const char *buf = cache->data;
+	size_t remaining = cache->size;
+
+	dir_path = g_path_get_dirname(path);
+	if (g_mkdir_with_parents(dir_path, 0755)) {
+		BT_LOGW("Cannot create symbol cache directory: path=\"%s\", "
+			"errno=%d", dir_path, errno);
+		goto error;
+	}
+
+	tmp_path = g_strdup_printf("%s.%d.tmp", path, (int) getpid());
+	if (!tmp_path) {
+		goto error;
+	}
+
+	fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		BT_LOGW("Cannot create symbol cache file: path=\"%s\", "
+			"errno=%d", tmp_path, errno);
+		goto error;
+	}
+
+	while (remaining > 0) {
+		ssize_t written = write(fd, buf, remaining);
+
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			BT_LOGW("Cannot write symbol cache file: path=\"%s\", "
+				"errno=%d", tmp_path, errno);
+			goto error_unlink;
+		}
+
+		buf += written;
+		remaining -= written;
+	}
+
+	ret = close(fd);
+	fd = -1;
+	if (ret) {
+		goto error_unlink;
+	}
+
+	if (rename(tmp_path, path)) {
+		BT_LOGW("Cannot rename symbol cache file: path=\"%s\", "
+			"errno=%d", path, errno);
+		goto error_unlink;
+	}
+
+	BT_LOGD("Saved symbol cache file: path=\"%s\", size=%zu", path,
+		cache->size);
+	goto end;
+
+error_unlink:
+	if (fd >= 0) {
+		close(fd);
+		fd = -1;
+	}
+	unlink(tmp_path);
+error:
+	ret = -1;
+end:
+	g_free(tmp_path);
+	g_free(dir_path);
+	return ret;
+}
+
+BT_HIDDEN
+void symbol_cache_destroy(struct symbol_cache *cache)
+{
+	if (!cache) {
+		return;
+	}
+
+	if (cache->is_mapped) {
+		munmap(cache->data, cache->size);
+	} else {
+		g_free(cache->data);
+	}
+
+	g_free(cache);
+}
+
+static
+const char *get_string(struct symbol_cache *cache, uint32_t offset)
+{
+	if (offset >= cache->header->strings_size) {
+		return NULL;
+	}
+
+	return cache->strings + offset;
+}
+
+/*
+ * Find the range containing a given address, among ranges sorted by
+ * low address, each one being the first member of an element of
+ * `stride` bytes. If several ranges contain the address, the one with
+ * the lowest order is returned.
+ */
+static
+const struct symbol_cache_range *find_range(const void *ranges,
+		uint64_t count, size_t stride, uint64_t addr)
+{
+	const struct symbol_cache_range *found = NULL;
+	uint64_t low = 0, high = count;
+
+	/* Find the first range starting after `addr`. */
+	while (low < high) {
+		uint64_t mid = low + (high - low) / 2;
+
+		if (RANGE_AT(ranges, stride, mid)->low_addr <= addr) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	/*
+	 * Scan the ranges starting at or before `addr` backwards, as
+	 * long as one of them could still contain it.
+	 */
+	while (low > 0) {
+		const struct symbol_cache_range *range =
+			RANGE_AT(ranges, stride, low - 1);
+
+		if (range->max_high_addr <= addr) {
+			break;
+		}
+
+		if (addr < range->high_addr &&
+				(!found || range->order < found->order)) {
+			found = range;
+		}
+
+		low--;
+	}
+
+	return found;
+}
+
+BT_HIDDEN
+int symbol_cache_lookup_function(struct symbol_cache *cache, uint64_t addr,
+		const char **name, uint64_t *entry_addr)
+{
+	const struct symbol_cache_func *func;
+	const char *_name;
+
+	func = (const void *) find_range(cache->funcs,
+			cache->header->funcs_count,
+			sizeof(struct symbol_cache_func), addr);
+	if (!func) {
+		return 1;
+	}
+
+	_name = get_string(cache, func->name);
+	if (!_name) {
+		return -1;
+	}
+
+	*name = _name;
+	*entry_addr = func->entry_addr;
+	return 0;
+}
+
+BT_HIDDEN
+int symbol_cache_lookup_source_location(struct symbol_cache *cache,
+		uint64_t addr, const char **filename, uint64_t *line_no)
+{
+	const struct symbol_cache_func *func;
+	const struct symbol_cache_line *line;
+	const char *line_filename;
+	uint32_t cu_index;
+	uint64_t low = 0, high;
+
+	func = (const void *) find_range(cache->funcs,
+			cache->header->funcs_count,
+			sizeof(struct symbol_cache_func), addr);
+	if (func) {
+		uint64_t i;
+
+		if (func->inlines_index > cache->header->inlines_count ||
+				func->inlines_count >
+				cache->header->inlines_count -
+					func->inlines_index) {
+			return -1;
+		}
+
+		/* Call site of the first inlined subroutine containing addr. */
+		for (i = func->inlines_index;
+				i < func->inlines_index + func->inlines_count;
+				i++) {
+			const struct symbol_cache_inline *inl =
+				&cache->inlines[i];
+			const char *call_file;
+
+			if (addr < inl->low_addr || addr >= inl->high_addr) {
+				continue;
+			}
+
+			call_file = get_string(cache, inl->call_file);
+			if (!call_file) {
+				return -1;
+			}
+
+			*filename = call_file;
+			*line_no = inl->call_line;
+			return 0;
+		}
+
+		cu_index = func->range.cu_index;
+	} else {
+		const struct symbol_cache_range *cu_range;
+
+		cu_range = find_range(cache->cu_ranges,
+				cache->header->cu_ranges_count,
+				sizeof(struct symbol_cache_range), addr);
+		if (!cu_range) {
+			return 1;
+		}
+
+		cu_index = cu_range->cu_index;
+	}
+
+	/* Find the CU's line starting exactly at `addr`. */
+	high = cache->header->lines_count;
+	while (low < high) {
+		uint64_t mid = low + (high - low) / 2;
+
+		line = &cache->lines[mid];
+		if (line->addr < addr || (line->addr == addr &&
+				line->cu_index < cu_index)) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	if (low == cache->header->lines_count) {
+		return 1;
+	}
+
+	line = &cache->lines[low];
+	if (line->addr != addr || line->cu_index != cu_index) {
+		return 1;
+	}
+
+	line_filename = get_string(cache, line->filename);
+	if (!line_filename) {
+		return -1;
+	}
+
+	*filename = line_filename;
+	*line_no = line->line_no;
+	return 0;
+}
@@ -0,0 +1,222 @@
+#ifndef _BABELTRACE_SYMBOL_CACHE_H
+#define _BABELTRACE_SYMBOL_CACHE_H
+
+/*
+ * Babeltrace - Persistent Symbol Cache
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <babeltrace/babeltrace-internal.h>
+
+/*
+ * A symbol cache holds the resolved DWARF tables of an executable,
+ * which is all the bin_info lookups need once they are built:
+ *
+ * - the address ranges of its functions, with their name and entry
+ *   address, and the call sites of the subroutines inlined in them;
+ * - the address ranges of its compile units (CU);
+ * - the source lines of its CUs.
+ *
+ * A symbol cache is built once with a symbol_cache_builder, from the
+ * DWARF info, and can be saved to a file in a compact format which is
+ * mapped as is in memory when loaded back, so that later lookups need
+ * neither libelf nor libdw.
+ */
+struct symbol_cache;
+struct symbol_cache_builder;
+
+/**
+ * Create a symbol cache builder.
+ *
+ * @returns		The new builder, or NULL on failure
+ */
+BT_HIDDEN
+struct symbol_cache_builder *symbol_cache_builder_create(void);
+
+/**
+ * Destroy the given symbol cache builder.
+ *
+ * @param builder	Builder to destroy
+ */
+BT_HIDDEN
+void symbol_cache_builder_destroy(struct symbol_cache_builder *builder);
+
+/**
+ * Add a function to a symbol cache builder. Its address ranges and
+ * inlined subroutines are added next with
+ * symbol_cache_builder_add_func_range() and
+ * symbol_cache_builder_add_inline().
+ *
+ * @param builder	Builder
+ * @param name		Name of the function, or NULL if unknown, in
+ *			which case lookups within it fail
+ * @param entry_addr	Entry (low PC) address of the function
+ * @param cu_index	Index of the function's CU, as passed to
+ *			symbol_cache_builder_add_cu_range() and
+ *			symbol_cache_builder_add_line()
+ * @param order		Position of the function in a walk of the DIEs;
+ *			among functions containing an address, the one
+ *			with the lowest position is found
+ * @returns		0 on success, -1 on failure
+ */
+BT_HIDDEN
+int symbol_cache_builder_add_func(struct symbol_cache_builder *builder,
+		const char *name, uint64_t entry_addr, uint32_t cu_index,
+		uint32_t order);
+
+/**
+ * Add an address range to the last function added to a symbol cache
+ * builder.
+ *
+ * @param builder	Builder
+ * @param low_addr	Low address of the range
+ * @param high_addr	High address of the range, exclusive
+ * @returns		0 on success, -1 on failure
+ */
+BT_HIDDEN
+int symbol_cache_builder_add_func_range(struct symbol_cache_builder *builder,
+		uint64_t low_addr, uint64_t high_addr);
+
+/**
+ * Add an address range of a subroutine inlined in the last function
+ * added to a symbol cache builder. The inlined subroutines must be
+ * added in DIE order.
+ *
+ * @param builder	Builder
+ * @param low_addr	Low address of the range
+ * @param high_addr	High address of the range, exclusive
+ * @param call_file	File name of the subroutine's call site
+ * @param call_line	Line number of the subroutine's call site
+ * @returns		0 on success, -1 on failure
+ */
+BT_HIDDEN
+int symbol_cache_builder_add_inline(struct symbol_cache_builder *builder,
+		uint64_t low_addr, uint64_t high_addr, const char *call_file,
+		uint64_t call_line);
+
+/**
+ * Add an address range of a CU to a symbol cache builder.
+ *
+ * @param builder	Builder
+ * @param low_addr	Low address of the range
+ * @param high_addr	High address of the range, exclusive
+ * @param cu_index	Index of the CU
+ * @returns		0 on success, -1 on failure
+ */
+BT_HIDDEN
+int symbol_cache_builder_add_cu_range(struct symbol_cache_builder *builder,
+		uint64_t low_addr, uint64_t high_addr, uint32_t cu_index);
+
+/**
+ * Add a source line of a CU to a symbol cache builder.
+ *
+ * @param builder	Builder
+ * @param addr		Address of the line
+ * @param filename	File name of the line
+ * @param line_no	Line number
+ * @param cu_index	Index of the CU
+ * @returns		0 on success, -1 on failure
+ */
+BT_HIDDEN
+int symbol_cache_builder_add_line(struct symbol_cache_builder *builder,
+		uint64_t addr, const char *filename, uint64_t line_no,
+		uint32_t cu_index);
+
+/**
+ * Build a symbol cache from the tables added to a symbol cache
+ * builder. The builder can be destroyed afterwards.
+ *
+ * @param builder	Builder
+ * @returns		The new symbol cache, or NULL on failure
+ */
+BT_HIDDEN
+struct symbol_cache *symbol_cache_builder_build(
+		struct symbol_cache_builder *builder);
+
+/**
+ * Load a symbol cache from a file written by symbol_cache_save().
+ *
+ * @param path		Path of the file
+ * @returns		The symbol cache, or NULL if the file does not
+ *			exist or is not a valid symbol cache file
+ */
+BT_HIDDEN
+struct symbol_cache *symbol_cache_load(const char *path);
+
+/**
+ * Save a symbol cache to a file. The file is written under a temporary
+ * name and then renamed, so that concurrent readers only ever see
+ * complete files.
+ *
+ * @param cache		Symbol cache to save
+ * @param path		Path of the file
+ * @returns		0 on success, -1 on failure
+ */
+BT_HIDDEN
+int symbol_cache_save(struct symbol_cache *cache, const char *path);
+
+/**
+ * Destroy the given symbol cache.
+ *
+ * @param cache		Symbol cache to destroy
+ */
+BT_HIDDEN
+void symbol_cache_destroy(struct symbol_cache *cache);
+
+/**
+ * Get the function containing a given address.
+ *
+ * On success, if found, the out parameters `name` and `entry_addr` are
+ * set. `name` belongs to the symbol cache. On failure or if not found,
+ * they remain unchanged.
+ *
+ * @param cache		Symbol cache
+ * @param addr		Address for which to find the function
+ * @param name		Out parameter, the name of the function
+ * @param entry_addr	Out parameter, the entry address of the function
+ * @returns		0 if found, 1 if not found, -1 on failure
+ */
+BT_HIDDEN
+int symbol_cache_lookup_function(struct symbol_cache *cache, uint64_t addr,
+		const char **name, uint64_t *entry_addr);
+
+/**
+ * Get the source location of a given address: the call site of the
+ * inlined subroutine containing the address if any, or else the
+ * source line starting exactly at the address.
+ *
+ * On success, if found, the out parameters `filename` and `line_no`
+ * are set. `filename` belongs to the symbol cache. On failure or if
+ * not found, they remain unchanged.
+ *
+ * @param cache		Symbol cache
+ * @param addr		Address for which to find the source location
+ * @param filename	Out parameter, the file name
+ * @param line_no	Out parameter, the line number
+ * @returns		0 if found, 1 if not found, -1 on failure
+ */
+BT_HIDDEN
+int symbol_cache_lookup_source_location(struct symbol_cache *cache,
+		uint64_t addr, const char **filename, uint64_t *line_no);
+
+#endif	/* _BABELTRACE_SYMBOL_CACHE_H */
@@ -0,0 +1,351 @@
+/*
+ * output.c
+ *
+ * Babeltrace CTF Text Output Plugin buffered output
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <glib.h>
+#include <babeltrace/babeltrace-internal.h>
+#include "output.h"
+
+struct pretty_output_buf {
+	char *addr;
+	size_t len;
+};
+
+struct pretty_output {
+	/* Weak */
+	FILE *fp;
+
+	/* Capacity of each buffer (0 means no buffer) */
+	size_t capacity;
+
+	/*
+	 * Buffers (owned by this): the component appends to
+	 * `bufs[cur_buf]`, and the writer thread, if any, writes the
+	 * other one.
+	 */
+	struct pretty_output_buf bufs[2];
+	unsigned int cur_buf;
+
+	bool async;
+	pthread_t writer_tid;
+	bool writer_tid_is_valid;
+
+	/* Protects `pending`, `quit`, and `error` */
+	pthread_mutex_t lock;
+
+	/* Signaled when a buffer is pending or when quitting */
+	pthread_cond_t pending_cond;
+
+	/* Signaled when the writer thread is done writing a buffer */
+	pthread_cond_t written_cond;
+
+	/* Buffer which the writer thread writes, if any (weak) */
+	struct pretty_output_buf *pending;
+
+	bool quit;
+
+	/* True if the writer thread failed to write a buffer */
+	bool error;
+};
+
+static
+int write_to_file(FILE *fp, const char *addr, size_t len)
+{
+	int ret = 0;
+
+	if (len == 0) {
+		goto end;
+	}
+
+	if (fwrite(addr, len, 1, fp) != 1) {
+		perror("write output");
+		ret = -1;
+	}
+
+end:
+	return ret;
+}
+
+static
+void *writer_thread_func(void *data)
+{
+	struct pretty_output *output = data;
+
+	pthread_mutex_lock(&output->lock);
+
+	while (true) {
+		struct pretty_output_buf *buf;
+		int ret;
+
+		while (!output->pending && !output->quit) {
+			pthread_cond_wait(&output->pending_cond, &output->lock);
+		}
+
+		if (!output->pending) {
+			/* Quitting, and everything is written */
+			break;
+		}
+
+		buf = output->pending;
+		pthread_mutex_unlock(&output->lock);
+		ret = write_to_file(output->fp, buf->addr, buf->len);
+		if (!ret && fflush(output->fp)) {
+			perror("flush output");
+			ret = -1;
+		}
+		pthread_mutex_lock(&output->lock);
+
+		if (ret) {
+			output->error = true;
+		}
+
+		buf->len = 0;
+		output->pending = NULL;
+		pthread_cond_broadcast(&output->written_cond);
+	}
+
+	pthread_mutex_unlock(&output->lock);
+	return NULL;
+}
+
+/*
+ * Waits for the writer thread to be done writing its pending buffer,
+ * if any. Returns a negative value if the writer thread failed to write
+ * a buffer.
+ */
+static
+int wait_writer_thread(struct pretty_output *output)
+{
+	int ret = 0;
+
+	if (!output->async) {
+		goto end;
+	}
+
+	pthread_mutex_lock(&output->lock);
+
+	while (output->pending) {
+		pthread_cond_wait(&output->written_cond, &output->lock);
+	}
+
+	if (output->error) {
+		ret = -1;
+	}
+
+	pthread_mutex_unlock(&output->lock);
+
+end:
+	return ret;
+}
+
+/*
+ * Hands off the current buffer to the writer thread, or writes it
+ * when there's no writer thread, and makes the current buffer empty.
+ */
+static
+int flush_cur_buf(struct pretty_output *output)
+{
+	struct pretty_output_buf *buf = &output->bufs[output->cur_buf];
+	int ret = 0;
+
+	if (buf->len == 0) {
+		goto end;
+	}
+
+	if (!output->async) {
+		ret = write_to_file(output->fp, buf->addr, buf->len);
+		buf->len = 0;
+		goto end;
+	}
+
+	/* The other buffer becomes the current one once it's written */
+	ret = wait_writer_thread(output);
+	if (ret) {
+		goto end;
+	}
+
+	pthread_mutex_lock(&output->lock);
+	output->pending = buf;
+	pthread_cond_signal(&output->pending_cond);
+	pthread_mutex_unlock(&output->lock);
+	output->cur_buf ^= 1;
+	assert(output->bufs[output->cur_buf].len == 0);
+
+end:
+	return ret;
+}
+
+BT_HIDDEN
+struct pretty_output *pretty_output_create(FILE *fp, size_t buffer_size,
+		bool async)
+{
+	struct pretty_output *output;
+	unsigned int i;
+
+	assert(fp);
+	assert(buffer_size > 0 || !async);
+	output = g_new0(struct pretty_output, 1);
+	if (!output) {
+		goto error;
+	}
+
+	output->fp = fp;
+	output->capacity = buffer_size;
+	output->async = async;
+	pthread_mutex_init(&output->lock, NULL);
+	pthread_cond_init(&output->pending_cond, NULL);
+	pthread_cond_init(&output->written_cond, NULL);
+
+	if (buffer_size == 0) {
+		goto end;
+	}
+
+	for (i = 0; i < (async ? 2 : 1); i++) {
+		output->bufs[i].addr = g_malloc(buffer_size);
+		if (!output->bufs[i].addr) {
+			goto error;
+		}
+	}
+
+	if (async) {
+		if (pthread_create(&output->writer_tid, NULL,
+				writer_thread_func, output)) {
+			perror("create output writer thread");
+			goto error;
+		}
+
+		output->writer_tid_is_valid = true;
+	}
+
+	goto end;
+
+error:
+	pretty_output_destroy(output);
+	output = NULL;
+
+end:
+	return output;
+}
+
+BT_HIDDEN
+void pretty_output_destroy(struct pretty_output *output)
+{
+	if (!output) {
+		return;
+	}
+
+	(void) pretty_output_flush(output);
+
+	if (output->writer_tid_is_valid) {
+		pthread_mutex_lock(&output->lock);
+		output->quit = true;
+		pthread_cond_signal(&output->pending_cond);
+		pthread_mutex_unlock(&output->lock);
+		(void) pthread_join(output->writer_tid, NULL);
+	}
+
+	g_free(output->bufs[0].addr);
+	g_free(output->bufs[1].addr);
+	pthread_cond_destroy(&output->written_cond);
+	pthread_cond_destroy(&output->pending_cond);
+	pthread_mutex_destroy(&output->lock);
+	g_free(output);
+}
+
+BT_HIDDEN
+int pretty_output_write(struct pretty_output *output, const char *buf,
+		size_t len)
+{
+	struct pretty_output_buf *cur_buf;
+	int ret = 0;
+
+	if (output->capacity == 0) {
+		ret = write_to_file(output->fp, buf, len);
+		goto end;
+	}
+
+	cur_buf = &output->bufs[output->cur_buf];
+
+	if (unlikely(cur_buf->len + len > output->capacity)) {
+		ret = flush_cur_buf(output);
+		if (ret) {
+			goto end;
+		}
+
+		cur_buf = &output->bufs[output->cur_buf];
+	}
+
+	if (unlikely(len > output->capacity)) {
+		/*
+		 * Larger than a whole buffer: write it directly, once
+		 * the previous text is written.
+		 */
+		ret = wait_writer_thread(output);
+		if (ret) {
+			goto end;
+		}
+
+		ret = write_to_file(output->fp, buf, len);
+		goto end;
+	}
+
+	memcpy(&cur_buf->addr[cur_buf->len], buf, len);
+	cur_buf->len += len;
+
+end:
+	return ret;
+}
+
+BT_HIDDEN
+int pretty_output_flush(struct pretty_output *output)
+{
+	int ret = 0;
+
+	if (output->capacity > 0) {
+		ret = flush_cur_buf(output);
+		if (ret) {
+			goto end;
+		}
+
+		ret = wait_writer_thread(output);
+		if (ret) {
+			goto end;
+		}
+	}
+
+	if (fflush(output->fp)) {
+		perror("flush output");
+		ret = -1;
+	}
+
+end:
+	return ret;
+}
@@ -0,0 +1,75 @@
+#ifndef BABELTRACE_PLUGIN_TEXT_PRETTY_OUTPUT_H
+#define BABELTRACE_PLUGIN_TEXT_PRETTY_OUTPUT_H
+
+/*
+ * BabelTrace - CTF Text Output Plug-in buffered output
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <babeltrace/babeltrace-internal.h>
+
+/*
+ * An output accumulates the formatted text in a large buffer and
+ * writes the whole buffer to its file at once when it's full.
+ *
+ * An asynchronous output has two buffers: when the current one is
+ * full, it's handed off to a writer thread, and the text is
+ * accumulated in the other one meanwhile. The component therefore only
+ * waits for the file when it fills a buffer before the writer thread
+ * is done writing the previous one.
+ */
+struct pretty_output;
+
+/*
+ * Creates an output which writes to `fp` (not owned by the output).
+ *
+ * If `buffer_size` is 0, the text is written to `fp` as is, that is,
+ * with the buffering of `fp` only, and `async` must be false.
+ */
+BT_HIDDEN
+struct pretty_output *pretty_output_create(FILE *fp, size_t buffer_size,
+		bool async);
+
+/* Flushes the output and destroys it. */
+BT_HIDDEN
+void pretty_output_destroy(struct pretty_output *output);
+
+/*
+ * Appends `len` bytes of `buf` to the output. Returns a negative value
+ * if a previous buffer could not be written.
+ */
+BT_HIDDEN
+int pretty_output_write(struct pretty_output *output, const char *buf,
+		size_t len);
+
+/*
+ * Writes everything which is appended to the output to its file and
+ * flushes the file.
+ */
+BT_HIDDEN
+int pretty_output_flush(struct pretty_output *output);
+
+#endif /* BABELTRACE_PLUGIN_TEXT_PRETTY_OUTPUT_H */
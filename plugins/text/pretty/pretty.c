@@ -45,11 +45,19 @@
 #include <plugins-common.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
 #include <glib.h>
 #include <assert.h>
 
 #include "pretty.h"
 
+/* Maximum number of notifications to get from the iterator at once */
+#define PRETTY_NOTIF_BATCH_CAPACITY	64
+
+/* Default size of the output buffer(s) when not writing to a terminal */
+#define PRETTY_DEFAULT_OUTPUT_BUFFER_SIZE	(4 * 1024 * 1024)
+
 static
 const char *plugin_options[] = {
 	"color",
@@ -74,6 +82,8 @@ const char *plugin_options[] = {
 	"field-loglevel",
 	"field-emf",
 	"field-callsite",
+	"buffer-size",
+	"async-output",
 };
 
 static
@@ -89,7 +99,10 @@ void destroy_pretty_data(struct pretty_component *pretty)
 		(void) g_string_free(pretty->tmp_string, TRUE);
 	}
 
-	if (pretty->out != stdout) {
+	/* Writes what's left to `pretty->out` */
+	pretty_output_destroy(pretty->output);
+
+	if (pretty->out && pretty->out != stdout) {
 		int ret;
 
 		ret = fclose(pretty->out);
@@ -192,12 +205,14 @@ void pretty_port_connected(
 BT_HIDDEN
 enum bt_component_status pretty_consume(struct bt_private_component *component)
 {
-	enum bt_component_status ret;
-	struct bt_notification *notification = NULL;
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+	struct bt_notification *notifications[PRETTY_NOTIF_BATCH_CAPACITY];
 	struct bt_notification_iterator *it;
 	struct pretty_component *pretty =
 		bt_private_component_get_user_data(component);
 	enum bt_notification_iterator_status it_ret;
+	uint64_t count = 0;
+	uint64_t i = 0;
 
 	if (unlikely(pretty->error)) {
 		ret = BT_COMPONENT_STATUS_ERROR;
@@ -205,15 +220,30 @@ enum bt_component_status pretty_consume(struct bt_private_component *component)
 	}
 
 	it = pretty->input_iterator;
-	it_ret = bt_notification_iterator_next(it);
+	it_ret = bt_notification_iterator_next_batch(it, notifications,
+		PRETTY_NOTIF_BATCH_CAPACITY, &count);
 
 	switch (it_ret) {
 	case BT_NOTIFICATION_ITERATOR_STATUS_END:
 		ret = BT_COMPONENT_STATUS_END;
 		BT_PUT(pretty->input_iterator);
+
+		if (pretty_output_flush(pretty->output)) {
+			ret = BT_COMPONENT_STATUS_ERROR;
+		}
+
 		goto end;
 	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
+		/*
+		 * Nothing to print for now (live trace, for example):
+		 * show what's printed so far.
+		 */
 		ret = BT_COMPONENT_STATUS_AGAIN;
+
+		if (pretty_output_flush(pretty->output)) {
+			ret = BT_COMPONENT_STATUS_ERROR;
+		}
+
 		goto end;
 	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
 		break;
@@ -222,12 +252,20 @@ enum bt_component_status pretty_consume(struct bt_private_component *component)
 		goto end;
 	}
 
-	notification = bt_notification_iterator_get_notification(it);
-	assert(notification);
-	ret = handle_notification(pretty, notification);
+	for (i = 0; i < count; i++) {
+		ret = handle_notification(pretty, notifications[i]);
+		BT_PUT(notifications[i]);
+		if (ret != BT_COMPONENT_STATUS_OK) {
+			i++;
+			break;
+		}
+	}
 
 end:
-	bt_put(notification);
+	for (; i < count; i++) {
+		bt_put(notifications[i]);
+	}
+
 	return ret;
 }
 
@@ -330,6 +368,42 @@ end:
 	return ret;
 }
 
+static
+enum bt_component_status apply_one_uint(const char *key,
+		struct bt_value *params,
+		uint64_t *option,
+		bool *found)
+{
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+	struct bt_value *value = NULL;
+	enum bt_value_status status;
+	int64_t int_val;
+
+	value = bt_value_map_get(params, key);
+	if (!value) {
+		goto end;
+	}
+	status = bt_value_integer_get(value, &int_val);
+	switch (status) {
+	case BT_VALUE_STATUS_OK:
+		break;
+	default:
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+	if (int_val < 0) {
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+	*option = (uint64_t) int_val;
+	if (found) {
+		*found = true;
+	}
+end:
+	bt_put(value);
+	return ret;
+}
+
 static
 void warn_wrong_color_param(struct pretty_component *pretty)
 {
@@ -682,6 +756,45 @@ enum bt_component_status apply_params(struct pretty_component *pretty,
 		pretty->options.print_callsite_field = value;
 	}
 
+	/* Output buffering. */
+	value = false;		/* Default. */
+	ret = apply_one_bool("async-output", params, &value, NULL);
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		goto end;
+	}
+	pretty->options.async_output = value;
+
+	found = false;
+	ret = apply_one_uint("buffer-size", params,
+		&pretty->options.output_buffer_size, &found);
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		goto end;
+	}
+	if (!found) {
+		/*
+		 * Keep the standard I/O buffering when printing to a
+		 * terminal so that the events show up as they come.
+		 */
+		if (pretty->options.async_output ||
+				!isatty(fileno(pretty->out))) {
+			pretty->options.output_buffer_size =
+				PRETTY_DEFAULT_OUTPUT_BUFFER_SIZE;
+		} else {
+			pretty->options.output_buffer_size = 0;
+		}
+	}
+	if (pretty->options.output_buffer_size > SIZE_MAX) {
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+	if (pretty->options.async_output &&
+			pretty->options.output_buffer_size == 0) {
+		fprintf(pretty->err,
+			"[error] The \"async-output\" parameter requires a non-zero \"buffer-size\" parameter\n");
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+
 end:
 	bt_put(pretty->plugin_opt_map);
 	pretty->plugin_opt_map = NULL;
@@ -759,6 +872,14 @@ enum bt_component_status pretty_init(
 		goto error;
 	}
 
+	pretty->output = pretty_output_create(pretty->out,
+		(size_t) pretty->options.output_buffer_size,
+		pretty->options.async_output);
+	if (!pretty->output) {
+		ret = BT_COMPONENT_STATUS_NOMEM;
+		goto error;
+	}
+
 	set_use_colors(pretty);
 	ret = bt_private_component_set_user_data(component, pretty);
 	if (ret != BT_COMPONENT_STATUS_OK) {
@@ -33,6 +33,7 @@
 #include <babeltrace/graph/private-component.h>
 #include <babeltrace/graph/private-port.h>
 #include <babeltrace/ctf-ir/event.h>
+#include "output.h"
 
 enum pretty_default {
 	PRETTY_DEFAULT_UNSET,
@@ -73,12 +74,16 @@ struct pretty_options {
 	bool clock_gmt;
 	enum pretty_color_option color;
 	bool verbose;
+
+	uint64_t output_buffer_size;
+	bool async_output;
 };
 
 struct pretty_component {
 	struct pretty_options options;
 	struct bt_notification_iterator *input_iterator;
 	FILE *out, *err;
+	struct pretty_output *output;	/* Writes to `out` */
 	int depth;	/* nesting, used for tabulation alignment. */
 	bool start_line;
 	GString *string;
@@ -92,6 +97,18 @@ struct pretty_component {
 
 	uint64_t last_real_timestamp;
 	uint64_t delta_real_timestamp;
+
+	/*
+	 * Formatted date and time of day, up to the seconds' dot, of
+	 * the last printed wall clock timestamp: only the nanoseconds
+	 * are formatted for the next timestamps of the same second.
+	 */
+	struct {
+		bool is_valid;
+		uint64_t sec;
+		char str[32];
+		size_t len;
+	} wall_time_cache;
 };
 
 enum stream_packet_context_quarks_enum {
@@ -71,6 +71,126 @@ struct timestamp {
 	uint64_t clock_value;	/* In cycles. */
 };
 
+/*
+ * The following functions format numbers straight into a GString
+ * instead of going through g_string_append_printf(), which parses its
+ * format string and formats to a temporary buffer for each call.
+ */
+
+/* Maximum number of digits of a 64-bit unsigned integer in base 8 */
+#define UINT64_MAX_DIGITS	22
+
+static const char dec_digit_pairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+/*
+ * Formats `value` in base 10 backwards from `buf_end`, and returns the
+ * address of its first digit.
+ */
+static inline
+char *format_uint_dec(char *buf_end, uint64_t value)
+{
+	char *p = buf_end;
+
+	while (value >= 100) {
+		unsigned int i = (unsigned int) (value % 100) * 2;
+
+		value /= 100;
+		p -= 2;
+		p[0] = dec_digit_pairs[i];
+		p[1] = dec_digit_pairs[i + 1];
+	}
+
+	if (value >= 10) {
+		unsigned int i = (unsigned int) value * 2;
+
+		p -= 2;
+		p[0] = dec_digit_pairs[i];
+		p[1] = dec_digit_pairs[i + 1];
+	} else {
+		*--p = '0' + (char) value;
+	}
+
+	return p;
+}
+
+/*
+ * Appends `value` in base 10, left-padded with zeros to `width`
+ * digits (at most UINT64_MAX_DIGITS).
+ */
+static inline
+void append_uint_dec_width(GString *str, uint64_t value, unsigned int width)
+{
+	char buf[UINT64_MAX_DIGITS];
+	char *buf_end = &buf[UINT64_MAX_DIGITS];
+	char *p = format_uint_dec(buf_end, value);
+
+	assert(width <= UINT64_MAX_DIGITS);
+
+	while (buf_end - p < width) {
+		*--p = '0';
+	}
+
+	g_string_append_len(str, p, buf_end - p);
+}
+
+static inline
+void append_uint_dec(GString *str, uint64_t value)
+{
+	append_uint_dec_width(str, value, 0);
+}
+
+static inline
+void append_int_dec(GString *str, int64_t value)
+{
+	if (value < 0) {
+		g_string_append_c(str, '-');
+		append_uint_dec(str, -(uint64_t) value);
+	} else {
+		append_uint_dec(str, (uint64_t) value);
+	}
+}
+
+/* Appends `value` like the "0x%" PRIX64 format. */
+static inline
+void append_uint_hex(GString *str, uint64_t value)
+{
+	char buf[UINT64_MAX_DIGITS];
+	char *buf_end = &buf[UINT64_MAX_DIGITS];
+	char *p = buf_end;
+
+	do {
+		*--p = hex_digits[value & 0xf];
+		value >>= 4;
+	} while (value);
+
+	g_string_append_len(str, "0x", 2);
+	g_string_append_len(str, p, buf_end - p);
+}
+
+/* Appends `value` like the "0%" PRIo64 format. */
+static inline
+void append_uint_oct(GString *str, uint64_t value)
+{
+	char buf[UINT64_MAX_DIGITS];
+	char *buf_end = &buf[UINT64_MAX_DIGITS];
+	char *p = buf_end;
+
+	do {
+		*--p = '0' + (char) (value & 0x7);
+		value >>= 3;
+	} while (value);
+
+	g_string_append_c(str, '0');
+	g_string_append_len(str, p, buf_end - p);
+}
+
 static
 enum bt_component_status print_field(struct pretty_component *pretty,
 		struct bt_ctf_field *field, bool print_names,
@@ -80,22 +200,28 @@ static
 void print_name_equal(struct pretty_component *pretty, const char *name)
 {
 	if (pretty->use_colors) {
-		g_string_append_printf(pretty->string, "%s%s%s = ", COLOR_NAME,
-			name, COLOR_RST);
+		g_string_append(pretty->string, COLOR_NAME);
+		g_string_append(pretty->string, name);
+		g_string_append(pretty->string, COLOR_RST);
 	} else {
-		g_string_append_printf(pretty->string, "%s = ", name);
+		g_string_append(pretty->string, name);
 	}
+
+	g_string_append_len(pretty->string, " = ", 3);
 }
 
 static
 void print_field_name_equal(struct pretty_component *pretty, const char *name)
 {
 	if (pretty->use_colors) {
-		g_string_append_printf(pretty->string, "%s%s%s = ",
-			COLOR_FIELD_NAME, name, COLOR_RST);
+		g_string_append(pretty->string, COLOR_FIELD_NAME);
+		g_string_append(pretty->string, name);
+		g_string_append(pretty->string, COLOR_RST);
 	} else {
-		g_string_append_printf(pretty->string, "%s = ", name);
+		g_string_append(pretty->string, name);
 	}
+
+	g_string_append_len(pretty->string, " = ", 3);
 }
 
 static
@@ -121,7 +247,7 @@ void print_timestamp_cycles(struct pretty_component *pretty,
 		return;
 	}
 
-	g_string_append_printf(pretty->string, "%020" PRIu64, cycles);
+	append_uint_dec_width(pretty->string, cycles, 20);
 
 	if (pretty->last_cycles_timestamp != -1ULL) {
 		pretty->delta_cycles = cycles - pretty->last_cycles_timestamp;
@@ -129,6 +255,78 @@ void print_timestamp_cycles(struct pretty_component *pretty,
 	pretty->last_cycles_timestamp = cycles;
 }
 
+/*
+ * Formats the date (if needed) and the time of day, up to the seconds'
+ * dot, of `sec` seconds from Epoch into the wall time cache of
+ * `pretty`.
+ */
+static
+int update_wall_time_cache(struct pretty_component *pretty, uint64_t sec)
+{
+	struct tm tm;
+	time_t time_s = (time_t) sec;
+	char *str = pretty->wall_time_cache.str;
+	size_t len = 0;
+	int ret = 0;
+
+	pretty->wall_time_cache.is_valid = false;
+
+	if (!pretty->options.clock_gmt) {
+		struct tm *res;
+
+		res = bt_localtime_r(&time_s, &tm);
+		if (!res) {
+			// TODO: log instead
+			fprintf(stderr, "[warning] Unable to get localtime.\n");
+			ret = -1;
+			goto end;
+		}
+	} else {
+		struct tm *res;
+
+		res = bt_gmtime_r(&time_s, &tm);
+		if (!res) {
+			// TODO: log instead
+			fprintf(stderr, "[warning] Unable to get gmtime.\n");
+			ret = -1;
+			goto end;
+		}
+	}
+	if (pretty->options.clock_date) {
+		/* Print date and time */
+		len = strftime(str, sizeof(pretty->wall_time_cache.str),
+				"%Y-%m-%d ", &tm);
+		if (!len) {
+			// TODO: log instead
+			fprintf(stderr, "[warning] Unable to print ascii time.\n");
+			ret = -1;
+			goto end;
+		}
+	}
+
+	/* "HH:MM:SS." */
+	if (len + 9 > sizeof(pretty->wall_time_cache.str)) {
+		ret = -1;
+		goto end;
+	}
+
+	str[len++] = dec_digit_pairs[tm.tm_hour * 2];
+	str[len++] = dec_digit_pairs[tm.tm_hour * 2 + 1];
+	str[len++] = ':';
+	str[len++] = dec_digit_pairs[tm.tm_min * 2];
+	str[len++] = dec_digit_pairs[tm.tm_min * 2 + 1];
+	str[len++] = ':';
+	str[len++] = dec_digit_pairs[tm.tm_sec * 2];
+	str[len++] = dec_digit_pairs[tm.tm_sec * 2 + 1];
+	str[len++] = '.';
+	pretty->wall_time_cache.len = len;
+	pretty->wall_time_cache.sec = sec;
+	pretty->wall_time_cache.is_valid = true;
+
+end:
+	return ret;
+}
+
 static
 void print_timestamp_wall(struct pretty_component *pretty,
 		struct bt_ctf_clock_class *clock_class,
@@ -190,59 +388,34 @@ void print_timestamp_wall(struct pretty_component *pretty,
 	}
 
 	if (!pretty->options.clock_seconds) {
-		struct tm tm;
-		time_t time_s = (time_t) ts_sec_abs;
-
 		if (is_negative) {
 			// TODO: log instead
 			fprintf(stderr, "[warning] Fallback to [sec.ns] to print negative time value. Use --clock-seconds.\n");
 			goto seconds;
 		}
 
-		if (!pretty->options.clock_gmt) {
-			struct tm *res;
-
-			res = bt_localtime_r(&time_s, &tm);
-			if (!res) {
-				// TODO: log instead
-				fprintf(stderr, "[warning] Unable to get localtime.\n");
-				goto seconds;
-			}
-		} else {
-			struct tm *res;
-
-			res = bt_gmtime_r(&time_s, &tm);
-			if (!res) {
-				// TODO: log instead
-				fprintf(stderr, "[warning] Unable to get gmtime.\n");
-				goto seconds;
-			}
-		}
-		if (pretty->options.clock_date) {
-			char timestr[26];
-			size_t res;
-
-			/* Print date and time */
-			res = strftime(timestr, sizeof(timestr),
-					"%Y-%m-%d ", &tm);
-			if (!res) {
-				// TODO: log instead
-				fprintf(stderr, "[warning] Unable to print ascii time.\n");
+		if (!pretty->wall_time_cache.is_valid ||
+				pretty->wall_time_cache.sec != ts_sec_abs) {
+			if (update_wall_time_cache(pretty, ts_sec_abs)) {
 				goto seconds;
 			}
-
-			g_string_append(pretty->string, timestr);
 		}
 
-		/* Print time in HH:MM:SS.ns */
-		g_string_append_printf(pretty->string,
-			"%02d:%02d:%02d.%09" PRIu64, tm.tm_hour, tm.tm_min,
-			tm.tm_sec, ts_nsec_abs);
+		/* Print [date and] time in HH:MM:SS.ns */
+		g_string_append_len(pretty->string,
+			pretty->wall_time_cache.str,
+			pretty->wall_time_cache.len);
+		append_uint_dec_width(pretty->string, ts_nsec_abs, 9);
 		goto end;
 	}
 seconds:
-	g_string_append_printf(pretty->string, "%s%" PRId64 ".%09" PRIu64,
-		is_negative ? "-" : "", ts_sec_abs, ts_nsec_abs);
+	if (is_negative) {
+		g_string_append_c(pretty->string, '-');
+	}
+
+	append_uint_dec(pretty->string, ts_sec_abs);
+	g_string_append_c(pretty->string, '.');
+	append_uint_dec_width(pretty->string, ts_nsec_abs, 9);
 end:
 	return;
 }
@@ -322,8 +495,9 @@ enum bt_component_status print_event_timestamp(struct pretty_component *pretty,
 				g_string_append(pretty->string,
 					"+??????????\?\?) "); /* Not a trigraph. */
 			} else {
-				g_string_append_printf(pretty->string,
-					"+%012" PRIu64, pretty->delta_cycles);
+				g_string_append_c(pretty->string, '+');
+				append_uint_dec_width(pretty->string,
+					pretty->delta_cycles, 12);
 			}
 		} else {
 			if (pretty->delta_real_timestamp != -1ULL) {
@@ -332,9 +506,11 @@ enum bt_component_status print_event_timestamp(struct pretty_component *pretty,
 				delta = pretty->delta_real_timestamp;
 				delta_sec = delta / NSEC_PER_SEC;
 				delta_nsec = delta % NSEC_PER_SEC;
-				g_string_append_printf(pretty->string,
-					"+%" PRIu64 ".%09" PRIu64,
-					delta_sec, delta_nsec);
+				g_string_append_c(pretty->string, '+');
+				append_uint_dec(pretty->string, delta_sec);
+				g_string_append_c(pretty->string, '.');
+				append_uint_dec_width(pretty->string,
+					delta_nsec, 9);
 			} else {
 				g_string_append(pretty->string, "+?.?????????");
 			}
@@ -492,7 +668,9 @@ enum bt_component_status print_event_header(struct pretty_component *pretty,
 			}
 			if (bt_value_integer_get(vpid_value, &value)
 					== BT_VALUE_STATUS_OK) {
-				g_string_append_printf(pretty->string, "(%" PRId64 ")", value);
+				g_string_append_c(pretty->string, '(');
+				append_int_dec(pretty->string, value);
+				g_string_append_c(pretty->string, ')');
 			}
 			bt_put(vpid_value);
 			dom_print = 1;
@@ -530,8 +708,13 @@ enum bt_component_status print_event_header(struct pretty_component *pretty,
 
 				if (bt_value_integer_get(loglevel_value, &value)
 						== BT_VALUE_STATUS_OK) {
-					g_string_append_printf(pretty->string, "%s(%" PRId64 ")",
-						has_str ? " " : "", value);
+					if (has_str) {
+						g_string_append_c(pretty->string, ' ');
+					}
+
+					g_string_append_c(pretty->string, '(');
+					append_int_dec(pretty->string, value);
+					g_string_append_c(pretty->string, ')');
 				}
 			}
 			bt_put(loglevel_str);
@@ -655,18 +838,21 @@ enum bt_component_status print_integer(struct pretty_component *pretty,
 	case BT_CTF_INTEGER_BASE_BINARY:
 	{
 		int bitnr, len;
+		char bits[64];
 
 		len = bt_ctf_field_type_integer_get_size(field_type);
 		if (len < 0) {
 			ret = BT_COMPONENT_STATUS_ERROR;
 			goto end;
 		}
+		assert(len <= 64);
 		g_string_append(pretty->string, "0b");
 		v.u = _bt_piecewise_lshift(v.u, 64 - len);
 		for (bitnr = 0; bitnr < len; bitnr++) {
-			g_string_append_printf(pretty->string, "%u", (v.u & (1ULL << 63)) ? 1 : 0);
+			bits[bitnr] = (v.u & (1ULL << 63)) ? '1' : '0';
 			v.u = _bt_piecewise_lshift(v.u, 1);
 		}
+		g_string_append_len(pretty->string, bits, len);
 		break;
 	}
 	case BT_CTF_INTEGER_BASE_OCTAL:
@@ -689,14 +875,14 @@ enum bt_component_status print_integer(struct pretty_component *pretty,
 			}
 		}
 
-		g_string_append_printf(pretty->string, "0%" PRIo64, v.u);
+		append_uint_oct(pretty->string, v.u);
 		break;
 	}
 	case BT_CTF_INTEGER_BASE_DECIMAL:
 		if (!signedness) {
-			g_string_append_printf(pretty->string, "%" PRIu64, v.u);
+			append_uint_dec(pretty->string, v.u);
 		} else {
-			g_string_append_printf(pretty->string, "%" PRId64, v.s);
+			append_int_dec(pretty->string, v.s);
 		}
 		break;
 	case BT_CTF_INTEGER_BASE_HEXADECIMAL:
@@ -715,7 +901,7 @@ enum bt_component_status print_integer(struct pretty_component *pretty,
 			v.u &= ((uint64_t) 1 << rounded_len) - 1;
 		}
 
-		g_string_append_printf(pretty->string, "0x%" PRIX64, v.u);
+		append_uint_hex(pretty->string, v.u);
 		break;
 	}
 	default:
@@ -733,68 +919,81 @@ end:
 static
 void print_escape_string(struct pretty_component *pretty, const char *str)
 {
-	int i;
+	/* First character which is not appended yet */
+	const char *run = str;
+	const char *p;
 
 	g_string_append_c(pretty->string, '"');
 
-	for (i = 0; i < strlen(str); i++) {
+	for (p = str; *p != '\0'; p++) {
+		const char *esc;
+
+		switch (*p) {
 		/* Escape sequences not recognized by iscntrl(). */
-		switch (str[i]) {
 		case '\\':
-			g_string_append(pretty->string, "\\\\");
-			continue;
+			esc = "\\\\";
+			break;
 		case '\'':
-			g_string_append(pretty->string, "\\\'");
-			continue;
+			esc = "\\\'";
+			break;
 		case '\"':
-			g_string_append(pretty->string, "\\\"");
-			continue;
+			esc = "\\\"";
+			break;
 		case '\?':
-			g_string_append(pretty->string, "\\\?");
-			continue;
-		}
-
-		/* Standard characters. */
-		if (!iscntrl(str[i])) {
-			g_string_append_c(pretty->string, str[i]);
-			continue;
-		}
-
-		switch (str[i]) {
-		case '\0':
-			g_string_append(pretty->string, "\\0");
+			esc = "\\\?";
 			break;
 		case '\a':
-			g_string_append(pretty->string, "\\a");
+			esc = "\\a";
 			break;
 		case '\b':
-			g_string_append(pretty->string, "\\b");
+			esc = "\\b";
 			break;
 		case '\e':
-			g_string_append(pretty->string, "\\e");
+			esc = "\\e";
 			break;
 		case '\f':
-			g_string_append(pretty->string, "\\f");
+			esc = "\\f";
 			break;
 		case '\n':
-			g_string_append(pretty->string, "\\n");
+			esc = "\\n";
 			break;
 		case '\r':
-			g_string_append(pretty->string, "\\r");
+			esc = "\\r";
 			break;
 		case '\t':
-			g_string_append(pretty->string, "\\t");
+			esc = "\\t";
 			break;
 		case '\v':
-			g_string_append(pretty->string, "\\v");
+			esc = "\\v";
 			break;
 		default:
+			/* Standard characters: part of the current run. */
+			if (!iscntrl(*p)) {
+				continue;
+			}
+
 			/* Unhandled control-sequence, print as hex. */
-			g_string_append_printf(pretty->string, "\\x%02x", str[i]);
+			esc = NULL;
 			break;
 		}
+
+		g_string_append_len(pretty->string, run, p - run);
+		run = p + 1;
+
+		if (esc) {
+			g_string_append(pretty->string, esc);
+		} else {
+			unsigned char c = (unsigned char) *p;
+
+			g_string_append_len(pretty->string, "\\x", 2);
+			g_string_append_c(pretty->string,
+				"0123456789abcdef"[c >> 4]);
+			g_string_append_c(pretty->string,
+				"0123456789abcdef"[c & 0xf]);
+		}
 	}
 
+	g_string_append_len(pretty->string, run, p - run);
 	g_string_append_c(pretty->string, '"');
 }
 
@@ -1016,7 +1215,9 @@ enum bt_component_status print_array_field(struct pretty_component *pretty,
 			g_string_append(pretty->string, " ");
 		}
 		if (print_names) {
-			g_string_append_printf(pretty->string, "[%" PRIu64 "] = ", i);
+			g_string_append_c(pretty->string, '[');
+			append_uint_dec(pretty->string, i);
+			g_string_append_len(pretty->string, "] = ", 4);
 		}
 	}
 	field = bt_ctf_field_array_get_field(array, i);
@@ -1127,7 +1328,9 @@ enum bt_component_status print_sequence_field(struct pretty_component *pretty,
 			g_string_append(pretty->string, " ");
 		}
 		if (print_names) {
-			g_string_append_printf(pretty->string, "[%" PRIu64 "] = ", i);
+			g_string_append_c(pretty->string, '[');
+			append_uint_dec(pretty->string, i);
+			g_string_append_len(pretty->string, "] = ", 4);
 		}
 	}
 	field = bt_ctf_field_sequence_get_field(seq, i);
@@ -1303,6 +1506,8 @@ enum bt_component_status print_field(struct pretty_component *pretty,
 	case CTF_TYPE_FLOAT:
 	{
 		double v;
+		char buf[32];
+		int buf_len;
 
 		if (bt_ctf_field_floating_point_get_value(field, &v)) {
 			return BT_COMPONENT_STATUS_ERROR;
@@ -1310,7 +1515,9 @@ enum bt_component_status print_field(struct pretty_component *pretty,
 		if (pretty->use_colors) {
 			g_string_append(pretty->string, COLOR_NUMBER_VALUE);
 		}
-		g_string_append_printf(pretty->string, "%g", v);
+		buf_len = snprintf(buf, sizeof(buf), "%g", v);
+		assert(buf_len > 0 && (size_t) buf_len < sizeof(buf));
+		g_string_append_len(pretty->string, buf, buf_len);
 		if (pretty->use_colors) {
 			g_string_append(pretty->string, COLOR_RST);
 		}
@@ -1524,7 +1731,8 @@ enum bt_component_status pretty_print_event(struct pretty_component *pretty,
 	}
 
 	g_string_append_c(pretty->string, '\n');
-	if (fwrite(pretty->string->str, pretty->string->len, 1, pretty->out) != 1) {
+	if (pretty_output_write(pretty->output, pretty->string->str,
+			pretty->string->len)) {
 		ret = BT_COMPONENT_STATUS_ERROR;
 		goto end;
 	}
@@ -36,6 +36,9 @@
 #include <assert.h>
 #include "dummy.h"
 
+/* Maximum number of notifications to get from an iterator at once */
+#define DUMMY_NOTIF_BATCH_CAPACITY	64
+
 static
 void destroy_private_dummy_data(struct dummy *dummy)
 {
@@ -120,7 +123,7 @@ end:
 enum bt_component_status dummy_consume(struct bt_private_component *component)
 {
 	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
-	struct bt_notification *notif = NULL;
+	struct bt_notification *notifs[DUMMY_NOTIF_BATCH_CAPACITY];
 	size_t i;
 	struct dummy *dummy;
 
@@ -132,14 +135,17 @@ enum bt_component_status dummy_consume(struct bt_private_component *component)
 		goto end;
 	}
 
-	/* Consume one notification from each iterator. */
+	/* Consume a batch of notifications from each iterator. */
 	for (i = 0; i < dummy->iterators->len; i++) {
 		struct bt_notification_iterator *it;
 		enum bt_notification_iterator_status it_ret;
+		uint64_t count = 0;
+		uint64_t j;
 
 		it = g_ptr_array_index(dummy->iterators, i);
 
-		it_ret = bt_notification_iterator_next(it);
+		it_ret = bt_notification_iterator_next_batch(it, notifs,
+			DUMMY_NOTIF_BATCH_CAPACITY, &count);
 		switch (it_ret) {
 		case BT_NOTIFICATION_ITERATOR_STATUS_ERROR:
 			ret = BT_COMPONENT_STATUS_ERROR;
@@ -154,12 +160,15 @@ enum bt_component_status dummy_consume(struct bt_private_component *component)
 		default:
 			break;
 		}
+
+		for (j = 0; j < count; j++) {
+			bt_put(notifs[j]);
+		}
 	}
 
 	if (dummy->iterators->len == 0) {
 		ret = BT_COMPONENT_STATUS_END;
 	}
 end:
-	bt_put(notif);
 	return ret;
 }
@@ -22,6 +22,8 @@
 
 #include <babeltrace/babeltrace-internal.h>
 #include <babeltrace/compat/uuid-internal.h>
+#include <babeltrace/prio-heap-internal.h>
+#include <babeltrace/spsc-ring-internal.h>
 #include <babeltrace/ctf-ir/clock-class.h>
 #include <babeltrace/ctf-ir/event.h>
 #include <babeltrace/graph/clock-class-priority-map.h>
@@ -43,10 +45,29 @@
 #include <glib.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #define ASSUME_ABSOLUTE_CLOCK_CLASSES_PARAM_NAME	"assume-absolute-clock-classes"
+#define THREADS_PARAM_NAME				"threads"
+
+/* Maximum number of notifications a worker pushes ahead of the muxer */
+#define MUXER_UPSTREAM_RING_CAPACITY			256
+
+/* Maximum number of notifications a worker gets at once from upstream */
+#define MUXER_WORKER_BATCH_CAPACITY			64
+
+/*
+ * Bounds of the time a worker waits before advancing again upstream
+ * notification iterators which returned
+ * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN. The worker doubles this
+ * time after each wait which ends without any progress, and the muxer
+ * notification iterator wakes it up early when it is retried itself.
+ */
+#define MUXER_WORKER_AGAIN_MIN_WAIT_US			1000
+#define MUXER_WORKER_AGAIN_MAX_WAIT_US			100000
 
 struct muxer_comp {
 	/* Array of struct bt_private_notification_iterator * (weak refs) */
@@ -59,12 +80,33 @@ struct muxer_comp {
 	bool error;
 	bool initializing_muxer_notif_iter;
 	bool assume_absolute_clock_classes;
+
+	/*
+	 * Maximum number of worker threads of each muxer notification
+	 * iterator, or 0 if the upstream notification iterators are
+	 * advanced by the thread which uses the muxer notification
+	 * iterator.
+	 */
+	uint64_t nr_threads;
 };
 
+struct muxer_notif_iter;
+struct muxer_worker;
+
 struct muxer_upstream_notif_iter {
-	/* Owned by this, NULL if ended */
+	/* Owned by this, NULL if canceled */
 	struct bt_notification_iterator *notif_iter;
 
+	/* Input port (weak) on which notif_iter above was created */
+	struct bt_private_port *priv_port;
+
+	/*
+	 * True if the upstream notification iterator reached its end.
+	 * We keep the notification iterator in this case because a
+	 * seek operation can make it active again.
+	 */
+	bool is_ended;
+
 	/*
 	 * This flag is true if the upstream notification iterator's
 	 * current notification must be considered for the multiplexing
@@ -77,6 +119,85 @@ struct muxer_upstream_notif_iter {
 	 * is NULL (which means the upstream iterator is finished).
 	 */
 	bool is_valid;
+
+	/*
+	 * Time (ns from origin) of the current notification, only
+	 * valid when is_valid above is true. It is computed once, when
+	 * this object is validated, so that the heap comparison
+	 * function does not need to get the notification's clock value.
+	 */
+	int64_t ts_ns;
+
+	/*
+	 * Insertion sequence number in the muxer notification
+	 * iterator's heap. When two current notifications have the
+	 * same time, the most recently inserted one is the youngest.
+	 */
+	uint64_t heap_seq;
+
+	/*
+	 * Worker (weak) which advances notif_iter above on its own
+	 * thread and pushes the upstream notifications to `ring` below,
+	 * or NULL if the muxer notification iterator advances
+	 * notif_iter itself. The following members are only used when
+	 * there's a worker.
+	 */
+	struct muxer_worker *worker;
+
+	/*
+	 * Notifications (owned by this) which the worker pushes and
+	 * which the muxer notification iterator pops.
+	 */
+	struct bt_spsc_ring ring;
+
+	/* Current notification (owned by this), last popped from `ring` */
+	struct bt_notification *notif;
+
+	/*
+	 * True (atomic access) if the last "next" operation of the
+	 * worker on notif_iter returned
+	 * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN.
+	 */
+	bool worker_again;
+
+	/*
+	 * True (atomic access) once the worker does not access this
+	 * object anymore because notif_iter returned
+	 * worker_status below, which is not
+	 * BT_NOTIFICATION_ITERATOR_STATUS_OK. The notifications which
+	 * the worker pushed before remain in `ring`.
+	 */
+	bool worker_done;
+	enum bt_notification_iterator_status worker_status;
+};
+
+struct muxer_worker {
+	/* Weak */
+	struct muxer_notif_iter *muxer_notif_iter;
+
+	pthread_t thread;
+
+	/*
+	 * Array of struct muxer_upstream_notif_iter * (weak) which
+	 * this worker advances, only accessed by the worker's thread.
+	 */
+	GPtrArray *upstream_notif_iters;
+
+	/*
+	 * Array of struct muxer_upstream_notif_iter * (weak) which are
+	 * assigned to this worker, but not moved to
+	 * upstream_notif_iters above yet (protected by `lock`).
+	 */
+	GPtrArray *new_upstream_notif_iters;
+
+	/* True if the worker's thread must exit (protected by `lock`) */
+	bool quit;
+
+	/* True (atomic access) if the worker waits on `cond` */
+	bool waiting;
+
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
 };
 
 enum muxer_notif_iter_clock_class_expectation {
@@ -88,15 +209,40 @@ enum muxer_notif_iter_clock_class_expectation {
 
 struct muxer_notif_iter {
 	/*
-	 * Array of struct muxer_upstream_notif_iter * (owned by this).
-	 *
-	 * NOTE: This array is searched in linearly to find the youngest
-	 * current notification. Keep this until benchmarks confirm that
-	 * another data structure is faster than this for our typical
-	 * use cases.
+	 * Array of struct muxer_upstream_notif_iter * (owned by this)
+	 * which are neither ended nor canceled.
 	 */
 	GPtrArray *muxer_upstream_notif_iters;
 
+	/*
+	 * Priority heap of struct muxer_upstream_notif_iter * (weak)
+	 * which are valid. The heap's maximum is the upstream
+	 * notification iterator of which the current notification is
+	 * the youngest, so that finding it is O(1) and replacing it is
+	 * O(log N).
+	 */
+	struct ptr_heap valid_muxer_upstream_notif_iters;
+
+	/*
+	 * Queue of struct muxer_upstream_notif_iter * (weak) which
+	 * are invalid, that is, which are in
+	 * muxer_upstream_notif_iters above but not in
+	 * valid_muxer_upstream_notif_iters. They are validated in
+	 * order by validate_muxer_upstream_notif_iters().
+	 */
+	GQueue *invalid_muxer_upstream_notif_iters;
+
+	/* Next heap insertion sequence number */
+	uint64_t next_heap_seq;
+
+	/*
+	 * Array of struct muxer_upstream_notif_iter * (owned by this)
+	 * of which the upstream notification iterator is ended. They
+	 * are moved back to muxer_upstream_notif_iters above when this
+	 * muxer notification iterator seeks.
+	 */
+	GPtrArray *ended_muxer_upstream_notif_iters;
+
 	/*
 	 * List of "recently" connected input ports (weak) to
 	 * handle by this muxer notification iterator.
@@ -123,8 +269,566 @@ struct muxer_notif_iter {
 	 * MUXER_NOTIF_ITER_CLOCK_CLASS_EXPECTATION_NOT_ABS_SPEC_UUID.
 	 */
 	unsigned char expected_clock_class_uuid[BABELTRACE_UUID_LEN];
+
+	/*
+	 * Array of struct muxer_worker * (owned by this), or NULL if
+	 * the upstream notification iterators are advanced by this
+	 * muxer notification iterator's thread. There are at most
+	 * nr_threads workers: when there are as many workers, the
+	 * next upstream notification iterator is assigned to the
+	 * worker at next_worker_index.
+	 */
+	GPtrArray *workers;
+	uint64_t nr_threads;
+	guint next_worker_index;
+
+	/*
+	 * Workers signal `consumer_cond` when they make progress and
+	 * consumer_waiting (atomic access) is true, that is, when this
+	 * muxer notification iterator waits for the notification of a
+	 * specific upstream notification iterator.
+	 */
+	bool consumer_waiting;
+	pthread_mutex_t consumer_lock;
+	pthread_cond_t consumer_cond;
+};
+
+/*
+ * Wakes the muxer notification iterator's thread if it waits for a
+ * worker. Called by a worker after it made progress.
+ */
+static
+void muxer_notif_iter_wake_consumer(struct muxer_notif_iter *muxer_notif_iter)
+{
+	/*
+	 * This full barrier pairs with the one in
+	 * muxer_notif_iter_wait_for_worker(): either the muxer
+	 * notification iterator sees the worker's progress, or the
+	 * worker sees that the muxer notification iterator waits.
+	 */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&muxer_notif_iter->consumer_waiting,
+			__ATOMIC_RELAXED)) {
+		pthread_mutex_lock(&muxer_notif_iter->consumer_lock);
+		pthread_cond_signal(&muxer_notif_iter->consumer_cond);
+		pthread_mutex_unlock(&muxer_notif_iter->consumer_lock);
+	}
+}
+
+static
+bool muxer_upstream_notif_iter_worker_has_news(
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
+{
+	return !bt_spsc_ring_is_empty(&muxer_upstream_notif_iter->ring) ||
+		__atomic_load_n(&muxer_upstream_notif_iter->worker_again,
+			__ATOMIC_ACQUIRE) ||
+		__atomic_load_n(&muxer_upstream_notif_iter->worker_done,
+			__ATOMIC_ACQUIRE);
+}
+
+/*
+ * Waits until the worker of `muxer_upstream_notif_iter` pushes a
+ * notification, or until its upstream notification iterator returns
+ * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN or a final status.
+ */
+static
+void muxer_notif_iter_wait_for_worker(struct muxer_notif_iter *muxer_notif_iter,
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
+{
+	pthread_mutex_lock(&muxer_notif_iter->consumer_lock);
+	__atomic_store_n(&muxer_notif_iter->consumer_waiting, true,
+		__ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	while (!muxer_upstream_notif_iter_worker_has_news(
+			muxer_upstream_notif_iter)) {
+		pthread_cond_wait(&muxer_notif_iter->consumer_cond,
+			&muxer_notif_iter->consumer_lock);
+	}
+
+	__atomic_store_n(&muxer_notif_iter->consumer_waiting, false,
+		__ATOMIC_RELAXED);
+	pthread_mutex_unlock(&muxer_notif_iter->consumer_lock);
+}
+
+/*
+ * Wakes `worker` if it waits for free slots in the rings of its
+ * upstream notification iterators, or before advancing again upstream
+ * notification iterators which returned
+ * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN. Called by the muxer
+ * notification iterator after it popped a notification, or when it
+ * reports BT_NOTIFICATION_ITERATOR_STATUS_AGAIN itself.
+ */
+static
+void muxer_worker_wake(struct muxer_worker *worker)
+{
+	/* Pairs with the full barrier in muxer_worker_wait() */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&worker->waiting, __ATOMIC_RELAXED)) {
+		pthread_mutex_lock(&worker->lock);
+		pthread_cond_signal(&worker->cond);
+		pthread_mutex_unlock(&worker->lock);
+	}
+}
+
+static
+bool muxer_worker_can_advance(struct muxer_worker *worker)
+{
+	guint i;
+
+	for (i = 0; i < worker->upstream_notif_iters->len; i++) {
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter =
+			g_ptr_array_index(worker->upstream_notif_iters, i);
+
+		if (bt_spsc_ring_free_count(
+				&muxer_upstream_notif_iter->ring) > 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Waits until the muxer notification iterator pops a notification
+ * from one of the worker's full rings, until a new upstream
+ * notification iterator is assigned to the worker, or until the
+ * worker must quit.
+ */
+static
+void muxer_worker_wait(struct muxer_worker *worker)
+{
+	pthread_mutex_lock(&worker->lock);
+	__atomic_store_n(&worker->waiting, true, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if (!worker->quit && worker->new_upstream_notif_iters->len == 0 &&
+			!muxer_worker_can_advance(worker)) {
+		pthread_cond_wait(&worker->cond, &worker->lock);
+	}
+
+	__atomic_store_n(&worker->waiting, false, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&worker->lock);
+}
+
+/*
+ * Waits until the muxer notification iterator pops a notification
+ * from one of the worker's rings or is retried after reporting
+ * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN, until a new upstream
+ * notification iterator is assigned to the worker, until the worker
+ * must quit, or for at most `wait_us` microseconds.
+ */
+static
+void muxer_worker_wait_again(struct muxer_worker *worker, uint64_t wait_us)
+{
+	struct timespec deadline;
+
+	(void) clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += wait_us / 1000000;
+	deadline.tv_nsec += (long) (wait_us % 1000000) * 1000;
+	if (deadline.tv_nsec >= 1000000000) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&worker->lock);
+	__atomic_store_n(&worker->waiting, true, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if (!worker->quit && worker->new_upstream_notif_iters->len == 0) {
+		(void) pthread_cond_timedwait(&worker->cond, &worker->lock,
+			&deadline);
+	}
+
+	__atomic_store_n(&worker->waiting, false, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&worker->lock);
+}
+
+enum muxer_worker_advance_status {
+	MUXER_WORKER_ADVANCE_STATUS_PUSHED,
+	MUXER_WORKER_ADVANCE_STATUS_FULL,
+	MUXER_WORKER_ADVANCE_STATUS_AGAIN,
+	MUXER_WORKER_ADVANCE_STATUS_DONE,
 };
 
+/*
+ * Gets a batch of notifications from the upstream notification
+ * iterator of `muxer_upstream_notif_iter` and pushes them to its ring.
+ *
+ * When the upstream notification iterator returns a final status,
+ * this function removes `muxer_upstream_notif_iter` from the worker's
+ * upstream notification iterators and marks it as done: the worker
+ * must not access it anymore.
+ */
+static
+enum muxer_worker_advance_status muxer_worker_advance(
+		struct muxer_worker *worker,
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter,
+		struct bt_notification **notifs)
+{
+	enum muxer_worker_advance_status advance_status;
+	enum bt_notification_iterator_status status;
+	uint64_t free_count;
+	uint64_t count = 0;
+	uint64_t i;
+	bool pushed;
+
+	free_count = bt_spsc_ring_free_count(&muxer_upstream_notif_iter->ring);
+	if (free_count == 0) {
+		advance_status = MUXER_WORKER_ADVANCE_STATUS_FULL;
+		goto end;
+	}
+
+	status = bt_notification_iterator_next_batch(
+		muxer_upstream_notif_iter->notif_iter, notifs,
+		MIN(free_count, MUXER_WORKER_BATCH_CAPACITY), &count);
+	switch (status) {
+	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
+		for (i = 0; i < count; i++) {
+			pushed = bt_spsc_ring_push(
+				&muxer_upstream_notif_iter->ring, notifs[i]);
+			assert(pushed);
+		}
+
+		__atomic_store_n(&muxer_upstream_notif_iter->worker_again,
+			false, __ATOMIC_RELEASE);
+		advance_status = MUXER_WORKER_ADVANCE_STATUS_PUSHED;
+		break;
+	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
+		__atomic_store_n(&muxer_upstream_notif_iter->worker_again,
+			true, __ATOMIC_RELEASE);
+		advance_status = MUXER_WORKER_ADVANCE_STATUS_AGAIN;
+		break;
+	default:
+		muxer_upstream_notif_iter->worker_status = status;
+		g_ptr_array_remove_fast(worker->upstream_notif_iters,
+			muxer_upstream_notif_iter);
+		__atomic_store_n(&muxer_upstream_notif_iter->worker_done,
+			true, __ATOMIC_RELEASE);
+		advance_status = MUXER_WORKER_ADVANCE_STATUS_DONE;
+		break;
+	}
+
+	muxer_notif_iter_wake_consumer(worker->muxer_notif_iter);
+
+end:
+	return advance_status;
+}
+
+static
+void *muxer_worker_thread(void *data)
+{
+	struct muxer_worker *worker = data;
+	struct bt_notification *notifs[MUXER_WORKER_BATCH_CAPACITY];
+	uint64_t again_wait_us = MUXER_WORKER_AGAIN_MIN_WAIT_US;
+
+	while (true) {
+		bool made_progress = false;
+		bool got_again = false;
+		guint i;
+
+		pthread_mutex_lock(&worker->lock);
+
+		if (worker->quit) {
+			pthread_mutex_unlock(&worker->lock);
+			break;
+		}
+
+		for (i = 0; i < worker->new_upstream_notif_iters->len; i++) {
+			g_ptr_array_add(worker->upstream_notif_iters,
+				g_ptr_array_index(
+					worker->new_upstream_notif_iters, i));
+		}
+
+		g_ptr_array_set_size(worker->new_upstream_notif_iters, 0);
+		pthread_mutex_unlock(&worker->lock);
+
+		i = 0;
+
+		while (i < worker->upstream_notif_iters->len) {
+			struct muxer_upstream_notif_iter *muxer_upstream_notif_iter =
+				g_ptr_array_index(worker->upstream_notif_iters,
+					i);
+
+			switch (muxer_worker_advance(worker,
+					muxer_upstream_notif_iter, notifs)) {
+			case MUXER_WORKER_ADVANCE_STATUS_PUSHED:
+				made_progress = true;
+				i++;
+				break;
+			case MUXER_WORKER_ADVANCE_STATUS_AGAIN:
+				got_again = true;
+				i++;
+				break;
+			case MUXER_WORKER_ADVANCE_STATUS_FULL:
+				i++;
+				break;
+			case MUXER_WORKER_ADVANCE_STATUS_DONE:
+				/*
+				 * Removed from the array: another upstream
+				 * notification iterator is now at index i.
+				 */
+				made_progress = true;
+				break;
+			}
+		}
+
+		if (made_progress) {
+			again_wait_us = MUXER_WORKER_AGAIN_MIN_WAIT_US;
+			continue;
+		}
+
+		if (got_again) {
+			muxer_worker_wait_again(worker, again_wait_us);
+			again_wait_us = MIN(again_wait_us * 2,
+				MUXER_WORKER_AGAIN_MAX_WAIT_US);
+		} else {
+			muxer_worker_wait(worker);
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Stops and destroys a worker. The worker does not access its upstream
+ * notification iterators anymore when this function returns.
+ */
+static
+void destroy_muxer_worker(struct muxer_worker *worker)
+{
+	if (!worker) {
+		return;
+	}
+
+	pthread_mutex_lock(&worker->lock);
+	worker->quit = true;
+	pthread_cond_signal(&worker->cond);
+	pthread_mutex_unlock(&worker->lock);
+	(void) pthread_join(worker->thread, NULL);
+	g_ptr_array_free(worker->upstream_notif_iters, TRUE);
+	g_ptr_array_free(worker->new_upstream_notif_iters, TRUE);
+	(void) pthread_cond_destroy(&worker->cond);
+	(void) pthread_mutex_destroy(&worker->lock);
+	g_free(worker);
+}
+
+static
+struct muxer_worker *create_muxer_worker(
+		struct muxer_notif_iter *muxer_notif_iter)
+{
+	struct muxer_worker *worker = g_new0(struct muxer_worker, 1);
+
+	if (!worker) {
+		goto end;
+	}
+
+	worker->muxer_notif_iter = muxer_notif_iter;
+	worker->upstream_notif_iters = g_ptr_array_new();
+	if (!worker->upstream_notif_iters) {
+		goto error_free;
+	}
+
+	worker->new_upstream_notif_iters = g_ptr_array_new();
+	if (!worker->new_upstream_notif_iters) {
+		goto error_free;
+	}
+
+	if (pthread_mutex_init(&worker->lock, NULL)) {
+		goto error_free;
+	}
+
+	if (pthread_cond_init(&worker->cond, NULL)) {
+		goto error_destroy_lock;
+	}
+
+	if (pthread_create(&worker->thread, NULL, muxer_worker_thread,
+			worker)) {
+		goto error_destroy_cond;
+	}
+
+	goto end;
+
+error_destroy_cond:
+	(void) pthread_cond_destroy(&worker->cond);
+
+error_destroy_lock:
+	(void) pthread_mutex_destroy(&worker->lock);
+
+error_free:
+	if (worker->upstream_notif_iters) {
+		g_ptr_array_free(worker->upstream_notif_iters, TRUE);
+	}
+
+	if (worker->new_upstream_notif_iters) {
+		g_ptr_array_free(worker->new_upstream_notif_iters, TRUE);
+	}
+
+	g_free(worker);
+	worker = NULL;
+
+end:
+	return worker;
+}
+
+/*
+ * Assigns `muxer_upstream_notif_iter` to a worker of
+ * `muxer_notif_iter`, creating it if there are less than nr_threads
+ * workers. From this point, the worker advances its upstream
+ * notification iterator.
+ */
+static
+int muxer_notif_iter_assign_worker(struct muxer_notif_iter *muxer_notif_iter,
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
+{
+	struct muxer_worker *worker;
+	int ret = 0;
+
+	assert(muxer_notif_iter->workers);
+
+	if (muxer_notif_iter->workers->len < muxer_notif_iter->nr_threads) {
+		worker = create_muxer_worker(muxer_notif_iter);
+		if (!worker) {
+			ret = -1;
+			goto end;
+		}
+
+		g_ptr_array_add(muxer_notif_iter->workers, worker);
+	} else {
+		worker = g_ptr_array_index(muxer_notif_iter->workers,
+			muxer_notif_iter->next_worker_index %
+				muxer_notif_iter->workers->len);
+		muxer_notif_iter->next_worker_index++;
+	}
+
+	muxer_upstream_notif_iter->worker = worker;
+	muxer_upstream_notif_iter->worker_again = false;
+	muxer_upstream_notif_iter->worker_done = false;
+	pthread_mutex_lock(&worker->lock);
+	g_ptr_array_add(worker->new_upstream_notif_iters,
+		muxer_upstream_notif_iter);
+	pthread_cond_signal(&worker->cond);
+	pthread_mutex_unlock(&worker->lock);
+
+end:
+	return ret;
+}
+
+/*
+ * Stops and destroys all the workers of `muxer_notif_iter`. Its
+ * upstream notification iterators can be assigned to new workers
+ * after a call to muxer_upstream_notif_iter_reset_worker_state().
+ */
+static
+void muxer_notif_iter_stop_workers(struct muxer_notif_iter *muxer_notif_iter)
+{
+	if (!muxer_notif_iter->workers) {
+		return;
+	}
+
+	/* The array's free function destroys each worker */
+	g_ptr_array_set_size(muxer_notif_iter->workers, 0);
+	muxer_notif_iter->next_worker_index = 0;
+}
+
+/*
+ * Stops the workers of `muxer_notif_iter` if one of them advances an
+ * upstream notification iterator created on `priv_port`, which is being
+ * disconnected: the graph finalizes this upstream notification iterator
+ * on this thread as soon as the muxer component handles the
+ * disconnection, so that no worker may be advancing it then.
+ *
+ * The notifications which the stopped workers pushed are kept. The
+ * upstream notification iterator of `priv_port` is done, as if it
+ * returned BT_NOTIFICATION_ITERATOR_STATUS_CANCELED, and the other
+ * upstream notification iterators are assigned to new workers.
+ */
+static
+void muxer_notif_iter_stop_port_workers(
+		struct muxer_notif_iter *muxer_notif_iter,
+		struct bt_private_port *priv_port)
+{
+	struct muxer_upstream_notif_iter *muxer_upstream_notif_iter;
+	bool port_is_advanced = false;
+	guint i;
+
+	if (!muxer_notif_iter->workers) {
+		return;
+	}
+
+	for (i = 0; i < muxer_notif_iter->muxer_upstream_notif_iters->len; i++) {
+		muxer_upstream_notif_iter = g_ptr_array_index(
+			muxer_notif_iter->muxer_upstream_notif_iters, i);
+
+		if (muxer_upstream_notif_iter->priv_port == priv_port &&
+				muxer_upstream_notif_iter->worker &&
+				!__atomic_load_n(
+					&muxer_upstream_notif_iter->worker_done,
+					__ATOMIC_ACQUIRE)) {
+			port_is_advanced = true;
+			break;
+		}
+	}
+
+	if (!port_is_advanced) {
+		return;
+	}
+
+	muxer_notif_iter_stop_workers(muxer_notif_iter);
+
+	/* The workers are joined: their states are not shared anymore */
+	for (i = 0; i < muxer_notif_iter->muxer_upstream_notif_iters->len; i++) {
+		muxer_upstream_notif_iter = g_ptr_array_index(
+			muxer_notif_iter->muxer_upstream_notif_iters, i);
+
+		if (!muxer_upstream_notif_iter->worker ||
+				muxer_upstream_notif_iter->worker_done) {
+			continue;
+		}
+
+		if (muxer_upstream_notif_iter->priv_port == priv_port) {
+			muxer_upstream_notif_iter->worker_status =
+				BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
+			muxer_upstream_notif_iter->worker_done = true;
+			continue;
+		}
+
+		if (muxer_notif_iter_assign_worker(muxer_notif_iter,
+				muxer_upstream_notif_iter)) {
+			muxer_upstream_notif_iter->worker_status =
+				BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			muxer_upstream_notif_iter->worker_done = true;
+		}
+	}
+}
+
+/*
+ * Discards the notifications which the (stopped) worker of
+ * `muxer_upstream_notif_iter` pushed and unassigns it from this
+ * worker.
+ */
+static
+void muxer_upstream_notif_iter_reset_worker_state(
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
+{
+	struct bt_notification *notif;
+
+	if (!muxer_upstream_notif_iter->ring.slots) {
+		return;
+	}
+
+	while ((notif = bt_spsc_ring_pop(&muxer_upstream_notif_iter->ring))) {
+		bt_put(notif);
+	}
+
+	BT_PUT(muxer_upstream_notif_iter->notif);
+	muxer_upstream_notif_iter->worker = NULL;
+	muxer_upstream_notif_iter->worker_again = false;
+	muxer_upstream_notif_iter->worker_done = false;
+}
+
 static
 void destroy_muxer_upstream_notif_iter(
 		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
@@ -133,6 +837,12 @@ void destroy_muxer_upstream_notif_iter(
 		return;
 	}
 
+	muxer_upstream_notif_iter_reset_worker_state(muxer_upstream_notif_iter);
+
+	if (muxer_upstream_notif_iter->ring.slots) {
+		bt_spsc_ring_fini(&muxer_upstream_notif_iter->ring);
+	}
+
 	bt_put(muxer_upstream_notif_iter->notif_iter);
 	g_free(muxer_upstream_notif_iter);
 }
@@ -151,9 +861,30 @@ struct muxer_upstream_notif_iter *muxer_notif_iter_add_upstream_notif_iter(
 	}
 
 	muxer_upstream_notif_iter->notif_iter = bt_get(notif_iter);
+	muxer_upstream_notif_iter->priv_port = priv_port;
 	muxer_upstream_notif_iter->is_valid = false;
+
+	if (muxer_notif_iter->workers) {
+		if (bt_spsc_ring_init(&muxer_upstream_notif_iter->ring,
+				MUXER_UPSTREAM_RING_CAPACITY)) {
+			goto error;
+		}
+
+		if (muxer_notif_iter_assign_worker(muxer_notif_iter,
+				muxer_upstream_notif_iter)) {
+			goto error;
+		}
+	}
+
 	g_ptr_array_add(muxer_notif_iter->muxer_upstream_notif_iters,
 		muxer_upstream_notif_iter);
+	g_queue_push_tail(muxer_notif_iter->invalid_muxer_upstream_notif_iters,
+		muxer_upstream_notif_iter);
+	goto end;
+
+error:
+	destroy_muxer_upstream_notif_iter(muxer_upstream_notif_iter);
+	muxer_upstream_notif_iter = NULL;
 
 end:
 	return muxer_upstream_notif_iter;
@@ -237,6 +968,11 @@ struct bt_value *get_default_params(void)
 		goto error;
 	}
 
+	ret = bt_value_map_insert_integer(params, THREADS_PARAM_NAME, 0);
+	if (ret) {
+		goto error;
+	}
+
 	goto end;
 
 error:
@@ -252,8 +988,10 @@ int configure_muxer_comp(struct muxer_comp *muxer_comp, struct bt_value *params)
 	struct bt_value *default_params = NULL;
 	struct bt_value *real_params = NULL;
 	struct bt_value *assume_absolute_clock_classes = NULL;
+	struct bt_value *threads = NULL;
 	int ret = 0;
 	bt_bool bool_val;
+	int64_t int_val;
 
 	default_params = get_default_params();
 	if (!default_params) {
@@ -276,7 +1014,16 @@ int configure_muxer_comp(struct muxer_comp *muxer_comp, struct bt_value *params)
 	}
 
 	muxer_comp->assume_absolute_clock_classes = (bool) bool_val;
+	threads = bt_value_map_get(real_params, THREADS_PARAM_NAME);
+	if (!bt_value_is_integer(threads)) {
+		goto error;
+	}
+
+	if (bt_value_integer_get(threads, &int_val) || int_val < 0) {
+		goto error;
+	}
 
+	muxer_comp->nr_threads = (uint64_t) int_val;
 	goto end;
 
 error:
@@ -286,6 +1033,7 @@ end:
 	bt_put(default_params);
 	bt_put(real_params);
 	bt_put(assume_absolute_clock_classes);
+	bt_put(threads);
 	return ret;
 }
 
@@ -346,53 +1094,138 @@ void muxer_finalize(struct bt_private_component *priv_comp)
 	struct muxer_comp *muxer_comp =
 		bt_private_component_get_user_data(priv_comp);
 
-	destroy_muxer_comp(muxer_comp);
+	destroy_muxer_comp(muxer_comp);
+}
+
+static
+struct bt_notification_iterator *create_notif_iter_on_input_port(
+		struct bt_private_port *priv_port, int *ret)
+{
+	struct bt_port *port = bt_port_from_private_port(priv_port);
+	struct bt_notification_iterator *notif_iter = NULL;
+	struct bt_private_connection *priv_conn = NULL;
+	enum bt_connection_status conn_status;
+
+	assert(ret);
+	*ret = 0;
+	assert(port);
+
+	assert(bt_port_is_connected(port));
+	priv_conn = bt_private_port_get_private_connection(priv_port);
+	if (!priv_conn) {
+		*ret = -1;
+		goto end;
+	}
+
+	// TODO: Advance the iterator to >= the time of the latest
+	//       returned notification by the muxer notification
+	//       iterator which creates it.
+	conn_status = bt_private_connection_create_notification_iterator(
+		priv_conn, NULL, &notif_iter);
+	if (conn_status != BT_CONNECTION_STATUS_OK) {
+		*ret = -1;
+		goto end;
+	}
+
+end:
+	bt_put(port);
+	bt_put(priv_conn);
+	return notif_iter;
+}
+
+/*
+ * Makes the next notification which the worker of
+ * `muxer_upstream_notif_iter` pushed its current notification. Waits
+ * for the worker if it did not push anything yet.
+ */
+static
+enum bt_notification_iterator_status muxer_upstream_notif_iter_next_from_worker(
+		struct muxer_notif_iter *muxer_notif_iter,
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
+{
+	enum bt_notification_iterator_status status;
+
+	BT_PUT(muxer_upstream_notif_iter->notif);
+
+	while (true) {
+		muxer_upstream_notif_iter->notif =
+			bt_spsc_ring_pop(&muxer_upstream_notif_iter->ring);
+		if (muxer_upstream_notif_iter->notif) {
+			/*
+			 * A worker which is done with this upstream
+			 * notification iterator could be destroyed.
+			 */
+			if (!__atomic_load_n(
+					&muxer_upstream_notif_iter->worker_done,
+					__ATOMIC_ACQUIRE)) {
+				muxer_worker_wake(
+					muxer_upstream_notif_iter->worker);
+			}
+
+			status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+			break;
+		}
+
+		if (__atomic_load_n(&muxer_upstream_notif_iter->worker_done,
+				__ATOMIC_ACQUIRE)) {
+			/*
+			 * The worker could push notifications after our
+			 * last pop and before being done.
+			 */
+			if (!bt_spsc_ring_is_empty(
+					&muxer_upstream_notif_iter->ring)) {
+				continue;
+			}
+
+			status = muxer_upstream_notif_iter->worker_status;
+			break;
+		}
+
+		if (__atomic_load_n(&muxer_upstream_notif_iter->worker_again,
+				__ATOMIC_ACQUIRE)) {
+			/*
+			 * Our caller retries later: make the worker
+			 * retry the upstream notification iterator
+			 * without waiting for the end of its backoff.
+			 */
+			muxer_worker_wake(muxer_upstream_notif_iter->worker);
+			status = BT_NOTIFICATION_ITERATOR_STATUS_AGAIN;
+			break;
+		}
+
+		muxer_notif_iter_wait_for_worker(muxer_notif_iter,
+			muxer_upstream_notif_iter);
+	}
+
+	return status;
 }
 
 static
-struct bt_notification_iterator *create_notif_iter_on_input_port(
-		struct bt_private_port *priv_port, int *ret)
+struct bt_notification *muxer_upstream_notif_iter_get_notification(
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
 {
-	struct bt_port *port = bt_port_from_private_port(priv_port);
-	struct bt_notification_iterator *notif_iter = NULL;
-	struct bt_private_connection *priv_conn = NULL;
-	enum bt_connection_status conn_status;
-
-	assert(ret);
-	*ret = 0;
-	assert(port);
-
-	assert(bt_port_is_connected(port));
-	priv_conn = bt_private_port_get_private_connection(priv_port);
-	if (!priv_conn) {
-		*ret = -1;
-		goto end;
-	}
-
-	// TODO: Advance the iterator to >= the time of the latest
-	//       returned notification by the muxer notification
-	//       iterator which creates it.
-	conn_status = bt_private_connection_create_notification_iterator(
-		priv_conn, NULL, &notif_iter);
-	if (conn_status != BT_CONNECTION_STATUS_OK) {
-		*ret = -1;
-		goto end;
+	if (muxer_upstream_notif_iter->worker) {
+		return bt_get(muxer_upstream_notif_iter->notif);
 	}
 
-end:
-	bt_put(port);
-	bt_put(priv_conn);
-	return notif_iter;
+	return bt_notification_iterator_get_notification(
+		muxer_upstream_notif_iter->notif_iter);
 }
 
 static
 enum bt_notification_iterator_status muxer_upstream_notif_iter_next(
+		struct muxer_notif_iter *muxer_notif_iter,
 		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
 {
 	enum bt_notification_iterator_status status;
 
-	status = bt_notification_iterator_next(
-		muxer_upstream_notif_iter->notif_iter);
+	if (muxer_upstream_notif_iter->worker) {
+		status = muxer_upstream_notif_iter_next_from_worker(
+			muxer_notif_iter, muxer_upstream_notif_iter);
+	} else {
+		status = bt_notification_iterator_next(
+			muxer_upstream_notif_iter->notif_iter);
+	}
 
 	switch (status) {
 	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
@@ -411,10 +1244,19 @@ enum bt_notification_iterator_status muxer_upstream_notif_iter_next(
 		 */
 		muxer_upstream_notif_iter->is_valid = false;
 		break;
-	case BT_NOTIFICATION_ITERATOR_STATUS_END:	/* Fall-through. */
+	case BT_NOTIFICATION_ITERATOR_STATUS_END:
+		/*
+		 * Notification iterator reached the end: keep it (we
+		 * could seek it later), but it won't be considered
+		 * again to find the youngest notification.
+		 */
+		muxer_upstream_notif_iter->is_ended = true;
+		muxer_upstream_notif_iter->is_valid = false;
+		status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+		break;
 	case BT_NOTIFICATION_ITERATOR_STATUS_CANCELED:
 		/*
-		 * Notification iterator reached the end: release it. It
+		 * Notification iterator is canceled: release it. It
 		 * won't be considered again to find the youngest
 		 * notification.
 		 */
@@ -672,133 +1514,133 @@ end:
 }
 
 /*
- * This function finds the youngest available notification amongst the
- * non-ended upstream notification iterators and returns the upstream
- * notification iterator which has it, or
- * BT_NOTIFICATION_ITERATOR_STATUS_END if there's no available
- * notification.
- *
- * This function does NOT:
- *
- * * Update any upstream notification iterator.
- * * Check for newly connected ports.
- * * Check the upstream notification iterators to retry.
- *
- * On sucess, this function sets *muxer_upstream_notif_iter to the
- * upstream notification iterator of which the current notification is
- * the youngest, and sets *ts_ns to its time.
+ * Heap comparison function: returns true if the current notification
+ * of `a` is younger than the current notification of `b`. When both
+ * notifications have the same time, the most recently inserted
+ * upstream notification iterator wins.
  */
 static
-enum bt_notification_iterator_status
-muxer_notif_iter_youngest_upstream_notif_iter(
-		struct muxer_comp *muxer_comp,
-		struct muxer_notif_iter *muxer_notif_iter,
-		struct muxer_upstream_notif_iter **muxer_upstream_notif_iter,
-		int64_t *ts_ns)
+int muxer_upstream_notif_iter_gt(void *a, void *b)
 {
-	size_t i;
-	int ret;
-	int64_t youngest_ts_ns = INT64_MAX;
-	enum bt_notification_iterator_status status =
-		BT_NOTIFICATION_ITERATOR_STATUS_OK;
-
-	assert(muxer_comp);
-	assert(muxer_notif_iter);
-	assert(muxer_upstream_notif_iter);
-	*muxer_upstream_notif_iter = NULL;
-
-	for (i = 0; i < muxer_notif_iter->muxer_upstream_notif_iters->len; i++) {
-		struct bt_notification *notif;
-		struct muxer_upstream_notif_iter *cur_muxer_upstream_notif_iter =
-			g_ptr_array_index(muxer_notif_iter->muxer_upstream_notif_iters, i);
-		int64_t notif_ts_ns;
-
-		if (!cur_muxer_upstream_notif_iter->notif_iter) {
-			/* This upstream notification iterator is ended */
-			continue;
-		}
-
-		assert(cur_muxer_upstream_notif_iter->is_valid);
-		notif = bt_notification_iterator_get_notification(
-			cur_muxer_upstream_notif_iter->notif_iter);
-		assert(notif);
-		ret = get_notif_ts_ns(muxer_comp, muxer_notif_iter, notif,
-			muxer_notif_iter->last_returned_ts_ns, &notif_ts_ns);
-		bt_put(notif);
-		if (ret) {
-			*muxer_upstream_notif_iter = NULL;
-			status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
-			goto end;
-		}
-
-		if (notif_ts_ns <= youngest_ts_ns) {
-			*muxer_upstream_notif_iter =
-				cur_muxer_upstream_notif_iter;
-			youngest_ts_ns = notif_ts_ns;
-			*ts_ns = youngest_ts_ns;
-		}
-	}
+	struct muxer_upstream_notif_iter *iter_a = a;
+	struct muxer_upstream_notif_iter *iter_b = b;
 
-	if (!*muxer_upstream_notif_iter) {
-		status = BT_NOTIFICATION_ITERATOR_STATUS_END;
-		*ts_ns = INT64_MIN;
+	if (iter_a->ts_ns != iter_b->ts_ns) {
+		return iter_a->ts_ns < iter_b->ts_ns;
 	}
 
-end:
-	return status;
+	return iter_a->heap_seq > iter_b->heap_seq;
 }
 
+/*
+ * Removes `muxer_upstream_notif_iter` from `array` without destroying
+ * it: its slot is set to NULL first so that the array's free function
+ * is not called with it.
+ */
 static
-enum bt_notification_iterator_status validate_muxer_upstream_notif_iter(
-	struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
+void steal_muxer_upstream_notif_iter(GPtrArray *array,
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
 {
-	enum bt_notification_iterator_status status =
-		BT_NOTIFICATION_ITERATOR_STATUS_OK;
-
-	if (muxer_upstream_notif_iter->is_valid ||
-			!muxer_upstream_notif_iter->notif_iter) {
-		goto end;
-	}
+	size_t i;
 
-	status = muxer_upstream_notif_iter_next(muxer_upstream_notif_iter);
+	for (i = 0; i < array->len; i++) {
+		if (g_ptr_array_index(array, i) == muxer_upstream_notif_iter) {
+			g_ptr_array_index(array, i) = NULL;
 
-end:
-	return status;
+			/*
+			 * Use g_ptr_array_remove_index_fast() because
+			 * the order of those elements is not important.
+			 */
+			g_ptr_array_remove_index_fast(array, i);
+			break;
+		}
+	}
 }
 
+/*
+ * Validates the invalid upstream notification iterators of
+ * `muxer_notif_iter`: each one is advanced and, if its new current
+ * notification is valid, it is inserted into the heap of valid
+ * upstream notification iterators with the time of this notification.
+ * Ended and canceled upstream notification iterators are removed from
+ * muxer_upstream_notif_iters.
+ *
+ * If an upstream notification iterator returns
+ * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN, it stays in the list of
+ * invalid upstream notification iterators and this function returns
+ * this status immediately.
+ */
 static
 enum bt_notification_iterator_status validate_muxer_upstream_notif_iters(
-	struct muxer_notif_iter *muxer_notif_iter)
+		struct muxer_comp *muxer_comp,
+		struct muxer_notif_iter *muxer_notif_iter)
 {
 	enum bt_notification_iterator_status status =
 		BT_NOTIFICATION_ITERATOR_STATUS_OK;
-	size_t i;
+	GQueue *invalid_iters =
+		muxer_notif_iter->invalid_muxer_upstream_notif_iters;
 
-	for (i = 0; i < muxer_notif_iter->muxer_upstream_notif_iters->len; i++) {
+	while (!g_queue_is_empty(invalid_iters)) {
 		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter =
-			g_ptr_array_index(
-				muxer_notif_iter->muxer_upstream_notif_iters,
-				i);
+			g_queue_peek_head(invalid_iters);
+		struct bt_notification *notif;
+		int ret;
 
-		status = validate_muxer_upstream_notif_iter(
+		assert(!muxer_upstream_notif_iter->is_valid);
+		assert(muxer_upstream_notif_iter->notif_iter);
+		assert(!muxer_upstream_notif_iter->is_ended);
+		status = muxer_upstream_notif_iter_next(muxer_notif_iter,
 			muxer_upstream_notif_iter);
 		if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
 			goto end;
 		}
 
-		/*
-		 * Remove this muxer upstream notification iterator
-		 * if it's ended or canceled.
-		 */
+		(void) g_queue_pop_head(invalid_iters);
+
 		if (!muxer_upstream_notif_iter->notif_iter) {
+			/* Canceled: destroy it */
+			g_ptr_array_remove_fast(
+				muxer_notif_iter->muxer_upstream_notif_iters,
+				muxer_upstream_notif_iter);
+			continue;
+		}
+
+		if (muxer_upstream_notif_iter->is_ended) {
 			/*
-			 * Use g_ptr_array_remove_fast() because the
-			 * order of those elements is not important.
+			 * Keep an ended one in
+			 * ended_muxer_upstream_notif_iters for a future
+			 * seek operation.
 			 */
-			g_ptr_array_remove_index_fast(
+			steal_muxer_upstream_notif_iter(
 				muxer_notif_iter->muxer_upstream_notif_iters,
-				i);
-			i--;
+				muxer_upstream_notif_iter);
+			g_ptr_array_add(
+				muxer_notif_iter->ended_muxer_upstream_notif_iters,
+				muxer_upstream_notif_iter);
+			continue;
+		}
+
+		assert(muxer_upstream_notif_iter->is_valid);
+		notif = muxer_upstream_notif_iter_get_notification(
+			muxer_upstream_notif_iter);
+		assert(notif);
+		ret = get_notif_ts_ns(muxer_comp, muxer_notif_iter, notif,
+			muxer_notif_iter->last_returned_ts_ns,
+			&muxer_upstream_notif_iter->ts_ns);
+		bt_put(notif);
+		if (ret) {
+			status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto end;
+		}
+
+		muxer_upstream_notif_iter->heap_seq =
+			muxer_notif_iter->next_heap_seq++;
+		ret = bt_heap_insert(
+			&muxer_notif_iter->valid_muxer_upstream_notif_iters,
+			muxer_upstream_notif_iter);
+		if (ret) {
+			status = BT_NOTIFICATION_ITERATOR_STATUS_NOMEM;
+			goto end;
 		}
 	}
 
@@ -829,7 +1671,8 @@ struct bt_notification_iterator_next_return muxer_notif_iter_do_next(
 		}
 
 		next_return.status =
-			validate_muxer_upstream_notif_iters(muxer_notif_iter);
+			validate_muxer_upstream_notif_iters(muxer_comp,
+				muxer_notif_iter);
 		if (next_return.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
 			goto end;
 		}
@@ -849,39 +1692,51 @@ struct bt_notification_iterator_next_return muxer_notif_iter_do_next(
 
 	assert(!muxer_notif_iter->newly_connected_priv_ports);
 
+	assert(g_queue_is_empty(
+		muxer_notif_iter->invalid_muxer_upstream_notif_iters));
+
 	/*
 	 * At this point we know that all the existing upstream
-	 * notification iterators are valid. We can find the one,
-	 * amongst those, of which the current notification is the
-	 * youngest.
+	 * notification iterators are valid, and therefore in the heap.
+	 * The heap's maximum is the one of which the current
+	 * notification is the youngest.
 	 */
-	next_return.status =
-		muxer_notif_iter_youngest_upstream_notif_iter(muxer_comp,
-			muxer_notif_iter, &muxer_upstream_notif_iter,
-			&next_return_ts);
-	if (next_return.status < 0 ||
-			next_return.status == BT_NOTIFICATION_ITERATOR_STATUS_END ||
-			next_return.status == BT_NOTIFICATION_ITERATOR_STATUS_CANCELED) {
+	muxer_upstream_notif_iter = bt_heap_maximum(
+		&muxer_notif_iter->valid_muxer_upstream_notif_iters);
+	if (!muxer_upstream_notif_iter) {
+		next_return.status = BT_NOTIFICATION_ITERATOR_STATUS_END;
 		goto end;
 	}
 
+	next_return_ts = muxer_upstream_notif_iter->ts_ns;
 	if (next_return_ts < muxer_notif_iter->last_returned_ts_ns) {
 		next_return.status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
 		goto end;
 	}
 
-	assert(next_return.status == BT_NOTIFICATION_ITERATOR_STATUS_OK);
-	assert(muxer_upstream_notif_iter);
-	next_return.notification = bt_notification_iterator_get_notification(
-		muxer_upstream_notif_iter->notif_iter);
+	if (muxer_upstream_notif_iter->worker) {
+		/* Move the current notification, the next one replaces it */
+		next_return.notification = muxer_upstream_notif_iter->notif;
+		muxer_upstream_notif_iter->notif = NULL;
+	} else {
+		next_return.notification =
+			bt_notification_iterator_get_notification(
+				muxer_upstream_notif_iter->notif_iter);
+	}
+
 	assert(next_return.notification);
 
 	/*
 	 * We invalidate the upstream notification iterator so that, the
 	 * next time this function is called,
-	 * validate_muxer_upstream_notif_iters() will make it valid.
+	 * validate_muxer_upstream_notif_iters() will make it valid and
+	 * insert it back into the heap.
 	 */
+	(void) bt_heap_remove(
+		&muxer_notif_iter->valid_muxer_upstream_notif_iters);
 	muxer_upstream_notif_iter->is_valid = false;
+	g_queue_push_tail(muxer_notif_iter->invalid_muxer_upstream_notif_iters,
+		muxer_upstream_notif_iter);
 	muxer_notif_iter->last_returned_ts_ns = next_return_ts;
 
 end:
@@ -895,11 +1750,33 @@ void destroy_muxer_notif_iter(struct muxer_notif_iter *muxer_notif_iter)
 		return;
 	}
 
+	/*
+	 * Stop the workers first: they use the upstream notification
+	 * iterators.
+	 */
+	if (muxer_notif_iter->workers) {
+		g_ptr_array_free(muxer_notif_iter->workers, TRUE);
+		(void) pthread_cond_destroy(&muxer_notif_iter->consumer_cond);
+		(void) pthread_mutex_destroy(&muxer_notif_iter->consumer_lock);
+	}
+
 	if (muxer_notif_iter->muxer_upstream_notif_iters) {
 		g_ptr_array_free(
 			muxer_notif_iter->muxer_upstream_notif_iters, TRUE);
 	}
 
+	if (muxer_notif_iter->ended_muxer_upstream_notif_iters) {
+		g_ptr_array_free(
+			muxer_notif_iter->ended_muxer_upstream_notif_iters, TRUE);
+	}
+
+	if (muxer_notif_iter->invalid_muxer_upstream_notif_iters) {
+		g_queue_free(
+			muxer_notif_iter->invalid_muxer_upstream_notif_iters);
+	}
+
+	bt_heap_free(&muxer_notif_iter->valid_muxer_upstream_notif_iters);
+
 	g_list_free(muxer_notif_iter->newly_connected_priv_ports);
 	g_free(muxer_notif_iter);
 }
@@ -999,6 +1876,50 @@ enum bt_notification_iterator_status muxer_notif_iter_init(
 		goto error;
 	}
 
+	muxer_notif_iter->ended_muxer_upstream_notif_iters =
+		g_ptr_array_new_with_free_func(
+			(GDestroyNotify) destroy_muxer_upstream_notif_iter);
+	if (!muxer_notif_iter->ended_muxer_upstream_notif_iters) {
+		goto error;
+	}
+
+	muxer_notif_iter->invalid_muxer_upstream_notif_iters = g_queue_new();
+	if (!muxer_notif_iter->invalid_muxer_upstream_notif_iters) {
+		goto error;
+	}
+
+	ret = bt_heap_init(&muxer_notif_iter->valid_muxer_upstream_notif_iters,
+		0, muxer_upstream_notif_iter_gt);
+	if (ret) {
+		goto error;
+	}
+
+	if (muxer_comp->nr_threads > 0) {
+		muxer_notif_iter->nr_threads = muxer_comp->nr_threads;
+
+		if (pthread_mutex_init(&muxer_notif_iter->consumer_lock,
+				NULL)) {
+			goto error;
+		}
+
+		if (pthread_cond_init(&muxer_notif_iter->consumer_cond,
+				NULL)) {
+			(void) pthread_mutex_destroy(
+				&muxer_notif_iter->consumer_lock);
+			goto error;
+		}
+
+		muxer_notif_iter->workers = g_ptr_array_new_with_free_func(
+			(GDestroyNotify) destroy_muxer_worker);
+		if (!muxer_notif_iter->workers) {
+			(void) pthread_cond_destroy(
+				&muxer_notif_iter->consumer_cond);
+			(void) pthread_mutex_destroy(
+				&muxer_notif_iter->consumer_lock);
+			goto error;
+		}
+	}
+
 	/*
 	 * Add the muxer notification iterator to the component's array
 	 * of muxer notification iterators here because
@@ -1092,6 +2013,142 @@ end:
 	return next_ret;
 }
 
+BT_HIDDEN
+enum bt_notification_iterator_status muxer_notif_iter_next_batch(
+		struct bt_private_notification_iterator *priv_notif_iter,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	struct bt_notification_iterator_next_return next_ret = {
+		.notification = NULL,
+		.status = BT_NOTIFICATION_ITERATOR_STATUS_OK,
+	};
+	struct muxer_notif_iter *muxer_notif_iter =
+		bt_private_notification_iterator_get_user_data(priv_notif_iter);
+	struct bt_private_component *priv_comp = NULL;
+	struct muxer_comp *muxer_comp = NULL;
+
+	assert(muxer_notif_iter);
+	priv_comp = bt_private_notification_iterator_get_private_component(
+		priv_notif_iter);
+	assert(priv_comp);
+	muxer_comp = bt_private_component_get_user_data(priv_comp);
+	assert(muxer_comp);
+	*count = 0;
+
+	/*
+	 * Sort as many notifications as possible: the first non-OK
+	 * status (for example, an upstream iterator returning
+	 * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN) ends the batch, and
+	 * the notifications sorted so far are delivered before it.
+	 */
+	while (*count < capacity) {
+		/* Are we in an error state set elsewhere? */
+		if (unlikely(muxer_comp->error)) {
+			next_ret.status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			break;
+		}
+
+		next_ret = muxer_notif_iter_do_next(muxer_comp,
+			muxer_notif_iter);
+		if (next_ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			break;
+		}
+
+		notifications[*count] = next_ret.notification;
+		(*count)++;
+	}
+
+	bt_put(priv_comp);
+	return next_ret.status;
+}
+
+BT_HIDDEN
+enum bt_notification_iterator_status muxer_notif_iter_seek_time(
+		struct bt_private_notification_iterator *priv_notif_iter,
+		int64_t time)
+{
+	struct muxer_notif_iter *muxer_notif_iter =
+		bt_private_notification_iterator_get_user_data(priv_notif_iter);
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	size_t i;
+
+	assert(muxer_notif_iter);
+
+	/*
+	 * The workers must not advance the upstream iterators while
+	 * they seek: they are stopped, and new ones are created for
+	 * the new position.
+	 */
+	muxer_notif_iter_stop_workers(muxer_notif_iter);
+
+	/* All the upstream iterators become invalid */
+	while (bt_heap_remove(
+			&muxer_notif_iter->valid_muxer_upstream_notif_iters)) {
+		continue;
+	}
+
+	g_queue_clear(muxer_notif_iter->invalid_muxer_upstream_notif_iters);
+
+	/* Ended upstream iterators can become active again */
+	while (muxer_notif_iter->ended_muxer_upstream_notif_iters->len > 0) {
+		GPtrArray *ended_iters =
+			muxer_notif_iter->ended_muxer_upstream_notif_iters;
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter =
+			g_ptr_array_index(ended_iters, ended_iters->len - 1);
+
+		g_ptr_array_index(ended_iters, ended_iters->len - 1) = NULL;
+		g_ptr_array_remove_index(ended_iters, ended_iters->len - 1);
+		muxer_upstream_notif_iter->is_ended = false;
+		g_ptr_array_add(muxer_notif_iter->muxer_upstream_notif_iters,
+			muxer_upstream_notif_iter);
+	}
+
+	for (i = 0; i < muxer_notif_iter->muxer_upstream_notif_iters->len; i++) {
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter =
+			g_ptr_array_index(
+				muxer_notif_iter->muxer_upstream_notif_iters,
+				i);
+
+		muxer_upstream_notif_iter->is_ended = false;
+		muxer_upstream_notif_iter->is_valid = false;
+		muxer_upstream_notif_iter_reset_worker_state(
+			muxer_upstream_notif_iter);
+
+		if (!muxer_upstream_notif_iter->notif_iter) {
+			continue;
+		}
+
+		g_queue_push_tail(
+			muxer_notif_iter->invalid_muxer_upstream_notif_iters,
+			muxer_upstream_notif_iter);
+		status = bt_notification_iterator_seek_time(
+			muxer_upstream_notif_iter->notif_iter,
+			BT_NOTIFICATION_ITERATOR_SEEK_ORIGIN_EPOCH, time);
+		if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			goto end;
+		}
+
+		if (muxer_notif_iter->workers &&
+				muxer_notif_iter_assign_worker(muxer_notif_iter,
+					muxer_upstream_notif_iter)) {
+			status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto end;
+		}
+	}
+
+	/*
+	 * The upstream iterators are invalidated: the next "next"
+	 * operation gets their first notification at the new
+	 * position.
+	 */
+	muxer_notif_iter->last_returned_ts_ns = INT64_MIN;
+
+end:
+	return status;
+}
+
 BT_HIDDEN
 void muxer_port_connected(
 		struct bt_private_component *priv_comp,
@@ -1164,17 +2221,22 @@ void muxer_port_disconnected(struct bt_private_component *priv_comp,
 	assert(muxer_comp);
 
 	/*
-	 * There's nothing special to do when a port is disconnected
-	 * because this component deals with upstream notification
-	 * iterators which were already created thanks to connected
-	 * ports. The fact that the port is disconnected does not cancel
-	 * the upstream notification iterators created using its
-	 * connection: they still exist, even if the connection is dead.
-	 * The only way to remove an upstream notification iterator is
-	 * for its "next" operation to return
-	 * BT_NOTIFICATION_ITERATOR_STATUS_END.
+	 * The graph finalizes the upstream notification iterators
+	 * created on the connection of a disconnected input port right
+	 * after this call. Their "next" operation then returns
+	 * BT_NOTIFICATION_ITERATOR_STATUS_CANCELED, but the workers
+	 * must not be advancing them while they are finalized.
 	 */
 	if (bt_port_get_type(port) == BT_PORT_TYPE_INPUT) {
+		size_t i;
+
+		for (i = 0; i < muxer_comp->muxer_notif_iters->len; i++) {
+			muxer_notif_iter_stop_port_workers(
+				g_ptr_array_index(
+					muxer_comp->muxer_notif_iters, i),
+				priv_port);
+		}
+
 		/* One more available input port */
 		muxer_comp->available_input_ports++;
 	}
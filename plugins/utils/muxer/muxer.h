@@ -48,6 +48,17 @@ BT_HIDDEN
 struct bt_notification_iterator_next_return muxer_notif_iter_next(
 		struct bt_private_notification_iterator *priv_notif_iter);
 
+BT_HIDDEN
+enum bt_notification_iterator_status muxer_notif_iter_next_batch(
+		struct bt_private_notification_iterator *priv_notif_iter,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count);
+
+BT_HIDDEN
+enum bt_notification_iterator_status muxer_notif_iter_seek_time(
+		struct bt_private_notification_iterator *priv_notif_iter,
+		int64_t time);
+
 BT_HIDDEN
 void muxer_port_connected(
 		struct bt_private_component *priv_comp,
@@ -33,40 +33,14 @@
 #include <babeltrace/ctf-ir/stream-class.h>
 #include <babeltrace/ctf-ir/clock-class.h>
 #include <babeltrace/ctf-ir/fields.h>
+#include <babeltrace/ctf-ir/trace.h>
 #include <babeltrace/ctf-writer/stream-class.h>
 #include <babeltrace/ctf-writer/stream.h>
+#include <assert.h>
 
 #include <ctfcopytrace.h>
 #include "iterator.h"
 
-static
-struct bt_ctf_packet *lookup_packet(struct trimmer_iterator *trim_it,
-		struct bt_ctf_packet *packet)
-{
-	return (struct bt_ctf_packet *) g_hash_table_lookup(
-			trim_it->packet_map,
-			(gpointer) packet);
-}
-
-static
-struct bt_ctf_packet *insert_new_packet(struct trimmer_iterator *trim_it,
-		struct bt_ctf_packet *packet,
-		struct bt_ctf_stream *stream)
-{
-	struct bt_ctf_packet *writer_packet = NULL;
-
-	writer_packet = bt_ctf_packet_create(stream);
-	if (!writer_packet) {
-		fprintf(trim_it->err, "[error] %s in %s:%d\n", __func__,
-				__FILE__, __LINE__);
-		goto end;
-	}
-	g_hash_table_insert(trim_it->packet_map, (gpointer) packet, writer_packet);
-
-end:
-	return writer_packet;
-}
-
 BT_HIDDEN
 enum bt_component_status update_packet_context_field(FILE *err,
 		struct bt_ctf_packet *writer_packet,
@@ -175,23 +149,12 @@ struct bt_ctf_packet *trimmer_new_packet(
 		goto error;
 	}
 
-	/*
-	 * If a packet was already opened, close it and remove it from
-	 * the HT.
-	 */
-	writer_packet = lookup_packet(trim_it, packet);
-	if (writer_packet) {
-		g_hash_table_remove(trim_it->packet_map, packet);
-		BT_PUT(writer_packet);
-	}
-
-	writer_packet = insert_new_packet(trim_it, packet, stream);
+	writer_packet = bt_ctf_packet_create(stream);
 	if (!writer_packet) {
 		fprintf(trim_it->err, "[error] %s in %s:%d\n",
 				__func__, __FILE__, __LINE__);
 		goto error;
 	}
-	bt_get(writer_packet);
 
 	writer_packet_context = ctf_copy_packet_context(trim_it->err, packet,
 			stream);
@@ -218,35 +181,67 @@ end:
 	return writer_packet;
 }
 
-BT_HIDDEN
-struct bt_ctf_packet *trimmer_close_packet(
-		struct trimmer_iterator *trim_it,
-		struct bt_ctf_packet *packet)
+static
+int set_event_clock_value(struct trimmer_iterator *trim_it,
+		struct bt_ctf_event *event, struct bt_ctf_event *writer_event)
 {
-	struct bt_ctf_packet *writer_packet = NULL;
+	struct bt_ctf_event_class *event_class = NULL;
+	struct bt_ctf_stream_class *stream_class = NULL;
+	struct bt_ctf_trace *trace = NULL;
+	struct bt_ctf_clock_class *clock_class = NULL;
+	struct bt_ctf_clock_value *clock_value = NULL;
+	int ret = 0;
 
-	writer_packet = lookup_packet(trim_it, packet);
-	if (!writer_packet) {
+	event_class = bt_ctf_event_get_class(event);
+	assert(event_class);
+	stream_class = bt_ctf_event_class_get_stream_class(event_class);
+	assert(stream_class);
+	trace = bt_ctf_stream_class_get_trace(stream_class);
+	assert(trace);
+
+	/* FIXME multi-clock? */
+	clock_class = bt_ctf_trace_get_clock_class_by_index(trace, 0);
+	if (!clock_class) {
+		/* No clock. */
+		goto end;
+	}
+
+	clock_value = bt_ctf_event_get_clock_value(event, clock_class);
+	if (!clock_value) {
 		fprintf(trim_it->err, "[error] %s in %s:%d\n", __func__,
 				__FILE__, __LINE__);
-		goto end;
+		goto error;
+	}
+
+	/* Both events share the same trace, thus the same clocks. */
+	ret = bt_ctf_event_set_clock_value(writer_event, clock_value);
+	if (ret) {
+		fprintf(trim_it->err, "[error] %s in %s:%d\n", __func__,
+				__FILE__, __LINE__);
+		goto error;
 	}
 
-	g_hash_table_remove(trim_it->packet_map, packet);
+	goto end;
 
+error:
+	ret = -1;
 end:
-	return writer_packet;
+	bt_put(clock_value);
+	bt_put(clock_class);
+	bt_put(trace);
+	bt_put(stream_class);
+	bt_put(event_class);
+	return ret;
 }
 
 BT_HIDDEN
 struct bt_ctf_event *trimmer_output_event(
 		struct trimmer_iterator *trim_it,
-		struct bt_ctf_event *event)
+		struct bt_ctf_event *event,
+		struct bt_ctf_packet *writer_packet)
 {
 	struct bt_ctf_event_class *event_class = NULL;
 	struct bt_ctf_event *writer_event = NULL;
-	struct bt_ctf_packet *packet = NULL, *writer_packet = NULL;
-	const char *event_name;
 	int int_ret;
 
 	event_class = bt_ctf_event_get_class(event);
@@ -256,14 +251,11 @@ struct bt_ctf_event *trimmer_output_event(
 		goto error;
 	}
 
-	event_name = bt_ctf_event_class_get_name(event_class);
-	if (!event_name) {
-		fprintf(trim_it->err, "[error] %s in %s:%d\n", __func__,
-				__FILE__, __LINE__);
-		goto error;
-	}
-
-	writer_event = ctf_copy_event(trim_it->err, event, event_class, false);
+	/*
+	 * The writer event is only needed to be part of the writer
+	 * packet: it shares all the fields of the original event.
+	 */
+	writer_event = bt_ctf_event_create_extended(event_class, event);
 	if (!writer_event) {
 		fprintf(trim_it->err, "[error] %s in %s:%d\n", __func__,
 				__FILE__, __LINE__);
@@ -272,20 +264,12 @@ struct bt_ctf_event *trimmer_output_event(
 		goto error;
 	}
 
-	packet = bt_ctf_event_get_packet(event);
-	if (!packet) {
-		fprintf(trim_it->err, "[error] %s in %s:%d\n", __func__,
-				__FILE__, __LINE__);
-		goto error;
-	}
-
-	writer_packet = lookup_packet(trim_it, packet);
-	if (!writer_packet) {
+	int_ret = set_event_clock_value(trim_it, event, writer_event);
+	if (int_ret) {
 		fprintf(trim_it->err, "[error] %s in %s:%d\n", __func__,
 				__FILE__, __LINE__);
 		goto error;
 	}
-	bt_get(writer_packet);
 
 	int_ret = bt_ctf_event_set_packet(writer_event, writer_packet);
 	if (int_ret < 0) {
@@ -302,8 +286,6 @@ struct bt_ctf_event *trimmer_output_event(
 error:
 	BT_PUT(writer_event);
 end:
-	bt_put(writer_packet);
-	bt_put(packet);
 	bt_put(event_class);
 	return writer_event;
 }
@@ -35,14 +35,11 @@
 
 BT_HIDDEN
 struct bt_ctf_event *trimmer_output_event(struct trimmer_iterator *trim_it,
-		struct bt_ctf_event *event);
+		struct bt_ctf_event *event, struct bt_ctf_packet *writer_packet);
 BT_HIDDEN
 struct bt_ctf_packet *trimmer_new_packet(struct trimmer_iterator *trim_it,
 		struct bt_ctf_packet *packet);
 BT_HIDDEN
-struct bt_ctf_packet *trimmer_close_packet(struct trimmer_iterator *trim_it,
-		struct bt_ctf_packet *packet);
-BT_HIDDEN
 enum bt_component_status update_packet_context_field(FILE *err,
 		struct bt_ctf_packet *writer_packet,
 		const char *name, int64_t value);
@@ -51,6 +51,7 @@
 #include <babeltrace/ctf-ir/trace.h>
 #include <babeltrace/ctf-ir/fields.h>
 #include <assert.h>
+#include <inttypes.h>
 #include <plugins-common.h>
 
 #include "trimmer.h"
@@ -58,12 +59,12 @@
 #include "copy.h"
 
 static
-gboolean close_packets(gpointer key, gpointer value, gpointer user_data)
+void destroy_trimmer_packet(gpointer data)
 {
-	struct bt_ctf_packet *writer_packet = value;
+	struct trimmer_packet *trim_packet = data;
 
-	bt_put(writer_packet);
-	return TRUE;
+	bt_put(trim_packet->writer_packet);
+	g_free(trim_packet);
 }
 
 BT_HIDDEN
@@ -75,8 +76,6 @@ void trimmer_iterator_finalize(struct bt_private_notification_iterator *it)
 	assert(trim_it);
 
 	bt_put(trim_it->input_iterator);
-	g_hash_table_foreach_remove(trim_it->packet_map,
-			close_packets, NULL);
 	g_hash_table_destroy(trim_it->packet_map);
 	g_free(trim_it);
 }
@@ -124,7 +123,7 @@ enum bt_notification_iterator_status trimmer_iterator_init(
 
 	it_data->err = stderr;
 	it_data->packet_map = g_hash_table_new_full(g_direct_hash,
-			g_direct_equal, NULL, NULL);
+			g_direct_equal, NULL, destroy_trimmer_packet);
 
 	it_ret = bt_private_notification_iterator_set_user_data(iterator,
 		it_data);
@@ -198,6 +197,13 @@ error:
 	return -1;
 }
 
+static
+struct trimmer_packet *lookup_trimmer_packet(struct trimmer_iterator *trim_it,
+		struct bt_ctf_packet *packet)
+{
+	return g_hash_table_lookup(trim_it->packet_map, (gpointer) packet);
+}
+
 static
 struct bt_notification *evaluate_event_notification(
 		struct bt_notification *notification,
@@ -207,27 +213,47 @@ struct bt_notification *evaluate_event_notification(
 {
 	int64_t ts;
 	int clock_ret;
-	struct bt_ctf_event *event = NULL, *writer_event;
+	struct bt_ctf_event *event = NULL, *writer_event = NULL;
 	bool in_range = true;
 	struct bt_ctf_clock_class *clock_class = NULL;
 	struct bt_ctf_trace *trace = NULL;
 	struct bt_ctf_stream *stream = NULL;
 	struct bt_ctf_stream_class *stream_class = NULL;
 	struct bt_ctf_clock_value *clock_value = NULL;
+	struct bt_ctf_packet *packet = NULL;
+	struct trimmer_packet *trim_packet = NULL;
+	enum trimmer_packet_mode mode = TRIMMER_PACKET_MODE_CHECK_EVENTS;
 	bool lazy_update = false;
 	struct bt_notification *new_notification = NULL;
-	struct bt_clock_class_priority_map *cc_prio_map;
+	struct bt_clock_class_priority_map *cc_prio_map = NULL;
 
 	event = bt_notification_event_get_event(notification);
 	assert(event);
-	cc_prio_map = bt_notification_event_get_clock_class_priority_map(
-			notification);
-	assert(cc_prio_map);
-	writer_event = trimmer_output_event(trim_it, event);
-	assert(writer_event);
-	new_notification = bt_notification_event_create(writer_event, cc_prio_map);
-	assert(new_notification);
-	bt_put(cc_prio_map);
+
+	packet = bt_ctf_event_get_packet(event);
+	if (packet) {
+		trim_packet = lookup_trimmer_packet(trim_it, packet);
+		if (trim_packet) {
+			mode = trim_packet->mode;
+		}
+	}
+
+	/*
+	 * The time range of the packet tells whether or not its events
+	 * are in range: do not look at their timestamps.
+	 */
+	switch (mode) {
+	case TRIMMER_PACKET_MODE_FORWARD:
+		goto forward;
+	case TRIMMER_PACKET_MODE_DISCARD:
+		in_range = false;
+		if (trim_packet->after_range) {
+			*finished = true;
+		}
+		goto end;
+	default:
+		break;
+	}
 
 	stream = bt_ctf_event_get_stream(event);
 	assert(stream);
@@ -241,7 +267,7 @@ struct bt_notification *evaluate_event_notification(
 	/* FIXME multi-clock? */
 	clock_class = bt_ctf_trace_get_clock_class_by_index(trace, 0);
 	if (!clock_class) {
-		goto end;
+		goto forward;
 	}
 
 	clock_value = bt_ctf_event_get_clock_value(event, clock_class);
@@ -257,10 +283,10 @@ struct bt_notification *evaluate_event_notification(
 		goto error;
 	}
 	if (update_lazy_bound(begin, "begin", ts, &lazy_update)) {
-		goto end;
+		goto forward;
 	}
 	if (update_lazy_bound(end, "end", ts, &lazy_update)) {
-		goto end;
+		goto forward;
 	}
 	if (lazy_update && begin->set && end->set) {
 		if (begin->value > end->value) {
@@ -276,6 +302,27 @@ struct bt_notification *evaluate_event_notification(
 		*finished = true;
 	}
 
+	if (!in_range) {
+		/* Discarded: do not create anything for it */
+		goto end;
+	}
+
+forward:
+	if (mode != TRIMMER_PACKET_MODE_CLAMP) {
+		/* The event is not modified: forward it as is */
+		new_notification = bt_get(notification);
+		goto end;
+	}
+
+	/* The event must be part of the writer packet */
+	cc_prio_map = bt_notification_event_get_clock_class_priority_map(
+			notification);
+	assert(cc_prio_map);
+	writer_event = trimmer_output_event(trim_it, event,
+			trim_packet->writer_packet);
+	assert(writer_event);
+	new_notification = bt_notification_event_create(writer_event, cc_prio_map);
+	assert(new_notification);
 	goto end;
 
 error:
@@ -283,6 +330,8 @@ error:
 end:
 	bt_put(event);
 	bt_put(writer_event);
+	bt_put(packet);
+	bt_put(cc_prio_map);
 	bt_put(clock_class);
 	bt_put(trace);
 	bt_put(stream);
@@ -337,19 +386,6 @@ end:
 	return ret;
 }
 
-static uint64_t ns_from_value(uint64_t frequency, uint64_t value)
-{
-	uint64_t ns;
-
-	if (frequency == NSEC_PER_SEC) {
-		ns = value;
-	} else {
-		ns = (uint64_t) ((1e9 * (double) value) / (double) frequency);
-	}
-
-	return ns;
-}
-
 /*
  * timestamp minus the offset.
  */
@@ -358,12 +394,12 @@ int64_t get_raw_timestamp(struct bt_ctf_packet *writer_packet,
 		int64_t timestamp)
 {
 	struct bt_ctf_clock_class *writer_clock_class;
-	int64_t sec_offset, cycles_offset, ns;
+	struct bt_ctf_clock_value *offset_clock_value;
+	int64_t ns;
 	struct bt_ctf_trace *writer_trace;
 	struct bt_ctf_stream *writer_stream;
 	struct bt_ctf_stream_class *writer_stream_class;
 	int ret;
-	uint64_t freq;
 
 	writer_stream = bt_ctf_packet_get_stream(writer_packet);
 	assert(writer_stream);
@@ -379,18 +415,17 @@ int64_t get_raw_timestamp(struct bt_ctf_packet *writer_packet,
 		writer_trace, 0);
 	assert(writer_clock_class);
 
-	ret = bt_ctf_clock_class_get_offset_s(writer_clock_class, &sec_offset);
-	assert(!ret);
-	ns = sec_offset * NSEC_PER_SEC;
-
-	freq = bt_ctf_clock_class_get_frequency(writer_clock_class);
-	assert(freq != -1ULL);
-
-	ret = bt_ctf_clock_class_get_offset_cycles(writer_clock_class, &cycles_offset);
+	/*
+	 * The clock's offset, in ns from Epoch, is the time of its
+	 * value 0: let the library convert it exactly.
+	 */
+	offset_clock_value = bt_ctf_clock_value_create(writer_clock_class, 0);
+	assert(offset_clock_value);
+	ret = bt_ctf_clock_value_get_value_ns_from_epoch(offset_clock_value,
+		&ns);
 	assert(!ret);
 
-	ns += ns_from_value(freq, cycles_offset);
-
+	bt_put(offset_clock_value);
 	bt_put(writer_clock_class);
 	bt_put(writer_trace);
 	bt_put(writer_stream_class);
@@ -399,77 +434,92 @@ int64_t get_raw_timestamp(struct bt_ctf_packet *writer_packet,
 	return timestamp - ns;
 }
 
+/*
+ * Gets the time range of the packet `packet` from the timestamp_begin
+ * and timestamp_end fields of its context, in ns from Epoch.
+ *
+ * Returns 0 on success, or -1 if the packet's time range is unknown.
+ */
 static
-struct bt_notification *evaluate_packet_notification(
-		struct bt_notification *notification,
-		struct trimmer_iterator *trim_it,
-		struct trimmer_bound *begin, struct trimmer_bound *end,
-		bool *_packet_in_range, bool *finished)
+int get_packet_time_range(struct bt_ctf_packet *packet,
+		int64_t *pkt_begin_ns, int64_t *pkt_end_ns)
 {
-	int64_t begin_ns, pkt_begin_ns, end_ns, pkt_end_ns;
-	bool in_range = true;
-	struct bt_ctf_packet *packet = NULL, *writer_packet = NULL;
+	int ret = -1;
 	struct bt_ctf_field *packet_context = NULL,
 			*timestamp_begin = NULL,
 			*timestamp_end = NULL;
-	struct bt_notification *new_notification = NULL;
-	enum bt_component_status ret;
-	bool lazy_update = false;
-
-        switch (bt_notification_get_type(notification)) {
-	case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
-		packet = bt_notification_packet_begin_get_packet(notification);
-		assert(packet);
-		writer_packet = trimmer_new_packet(trim_it, packet);
-		assert(writer_packet);
-		break;
-	case BT_NOTIFICATION_TYPE_PACKET_END:
-		packet = bt_notification_packet_end_get_packet(notification);
-		assert(packet);
-		writer_packet = trimmer_close_packet(trim_it, packet);
-		assert(writer_packet);
-		break;
-	default:
-		goto end;
-	}
 
-	packet_context = bt_ctf_packet_get_context(writer_packet);
+	packet_context = bt_ctf_packet_get_context(packet);
 	if (!packet_context) {
-		goto end_no_notif;
+		goto end;
 	}
 
 	if (!bt_ctf_field_is_structure(packet_context)) {
-		goto end_no_notif;
+		goto end;
 	}
 
 	timestamp_begin = bt_ctf_field_structure_get_field(
 			packet_context, "timestamp_begin");
 	if (!timestamp_begin || !bt_ctf_field_is_integer(timestamp_begin)) {
-		goto end_no_notif;
+		goto end;
 	}
 	timestamp_end = bt_ctf_field_structure_get_field(
 			packet_context, "timestamp_end");
 	if (!timestamp_end || !bt_ctf_field_is_integer(timestamp_end)) {
-		goto end_no_notif;
+		goto end;
 	}
 
-	if (ns_from_integer_field(timestamp_begin, &pkt_begin_ns)) {
-		goto end_no_notif;
+	if (ns_from_integer_field(timestamp_begin, pkt_begin_ns)) {
+		goto end;
+	}
+	if (ns_from_integer_field(timestamp_end, pkt_end_ns)) {
+		goto end;
+	}
+
+	ret = 0;
+end:
+	bt_put(packet_context);
+	bt_put(timestamp_begin);
+	bt_put(timestamp_end);
+	return ret;
+}
+
+/*
+ * Decides how the notifications of the packet `packet`, which begins,
+ * are forwarded, and creates its writer packet if it needs one.
+ */
+static
+struct trimmer_packet *create_trimmer_packet(struct trimmer_iterator *trim_it,
+		struct bt_ctf_packet *packet,
+		struct trimmer_bound *begin, struct trimmer_bound *end)
+{
+	int64_t begin_ns, pkt_begin_ns, end_ns, pkt_end_ns;
+	struct trimmer_packet *trim_packet;
+	enum bt_component_status ret;
+	bool lazy_update = false;
+
+	trim_packet = g_new0(struct trimmer_packet, 1);
+	if (!trim_packet) {
+		BT_LOGE_STR("Failed to allocate one trimmer packet.");
+		goto error;
 	}
-	if (ns_from_integer_field(timestamp_end, &pkt_end_ns)) {
-		goto end_no_notif;
+
+	trim_packet->mode = TRIMMER_PACKET_MODE_CHECK_EVENTS;
+
+	if (get_packet_time_range(packet, &pkt_begin_ns, &pkt_end_ns)) {
+		goto end;
 	}
 
 	if (update_lazy_bound(begin, "begin", pkt_begin_ns, &lazy_update)) {
-		goto end_no_notif;
+		goto end;
 	}
 	if (update_lazy_bound(end, "end", pkt_end_ns, &lazy_update)) {
-		goto end_no_notif;
+		goto end;
 	}
 	if (lazy_update && begin->set && end->set) {
 		if (begin->value > end->value) {
 			BT_LOGE_STR("Unexpected: time range begin value is above end value");
-			goto end_no_notif;
+			goto end;
 		}
 	}
 
@@ -480,48 +530,121 @@ struct bt_notification *evaluate_packet_notification(
 	 * Accept if there is any overlap between the selected region and the
 	 * packet.
 	 */
-	in_range = (pkt_end_ns >= begin_ns) && (pkt_begin_ns <= end_ns);
-	if (!in_range) {
-		goto end_no_notif;
+	if (pkt_end_ns < begin_ns || pkt_begin_ns > end_ns) {
+		trim_packet->mode = TRIMMER_PACKET_MODE_DISCARD;
+		trim_packet->after_range = pkt_begin_ns > end_ns;
+		goto end;
 	}
-	if (pkt_begin_ns > end_ns) {
-		*finished = true;
+
+	if (begin_ns <= pkt_begin_ns && end_ns >= pkt_end_ns) {
+		trim_packet->mode = TRIMMER_PACKET_MODE_FORWARD;
+		goto end;
+	}
+
+	/* The packet's time range must be clamped to the selected region */
+	trim_packet->writer_packet = trimmer_new_packet(trim_it, packet);
+	if (!trim_packet->writer_packet) {
+		goto error;
 	}
 
+	trim_packet->mode = TRIMMER_PACKET_MODE_CLAMP;
+
 	if (begin_ns > pkt_begin_ns) {
-		ret = update_packet_context_field(trim_it->err, writer_packet,
+		ret = update_packet_context_field(trim_it->err,
+				trim_packet->writer_packet,
 				"timestamp_begin",
-				get_raw_timestamp(writer_packet, begin_ns));
+				get_raw_timestamp(trim_packet->writer_packet,
+					begin_ns));
 		assert(!ret);
 	}
 
 	if (end_ns < pkt_end_ns) {
-		ret = update_packet_context_field(trim_it->err, writer_packet,
+		ret = update_packet_context_field(trim_it->err,
+				trim_packet->writer_packet,
 				"timestamp_end",
-				get_raw_timestamp(writer_packet, end_ns));
+				get_raw_timestamp(trim_packet->writer_packet,
+					end_ns));
 		assert(!ret);
 	}
 
+	goto end;
+
+error:
+	if (trim_packet) {
+		destroy_trimmer_packet(trim_packet);
+		trim_packet = NULL;
+	}
 end:
-        switch (bt_notification_get_type(notification)) {
+	return trim_packet;
+}
+
+static
+struct bt_notification *evaluate_packet_notification(
+		struct bt_notification *notification,
+		struct trimmer_iterator *trim_it,
+		struct trimmer_bound *begin, struct trimmer_bound *end,
+		bool *_packet_in_range)
+{
+	bool in_range = true;
+	struct bt_ctf_packet *packet = NULL;
+	struct trimmer_packet *trim_packet;
+	struct bt_notification *new_notification = NULL;
+
+	switch (bt_notification_get_type(notification)) {
 	case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
-		new_notification = bt_notification_packet_begin_create(writer_packet);
-		assert(new_notification);
+		packet = bt_notification_packet_begin_get_packet(notification);
+		assert(packet);
+		trim_packet = create_trimmer_packet(trim_it, packet, begin,
+				end);
+		assert(trim_packet);
+
+		/* Replaces the packet's previous state, if any */
+		g_hash_table_insert(trim_it->packet_map, (gpointer) packet,
+				trim_packet);
 		break;
 	case BT_NOTIFICATION_TYPE_PACKET_END:
-		new_notification = bt_notification_packet_end_create(writer_packet);
+		packet = bt_notification_packet_end_get_packet(notification);
+		assert(packet);
+		trim_packet = lookup_trimmer_packet(trim_it, packet);
+		if (!trim_packet) {
+			/* Unknown packet: forward it as is */
+			new_notification = bt_get(notification);
+			goto end;
+		}
+		break;
+	default:
+		goto end;
+	}
+
+	switch (trim_packet->mode) {
+	case TRIMMER_PACKET_MODE_DISCARD:
+		in_range = false;
+		break;
+	case TRIMMER_PACKET_MODE_CLAMP:
+		if (bt_notification_get_type(notification) ==
+				BT_NOTIFICATION_TYPE_PACKET_BEGIN) {
+			new_notification = bt_notification_packet_begin_create(
+					trim_packet->writer_packet);
+		} else {
+			new_notification = bt_notification_packet_end_create(
+					trim_packet->writer_packet);
+		}
 		assert(new_notification);
 		break;
 	default:
+		/* The packet is not modified: forward it as is */
+		new_notification = bt_get(notification);
 		break;
 	}
-end_no_notif:
+
+	if (bt_notification_get_type(notification) ==
+			BT_NOTIFICATION_TYPE_PACKET_END) {
+		g_hash_table_remove(trim_it->packet_map, packet);
+	}
+
+end:
 	*_packet_in_range = in_range;
 	bt_put(packet);
-	bt_put(writer_packet);
-	bt_put(packet_context);
-	bt_put(timestamp_begin);
-	bt_put(timestamp_end);
 	return new_notification;
 }
 
@@ -530,13 +653,8 @@ struct bt_notification *evaluate_stream_notification(
 		struct bt_notification *notification,
 		struct trimmer_iterator *trim_it)
 {
-	struct bt_ctf_stream *stream;
-
-	stream = bt_notification_stream_end_get_stream(notification);
-	assert(stream);
-
-	/* FIXME: useless copy */
-	return bt_notification_stream_end_create(stream);
+	/* The stream is not modified: forward it as is */
+	return bt_get(notification);
 }
 
 /* Return true if the notification should be forwarded. */
@@ -561,7 +679,7 @@ enum bt_notification_iterator_status evaluate_notification(
 	case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
 	case BT_NOTIFICATION_TYPE_PACKET_END:
 	        new_notification = evaluate_packet_notification(*notification,
-				trim_it, begin, end, in_range, &finished);
+				trim_it, begin, end, in_range);
 		break;
 	case BT_NOTIFICATION_TYPE_STREAM_END:
 		new_notification = evaluate_stream_notification(*notification,
@@ -581,6 +699,46 @@ enum bt_notification_iterator_status evaluate_notification(
 	return BT_NOTIFICATION_ITERATOR_STATUS_OK;
 }
 
+/*
+ * Before reading the first notification, seeks the input iterator to
+ * the beginning of the trimming range, if it's known, so that the
+ * upstream components do not read and decode what precedes it.
+ */
+static
+enum bt_notification_iterator_status position_input_iterator(
+		struct trimmer_iterator *trim_it, struct trimmer *trimmer)
+{
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
+	if (trim_it->input_positioned) {
+		goto end;
+	}
+
+	trim_it->input_positioned = true;
+
+	if (!trimmer->begin.set || trimmer->begin.lazy) {
+		/* Read from the beginning */
+		goto end;
+	}
+
+	status = bt_notification_iterator_seek_time(trim_it->input_iterator,
+		BT_NOTIFICATION_ITERATOR_SEEK_ORIGIN_EPOCH,
+		trimmer->begin.value);
+	if (status == BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED) {
+		BT_LOGD("Input iterator cannot seek: reading from the beginning: "
+			"begin-ns=%" PRId64, trimmer->begin.value);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	} else if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		BT_LOGE("Cannot seek input iterator to the beginning of the trimming range: "
+			"begin-ns=%" PRId64 ", status=%d",
+			trimmer->begin.value, status);
+	}
+
+end:
+	return status;
+}
+
 BT_HIDDEN
 struct bt_notification_iterator_next_return trimmer_iterator_next(
 		struct bt_private_notification_iterator *iterator)
@@ -607,6 +765,11 @@ struct bt_notification_iterator_next_return trimmer_iterator_next(
 	source_it = trim_it->input_iterator;
 	assert(source_it);
 
+	ret.status = position_input_iterator(trim_it, trimmer);
+	if (ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		goto end;
+	}
+
 	while (!notification_in_range) {
 		ret.status = bt_notification_iterator_next(source_it);
 		if (ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
@@ -636,10 +799,116 @@ end:
 	return ret;
 }
 
+BT_HIDDEN
+enum bt_notification_iterator_status trimmer_iterator_next_batch(
+		struct bt_private_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	struct trimmer_iterator *trim_it = NULL;
+	struct bt_private_component *component = NULL;
+	struct trimmer *trimmer = NULL;
+	enum bt_notification_iterator_status ret =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
+	trim_it = bt_private_notification_iterator_get_user_data(iterator);
+	assert(trim_it);
+
+	component = bt_private_notification_iterator_get_private_component(
+		iterator);
+	assert(component);
+	trimmer = bt_private_component_get_user_data(component);
+	assert(trimmer);
+	assert(trim_it->input_iterator);
+	*count = 0;
+
+	ret = position_input_iterator(trim_it, trimmer);
+	if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		goto end;
+	}
+
+	/*
+	 * Get a batch of upstream notifications in the output array
+	 * and keep, in place, the ones which are in range.
+	 */
+	while (*count == 0) {
+		uint64_t input_count;
+		uint64_t i;
+
+		ret = bt_notification_iterator_next_batch(
+			trim_it->input_iterator, notifications, capacity,
+			&input_count);
+		if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			break;
+		}
+
+		for (i = 0; i < input_count; i++) {
+			struct bt_notification *notification =
+				notifications[i];
+			bool notification_in_range = false;
+
+			notifications[i] = NULL;
+
+			/* Discard what follows the end of the range */
+			if (ret == BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+				ret = evaluate_notification(&notification,
+					trim_it, &trimmer->begin,
+					&trimmer->end,
+					&notification_in_range);
+			}
+
+			if (notification_in_range) {
+				notifications[*count] = notification;
+				(*count)++;
+			} else {
+				bt_put(notification);
+			}
+		}
+
+		if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			break;
+		}
+	}
+
+end:
+	bt_put(component);
+	return ret;
+}
+
 BT_HIDDEN
 enum bt_notification_iterator_status trimmer_iterator_seek_time(
 		struct bt_private_notification_iterator *iterator,
 		int64_t time)
 {
-	return BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	struct trimmer_iterator *trim_it;
+	struct bt_private_component *component = NULL;
+	struct trimmer *trimmer;
+	enum bt_notification_iterator_status ret;
+
+	trim_it = bt_private_notification_iterator_get_user_data(iterator);
+	assert(trim_it);
+
+	component = bt_private_notification_iterator_get_private_component(
+		iterator);
+	assert(component);
+	trimmer = bt_private_component_get_user_data(component);
+	assert(trimmer);
+
+	/*
+	 * Nothing before the beginning of the range is forwarded
+	 * anyway: do not make upstream decode it.
+	 */
+	if (trimmer->begin.set && !trimmer->begin.lazy &&
+			time < trimmer->begin.value) {
+		time = trimmer->begin.value;
+	}
+
+	ret = bt_notification_iterator_seek_time(trim_it->input_iterator,
+		BT_NOTIFICATION_ITERATOR_SEEK_ORIGIN_EPOCH, time);
+	if (ret == BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		trim_it->input_positioned = true;
+	}
+
+	bt_put(component);
+	return ret;
 }
@@ -33,13 +33,54 @@
 #include <babeltrace/graph/private-component.h>
 #include <babeltrace/graph/private-port.h>
 
+/* How the notifications of an upstream packet are forwarded. */
+enum trimmer_packet_mode {
+	/*
+	 * The time range of the packet is unknown: forward it as is and
+	 * check the timestamp of each of its events.
+	 */
+	TRIMMER_PACKET_MODE_CHECK_EVENTS,
+	/*
+	 * The packet is within the trimming range: forward it and its
+	 * events as is.
+	 */
+	TRIMMER_PACKET_MODE_FORWARD,
+	/*
+	 * The packet is outside the trimming range: discard it and its
+	 * events.
+	 */
+	TRIMMER_PACKET_MODE_DISCARD,
+	/*
+	 * The packet overlaps a bound of the trimming range: forward a
+	 * writer packet with the same context, except for its
+	 * timestamp_begin/end fields which are clamped to the range,
+	 * and check the timestamp of each event, which is forwarded in
+	 * the writer packet.
+	 */
+	TRIMMER_PACKET_MODE_CLAMP,
+};
+
+struct trimmer_packet {
+	enum trimmer_packet_mode mode;
+	/* The packet begins after the end of the trimming range. */
+	bool after_range;
+	/* Owned by this, only in TRIMMER_PACKET_MODE_CLAMP mode. */
+	struct bt_ctf_packet *writer_packet;
+};
+
 struct trimmer_iterator {
 	/* Input iterator associated with this output iterator. */
 	struct bt_notification_iterator *input_iterator;
 	struct bt_notification *current_notification;
 	FILE *err;
-	/* Map between reader and writer packets. */
+	/* Map between reader packets and struct trimmer_packet. */
 	GHashTable *packet_map;
+	/*
+	 * True once the input iterator is positioned: either it was
+	 * sought to the beginning of the trimming range before the
+	 * first notification, or the downstream seeked this iterator.
+	 */
+	bool input_positioned;
 };
 
 BT_HIDDEN
@@ -54,6 +95,12 @@ BT_HIDDEN
 struct bt_notification_iterator_next_return trimmer_iterator_next(
 		struct bt_private_notification_iterator *iterator);
 
+BT_HIDDEN
+enum bt_notification_iterator_status trimmer_iterator_next_batch(
+		struct bt_private_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count);
+
 BT_HIDDEN
 enum bt_notification_iterator_status trimmer_iterator_seek_time(
 		struct bt_private_notification_iterator *iterator,
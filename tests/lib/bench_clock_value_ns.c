@@ -0,0 +1,125 @@
+/*
+ * bench_clock_value_ns.c
+ *
+ * CTF IR clock value to nanoseconds conversion benchmark
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Converts clock values of a few clock classes to nanoseconds from
+ * Epoch and reports the time per conversion, next to the time of the
+ * floating point formula which the library used before.
+ *
+ * Usage:
+ *
+ *     tests/lib/bench_clock_value_ns [CONVERSIONS]
+ */
+
+#include <babeltrace/ctf-ir/clock-class.h>
+#include <babeltrace/ref.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <time.h>
+
+#define DEFAULT_CONVERSIONS	10000000ULL
+
+static
+double get_time_s(void)
+{
+	struct timespec ts;
+	int ret;
+
+	ret = clock_gettime(CLOCK_MONOTONIC, &ts);
+	assert(ret == 0);
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static
+void bench_frequency(uint64_t frequency, uint64_t conversions)
+{
+	struct bt_ctf_clock_class *clock_class;
+	struct bt_ctf_clock_value *clock_value;
+	volatile int64_t sink = 0;
+	uint64_t i;
+	double begin, lib_s, float_s;
+	int ret;
+
+	clock_class = bt_ctf_clock_class_create("bench-clock");
+	assert(clock_class);
+	ret = bt_ctf_clock_class_set_frequency(clock_class, frequency);
+	assert(ret == 0);
+	ret = bt_ctf_clock_class_set_offset_s(clock_class, 1500000000);
+	assert(ret == 0);
+	ret = bt_ctf_clock_class_set_offset_cycles(clock_class, 12345);
+	assert(ret == 0);
+
+	/* Large values, as found in TSC-based traces */
+	clock_value = bt_ctf_clock_value_create(clock_class, 1ULL << 54);
+	assert(clock_value);
+	begin = get_time_s();
+
+	for (i = 0; i < conversions; i++) {
+		int64_t ns;
+
+		ret = bt_ctf_clock_value_get_value_ns_from_epoch(clock_value,
+			&ns);
+		assert(ret == 0);
+		sink += ns;
+	}
+
+	lib_s = get_time_s() - begin;
+	begin = get_time_s();
+
+	for (i = 0; i < conversions; i++) {
+		uint64_t value = (1ULL << 54) + (i & 0xff);
+		int64_t ns = 1500000000LL * 1000000000LL;
+
+		ns += (int64_t) ((1e9 * (double) 12345) / (double) frequency);
+		ns += (int64_t) ((1e9 * (double) value) / (double) frequency);
+		sink += ns;
+	}
+
+	float_s = get_time_s() - begin;
+	printf("%15" PRIu64 " Hz: %8.2f ns/conversion (library), "
+		"%8.2f ns/conversion (floating point formula)\n",
+		frequency, lib_s * 1e9 / (double) conversions,
+		float_s * 1e9 / (double) conversions);
+	bt_put(clock_value);
+	bt_put(clock_class);
+}
+
+int main(int argc, char **argv)
+{
+	uint64_t conversions = DEFAULT_CONVERSIONS;
+
+	if (argc > 1) {
+		conversions = strtoull(argv[1], NULL, 10);
+	}
+
+	if (conversions == 0) {
+		fprintf(stderr, "Invalid number of conversions\n");
+		return 1;
+	}
+
+	bench_frequency(1000000000ULL, conversions);
+	bench_frequency(2600000000ULL, conversions);
+	bench_frequency(32768ULL, conversions);
+	return 0;
+}
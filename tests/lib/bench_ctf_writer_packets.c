@@ -0,0 +1,198 @@
+/*
+ * bench_ctf_writer_packets.c
+ *
+ * CTF writer packet allocation benchmark
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Writes events to a CTF writer stream with a few packet sizes and
+ * packet allocation strategies, and reports the time per event and
+ * the write throughput of each one.
+ *
+ * Usage:
+ *
+ *     tests/lib/bench_ctf_writer_packets [EVENTS]
+ */
+
+#include <babeltrace/ctf-writer/writer.h>
+#include <babeltrace/ctf-writer/clock.h>
+#include <babeltrace/ctf-writer/stream.h>
+#include <babeltrace/ctf-writer/stream-class.h>
+#include <babeltrace/ctf-writer/event.h>
+#include <babeltrace/ctf-writer/event-types.h>
+#include <babeltrace/ctf-writer/event-fields.h>
+#include <babeltrace/ref.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "common.h"
+
+#define DEFAULT_EVENTS		10000000ULL
+#define PREALLOCATION_SIZE	(64ULL * 1024 * 1024)
+
+/* Approximate size of a benchmark event, with its header */
+#define EVENT_SIZE		24
+
+static
+double get_time_s(void)
+{
+	struct timespec ts;
+	int ret;
+
+	ret = clock_gettime(CLOCK_MONOTONIC, &ts);
+	assert(ret == 0);
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static
+void bench_packet_allocation(uint64_t events, uint64_t packet_size,
+		uint64_t preallocation_size, int buffered)
+{
+	char trace_path[] = "/tmp/ctfwriter_bench_XXXXXX";
+	struct bt_ctf_writer *writer;
+	struct bt_ctf_clock *clock;
+	struct bt_ctf_stream_class *stream_class;
+	struct bt_ctf_stream *stream;
+	struct bt_ctf_event_class *event_class;
+	struct bt_ctf_field_type *uint_64_type, *uint_32_type;
+	uint64_t events_per_packet = packet_size / EVENT_SIZE - 4;
+	uint64_t i;
+	double begin, elapsed_s;
+	struct stat st;
+	char stream_path[sizeof(trace_path) + 32];
+	int ret;
+
+	if (!mkdtemp(trace_path)) {
+		perror("# perror");
+		abort();
+	}
+
+	writer = bt_ctf_writer_create(trace_path);
+	assert(writer);
+	clock = bt_ctf_clock_create("bench_clock");
+	assert(clock);
+	ret = bt_ctf_writer_add_clock(writer, clock);
+	assert(ret == 0);
+	stream_class = bt_ctf_stream_class_create("bench_stream");
+	assert(stream_class);
+	ret = bt_ctf_stream_class_set_clock(stream_class, clock);
+	assert(ret == 0);
+	event_class = bt_ctf_event_class_create("bench_event");
+	assert(event_class);
+	uint_64_type = bt_ctf_field_type_integer_create(64);
+	assert(uint_64_type);
+	uint_32_type = bt_ctf_field_type_integer_create(32);
+	assert(uint_32_type);
+	ret = bt_ctf_event_class_add_field(event_class, uint_64_type,
+		"value");
+	assert(ret == 0);
+	ret = bt_ctf_event_class_add_field(event_class, uint_32_type,
+		"cpu");
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_add_event_class(stream_class, event_class);
+	assert(ret == 0);
+	stream = bt_ctf_writer_create_stream(writer, stream_class);
+	assert(stream);
+	ret = bt_ctf_stream_set_serialize_on_append(stream, 1);
+	assert(ret == 0);
+	ret = bt_ctf_stream_set_packet_allocation(stream, packet_size,
+		preallocation_size, buffered);
+	assert(ret == 0);
+	begin = get_time_s();
+
+	for (i = 0; i < events; i++) {
+		struct bt_ctf_event *event = bt_ctf_event_create(event_class);
+		struct bt_ctf_field *field;
+
+		assert(event);
+		field = bt_ctf_event_get_payload(event, "value");
+		ret = bt_ctf_field_unsigned_integer_set_value(field, i);
+		assert(ret == 0);
+		bt_put(field);
+		field = bt_ctf_event_get_payload(event, "cpu");
+		ret = bt_ctf_field_unsigned_integer_set_value(field, i & 7);
+		assert(ret == 0);
+		bt_put(field);
+		ret = bt_ctf_clock_set_time(clock, (int64_t) i);
+		assert(ret == 0);
+		ret = bt_ctf_stream_append_event(stream, event);
+		assert(ret == 0);
+		bt_put(event);
+
+		if ((i + 1) % events_per_packet == 0) {
+			ret = bt_ctf_stream_flush(stream);
+			assert(ret == 0);
+		}
+	}
+
+	ret = bt_ctf_stream_flush(stream);
+	assert(ret == 0);
+	elapsed_s = get_time_s() - begin;
+	bt_put(stream);
+	bt_put(uint_32_type);
+	bt_put(uint_64_type);
+	bt_put(event_class);
+	bt_put(stream_class);
+	bt_put(clock);
+	bt_put(writer);
+
+	/* The stream file is truncated to its final size at this point */
+	snprintf(stream_path, sizeof(stream_path), "%s/bench_stream_0",
+		trace_path);
+	ret = stat(stream_path, &st);
+	assert(ret == 0);
+	printf("%8" PRIu64 " KiB packets, %s, %2" PRIu64 " MiB extents: "
+		"%7.1f ns/event, %8.1f MiB/s\n",
+		packet_size / 1024, buffered ? "buffered" : "mapped  ",
+		preallocation_size / (1024 * 1024),
+		elapsed_s * 1e9 / (double) events,
+		(double) st.st_size / (1024 * 1024) / elapsed_s);
+	recursive_rmdir(trace_path);
+}
+
+int main(int argc, char **argv)
+{
+	static const uint64_t packet_sizes[] = {
+		32 * 1024, 256 * 1024, 4 * 1024 * 1024,
+	};
+	uint64_t events = DEFAULT_EVENTS;
+	size_t i;
+
+	if (argc > 1) {
+		events = strtoull(argv[1], NULL, 10);
+	}
+
+	if (events == 0) {
+		fprintf(stderr, "Invalid number of events\n");
+		return 1;
+	}
+
+	for (i = 0; i < sizeof(packet_sizes) / sizeof(*packet_sizes); i++) {
+		bench_packet_allocation(events, packet_sizes[i], 0, 0);
+		bench_packet_allocation(events, packet_sizes[i],
+			PREALLOCATION_SIZE, 0);
+		bench_packet_allocation(events, packet_sizes[i],
+			PREALLOCATION_SIZE, 1);
+	}
+
+	return 0;
+}
@@ -21,6 +21,7 @@
 
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
 #include <babeltrace/compat/dirent-internal.h>
 #include <babeltrace/compat/limits-internal.h>
 #include <sys/stat.h>
@@ -50,6 +51,10 @@ void recursive_rmdir(const char *path)
 
 		if (S_ISREG(st.st_mode)) {
 			unlinkat(bt_dirfd(dir), entry->d_name, 0);
+		} else if (S_ISDIR(st.st_mode) &&
+				strcmp(entry->d_name, ".") != 0 &&
+				strcmp(entry->d_name, "..") != 0) {
+			recursive_rmdir(filename);
 		}
 	}
 
@@ -23,6 +23,9 @@
 #include <time.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
 
 #include <tap/tap.h>
 
@@ -40,6 +43,8 @@ void fct(void)
 /* Test array size, in bytes */
 #define TEST_LEN 128
 #define NR_TESTS 10
+#define NR_ALIGNED_TESTS 8
+#define ALIGNED_TEST_DESC_FMT_STR "Reading back byte-aligned %u-bit %s integers"
 #define SIGNED_TEST_DESC_FMT_STR "Writing and reading back 0x%X, signed"
 #define UNSIGNED_TEST_DESC_FMT_STR "Writing and reading back 0x%X, unsigned"
 #define DIAG_FMT_STR "Failed reading value written \"%s\"-wise, with start=%i" \
@@ -262,10 +267,95 @@ void run_test_signed(void)
 	pass(SIGNED_TEST_DESC_FMT_STR, src);
 }
 
+static
+uint64_t rand_u64(void)
+{
+	return ((uint64_t) rand() << 42) ^ ((uint64_t) rand() << 21) ^
+		(uint64_t) rand();
+}
+
+/*
+ * Writes random values with bt_bitfield_write_le() or
+ * bt_bitfield_write_be() at each byte offset, and checks that the
+ * aligned readers read them back as the generic readers do.
+ */
+static
+void run_test_aligned_one(int be, unsigned int len,
+		uint64_t (*read_uint)(const unsigned char *),
+		int64_t (*read_sint)(const unsigned char *))
+{
+	unsigned char c[TEST_LEN];
+	const char *bo_str = be ? "big-endian" : "little-endian";
+	unsigned int iter, byte;
+
+	for (iter = 0; iter < 64; iter++) {
+		uint64_t src = rand_u64();
+
+		if (len < 64) {
+			src &= (UINT64_C(1) << len) - 1;
+		}
+
+		for (byte = 0; byte + len / CHAR_BIT <= TEST_LEN; byte++) {
+			uint64_t uval;
+			int64_t sval, sref;
+
+			init_byte_array(c, TEST_LEN, 0xFF);
+
+			if (be) {
+				bt_bitfield_write_be(c, unsigned char,
+					byte * CHAR_BIT, len, src);
+				bt_bitfield_read_be(c, unsigned char,
+					byte * CHAR_BIT, len, &sref);
+			} else {
+				bt_bitfield_write_le(c, unsigned char,
+					byte * CHAR_BIT, len, src);
+				bt_bitfield_read_le(c, unsigned char,
+					byte * CHAR_BIT, len, &sref);
+			}
+
+			uval = read_uint(&c[byte]);
+			sval = read_sint(&c[byte]);
+
+			if (uval != src || sval != sref) {
+				fail(ALIGNED_TEST_DESC_FMT_STR, len, bo_str);
+				diag("At byte %u: wrote 0x%" PRIX64 ", read 0x%"
+					PRIX64 " (unsigned) and %" PRId64
+					" (signed, expecting %" PRId64 ")",
+					byte, src, uval, sval, sref);
+				printf("# ");
+				print_byte_array(c, TEST_LEN);
+				return;
+			}
+		}
+	}
+
+	pass(ALIGNED_TEST_DESC_FMT_STR, len, bo_str);
+}
+
+void run_test_aligned(void)
+{
+	run_test_aligned_one(0, 8, bt_bitfield_read_aligned_le_u8,
+		bt_bitfield_read_aligned_le_s8);
+	run_test_aligned_one(0, 16, bt_bitfield_read_aligned_le_u16,
+		bt_bitfield_read_aligned_le_s16);
+	run_test_aligned_one(0, 32, bt_bitfield_read_aligned_le_u32,
+		bt_bitfield_read_aligned_le_s32);
+	run_test_aligned_one(0, 64, bt_bitfield_read_aligned_le_u64,
+		bt_bitfield_read_aligned_le_s64);
+	run_test_aligned_one(1, 8, bt_bitfield_read_aligned_be_u8,
+		bt_bitfield_read_aligned_be_s8);
+	run_test_aligned_one(1, 16, bt_bitfield_read_aligned_be_u16,
+		bt_bitfield_read_aligned_be_s16);
+	run_test_aligned_one(1, 32, bt_bitfield_read_aligned_be_u32,
+		bt_bitfield_read_aligned_be_s32);
+	run_test_aligned_one(1, 64, bt_bitfield_read_aligned_be_u64,
+		bt_bitfield_read_aligned_be_s64);
+}
+
 void run_test(void)
 {
 	int i;
-	plan_tests(NR_TESTS * 2 + 6);
+	plan_tests(NR_TESTS * 2 + 6 + NR_ALIGNED_TESTS);
 
 	srand(time(NULL));
 
@@ -291,6 +381,8 @@ void run_test(void)
 		run_test_unsigned();
 		run_test_signed();
 	}
+
+	run_test_aligned();
 }
 
 static
@@ -337,8 +429,94 @@ int print_encodings(unsigned long src, unsigned int shift, unsigned int len)
 	return 0;
 }
 
+/* Benchmark buffer size, in bytes */
+#define BENCH_LEN	(1 << 20)
+#define BENCH_ROUNDS	64
+
+static
+double get_time_s(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+#define bench_read(_name, _len, _read_expr)				\
+do {									\
+	uint64_t _sum = 0;						\
+	unsigned int _round;						\
+	size_t _i;							\
+	double _begin, _elapsed;					\
+									\
+	_begin = get_time_s();						\
+									\
+	for (_round = 0; _round < BENCH_ROUNDS; _round++) {		\
+		for (_i = 0; _i < BENCH_LEN / ((_len) / CHAR_BIT); _i++) { \
+			uint64_t _v;					\
+									\
+			_read_expr;					\
+			_sum += _v;					\
+		}							\
+	}								\
+									\
+	_elapsed = get_time_s() - _begin;				\
+	printf("%-34s %2u bits: %8.1f MiB/s (sum: %" PRIx64 ")\n",	\
+		(_name), (unsigned int) (_len),				\
+		(double) BENCH_LEN * BENCH_ROUNDS / _elapsed / (1 << 20), \
+		_sum);							\
+} while (0)
+
+/*
+ * Compares the throughput of the generic bitfield readers with the one
+ * of the aligned readers for byte-aligned fields.
+ */
+static
+int run_bench(void)
+{
+	unsigned char *buf = malloc(BENCH_LEN);
+	size_t i;
+
+	if (!buf) {
+		return 1;
+	}
+
+	srand(time(NULL));
+
+	for (i = 0; i < BENCH_LEN; i++) {
+		buf[i] = (unsigned char) rand();
+	}
+
+#define BENCH_LEN_BO(_len, _bo)						\
+	bench_read("bt_bitfield_read_" #_bo "()", _len,			\
+		bt_bitfield_read_##_bo(buf, unsigned char,		\
+			_i * (_len), _len, &_v));			\
+	bench_read("bt_bitfield_read_aligned_" #_bo "_u" #_len "()", _len, \
+		_v = bt_bitfield_read_aligned_##_bo##_u##_len(		\
+			&buf[_i * ((_len) / CHAR_BIT)]))
+
+	BENCH_LEN_BO(8, le);
+	BENCH_LEN_BO(16, le);
+	BENCH_LEN_BO(32, le);
+	BENCH_LEN_BO(64, le);
+	BENCH_LEN_BO(8, be);
+	BENCH_LEN_BO(16, be);
+	BENCH_LEN_BO(32, be);
+	BENCH_LEN_BO(64, be);
+
+#undef BENCH_LEN_BO
+
+	free(buf);
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		/* Run the aligned readers microbenchmark */
+		return run_bench();
+	}
+
 	if (argc > 1) {
 		/* Print encodings */
 		unsigned long src;
@@ -58,7 +58,7 @@
 
 #include "tap/tap.h"
 
-#define NR_TESTS	24
+#define NR_TESTS	28
 
 enum test {
 	TEST_NO_AUTO_NOTIFS,
@@ -73,6 +73,8 @@ enum test {
 	TEST_AUTO_PACKET_END_STREAM_END_FROM_END,
 	TEST_MULTIPLE_AUTO_STREAM_END_FROM_END,
 	TEST_MULTIPLE_AUTO_PACKET_END_STREAM_END_FROM_END,
+	TEST_SEEK_TIME_AFTER_END,
+	TEST_NEXT_BATCH,
 };
 
 enum test_event_type {
@@ -139,6 +141,7 @@ struct src_iter_user_data {
 
 struct sink_user_data {
 	struct bt_notification_iterator *notif_iter;
+	bool seeked;
 };
 
 /*
@@ -270,6 +273,16 @@ static int64_t seq_multiple_auto_packet_end_stream_end_from_end[] = {
 	SEQ_END,
 };
 
+/* Seek to the beginning after END, then read everything again */
+static int64_t seq_seek_time_after_end[] = {
+	SEQ_STREAM1_BEGIN,
+	SEQ_STREAM1_PACKET1_BEGIN,
+	SEQ_EVENT_STREAM1_PACKET1,
+	/* Automatic "packet end" here */
+	/* Automatic "stream end" here */
+	SEQ_END,
+};
+
 static
 void clear_test_events(void)
 {
@@ -510,6 +523,7 @@ enum bt_notification_iterator_status src_iter_init(
 
 	switch (current_test) {
 	case TEST_NO_AUTO_NOTIFS:
+	case TEST_NEXT_BATCH:
 		user_data->seq = seq_no_auto_notifs;
 		break;
 	case TEST_AUTO_STREAM_BEGIN_FROM_PACKET_BEGIN:
@@ -545,6 +559,9 @@ enum bt_notification_iterator_status src_iter_init(
 	case TEST_MULTIPLE_AUTO_PACKET_END_STREAM_END_FROM_END:
 		user_data->seq = seq_multiple_auto_packet_end_stream_end_from_end;
 		break;
+	case TEST_SEEK_TIME_AFTER_END:
+		user_data->seq = seq_seek_time_after_end;
+		break;
 	default:
 		abort();
 	}
@@ -696,6 +713,51 @@ struct bt_notification_iterator_next_return src_iter_next(
 	return next_return;
 }
 
+/* Returns at most 3 notifications at once, possibly with the end */
+static
+enum bt_notification_iterator_status src_iter_next_batch(
+		struct bt_private_notification_iterator *priv_iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	struct bt_notification_iterator_next_return next_return = {
+		.status = BT_NOTIFICATION_ITERATOR_STATUS_OK,
+		.notification = NULL,
+	};
+	struct src_iter_user_data *user_data =
+		bt_private_notification_iterator_get_user_data(priv_iterator);
+
+	assert(user_data);
+	*count = 0;
+
+	while (*count < capacity && *count < 3) {
+		next_return = src_iter_next_seq(user_data);
+		if (next_return.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			break;
+		}
+
+		notifications[*count] = next_return.notification;
+		(*count)++;
+	}
+
+	return next_return.status;
+}
+
+static
+enum bt_notification_iterator_status src_iter_seek_time(
+		struct bt_private_notification_iterator *priv_iterator,
+		int64_t time)
+{
+	struct src_iter_user_data *user_data =
+		bt_private_notification_iterator_get_user_data(priv_iterator);
+
+	assert(user_data);
+
+	/* Notifications have no time: always seek to the beginning */
+	user_data->at = 0;
+	return BT_NOTIFICATION_ITERATOR_STATUS_OK;
+}
+
 static
 enum bt_component_status src_init(
 		struct bt_private_component *private_component,
@@ -714,6 +776,112 @@ void src_finalize(struct bt_private_component *private_component)
 {
 }
 
+static
+void notification_to_test_event(struct bt_notification *notification,
+		struct test_event *test_event)
+{
+	switch (bt_notification_get_type(notification)) {
+	case BT_NOTIFICATION_TYPE_EVENT:
+	{
+		struct bt_ctf_event *event;
+
+		test_event->type = TEST_EV_TYPE_NOTIF_EVENT;
+		event = bt_notification_event_get_event(notification);
+		assert(event);
+		test_event->packet = bt_ctf_event_get_packet(event);
+		bt_put(event);
+		assert(test_event->packet);
+		bt_put(test_event->packet);
+		break;
+	}
+	case BT_NOTIFICATION_TYPE_INACTIVITY:
+		test_event->type = TEST_EV_TYPE_NOTIF_INACTIVITY;
+		break;
+	case BT_NOTIFICATION_TYPE_STREAM_BEGIN:
+		test_event->type = TEST_EV_TYPE_NOTIF_STREAM_BEGIN;
+		test_event->stream =
+			bt_notification_stream_begin_get_stream(notification);
+		assert(test_event->stream);
+		bt_put(test_event->stream);
+		break;
+	case BT_NOTIFICATION_TYPE_STREAM_END:
+		test_event->type = TEST_EV_TYPE_NOTIF_STREAM_END;
+		test_event->stream =
+			bt_notification_stream_end_get_stream(notification);
+		assert(test_event->stream);
+		bt_put(test_event->stream);
+		break;
+	case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
+		test_event->type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN;
+		test_event->packet =
+			bt_notification_packet_begin_get_packet(notification);
+		assert(test_event->packet);
+		bt_put(test_event->packet);
+		break;
+	case BT_NOTIFICATION_TYPE_PACKET_END:
+		test_event->type = TEST_EV_TYPE_NOTIF_PACKET_END;
+		test_event->packet =
+			bt_notification_packet_end_get_packet(notification);
+		assert(test_event->packet);
+		bt_put(test_event->packet);
+		break;
+	default:
+		test_event->type = TEST_EV_TYPE_NOTIF_UNEXPECTED;
+		break;
+	}
+
+	if (test_event->packet) {
+		test_event->stream = bt_ctf_packet_get_stream(test_event->packet);
+		assert(test_event->stream);
+		bt_put(test_event->stream);
+	}
+}
+
+/* Consumes at most 2 notifications at once */
+static
+enum bt_component_status sink_consume_batch(
+		struct sink_user_data *user_data)
+{
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+	struct bt_notification *notifications[2];
+	enum bt_notification_iterator_status it_ret;
+	uint64_t count = 0;
+	uint64_t i;
+
+	it_ret = bt_notification_iterator_next_batch(user_data->notif_iter,
+		notifications, 2, &count);
+
+	switch (it_ret) {
+	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
+		assert(count > 0 && count <= 2);
+		break;
+	case BT_NOTIFICATION_ITERATOR_STATUS_END:
+	{
+		struct test_event test_event = { .type = TEST_EV_TYPE_END };
+
+		assert(count == 0);
+		append_test_event(&test_event);
+		ret = BT_COMPONENT_STATUS_END;
+		BT_PUT(user_data->notif_iter);
+		goto end;
+	}
+	default:
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+
+	for (i = 0; i < count; i++) {
+		struct test_event test_event = { 0 };
+
+		notification_to_test_event(notifications[i], &test_event);
+		append_test_event(&test_event);
+		bt_put(notifications[i]);
+	}
+
+end:
+	return ret;
+}
+
 static
 enum bt_component_status sink_consume(
 		struct bt_private_component *priv_component)
@@ -727,6 +895,11 @@ enum bt_component_status sink_consume(
 	bool do_append_test_event = true;
 
 	assert(user_data && user_data->notif_iter);
+
+	if (current_test == TEST_NEXT_BATCH) {
+		return sink_consume_batch(user_data);
+	}
+
 	it_ret = bt_notification_iterator_next(user_data->notif_iter);
 
 	if (it_ret < 0) {
@@ -738,6 +911,17 @@ enum bt_component_status sink_consume(
 	switch (it_ret) {
 	case BT_NOTIFICATION_ITERATOR_STATUS_END:
 		test_event.type = TEST_EV_TYPE_END;
+
+		if (current_test == TEST_SEEK_TIME_AFTER_END &&
+				!user_data->seeked) {
+			it_ret = bt_notification_iterator_seek_time(
+				user_data->notif_iter,
+				BT_NOTIFICATION_ITERATOR_SEEK_ORIGIN_EPOCH, 0);
+			assert(it_ret == BT_NOTIFICATION_ITERATOR_STATUS_OK);
+			user_data->seeked = true;
+			goto end;
+		}
+
 		ret = BT_COMPONENT_STATUS_END;
 		BT_PUT(user_data->notif_iter);
 		goto end;
@@ -750,62 +934,7 @@ enum bt_component_status sink_consume(
 	notification = bt_notification_iterator_get_notification(
 		user_data->notif_iter);
 	assert(notification);
-
-	switch (bt_notification_get_type(notification)) {
-	case BT_NOTIFICATION_TYPE_EVENT:
-	{
-		struct bt_ctf_event *event;
-
-		test_event.type = TEST_EV_TYPE_NOTIF_EVENT;
-		event = bt_notification_event_get_event(notification);
-		assert(event);
-		test_event.packet = bt_ctf_event_get_packet(event);
-		bt_put(event);
-		assert(test_event.packet);
-		bt_put(test_event.packet);
-		break;
-	}
-	case BT_NOTIFICATION_TYPE_INACTIVITY:
-		test_event.type = TEST_EV_TYPE_NOTIF_INACTIVITY;
-		break;
-	case BT_NOTIFICATION_TYPE_STREAM_BEGIN:
-		test_event.type = TEST_EV_TYPE_NOTIF_STREAM_BEGIN;
-		test_event.stream =
-			bt_notification_stream_begin_get_stream(notification);
-		assert(test_event.stream);
-		bt_put(test_event.stream);
-		break;
-	case BT_NOTIFICATION_TYPE_STREAM_END:
-		test_event.type = TEST_EV_TYPE_NOTIF_STREAM_END;
-		test_event.stream =
-			bt_notification_stream_end_get_stream(notification);
-		assert(test_event.stream);
-		bt_put(test_event.stream);
-		break;
-	case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
-		test_event.type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN;
-		test_event.packet =
-			bt_notification_packet_begin_get_packet(notification);
-		assert(test_event.packet);
-		bt_put(test_event.packet);
-		break;
-	case BT_NOTIFICATION_TYPE_PACKET_END:
-		test_event.type = TEST_EV_TYPE_NOTIF_PACKET_END;
-		test_event.packet =
-			bt_notification_packet_end_get_packet(notification);
-		assert(test_event.packet);
-		bt_put(test_event.packet);
-		break;
-	default:
-		test_event.type = TEST_EV_TYPE_NOTIF_UNEXPECTED;
-		break;
-	}
-
-	if (test_event.packet) {
-		test_event.stream = bt_ctf_packet_get_stream(test_event.packet);
-		assert(test_event.stream);
-		bt_put(test_event.stream);
-	}
+	notification_to_test_event(notification, &test_event);
 
 end:
 	if (do_append_test_event) {
@@ -887,6 +1016,16 @@ void create_source_sink(struct bt_graph *graph, struct bt_component **source,
 	ret = bt_component_class_source_set_notification_iterator_finalize_method(
 		src_comp_class, src_iter_finalize);
 	assert(ret == 0);
+	ret = bt_component_class_source_set_notification_iterator_seek_time_method(
+		src_comp_class, src_iter_seek_time);
+	assert(ret == 0);
+
+	if (current_test == TEST_NEXT_BATCH) {
+		ret = bt_component_class_source_set_notification_iterator_next_batch_method(
+			src_comp_class, src_iter_next_batch);
+		assert(ret == 0);
+	}
+
 	ret = bt_graph_add_component(graph, src_comp_class, "source", NULL,
 		source);
 	assert(ret == 0);
@@ -1305,6 +1444,58 @@ end:
 		"the produced sequence of test events is the expected one");
 }
 
+static
+void test_seek_time_after_end(void)
+{
+	const struct test_event expected_test_events[] = {
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_BEGIN, .stream = src_stream1, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_END, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_END, .stream = src_stream1, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_END, },
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_BEGIN, .stream = src_stream1, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_END, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_END, .stream = src_stream1, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_END, },
+		{ .type = TEST_EV_TYPE_SENTINEL, },
+	};
+
+	do_std_test(TEST_SEEK_TIME_AFTER_END,
+		"seek time after BT_NOTIFICATION_ITERATOR_STATUS_END",
+		expected_test_events);
+}
+
+static
+void test_next_batch(void)
+{
+	const struct test_event expected_test_events[] = {
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_BEGIN, .stream = src_stream1, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_BEGIN, .stream = src_stream2, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN, .stream = src_stream2, .packet = src_stream2_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream2, .packet = src_stream2_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_END, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_END, .stream = src_stream2, .packet = src_stream2_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN, .stream = src_stream1, .packet = src_stream1_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_END, .stream = src_stream2, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_END, .stream = src_stream1, .packet = src_stream1_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_END, .stream = src_stream1, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_END, },
+		{ .type = TEST_EV_TYPE_SENTINEL, },
+	};
+
+	do_std_test(TEST_NEXT_BATCH, "\"next batch\" methods",
+		expected_test_events);
+}
+
 #define DEBUG_ENV_VAR	"TEST_BT_NOTIFICATION_ITERATOR_DEBUG"
 
 int main(int argc, char **argv)
@@ -1327,6 +1518,8 @@ int main(int argc, char **argv)
 	test_auto_packet_end_stream_end_from_end();
 	test_multiple_auto_stream_end_from_end();
 	test_multiple_auto_packet_end_stream_end_from_end();
+	test_seek_time_after_end();
+	test_next_batch();
 	fini_static_data();
 	return exit_status();
 }
@@ -0,0 +1,135 @@
+/*
+ * test_ctf_ir_clock_value_ns.c
+ *
+ * CTF IR clock value to nanoseconds conversion test
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "tap/tap.h"
+#include <babeltrace/ctf-ir/clock-class.h>
+#include <babeltrace/ref.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <assert.h>
+
+#define NR_TESTS 8
+
+static
+int64_t get_ns_from_epoch(struct bt_ctf_clock_class *clock_class,
+		uint64_t value)
+{
+	struct bt_ctf_clock_value *clock_value;
+	int64_t ns;
+	int ret;
+
+	clock_value = bt_ctf_clock_value_create(clock_class, value);
+	assert(clock_value);
+	ret = bt_ctf_clock_value_get_value_ns_from_epoch(clock_value, &ns);
+	assert(ret == 0);
+	bt_put(clock_value);
+	return ns;
+}
+
+static
+struct bt_ctf_clock_class *create_clock_class(uint64_t frequency,
+		int64_t offset_s, int64_t offset)
+{
+	struct bt_ctf_clock_class *clock_class;
+	int ret;
+
+	clock_class = bt_ctf_clock_class_create("my-clock");
+	assert(clock_class);
+	ret = bt_ctf_clock_class_set_frequency(clock_class, frequency);
+	assert(ret == 0);
+	ret = bt_ctf_clock_class_set_offset_s(clock_class, offset_s);
+	assert(ret == 0);
+	ret = bt_ctf_clock_class_set_offset_cycles(clock_class, offset);
+	assert(ret == 0);
+	return clock_class;
+}
+
+static
+void test_ghz_clock(void)
+{
+	struct bt_ctf_clock_class *clock_class =
+		create_clock_class(1000000000ULL, 3, 500);
+
+	ok(get_ns_from_epoch(clock_class, 1234) == 3000001734LL,
+		"1 GHz clock value is converted with the offset");
+	bt_put(clock_class);
+}
+
+static
+void test_slow_clock(void)
+{
+	struct bt_ctf_clock_class *clock_class = create_clock_class(3, 0, 0);
+
+	ok(get_ns_from_epoch(clock_class, 1) == 333333333LL,
+		"3 Hz clock value is rounded down");
+	ok(get_ns_from_epoch(clock_class, 3) == 1000000000LL,
+		"3 Hz clock value which is a whole second is exact");
+	bt_put(clock_class);
+}
+
+static
+void test_tsc_clock(void)
+{
+	/* 2.6 GHz: values above 2^53 lose precision with doubles */
+	const uint64_t frequency = 2600000000ULL;
+	struct bt_ctf_clock_class *clock_class =
+		create_clock_class(frequency, 0, 0);
+	uint64_t value = (1ULL << 55) + 12345;
+	uint64_t expected = (value / frequency) * 1000000000ULL +
+		((value % frequency) * 1000000000ULL) / frequency;
+	int64_t ns = get_ns_from_epoch(clock_class, value);
+	int64_t next_ns = get_ns_from_epoch(clock_class, value + 3);
+
+	ok(ns == (int64_t) expected,
+		"2.6 GHz clock value above 2^53 cycles is exact (%" PRId64 ")",
+		ns);
+	ok(next_ns - ns == 1,
+		"2.6 GHz clock values 3 cycles apart are 1 ns apart");
+	bt_put(clock_class);
+}
+
+static
+void test_offsets(void)
+{
+	struct bt_ctf_clock_class *clock_class =
+		create_clock_class(1000, 10, -2500);
+
+	ok(get_ns_from_epoch(clock_class, 0) == 7500000000LL,
+		"negative offset in cycles is converted");
+	ok(get_ns_from_epoch(clock_class, 2500) == 10000000000LL,
+		"value which cancels the offset in cycles gives the offset in seconds");
+	bt_put(clock_class);
+	clock_class = create_clock_class(1000, 0, 0);
+	ok(bt_ctf_clock_class_set_offset_cycles(clock_class, 1) == 0 &&
+		get_ns_from_epoch(clock_class, 0) == 1000000LL,
+		"changing the offset in cycles updates the conversion");
+	bt_put(clock_class);
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+	test_ghz_clock();
+	test_slow_clock();
+	test_tsc_clock();
+	test_offsets();
+	return exit_status();
+}
@@ -0,0 +1,237 @@
+/*
+ * test_ctf_ir_event_pool.c
+ *
+ * CTF IR event pool test
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "tap/tap.h"
+#include <babeltrace/ctf-ir/clock-class.h>
+#include <babeltrace/ctf-ir/event-class.h>
+#include <babeltrace/ctf-ir/event.h>
+#include <babeltrace/ctf-ir/field-types.h>
+#include <babeltrace/ctf-ir/fields.h>
+#include <babeltrace/ctf-ir/stream-class.h>
+#include <babeltrace/ctf-ir/trace.h>
+#include <babeltrace/ref.h>
+#include <stdint.h>
+#include <assert.h>
+
+#define NR_TESTS 14
+
+static struct bt_ctf_trace *trace;
+static struct bt_ctf_stream_class *stream_class;
+static struct bt_ctf_event_class *event_class;
+static struct bt_ctf_event_class *extended_event_class;
+static struct bt_ctf_clock_class *clock_class;
+
+static
+void init_static_data(void)
+{
+	int ret;
+	struct bt_ctf_field_type *empty_struct_ft;
+	struct bt_ctf_field_type *int_ft;
+
+	empty_struct_ft = bt_ctf_field_type_structure_create();
+	assert(empty_struct_ft);
+	int_ft = bt_ctf_field_type_integer_create(32);
+	assert(int_ft);
+	trace = bt_ctf_trace_create();
+	assert(trace);
+	ret = bt_ctf_trace_set_native_byte_order(trace,
+		BT_CTF_BYTE_ORDER_LITTLE_ENDIAN);
+	assert(ret == 0);
+	ret = bt_ctf_trace_set_packet_header_type(trace, empty_struct_ft);
+	assert(ret == 0);
+	clock_class = bt_ctf_clock_class_create("my-clock");
+	assert(clock_class);
+	ret = bt_ctf_trace_add_clock_class(trace, clock_class);
+	assert(ret == 0);
+	stream_class = bt_ctf_stream_class_create("my-stream-class");
+	assert(stream_class);
+	ret = bt_ctf_stream_class_set_packet_context_type(stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_set_event_header_type(stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	event_class = bt_ctf_event_class_create("my-event-class");
+	assert(event_class);
+	ret = bt_ctf_event_class_add_field(event_class, int_ft, "an_int");
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_add_event_class(stream_class, event_class);
+	assert(ret == 0);
+	extended_event_class = bt_ctf_event_class_create(
+		"my-extended-event-class");
+	assert(extended_event_class);
+	ret = bt_ctf_event_class_add_field(extended_event_class, int_ft,
+		"an_int");
+	assert(ret == 0);
+	ret = bt_ctf_event_class_add_field(extended_event_class, int_ft,
+		"an_extra_int");
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_add_event_class(stream_class,
+		extended_event_class);
+	assert(ret == 0);
+	ret = bt_ctf_trace_add_stream_class(trace, stream_class);
+	assert(ret == 0);
+	bt_put(empty_struct_ft);
+	bt_put(int_ft);
+}
+
+static
+void fini_static_data(void)
+{
+	bt_put(clock_class);
+	bt_put(extended_event_class);
+	bt_put(event_class);
+	bt_put(stream_class);
+	bt_put(trace);
+}
+
+static
+void test_event_pool(void)
+{
+	struct bt_ctf_event *event;
+	struct bt_ctf_event *recycled_event;
+	struct bt_ctf_field *payload;
+	struct bt_ctf_field *int_field;
+	struct bt_ctf_field *recycled_int_field;
+	uint64_t value;
+	int ret;
+
+	event = bt_ctf_event_create_pooled(event_class);
+	ok(event, "bt_ctf_event_create_pooled() creates an event");
+	int_field = bt_ctf_event_get_payload(event, "an_int");
+	assert(int_field);
+	ret = bt_ctf_field_unsigned_integer_set_value(int_field, 23);
+	assert(ret == 0);
+	payload = bt_ctf_event_get_event_payload(event);
+	assert(payload);
+	bt_put(payload);
+	bt_put(int_field);
+	bt_put(event);
+
+	recycled_event = bt_ctf_event_create_pooled(event_class);
+	ok(recycled_event == event,
+		"bt_ctf_event_create_pooled() reuses a released event");
+	int_field = bt_ctf_event_get_payload(recycled_event, "an_int");
+	ok(int_field, "recycled event has a payload field");
+	ok(bt_ctf_field_unsigned_integer_get_value(int_field, &value),
+		"recycled event's payload field is reset");
+
+	/* Keep a reference on the payload: it must not be recycled */
+	payload = bt_ctf_event_get_event_payload(recycled_event);
+	assert(payload);
+	ret = bt_ctf_field_unsigned_integer_set_value(int_field, 42);
+	assert(ret == 0);
+	bt_put(int_field);
+	bt_put(recycled_event);
+	recycled_event = bt_ctf_event_create_pooled(event_class);
+	ok(recycled_event == event,
+		"bt_ctf_event_create_pooled() reuses a released event again");
+	recycled_int_field = bt_ctf_event_get_payload(recycled_event,
+		"an_int");
+	ok(recycled_int_field,
+		"recycled event has a new payload field when the previous one is still in use");
+	int_field = bt_ctf_field_structure_get_field_by_name(payload,
+		"an_int");
+	assert(int_field);
+	ok(recycled_int_field != int_field &&
+		bt_ctf_field_unsigned_integer_get_value(int_field, &value) == 0 &&
+		value == 42,
+		"payload field still in use is not modified by the recycled event");
+	bt_put(recycled_int_field);
+	bt_put(int_field);
+	bt_put(payload);
+	bt_put(recycled_event);
+}
+
+static
+void test_extended_event(void)
+{
+	struct bt_ctf_event *event;
+	struct bt_ctf_event *extended_event;
+	struct bt_ctf_field *header;
+	struct bt_ctf_field *extended_header;
+	struct bt_ctf_field *int_field;
+	struct bt_ctf_field *extended_int_field;
+	struct bt_ctf_field *extra_int_field;
+	int ret;
+
+	event = bt_ctf_event_create_pooled(event_class);
+	assert(event);
+	int_field = bt_ctf_event_get_payload(event, "an_int");
+	assert(int_field);
+	ret = bt_ctf_field_unsigned_integer_set_value(int_field, 23);
+	assert(ret == 0);
+	extended_event = bt_ctf_event_create_extended(extended_event_class,
+		event);
+	ok(extended_event,
+		"bt_ctf_event_create_extended() creates an event");
+	header = bt_ctf_event_get_header(event);
+	extended_header = bt_ctf_event_get_header(extended_event);
+	ok(header && header == extended_header,
+		"extended event shares the header field of the same type");
+	extended_int_field = bt_ctf_event_get_payload(extended_event,
+		"an_int");
+	ok(extended_int_field == int_field,
+		"extended event's payload starts with the original payload's fields");
+	extra_int_field = bt_ctf_event_get_payload(extended_event,
+		"an_extra_int");
+	ok(extra_int_field && extra_int_field != int_field &&
+		bt_ctf_field_unsigned_integer_set_value(extra_int_field,
+			42) == 0,
+		"extended event's extra payload field is its own");
+	bt_put(extra_int_field);
+	bt_put(extended_int_field);
+	bt_put(extended_header);
+	bt_put(header);
+	bt_put(int_field);
+	bt_put(extended_event);
+	bt_put(event);
+}
+
+static
+void test_clock_value_pool(void)
+{
+	struct bt_ctf_clock_value *clock_value;
+	struct bt_ctf_clock_value *recycled_clock_value;
+	uint64_t value;
+	int ret;
+
+	clock_value = bt_ctf_clock_value_create(clock_class, 23);
+	ok(clock_value, "bt_ctf_clock_value_create() creates a clock value");
+	bt_put(clock_value);
+	recycled_clock_value = bt_ctf_clock_value_create(clock_class, 42);
+	ok(recycled_clock_value == clock_value,
+		"bt_ctf_clock_value_create() reuses a released clock value");
+	ret = bt_ctf_clock_value_get_value(recycled_clock_value, &value);
+	ok(ret == 0 && value == 42, "recycled clock value has the new value");
+	bt_put(recycled_clock_value);
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+	init_static_data();
+	test_event_pool();
+	test_extended_event();
+	test_clock_value_pool();
+	fini_static_data();
+	return exit_status();
+}
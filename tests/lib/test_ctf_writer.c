@@ -39,10 +39,14 @@
 #include <babeltrace/compat/limits-internal.h>
 #include <babeltrace/compat/stdio-internal.h>
 #include <string.h>
+#include <stdbool.h>
 #include <assert.h>
 #include <sys/wait.h>
 #include <fcntl.h>
 #include <babeltrace/compat/dirent-internal.h>
+#include <babeltrace/endian-internal.h>
+#include <babeltrace/lttng-index-internal.h>
+#include <sys/stat.h>
 #include "tap/tap.h"
 #include <math.h>
 #include <float.h>
@@ -61,7 +65,7 @@
 #define DEFAULT_CLOCK_TIME 0
 #define DEFAULT_CLOCK_VALUE 0
 
-#define NR_TESTS 634
+#define NR_TESTS 655
 
 static int64_t current_time = 42;
 
@@ -87,6 +91,51 @@ end:
 	return ret;
 }
 
+static
+void validate_stream_index(const char *trace_path, const char *stream_name)
+{
+	char path[PATH_MAX];
+	FILE *fp;
+	struct ctf_packet_index_file_hdr hdr;
+	struct ctf_packet_index entry;
+	uint64_t expected_offset = 0;
+	size_t nr_entries = 0;
+	bool entries_ok = true;
+	struct stat st;
+
+	snprintf(path, sizeof(path), "%s/index/%s.idx", trace_path,
+		stream_name);
+	fp = fopen(path, "rb");
+	ok(fp, "CTF writer creates the packet index file of a stream");
+	if (!fp) {
+		skip(2, "No packet index file");
+		return;
+	}
+
+	ok(fread(&hdr, sizeof(hdr), 1, fp) == 1 &&
+		be32toh(hdr.magic) == CTF_INDEX_MAGIC &&
+		be32toh(hdr.packet_index_len) == sizeof(entry),
+		"Packet index file has a valid header");
+
+	while (fread(&entry, sizeof(entry), 1, fp) == 1) {
+		if (be64toh(entry.offset) != expected_offset ||
+				be64toh(entry.content_size) >
+				be64toh(entry.packet_size) ||
+				be64toh(entry.packet_seq_num) != nr_entries) {
+			entries_ok = false;
+		}
+
+		expected_offset += be64toh(entry.packet_size) / CHAR_BIT;
+		nr_entries++;
+	}
+
+	fclose(fp);
+	snprintf(path, sizeof(path), "%s/%s", trace_path, stream_name);
+	ok(entries_ok && nr_entries > 0 && stat(path, &st) == 0 &&
+		st.st_size == expected_offset,
+		"Packet index entries cover the whole stream file");
+}
+
 static
 void validate_trace(char *parser_path, char *trace_path)
 {
@@ -2386,6 +2435,200 @@ end:
 	bt_put(event_header_type);
 }
 
+static
+void test_serialize_on_append_stream(struct bt_ctf_writer *writer,
+		struct bt_ctf_clock *clock)
+{
+	int i, ret = 0;
+	bool released = true;
+	struct bt_ctf_stream_class *stream_class = NULL;
+	struct bt_ctf_stream *stream = NULL, *ret_stream = NULL;
+	struct bt_ctf_event_class *event_class = NULL;
+	struct bt_ctf_event *event = NULL;
+	struct bt_ctf_field_type *integer_type = NULL;
+	struct bt_ctf_field *integer = NULL, *packet_header = NULL;
+
+	stream_class = bt_ctf_stream_class_create(
+		"serialize_on_append_stream");
+	assert(stream_class);
+	ret = bt_ctf_stream_class_set_clock(stream_class, clock);
+	assert(ret == 0);
+	event_class = bt_ctf_event_class_create("serialized_event");
+	assert(event_class);
+	integer_type = bt_ctf_field_type_integer_create(32);
+	assert(integer_type);
+	ret = bt_ctf_event_class_add_field(event_class, integer_type,
+		"integer_field");
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_add_event_class(stream_class, event_class);
+	assert(ret == 0);
+	stream = bt_ctf_writer_create_stream(writer, stream_class);
+	assert(stream);
+
+	/* The trace's packet header has a custom field */
+	packet_header = bt_ctf_stream_get_packet_header(stream);
+	assert(packet_header);
+	integer = bt_ctf_field_structure_get_field(packet_header,
+		"custom_trace_packet_header_field");
+	assert(integer);
+	ret = bt_ctf_field_unsigned_integer_set_value(integer, 3487);
+	assert(ret == 0);
+	BT_PUT(integer);
+
+	ok(bt_ctf_stream_set_serialize_on_append(NULL, 1) < 0,
+		"bt_ctf_stream_set_serialize_on_append handles NULL correctly");
+	ok(bt_ctf_stream_set_serialize_on_append(stream, 1) == 0,
+		"bt_ctf_stream_set_serialize_on_append enables the mode on an empty stream");
+
+	/* Two packets of 500 events, the second one needing a resize */
+	for (i = 0; i < 1000; i++) {
+		event = bt_ctf_event_create(event_class);
+		assert(event);
+		integer = bt_ctf_event_get_payload(event, "integer_field");
+		assert(integer);
+		ret = bt_ctf_field_unsigned_integer_set_value(integer, i);
+		assert(ret == 0);
+		BT_PUT(integer);
+		ret = bt_ctf_clock_set_time(clock, ++current_time);
+		assert(ret == 0);
+		ret = bt_ctf_stream_append_event(stream, event);
+		if (ret) {
+			break;
+		}
+
+		ret_stream = bt_ctf_event_get_stream(event);
+		if (ret_stream) {
+			released = false;
+		}
+
+		BT_PUT(ret_stream);
+		BT_PUT(event);
+
+		if (i == 0) {
+			ok(bt_ctf_stream_set_serialize_on_append(stream, 0) < 0,
+				"bt_ctf_stream_set_serialize_on_append fails when the current packet is not empty");
+		}
+
+		if (i == 499) {
+			ret = bt_ctf_stream_flush(stream);
+			if (ret) {
+				break;
+			}
+		}
+	}
+
+	ok(ret == 0, "Append events to a stream in serialize-on-append mode");
+	ok(released,
+		"Stream releases the events which it serializes on append");
+	ok(bt_ctf_stream_flush(stream) == 0,
+		"Flush a stream in serialize-on-append mode");
+
+	bt_put(event);
+	bt_put(ret_stream);
+	bt_put(integer);
+	bt_put(packet_header);
+	bt_put(integer_type);
+	bt_put(event_class);
+	bt_put(stream);
+	bt_put(stream_class);
+}
+
+static
+void test_packet_allocation_stream(struct bt_ctf_writer *writer,
+		struct bt_ctf_clock *clock)
+{
+	int i, ret = 0;
+	struct bt_ctf_stream_class *stream_class = NULL;
+	struct bt_ctf_stream *stream = NULL;
+	struct bt_ctf_event_class *event_class = NULL;
+	struct bt_ctf_event *event = NULL;
+	struct bt_ctf_field_type *integer_type = NULL;
+	struct bt_ctf_field *integer = NULL, *packet_header = NULL;
+
+	stream_class = bt_ctf_stream_class_create("packet_allocation_stream");
+	assert(stream_class);
+	ret = bt_ctf_stream_class_set_clock(stream_class, clock);
+	assert(ret == 0);
+	event_class = bt_ctf_event_class_create("allocated_event");
+	assert(event_class);
+	integer_type = bt_ctf_field_type_integer_create(64);
+	assert(integer_type);
+	ret = bt_ctf_event_class_add_field(event_class, integer_type,
+		"integer_field");
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_add_event_class(stream_class, event_class);
+	assert(ret == 0);
+	stream = bt_ctf_writer_create_stream(writer, stream_class);
+	assert(stream);
+	packet_header = bt_ctf_stream_get_packet_header(stream);
+	assert(packet_header);
+	integer = bt_ctf_field_structure_get_field(packet_header,
+		"custom_trace_packet_header_field");
+	assert(integer);
+	ret = bt_ctf_field_unsigned_integer_set_value(integer, 3487);
+	assert(ret == 0);
+	BT_PUT(integer);
+
+	ok(bt_ctf_stream_set_packet_allocation(NULL, 4096, 0, 0) < 0,
+		"bt_ctf_stream_set_packet_allocation handles NULL correctly");
+	ok(bt_ctf_stream_set_packet_allocation(stream, 0, 0, 0) < 0,
+		"bt_ctf_stream_set_packet_allocation rejects a packet size of 0");
+
+	/* Small buffered packets which need to grow, large extents */
+	ok(bt_ctf_stream_set_packet_allocation(stream, 512, 1 << 20, 1) == 0,
+		"bt_ctf_stream_set_packet_allocation sets a buffered allocation");
+
+	for (i = 0; i < 300; i++) {
+		event = bt_ctf_event_create(event_class);
+		assert(event);
+		integer = bt_ctf_event_get_payload(event, "integer_field");
+		assert(integer);
+		ret = bt_ctf_field_unsigned_integer_set_value(integer, i);
+		assert(ret == 0);
+		BT_PUT(integer);
+		ret = bt_ctf_clock_set_time(clock, ++current_time);
+		assert(ret == 0);
+		ret = bt_ctf_stream_append_event(stream, event);
+		BT_PUT(event);
+		if (ret) {
+			break;
+		}
+
+		if (i % 100 == 99) {
+			ret = bt_ctf_stream_flush(stream);
+			if (ret) {
+				break;
+			}
+		}
+	}
+
+	ok(ret == 0,
+		"Append and flush events with a buffered packet allocation");
+
+	/* Back to mapped packets */
+	ok(bt_ctf_stream_set_packet_allocation(stream, 8192, 0, 0) == 0,
+		"bt_ctf_stream_set_packet_allocation sets a mapped allocation");
+	event = bt_ctf_event_create(event_class);
+	assert(event);
+	integer = bt_ctf_event_get_payload(event, "integer_field");
+	assert(integer);
+	ret = bt_ctf_field_unsigned_integer_set_value(integer, i);
+	assert(ret == 0);
+	ret = bt_ctf_clock_set_time(clock, ++current_time);
+	assert(ret == 0);
+	ok(bt_ctf_stream_append_event(stream, event) == 0 &&
+		bt_ctf_stream_flush(stream) == 0,
+		"Append and flush an event with a mapped packet allocation");
+
+	bt_put(event);
+	bt_put(integer);
+	bt_put(packet_header);
+	bt_put(integer_type);
+	bt_put(event_class);
+	bt_put(stream);
+	bt_put(stream_class);
+}
+
 static
 void test_instanciate_event_before_stream(struct bt_ctf_writer *writer,
 		struct bt_ctf_clock *clock)
@@ -3563,6 +3806,10 @@ int main(int argc, char **argv)
 
 	test_custom_event_header_stream(writer, clock);
 
+	test_serialize_on_append_stream(writer, clock);
+
+	test_packet_allocation_stream(writer, clock);
+
 	test_static_trace();
 
 	test_trace_is_static_listener();
@@ -3591,6 +3838,9 @@ int main(int argc, char **argv)
 	free(metadata_string);
 	bt_put(stream_class);
 
+	validate_stream_index(trace_path, "test_stream_0");
+	validate_stream_index(trace_path, "serialize_on_append_stream_0");
+	validate_stream_index(trace_path, "packet_allocation_stream_0");
 	validate_trace(argv[1], trace_path);
 
 	//recursive_rmdir(trace_path);
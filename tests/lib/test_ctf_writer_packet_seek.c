@@ -0,0 +1,205 @@
+/*
+ * test_ctf_writer_packet_seek.c
+ *
+ * CTF writer packet seeking failure test
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "tap/tap.h"
+#include <babeltrace/ctf-writer/writer.h>
+#include <babeltrace/ctf-writer/clock.h>
+#include <babeltrace/ctf-writer/stream.h>
+#include <babeltrace/ctf-writer/stream-class.h>
+#include <babeltrace/ctf-writer/event.h>
+#include <babeltrace/ctf-writer/event-types.h>
+#include <babeltrace/ctf-writer/event-fields.h>
+#include <babeltrace/ref.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "common.h"
+
+#define NR_TESTS 6
+
+#define PACKET_SIZE		4096
+#define CTF_MAGIC		0xC1FC1FC1U
+#define FIRST_VALUE		UINT64_C(0x0123456789abcdef)
+#define SECOND_VALUE		UINT64_C(0xfedcba9876543210)
+
+/* True to make munmap() fail */
+static bool fail_munmap;
+
+/*
+ * Overrides the C library's munmap() so that the CTF writer fails to
+ * unmap its current packet while fail_munmap is true.
+ */
+int munmap(void *addr, size_t length)
+{
+	if (fail_munmap) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return (int) syscall(SYS_munmap, addr, length);
+}
+
+static
+void append_event(struct bt_ctf_stream *stream,
+		struct bt_ctf_event_class *event_class,
+		struct bt_ctf_clock *clock, uint64_t value)
+{
+	struct bt_ctf_event *event = bt_ctf_event_create(event_class);
+	struct bt_ctf_field *field;
+	int ret;
+
+	assert(event);
+	field = bt_ctf_event_get_payload(event, "value");
+	assert(field);
+	ret = bt_ctf_field_unsigned_integer_set_value(field, value);
+	assert(ret == 0);
+	bt_put(field);
+	ret = bt_ctf_clock_set_time(clock, (int64_t) (value & 0xffff));
+	assert(ret == 0);
+	ret = bt_ctf_stream_append_event(stream, event);
+	assert(ret == 0);
+	bt_put(event);
+}
+
+/* Returns true if `buf` contains the native representation of `value` */
+static
+bool buf_contains_value(const char *buf, size_t len, uint64_t value)
+{
+	size_t i;
+
+	for (i = 0; i + sizeof(value) <= len; i++) {
+		if (memcmp(buf + i, &value, sizeof(value)) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static
+bool packet_is_intact(const char *buf, uint64_t value)
+{
+	uint32_t magic;
+
+	memcpy(&magic, buf, sizeof(magic));
+	return magic == CTF_MAGIC &&
+		buf_contains_value(buf, PACKET_SIZE, value);
+}
+
+static
+void test_unmap_failure(void)
+{
+	char trace_path[] = "/tmp/ctfwriter_seek_XXXXXX";
+	char stream_path[sizeof(trace_path) + 32];
+	static char buf[2 * PACKET_SIZE];
+	struct bt_ctf_writer *writer;
+	struct bt_ctf_clock *clock;
+	struct bt_ctf_stream_class *stream_class;
+	struct bt_ctf_stream *stream;
+	struct bt_ctf_event_class *event_class;
+	struct bt_ctf_field_type *uint_64_type;
+	struct stat st;
+	ssize_t read_len;
+	int fd;
+	int ret;
+
+	if (!mkdtemp(trace_path)) {
+		perror("# perror");
+		abort();
+	}
+
+	writer = bt_ctf_writer_create(trace_path);
+	assert(writer);
+	clock = bt_ctf_clock_create("test_clock");
+	assert(clock);
+	ret = bt_ctf_writer_add_clock(writer, clock);
+	assert(ret == 0);
+	stream_class = bt_ctf_stream_class_create("test_stream");
+	assert(stream_class);
+	ret = bt_ctf_stream_class_set_clock(stream_class, clock);
+	assert(ret == 0);
+	event_class = bt_ctf_event_class_create("test_event");
+	assert(event_class);
+	uint_64_type = bt_ctf_field_type_integer_create(64);
+	assert(uint_64_type);
+	ret = bt_ctf_event_class_add_field(event_class, uint_64_type,
+		"value");
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_add_event_class(stream_class, event_class);
+	assert(ret == 0);
+	stream = bt_ctf_writer_create_stream(writer, stream_class);
+	assert(stream);
+	ret = bt_ctf_stream_set_packet_allocation(stream, PACKET_SIZE, 0, 0);
+	assert(ret == 0);
+
+	append_event(stream, event_class, clock, FIRST_VALUE);
+	ok(bt_ctf_stream_flush(stream) == 0, "First packet is flushed");
+
+	/* Opening the second packet unmaps the first one */
+	append_event(stream, event_class, clock, SECOND_VALUE);
+	fail_munmap = true;
+	ok(bt_ctf_stream_flush(stream) < 0,
+		"Flushing fails when the previous packet cannot be unmapped");
+	fail_munmap = false;
+	ok(bt_ctf_stream_flush(stream) == 0,
+		"Second packet is flushed once the previous packet is unmapped");
+
+	bt_put(stream);
+	bt_put(uint_64_type);
+	bt_put(event_class);
+	bt_put(stream_class);
+	bt_put(clock);
+	bt_put(writer);
+
+	/* The stream file is truncated to its final size at this point */
+	snprintf(stream_path, sizeof(stream_path), "%s/test_stream_0",
+		trace_path);
+	ret = stat(stream_path, &st);
+	assert(ret == 0);
+	ok(st.st_size == 2 * PACKET_SIZE, "Stream file contains two packets");
+	fd = open(stream_path, O_RDONLY);
+	assert(fd >= 0);
+	read_len = read(fd, buf, sizeof(buf));
+	assert(read_len >= 0);
+	(void) close(fd);
+	ok(read_len == sizeof(buf) && packet_is_intact(buf, FIRST_VALUE),
+		"First packet is intact");
+	ok(read_len == sizeof(buf) &&
+		packet_is_intact(buf + PACKET_SIZE, SECOND_VALUE),
+		"Second packet follows the first one");
+	recursive_rmdir(trace_path);
+}
+
+int main(void)
+{
+	plan_tests(NR_TESTS);
+	test_unmap_failure();
+	return exit_status();
+}
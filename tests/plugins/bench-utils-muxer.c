@@ -0,0 +1,513 @@
+/*
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Muxer benchmark: a source component with N output ports, each one
+ * emitting interleaved timestamped events, is connected to a
+ * utils.muxer component which is connected to a counting sink. The
+ * time to run the graph is reported for each N.
+ *
+ * Usage:
+ *
+ *     BABELTRACE_PLUGIN_PATH=plugins/utils \
+ *         tests/plugins/bench-utils-muxer [EVENTS-PER-PORT [N...]]
+ *
+ * Without any N, the benchmark runs with 1, 64, and 1024 input ports.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <time.h>
+#include <babeltrace/ctf-ir/event-class.h>
+#include <babeltrace/ctf-ir/event.h>
+#include <babeltrace/ctf-ir/field-types.h>
+#include <babeltrace/ctf-ir/packet.h>
+#include <babeltrace/ctf-ir/stream-class.h>
+#include <babeltrace/ctf-ir/stream.h>
+#include <babeltrace/ctf-ir/trace.h>
+#include <babeltrace/graph/clock-class-priority-map.h>
+#include <babeltrace/graph/component-class-sink.h>
+#include <babeltrace/graph/component-class-source.h>
+#include <babeltrace/graph/component-class.h>
+#include <babeltrace/graph/component-filter.h>
+#include <babeltrace/graph/component-sink.h>
+#include <babeltrace/graph/component-source.h>
+#include <babeltrace/graph/component.h>
+#include <babeltrace/graph/graph.h>
+#include <babeltrace/graph/notification-event.h>
+#include <babeltrace/graph/notification-iterator.h>
+#include <babeltrace/graph/notification-packet.h>
+#include <babeltrace/graph/port.h>
+#include <babeltrace/graph/private-component-source.h>
+#include <babeltrace/graph/private-component-sink.h>
+#include <babeltrace/graph/private-component.h>
+#include <babeltrace/graph/private-connection.h>
+#include <babeltrace/graph/private-notification-iterator.h>
+#include <babeltrace/graph/private-port.h>
+#include <babeltrace/plugin/plugin.h>
+#include <babeltrace/ref.h>
+#include <glib.h>
+
+#define DEFAULT_EVENTS_PER_PORT	2000
+
+static uint64_t nb_ports;
+static uint64_t events_per_port = DEFAULT_EVENTS_PER_PORT;
+static uint64_t nb_consumed_notifs;
+static struct bt_clock_class_priority_map *src_cc_prio_map;
+static struct bt_ctf_clock_class *src_clock_class;
+static struct bt_ctf_stream_class *src_stream_class;
+static struct bt_ctf_event_class *src_event_class;
+
+struct src_iter_user_data {
+	uint64_t iter_index;
+	uint64_t at;
+	struct bt_ctf_packet *packet;
+};
+
+struct sink_user_data {
+	struct bt_notification_iterator *notif_iter;
+};
+
+static
+void init_static_data(void)
+{
+	int ret;
+	struct bt_ctf_trace *trace;
+	struct bt_ctf_field_type *empty_struct_ft;
+
+	empty_struct_ft = bt_ctf_field_type_structure_create();
+	assert(empty_struct_ft);
+	trace = bt_ctf_trace_create();
+	assert(trace);
+	ret = bt_ctf_trace_set_native_byte_order(trace,
+		BT_CTF_BYTE_ORDER_LITTLE_ENDIAN);
+	assert(ret == 0);
+	ret = bt_ctf_trace_set_packet_header_type(trace, empty_struct_ft);
+	assert(ret == 0);
+	src_clock_class = bt_ctf_clock_class_create("my-clock");
+	assert(src_clock_class);
+	ret = bt_ctf_clock_class_set_is_absolute(src_clock_class, 1);
+	assert(ret == 0);
+	ret = bt_ctf_trace_add_clock_class(trace, src_clock_class);
+	assert(ret == 0);
+	src_cc_prio_map = bt_clock_class_priority_map_create();
+	assert(src_cc_prio_map);
+	ret = bt_clock_class_priority_map_add_clock_class(src_cc_prio_map,
+		src_clock_class, 0);
+	assert(ret == 0);
+	src_stream_class = bt_ctf_stream_class_create("my-stream-class");
+	assert(src_stream_class);
+	ret = bt_ctf_stream_class_set_packet_context_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_set_event_header_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_set_event_context_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	src_event_class = bt_ctf_event_class_create("my-event-class");
+	assert(src_event_class);
+	ret = bt_ctf_event_class_set_context_type(src_event_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_ctf_stream_class_add_event_class(src_stream_class,
+		src_event_class);
+	assert(ret == 0);
+	ret = bt_ctf_trace_add_stream_class(trace, src_stream_class);
+	assert(ret == 0);
+	bt_put(trace);
+	bt_put(empty_struct_ft);
+}
+
+static
+void fini_static_data(void)
+{
+	bt_put(src_cc_prio_map);
+	bt_put(src_clock_class);
+	bt_put(src_stream_class);
+	bt_put(src_event_class);
+}
+
+static
+void src_iter_finalize(
+		struct bt_private_notification_iterator *private_notification_iterator)
+{
+	struct src_iter_user_data *user_data =
+		bt_private_notification_iterator_get_user_data(
+			private_notification_iterator);
+
+	if (user_data) {
+		bt_put(user_data->packet);
+		g_free(user_data);
+	}
+}
+
+static
+enum bt_notification_iterator_status src_iter_init(
+		struct bt_private_notification_iterator *priv_notif_iter,
+		struct bt_private_port *private_port)
+{
+	struct src_iter_user_data *user_data =
+		g_new0(struct src_iter_user_data, 1);
+	struct bt_port *port = bt_port_from_private_port(private_port);
+	struct bt_ctf_stream *stream;
+	const char *port_name;
+	int ret;
+
+	assert(user_data);
+	assert(port);
+	ret = bt_private_notification_iterator_set_user_data(priv_notif_iter,
+		user_data);
+	assert(ret == 0);
+	port_name = bt_port_get_name(port);
+	assert(port_name);
+	user_data->iter_index = g_ascii_strtoull(&port_name[3], NULL, 10);
+	stream = bt_ctf_stream_create(src_stream_class, port_name);
+	assert(stream);
+	user_data->packet = bt_ctf_packet_create(stream);
+	assert(user_data->packet);
+	bt_put(stream);
+	bt_put(port);
+	return BT_NOTIFICATION_ITERATOR_STATUS_OK;
+}
+
+static
+struct bt_notification_iterator_next_return src_iter_next(
+		struct bt_private_notification_iterator *priv_iterator)
+{
+	struct bt_notification_iterator_next_return next_return = {
+		.notification = NULL,
+		.status = BT_NOTIFICATION_ITERATOR_STATUS_OK,
+	};
+	struct src_iter_user_data *user_data =
+		bt_private_notification_iterator_get_user_data(priv_iterator);
+
+	assert(user_data);
+
+	if (user_data->at == 0) {
+		next_return.notification =
+			bt_notification_packet_begin_create(user_data->packet);
+		assert(next_return.notification);
+	} else if (user_data->at <= events_per_port) {
+		struct bt_ctf_event *event;
+		struct bt_ctf_clock_value *clock_value;
+		int ret;
+
+		/*
+		 * Interleave the events of all the ports so that the
+		 * muxer switches from one upstream iterator to another
+		 * for each event.
+		 */
+		event = bt_ctf_event_create(src_event_class);
+		assert(event);
+		ret = bt_ctf_event_set_packet(event, user_data->packet);
+		assert(ret == 0);
+		clock_value = bt_ctf_clock_value_create(src_clock_class,
+			(user_data->at - 1) * nb_ports + user_data->iter_index);
+		assert(clock_value);
+		ret = bt_ctf_event_set_clock_value(event, clock_value);
+		assert(ret == 0);
+		bt_put(clock_value);
+		next_return.notification = bt_notification_event_create(event,
+			src_cc_prio_map);
+		assert(next_return.notification);
+		bt_put(event);
+	} else if (user_data->at == events_per_port + 1) {
+		next_return.notification =
+			bt_notification_packet_end_create(user_data->packet);
+		assert(next_return.notification);
+	} else {
+		next_return.status = BT_NOTIFICATION_ITERATOR_STATUS_END;
+		goto end;
+	}
+
+	user_data->at++;
+
+end:
+	return next_return;
+}
+
+static
+enum bt_component_status src_init(
+		struct bt_private_component *private_component,
+		struct bt_value *params, void *init_method_data)
+{
+	uint64_t i;
+
+	for (i = 0; i < nb_ports; i++) {
+		char port_name[32];
+		int ret;
+
+		snprintf(port_name, sizeof(port_name), "out%" PRIu64, i);
+		ret = bt_private_component_source_add_output_private_port(
+			private_component, port_name, NULL, NULL);
+		assert(ret == 0);
+	}
+
+	return BT_COMPONENT_STATUS_OK;
+}
+
+static
+enum bt_component_status sink_consume(
+		struct bt_private_component *priv_component)
+{
+	struct sink_user_data *user_data =
+		bt_private_component_get_user_data(priv_component);
+	enum bt_notification_iterator_status it_ret;
+
+	assert(user_data && user_data->notif_iter);
+	it_ret = bt_notification_iterator_next(user_data->notif_iter);
+
+	switch (it_ret) {
+	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
+		nb_consumed_notifs++;
+		return BT_COMPONENT_STATUS_OK;
+	case BT_NOTIFICATION_ITERATOR_STATUS_END:
+		BT_PUT(user_data->notif_iter);
+		return BT_COMPONENT_STATUS_END;
+	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
+		return BT_COMPONENT_STATUS_AGAIN;
+	default:
+		return BT_COMPONENT_STATUS_ERROR;
+	}
+}
+
+static
+void sink_port_connected(struct bt_private_component *private_component,
+		struct bt_private_port *self_private_port,
+		struct bt_port *other_port)
+{
+	struct bt_private_connection *priv_conn =
+		bt_private_port_get_private_connection(self_private_port);
+	struct sink_user_data *user_data = bt_private_component_get_user_data(
+		private_component);
+	enum bt_connection_status conn_status;
+
+	assert(user_data);
+	assert(priv_conn);
+	conn_status = bt_private_connection_create_notification_iterator(
+		priv_conn, NULL, &user_data->notif_iter);
+	assert(conn_status == 0);
+	bt_put(priv_conn);
+}
+
+static
+enum bt_component_status sink_init(
+		struct bt_private_component *private_component,
+		struct bt_value *params, void *init_method_data)
+{
+	struct sink_user_data *user_data = g_new0(struct sink_user_data, 1);
+	int ret;
+
+	assert(user_data);
+	ret = bt_private_component_set_user_data(private_component,
+		user_data);
+	assert(ret == 0);
+	ret = bt_private_component_sink_add_input_private_port(
+		private_component, "in", NULL, NULL);
+	assert(ret == 0);
+	return BT_COMPONENT_STATUS_OK;
+}
+
+static
+void sink_finalize(struct bt_private_component *private_component)
+{
+	struct sink_user_data *user_data = bt_private_component_get_user_data(
+		private_component);
+
+	if (user_data) {
+		bt_put(user_data->notif_iter);
+		g_free(user_data);
+	}
+}
+
+static
+struct bt_graph *create_graph(void)
+{
+	struct bt_component_class *src_comp_class;
+	struct bt_component_class *muxer_comp_class;
+	struct bt_component_class *sink_comp_class;
+	struct bt_component *src_comp;
+	struct bt_component *muxer_comp;
+	struct bt_component *sink_comp;
+	struct bt_port *upstream_port;
+	struct bt_port *downstream_port;
+	struct bt_graph *graph;
+	uint64_t i;
+	int ret;
+
+	graph = bt_graph_create();
+	assert(graph);
+
+	/* Create source component */
+	src_comp_class = bt_component_class_source_create("src", src_iter_next);
+	assert(src_comp_class);
+	ret = bt_component_class_set_init_method(src_comp_class, src_init);
+	assert(ret == 0);
+	ret = bt_component_class_source_set_notification_iterator_init_method(
+		src_comp_class, src_iter_init);
+	assert(ret == 0);
+	ret = bt_component_class_source_set_notification_iterator_finalize_method(
+		src_comp_class, src_iter_finalize);
+	assert(ret == 0);
+	ret = bt_graph_add_component(graph, src_comp_class, "source", NULL,
+		&src_comp);
+	assert(ret == 0);
+
+	/* Create muxer component */
+	muxer_comp_class = bt_plugin_find_component_class("utils", "muxer",
+		BT_COMPONENT_CLASS_TYPE_FILTER);
+	if (!muxer_comp_class) {
+		fprintf(stderr, "Cannot find the utils.muxer component class: is BABELTRACE_PLUGIN_PATH set?\n");
+		exit(1);
+	}
+
+	ret = bt_graph_add_component(graph, muxer_comp_class, "muxer", NULL,
+		&muxer_comp);
+	assert(ret == 0);
+
+	/* Create sink component */
+	sink_comp_class = bt_component_class_sink_create("sink", sink_consume);
+	assert(sink_comp_class);
+	ret = bt_component_class_set_init_method(sink_comp_class, sink_init);
+	assert(ret == 0);
+	ret = bt_component_class_set_finalize_method(sink_comp_class,
+		sink_finalize);
+	assert(ret == 0);
+	ret = bt_component_class_set_port_connected_method(sink_comp_class,
+		sink_port_connected);
+	assert(ret == 0);
+	ret = bt_graph_add_component(graph, sink_comp_class, "sink", NULL,
+		&sink_comp);
+	assert(ret == 0);
+
+	/* Connect source output ports to muxer input ports */
+	for (i = 0; i < nb_ports; i++) {
+		upstream_port = bt_component_source_get_output_port_by_index(
+			src_comp, i);
+		assert(upstream_port);
+		downstream_port = bt_component_filter_get_input_port_by_index(
+			muxer_comp, i);
+		assert(downstream_port);
+		ret = bt_graph_connect_ports(graph, upstream_port,
+			downstream_port, NULL);
+		assert(ret == 0);
+		bt_put(upstream_port);
+		bt_put(downstream_port);
+	}
+
+	/* Connect muxer output port to sink input port */
+	upstream_port = bt_component_filter_get_output_port_by_name(muxer_comp,
+		"out");
+	assert(upstream_port);
+	downstream_port = bt_component_sink_get_input_port_by_name(sink_comp,
+		"in");
+	assert(downstream_port);
+	ret = bt_graph_connect_ports(graph, upstream_port, downstream_port,
+		NULL);
+	assert(ret == 0);
+	bt_put(upstream_port);
+	bt_put(downstream_port);
+
+	bt_put(src_comp);
+	bt_put(muxer_comp);
+	bt_put(sink_comp);
+	bt_put(src_comp_class);
+	bt_put(muxer_comp_class);
+	bt_put(sink_comp_class);
+	return graph;
+}
+
+static
+double get_time_s(void)
+{
+	struct timespec ts;
+	int ret;
+
+	ret = clock_gettime(CLOCK_MONOTONIC, &ts);
+	assert(ret == 0);
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static
+int run_bench(uint64_t ports)
+{
+	struct bt_graph *graph;
+	enum bt_graph_status graph_status = BT_GRAPH_STATUS_OK;
+	double begin, elapsed;
+
+	nb_ports = ports;
+	nb_consumed_notifs = 0;
+	graph = create_graph();
+	begin = get_time_s();
+
+	while (graph_status == BT_GRAPH_STATUS_OK ||
+			graph_status == BT_GRAPH_STATUS_AGAIN) {
+		graph_status = bt_graph_run(graph);
+	}
+
+	elapsed = get_time_s() - begin;
+	bt_put(graph);
+
+	if (graph_status != BT_GRAPH_STATUS_END) {
+		fprintf(stderr, "Graph failed with %d input ports\n",
+			(int) ports);
+		return -1;
+	}
+
+	printf("%6" PRIu64 " input ports: %10" PRIu64 " notifications in %8.3f s (%7.1f ns/notification)\n",
+		ports, nb_consumed_notifs, elapsed,
+		nb_consumed_notifs ? elapsed * 1e9 / nb_consumed_notifs : 0.);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	static const uint64_t default_ports[] = { 1, 64, 1024 };
+	int ret = 0;
+	int i;
+
+	if (argc >= 2) {
+		events_per_port = g_ascii_strtoull(argv[1], NULL, 10);
+	}
+
+	init_static_data();
+
+	if (argc >= 3) {
+		for (i = 2; i < argc; i++) {
+			ret = run_bench(g_ascii_strtoull(argv[i], NULL, 10));
+			if (ret) {
+				goto end;
+			}
+		}
+	} else {
+		for (i = 0; i < (int) G_N_ELEMENTS(default_ports); i++) {
+			ret = run_bench(default_ports[i]);
+			if (ret) {
+				goto end;
+			}
+		}
+	}
+
+end:
+	fini_static_data();
+	return ret ? 1 : 0;
+}
@@ -0,0 +1,626 @@
+/*
+ * fake-relayd.c
+ *
+ * Minimal LTTng relay daemon serving a synthetic live session
+ *
+ * Copyright (c) 2017 EfficiOS Inc. and Linux Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Serves the live session "fake-host/fake-session", made of STREAMS
+ * streams of PACKETS packets of EVENTS_PER_PACKET events each, to the
+ * viewers which connect to 127.0.0.1:<port>. The port is printed on the
+ * first line of the standard output once the daemon listens.
+ *
+ * The event `seq` field counts the events of a stream, and the
+ * timestamps of the streams interleave.
+ *
+ * When MAX_PACKET_REPLY is set, GET_PACKET responses carry at most this
+ * number of bytes, like a relay daemon which sends short reads.
+ *
+ * When SPLIT_DELAY_US is set, each GET_PACKET response is sent in two
+ * parts, the second one this number of microseconds after the first,
+ * like a response which crosses a slow network.
+ *
+ * The daemon exits once a viewer which attached the session
+ * disconnects, after printing the number of GET_PACKET requests it
+ * received, and how many of them were received while the viewer was
+ * not waiting for a response (pipelined requests):
+ *
+ *     get-packet-requests <count>
+ *     pipelined-get-packet-requests <count>
+ *
+ * Usage:
+ *
+ *     tests/plugins/fake-relayd STREAMS PACKETS EVENTS_PER_PACKET
+ *         [MAX_PACKET_REPLY [SPLIT_DELAY_US]]
+ */
+
+#include <babeltrace/endian-internal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "ctf/lttng-live/lttng-viewer-abi.h"
+
+#define SESSION_ID		1
+#define CTF_TRACE_ID		1
+#define METADATA_STREAM_ID	0
+#define HOSTNAME		"fake-host"
+#define SESSION_NAME		"fake-session"
+
+#define PACKET_MAGIC		0xC1FC1FC1
+#define PACKET_HEADER_LEN	8	/* magic, stream_id */
+#define PACKET_CONTEXT_LEN	32	/* timestamps, content and packet sizes */
+#define EVENT_LEN		28	/* id, timestamp, stream, seq */
+#define PACKET_ALIGN		4096
+
+static const char metadata[] =
+	"/* CTF 1.8 */\n"
+	"typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n"
+	"typealias integer { size = 64; align = 8; signed = false; } := uint64_t;\n"
+	"trace {\n"
+	"	major = 1;\n"
+	"	minor = 8;\n"
+	"	byte_order = le;\n"
+	"	packet.header := struct {\n"
+	"		uint32_t magic;\n"
+	"		uint32_t stream_id;\n"
+	"	};\n"
+	"};\n"
+	"env {\n"
+	"	hostname = \"" HOSTNAME "\";\n"
+	"};\n"
+	"clock {\n"
+	"	name = fake_clock;\n"
+	"	freq = 1000000000;\n"
+	"};\n"
+	"typealias integer { size = 64; align = 8; signed = false;\n"
+	"	map = clock.fake_clock.value; } := fake_clock_t;\n"
+	"stream {\n"
+	"	id = 0;\n"
+	"	packet.context := struct {\n"
+	"		fake_clock_t timestamp_begin;\n"
+	"		fake_clock_t timestamp_end;\n"
+	"		uint64_t content_size;\n"
+	"		uint64_t packet_size;\n"
+	"	};\n"
+	"	event.header := struct {\n"
+	"		uint32_t id;\n"
+	"		fake_clock_t timestamp;\n"
+	"	};\n"
+	"};\n"
+	"event {\n"
+	"	name = \"fake_event\";\n"
+	"	id = 0;\n"
+	"	stream_id = 0;\n"
+	"	fields := struct {\n"
+	"		uint64_t stream;\n"
+	"		uint64_t seq;\n"
+	"	};\n"
+	"};\n";
+
+struct fake_stream {
+	uint64_t next_packet;
+	bool hung_up;
+};
+
+struct fake_relayd {
+	uint64_t nr_streams;
+	uint64_t nr_packets;
+	uint64_t events_per_packet;
+	uint32_t max_packet_reply;
+	unsigned int split_delay_us;
+	uint64_t content_len;
+	uint64_t packet_len;
+	struct fake_stream *streams;
+	uint8_t *packet_buf;
+	bool metadata_sent;
+	bool attached;
+	uint64_t get_packet_requests;
+	uint64_t pipelined_get_packet_requests;
+};
+
+static
+int recv_all(int fd, void *buf, size_t len)
+{
+	size_t copied = 0;
+
+	while (copied < len) {
+		ssize_t ret = recv(fd, (uint8_t *) buf + copied,
+			len - copied, 0);
+
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		}
+		if (ret <= 0) {
+			return -1;
+		}
+		copied += ret;
+	}
+	return 0;
+}
+
+static
+int send_all(int fd, const void *buf, size_t len)
+{
+	size_t copied = 0;
+
+	while (copied < len) {
+		ssize_t ret = send(fd, (const uint8_t *) buf + copied,
+			len - copied, 0);
+
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		}
+		if (ret <= 0) {
+			return -1;
+		}
+		copied += ret;
+	}
+	return 0;
+}
+
+static
+uint64_t event_timestamp(struct fake_relayd *relayd, uint64_t stream_index,
+		uint64_t seq)
+{
+	return (seq + 1) * relayd->nr_streams + stream_index;
+}
+
+static
+void write_u32(uint8_t **pos, uint32_t value)
+{
+	value = htole32(value);
+	memcpy(*pos, &value, sizeof(value));
+	*pos += sizeof(value);
+}
+
+static
+void write_u64(uint8_t **pos, uint64_t value)
+{
+	value = htole64(value);
+	memcpy(*pos, &value, sizeof(value));
+	*pos += sizeof(value);
+}
+
+static
+void build_packet(struct fake_relayd *relayd, uint64_t stream_index,
+		uint64_t packet_index)
+{
+	uint64_t first_seq = packet_index * relayd->events_per_packet;
+	uint64_t last_seq = first_seq + relayd->events_per_packet - 1;
+	uint8_t *pos = relayd->packet_buf;
+	uint64_t seq;
+
+	memset(relayd->packet_buf, 0, relayd->packet_len);
+	write_u32(&pos, PACKET_MAGIC);
+	write_u32(&pos, 0);
+	write_u64(&pos, event_timestamp(relayd, stream_index, first_seq));
+	write_u64(&pos, event_timestamp(relayd, stream_index, last_seq));
+	write_u64(&pos, relayd->content_len * CHAR_BIT);
+	write_u64(&pos, relayd->packet_len * CHAR_BIT);
+	for (seq = first_seq; seq <= last_seq; seq++) {
+		write_u32(&pos, 0);
+		write_u64(&pos, event_timestamp(relayd, stream_index, seq));
+		write_u64(&pos, stream_index);
+		write_u64(&pos, seq);
+	}
+}
+
+static
+bool all_streams_hung_up(struct fake_relayd *relayd)
+{
+	uint64_t i;
+
+	for (i = 0; i < relayd->nr_streams; i++) {
+		if (!relayd->streams[i].hung_up) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static
+int send_streams(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_stream stream;
+	uint64_t i;
+
+	memset(&stream, 0, sizeof(stream));
+	stream.id = htobe64(METADATA_STREAM_ID);
+	stream.ctf_trace_id = htobe64(CTF_TRACE_ID);
+	stream.metadata_flag = htobe32(1);
+	snprintf(stream.path_name, sizeof(stream.path_name),
+		HOSTNAME "/" SESSION_NAME);
+	snprintf(stream.channel_name, sizeof(stream.channel_name),
+		"metadata");
+	if (send_all(fd, &stream, sizeof(stream))) {
+		return -1;
+	}
+	for (i = 0; i < relayd->nr_streams; i++) {
+		memset(&stream, 0, sizeof(stream));
+		stream.id = htobe64(i + 1);
+		stream.ctf_trace_id = htobe64(CTF_TRACE_ID);
+		snprintf(stream.path_name, sizeof(stream.path_name),
+			HOSTNAME "/" SESSION_NAME);
+		snprintf(stream.channel_name, sizeof(stream.channel_name),
+			"channel0_%" PRIu64, i);
+		if (send_all(fd, &stream, sizeof(stream))) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static
+int handle_connect(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_connect connect;
+
+	if (recv_all(fd, &connect, sizeof(connect))) {
+		return -1;
+	}
+	connect.viewer_session_id = htobe64(1);
+	connect.major = htobe32(2);
+	connect.minor = htobe32(4);
+	return send_all(fd, &connect, sizeof(connect));
+}
+
+static
+int handle_list_sessions(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_list_sessions list;
+	struct lttng_viewer_session session;
+
+	list.sessions_count = htobe32(1);
+	if (send_all(fd, &list, sizeof(list))) {
+		return -1;
+	}
+	memset(&session, 0, sizeof(session));
+	session.id = htobe64(SESSION_ID);
+	session.live_timer = htobe32(1000);
+	session.streams = htobe32(relayd->nr_streams + 1);
+	snprintf(session.hostname, sizeof(session.hostname), HOSTNAME);
+	snprintf(session.session_name, sizeof(session.session_name),
+		SESSION_NAME);
+	return send_all(fd, &session, sizeof(session));
+}
+
+static
+int handle_create_session(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_create_session_response rp;
+
+	rp.status = htobe32(LTTNG_VIEWER_CREATE_SESSION_OK);
+	return send_all(fd, &rp, sizeof(rp));
+}
+
+static
+int handle_attach_session(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_attach_session_request rq;
+	struct lttng_viewer_attach_session_response rp;
+
+	if (recv_all(fd, &rq, sizeof(rq))) {
+		return -1;
+	}
+	memset(&rp, 0, sizeof(rp));
+	if (be64toh(rq.session_id) != SESSION_ID) {
+		rp.status = htobe32(LTTNG_VIEWER_ATTACH_UNK);
+		return send_all(fd, &rp, sizeof(rp));
+	}
+	relayd->attached = true;
+	rp.status = htobe32(LTTNG_VIEWER_ATTACH_OK);
+	rp.streams_count = htobe32(relayd->nr_streams + 1);
+	if (send_all(fd, &rp, sizeof(rp))) {
+		return -1;
+	}
+	return send_streams(relayd, fd);
+}
+
+static
+int handle_detach_session(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_detach_session_request rq;
+	struct lttng_viewer_detach_session_response rp;
+
+	if (recv_all(fd, &rq, sizeof(rq))) {
+		return -1;
+	}
+	rp.status = htobe32(LTTNG_VIEWER_DETACH_SESSION_OK);
+	return send_all(fd, &rp, sizeof(rp));
+}
+
+static
+int handle_get_metadata(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_get_metadata rq;
+	struct lttng_viewer_metadata_packet rp;
+
+	if (recv_all(fd, &rq, sizeof(rq))) {
+		return -1;
+	}
+	memset(&rp, 0, sizeof(rp));
+	if (!relayd->metadata_sent) {
+		relayd->metadata_sent = true;
+		rp.len = htobe64(sizeof(metadata) - 1);
+		rp.status = htobe32(LTTNG_VIEWER_METADATA_OK);
+		if (send_all(fd, &rp, sizeof(rp))) {
+			return -1;
+		}
+		return send_all(fd, metadata, sizeof(metadata) - 1);
+	}
+
+	/* Metadata stream is closed once the session is over. */
+	rp.status = htobe32(all_streams_hung_up(relayd) ?
+		LTTNG_VIEWER_METADATA_ERR : LTTNG_VIEWER_NO_NEW_METADATA);
+	return send_all(fd, &rp, sizeof(rp));
+}
+
+static
+int handle_get_new_streams(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_new_streams_request rq;
+	struct lttng_viewer_new_streams_response rp;
+
+	if (recv_all(fd, &rq, sizeof(rq))) {
+		return -1;
+	}
+	memset(&rp, 0, sizeof(rp));
+	rp.status = htobe32(all_streams_hung_up(relayd) ?
+		LTTNG_VIEWER_NEW_STREAMS_HUP :
+		LTTNG_VIEWER_NEW_STREAMS_NO_NEW);
+	return send_all(fd, &rp, sizeof(rp));
+}
+
+static
+int handle_get_next_index(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_get_next_index rq;
+	struct lttng_viewer_index rp;
+	uint64_t stream_id;
+	struct fake_stream *stream;
+
+	if (recv_all(fd, &rq, sizeof(rq))) {
+		return -1;
+	}
+	memset(&rp, 0, sizeof(rp));
+	stream_id = be64toh(rq.stream_id);
+	if (stream_id == 0 || stream_id > relayd->nr_streams) {
+		rp.status = htobe32(LTTNG_VIEWER_INDEX_ERR);
+		return send_all(fd, &rp, sizeof(rp));
+	}
+	stream = &relayd->streams[stream_id - 1];
+	if (stream->next_packet == relayd->nr_packets) {
+		stream->hung_up = true;
+		rp.status = htobe32(LTTNG_VIEWER_INDEX_HUP);
+		return send_all(fd, &rp, sizeof(rp));
+	}
+	rp.offset = htobe64(stream->next_packet * relayd->packet_len);
+	rp.packet_size = htobe64(relayd->packet_len * CHAR_BIT);
+	rp.content_size = htobe64(relayd->content_len * CHAR_BIT);
+	rp.timestamp_begin = htobe64(event_timestamp(relayd, stream_id - 1,
+		stream->next_packet * relayd->events_per_packet));
+	rp.timestamp_end = htobe64(event_timestamp(relayd, stream_id - 1,
+		(stream->next_packet + 1) * relayd->events_per_packet - 1));
+	rp.stream_id = htobe64(0);
+	rp.status = htobe32(LTTNG_VIEWER_INDEX_OK);
+	stream->next_packet++;
+	return send_all(fd, &rp, sizeof(rp));
+}
+
+static
+int handle_get_packet(struct fake_relayd *relayd, int fd)
+{
+	struct lttng_viewer_get_packet rq;
+	struct lttng_viewer_trace_packet rp;
+	uint64_t stream_id, offset, packet_index, packet_offset;
+	uint32_t len;
+	uint8_t c;
+
+	if (recv_all(fd, &rq, sizeof(rq))) {
+		return -1;
+	}
+	relayd->get_packet_requests++;
+
+	/* Is the viewer already sending its next command? */
+	if (recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 1) {
+		relayd->pipelined_get_packet_requests++;
+	}
+
+	memset(&rp, 0, sizeof(rp));
+	stream_id = be64toh(rq.stream_id);
+	offset = be64toh(rq.offset);
+	len = be32toh(rq.len);
+	packet_index = offset / relayd->packet_len;
+	packet_offset = offset % relayd->packet_len;
+	if (stream_id == 0 || stream_id > relayd->nr_streams ||
+			packet_index >= relayd->streams[stream_id - 1].next_packet ||
+			len == 0 || packet_offset + len > relayd->packet_len) {
+		fprintf(stderr, "Invalid GET_PACKET request: stream %" PRIu64
+			", offset %" PRIu64 ", length %" PRIu32 "\n",
+			stream_id, offset, len);
+		rp.status = htobe32(LTTNG_VIEWER_GET_PACKET_ERR);
+		return send_all(fd, &rp, sizeof(rp));
+	}
+	if (relayd->max_packet_reply && len > relayd->max_packet_reply) {
+		len = relayd->max_packet_reply;
+	}
+	build_packet(relayd, stream_id - 1, packet_index);
+	rp.status = htobe32(LTTNG_VIEWER_GET_PACKET_OK);
+	rp.len = htobe32(len);
+	if (send_all(fd, &rp, sizeof(rp))) {
+		return -1;
+	}
+	if (relayd->split_delay_us) {
+		if (send_all(fd, relayd->packet_buf + packet_offset, len / 2)) {
+			return -1;
+		}
+		usleep(relayd->split_delay_us);
+		packet_offset += len / 2;
+		len -= len / 2;
+	}
+	return send_all(fd, relayd->packet_buf + packet_offset, len);
+}
+
+static
+int serve_viewer(struct fake_relayd *relayd, int fd)
+{
+	for (;;) {
+		struct lttng_viewer_cmd cmd;
+		int ret;
+
+		if (recv_all(fd, &cmd, sizeof(cmd))) {
+			/* Viewer is gone. */
+			return 0;
+		}
+		switch (be32toh(cmd.cmd)) {
+		case LTTNG_VIEWER_CONNECT:
+			ret = handle_connect(relayd, fd);
+			break;
+		case LTTNG_VIEWER_LIST_SESSIONS:
+			ret = handle_list_sessions(relayd, fd);
+			break;
+		case LTTNG_VIEWER_CREATE_SESSION:
+			ret = handle_create_session(relayd, fd);
+			break;
+		case LTTNG_VIEWER_ATTACH_SESSION:
+			ret = handle_attach_session(relayd, fd);
+			break;
+		case LTTNG_VIEWER_DETACH_SESSION:
+			ret = handle_detach_session(relayd, fd);
+			break;
+		case LTTNG_VIEWER_GET_METADATA:
+			ret = handle_get_metadata(relayd, fd);
+			break;
+		case LTTNG_VIEWER_GET_NEW_STREAMS:
+			ret = handle_get_new_streams(relayd, fd);
+			break;
+		case LTTNG_VIEWER_GET_NEXT_INDEX:
+			ret = handle_get_next_index(relayd, fd);
+			break;
+		case LTTNG_VIEWER_GET_PACKET:
+			ret = handle_get_packet(relayd, fd);
+			break;
+		default:
+			fprintf(stderr, "Unknown viewer command %" PRIu32 "\n",
+				be32toh(cmd.cmd));
+			return -1;
+		}
+		if (ret) {
+			return 0;
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	struct fake_relayd relayd;
+	struct sockaddr_in addr;
+	socklen_t addr_len = sizeof(addr);
+	int listen_fd, one = 1;
+
+	if (argc < 4) {
+		fprintf(stderr, "Usage: %s STREAMS PACKETS EVENTS_PER_PACKET "
+			"[MAX_PACKET_REPLY [SPLIT_DELAY_US]]\n", argv[0]);
+		return 1;
+	}
+
+	/* A viewer which goes away must not kill the daemon. */
+	signal(SIGPIPE, SIG_IGN);
+	memset(&relayd, 0, sizeof(relayd));
+	relayd.nr_streams = strtoull(argv[1], NULL, 10);
+	relayd.nr_packets = strtoull(argv[2], NULL, 10);
+	relayd.events_per_packet = strtoull(argv[3], NULL, 10);
+	if (argc > 4) {
+		relayd.max_packet_reply = strtoul(argv[4], NULL, 10);
+	}
+	if (argc > 5) {
+		relayd.split_delay_us = strtoul(argv[5], NULL, 10);
+	}
+	if (relayd.nr_streams == 0 || relayd.events_per_packet == 0) {
+		fprintf(stderr, "Invalid session parameters\n");
+		return 1;
+	}
+	relayd.content_len = PACKET_HEADER_LEN + PACKET_CONTEXT_LEN +
+		relayd.events_per_packet * EVENT_LEN;
+	relayd.packet_len = (relayd.content_len + PACKET_ALIGN - 1) &
+		~((uint64_t) PACKET_ALIGN - 1);
+	relayd.streams = calloc(relayd.nr_streams, sizeof(*relayd.streams));
+	relayd.packet_buf = malloc(relayd.packet_len);
+	if (!relayd.streams || !relayd.packet_buf) {
+		perror("malloc");
+		return 1;
+	}
+
+	listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (listen_fd < 0) {
+		perror("socket");
+		return 1;
+	}
+	(void) setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one,
+		sizeof(one));
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	if (bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr)) ||
+			listen(listen_fd, 1) ||
+			getsockname(listen_fd, (struct sockaddr *) &addr,
+				&addr_len)) {
+		perror("bind");
+		return 1;
+	}
+	printf("%u\n", (unsigned int) ntohs(addr.sin_port));
+	fflush(stdout);
+
+	while (!relayd.attached) {
+		int fd = accept(listen_fd, NULL, NULL);
+
+		if (fd < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			perror("accept");
+			return 1;
+		}
+		if (serve_viewer(&relayd, fd)) {
+			close(fd);
+			return 1;
+		}
+		close(fd);
+	}
+
+	printf("get-packet-requests %" PRIu64 "\n",
+		relayd.get_packet_requests);
+	printf("pipelined-get-packet-requests %" PRIu64 "\n",
+		relayd.pipelined_get_packet_requests);
+	close(listen_fd);
+	free(relayd.packet_buf);
+	free(relayd.streams);
+	return 0;
+}
@@ -53,11 +53,12 @@
 #include <babeltrace/graph/private-port.h>
 #include <babeltrace/plugin/plugin.h>
 #include <babeltrace/ref.h>
+#include <babeltrace/values.h>
 #include <glib.h>
 
 #include "tap/tap.h"
 
-#define NR_TESTS	12
+#define NR_TESTS	14
 
 enum test {
 	TEST_NO_TS,
@@ -913,6 +914,7 @@ void sink_finalize(struct bt_private_component *private_component)
 
 static
 void create_source_muxer_sink(struct bt_graph *graph,
+		struct bt_value *muxer_params,
 		struct bt_component **source,
 		struct bt_component **muxer,
 		struct bt_component **sink)
@@ -943,7 +945,8 @@ void create_source_muxer_sink(struct bt_graph *graph,
 	muxer_comp_class = bt_plugin_find_component_class("utils", "muxer",
 		BT_COMPONENT_CLASS_TYPE_FILTER);
 	assert(muxer_comp_class);
-	ret = bt_graph_add_component(graph, muxer_comp_class, "muxer", NULL, muxer);
+	ret = bt_graph_add_component(graph, muxer_comp_class, "muxer",
+		muxer_params, muxer);
 	assert(ret == 0);
 
 	/* Create sink component */
@@ -967,7 +970,7 @@ void create_source_muxer_sink(struct bt_graph *graph,
 static
 void do_std_test(enum test test, const char *name,
 		const struct test_event *expected_test_events,
-		bool with_upstream)
+		bool with_upstream, struct bt_value *muxer_params)
 {
 	struct bt_component *src_comp;
 	struct bt_component *muxer_comp;
@@ -984,7 +987,8 @@ void do_std_test(enum test test, const char *name,
 	diag("test: %s", name);
 	graph = bt_graph_create();
 	assert(graph);
-	create_source_muxer_sink(graph, &src_comp, &muxer_comp, &sink_comp);
+	create_source_muxer_sink(graph, muxer_params, &src_comp, &muxer_comp,
+		&sink_comp);
 
 	/* Connect source output ports to muxer input ports */
 	if (with_upstream) {
@@ -1059,7 +1063,7 @@ void test_no_ts(void)
 	};
 
 	do_std_test(TEST_NO_TS, "event notifications with no time",
-		expected_test_events, true);
+		expected_test_events, true, NULL);
 }
 
 static
@@ -1071,7 +1075,7 @@ void test_no_upstream_connection(void)
 	};
 
 	do_std_test(TEST_NO_UPSTREAM_CONNECTION, "no upstream connection",
-		expected_test_events, false);
+		expected_test_events, false, NULL);
 }
 
 static
@@ -1194,8 +1198,21 @@ void test_simple_4_ports(void)
 		{ .type = TEST_EV_TYPE_SENTINEL, },
 	};
 
+	struct bt_value *muxer_params;
+	int ret;
+
 	do_std_test(TEST_SIMPLE_4_PORTS, "simple: 4 ports without retries",
-		expected_test_events, true);
+		expected_test_events, true, NULL);
+
+	/* Same notifications, with 2 worker threads for 4 upstream ports */
+	muxer_params = bt_value_map_create();
+	assert(muxer_params);
+	ret = bt_value_map_insert_integer(muxer_params, "threads", 2);
+	assert(ret == 0);
+	do_std_test(TEST_SIMPLE_4_PORTS,
+		"simple: 4 ports without retries, 2 worker threads",
+		expected_test_events, true, muxer_params);
+	bt_put(muxer_params);
 }
 
 static
@@ -1323,7 +1340,7 @@ void test_4_ports_with_retries(void)
 	};
 
 	do_std_test(TEST_4_PORTS_WITH_RETRIES, "4 ports with retries",
-		expected_test_events, true);
+		expected_test_events, true, NULL);
 }
 
 static
@@ -1458,7 +1475,8 @@ void test_single_end_then_multiple_full(void)
 	diag("test: single end then multiple full");
 	graph = bt_graph_create();
 	assert(graph);
-	create_source_muxer_sink(graph, &src_comp, &muxer_comp, &sink_comp);
+	create_source_muxer_sink(graph, NULL, &src_comp, &muxer_comp,
+		&sink_comp);
 	graph_listener_data.graph = graph;
 	graph_listener_data.source = src_comp;
 	graph_listener_data.muxer = muxer_comp;
@@ -1586,7 +1604,8 @@ void test_single_again_end_then_multiple_full(void)
 	diag("test: single again then end then multiple full");
 	graph = bt_graph_create();
 	assert(graph);
-	create_source_muxer_sink(graph, &src_comp, &muxer_comp, &sink_comp);
+	create_source_muxer_sink(graph, NULL, &src_comp, &muxer_comp,
+		&sink_comp);
 	graph_listener_data.graph = graph;
 	graph_listener_data.source = src_comp;
 	graph_listener_data.muxer = muxer_comp;